@@ -190,6 +190,18 @@ public:
     /// \param[out] report [optional] collision report to be filled with data about the collision. If a body was hit, CollisionReport::plink1 contains the hit link pointer.
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr()) = 0;
 
+    /** \brief Checks a batch of rays against the environment or a body. The buffers are flat so that callers can pass arrays they already own.
+
+        The default implementation calls \ref CheckCollision(const RAY&, KinBodyConstPtr, CollisionReportPtr) for every ray, checkers can override it to synchronize their data once per batch.
+        \param[in] prays 6*nrays values, the position followed by the direction of every ray. The length of the direction is the maximum distance checked.
+        \param[in] pbody if not empty, only check against this body
+        \param[out] pcollision nrays values, 1 if the ray hit something
+        \param[out] phits 6*nrays values, the position followed by the normal of the closest hit, zeros if there was no hit
+        \param bFrontFacingOnly if true, ignore hits on surfaces whose normal faces away from the ray
+        \return the number of rays that hit
+     */
+    virtual int CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly=false);
+
     /// \brief Checks self collision only with the links of the passed in body.
     ///
     /// Only checks KinBody::GetNonAdjacentLinks(), Links that are joined together are ignored.
@@ -203,6 +215,20 @@ public:
     /// \param[out] report [optional] collision report to be filled with data about the collision.
     virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) = 0;
 
+    /** \brief Checks if a body moving along a joint-space segment collides with the environment or with itself at any time of the segment.
+
+        If timeelapsed > 0 and the velocities are given, the segment is the parabola q(t) = q0 + dq0*t + 0.5*(dq1-dq0)/timeelapsed*t^2 for t in [0,timeelapsed], otherwise it is the line from q0 to q1.
+        The default implementation uses conservative advancement: the minimum distance of the body (CO_Distance) is divided by a bound on the speed of its links to get a time step that cannot miss any contact.
+        The body state is restored on return.
+        \param pbody the body to move, its dofs not in vdofindices are kept at their current values
+        \param vdofindices the dof indices of the body that q0, q1, dq0, and dq1 refer to
+        \param fmindistance distances below this are treated as collisions. Conservative advancement cannot prove contact-free motion at zero clearance, so this should be > 0.
+        \param[out] report [optional] filled with the collision at the first colliding time using the current collision options. If the body only came closer than fmindistance, it holds the closest pair of links.
+        \param[out] ptimeofimpact [optional] set to the first colliding time when there is a collision, in [0,timeelapsed] for parabolic segments and in [0,1] for lines
+        \throw openrave_exception ORE_NotImplemented if the checker does not support CO_Distance or the body has mimic joints
+     */
+    virtual bool CheckContinuousCollision(KinBodyPtr pbody, const std::vector<int>& vdofindices, const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, dReal fmindistance=1e-4, CollisionReportPtr report = CollisionReportPtr(), dReal* ptimeofimpact = NULL);
+
     /// \deprecated (13/04/09)
     virtual bool CheckSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) RAVE_DEPRECATED
     {
@@ -230,6 +256,9 @@ protected:
         return boost::static_pointer_cast<CollisionCheckerBase const>(shared_from_this());
     }
 
+    /// \brief fills the report of \ref CheckContinuousCollision at the colliding time with the caller's collision options
+    void _FillContinuousCollisionReport(KinBodyPtr pbody, int coloptions, const CollisionReport& distreport, CollisionReportPtr report);
+
 private:
     virtual const char* GetHash() const {
         return OPENRAVE_COLLISIONCHECKER_HASH;
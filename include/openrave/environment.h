@@ -118,6 +118,9 @@ public:
     /// \see CollisionCheckerBase::CheckCollision(const RAY&,CollisionReportPtr)
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr()) = 0;
 
+    /// \see CollisionCheckerBase::CheckCollisionRays
+    virtual int CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly=false) = 0;
+
     /// \see CollisionCheckerBase::CheckSelfCollision
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) = 0;
 
@@ -231,6 +234,11 @@ public:
 
     /** \brief Saves a scene depending on the filename extension. Default is in COLLADA format
 
+        If the extension is *.orsnap, saves a binary snapshot of the fully initialized bodies including their collision
+        meshes and adjacency information. Loading a snapshot through \ref Load skips all parsing and mesh importing.
+        Snapshots are only valid for the same OpenRAVE version and precision, and are rejected if the kinematics hashes
+        of the re-created bodies differ.
+
         \param filename the filename to save the results at
         \param options controls what to save
         \param atts attributes that refine further options. For collada parsing, the options are passed through
@@ -37,6 +37,88 @@ enum SerializationOptions
     SO_InverseKinematics = 0x80, ///< information necessary for inverse kinematics. If Transform6D, then don't include the manipulator local transform
 };
 
+/// \brief the type of a \ref CommandValue
+enum CommandValueType
+{
+    CVT_None = 0, ///< no value, passed for optional arguments that are not set
+    CVT_Bool = 1, ///< CommandValue::intvalue is 0 or 1
+    CVT_Int = 2, ///< CommandValue::intvalue
+    CVT_Real = 3, ///< CommandValue::realvalue
+    CVT_String = 4, ///< CommandValue::stringvalue, as text a single word, or a double-quoted string with backslash-escaped quotes and backslashes
+    CVT_Ints = 5, ///< CommandValue::intvalues, as text the number of values followed by the values
+    CVT_Reals = 6, ///< CommandValue::realvalues, as text the number of values followed by the values
+    CVT_Transform = 7, ///< CommandValue::transform, as text the quaternion followed by the translation
+};
+
+/** \brief A typed argument or result of a structured command, see \ref InterfaceBase::SendStructuredCommand
+
+    Only the member corresponding to the type is used. Scalar values do not allocate any memory.
+ */
+class OPENRAVE_API CommandValue
+{
+public:
+    CommandValue() : type(CVT_None), intvalue(0), realvalue(0) {
+    }
+    CommandValue(bool b) : type(CVT_Bool), intvalue(b), realvalue(0) {
+    }
+    // one constructor per fundamental type so that size_t, uint64_t, float, etc do not have ambiguous conversions
+    CommandValue(int i) : type(CVT_Int), intvalue(i), realvalue(0) {
+    }
+    CommandValue(unsigned int i) : type(CVT_Int), intvalue(i), realvalue(0) {
+    }
+    CommandValue(long i) : type(CVT_Int), intvalue(i), realvalue(0) {
+    }
+    CommandValue(unsigned long i) : type(CVT_Int), intvalue(static_cast<int64_t>(i)), realvalue(0) {
+    }
+    CommandValue(long long i) : type(CVT_Int), intvalue(i), realvalue(0) {
+    }
+    CommandValue(unsigned long long i) : type(CVT_Int), intvalue(static_cast<int64_t>(i)), realvalue(0) {
+    }
+    CommandValue(float f) : type(CVT_Real), intvalue(0), realvalue(f) {
+    }
+    CommandValue(double f) : type(CVT_Real), intvalue(0), realvalue(f) {
+    }
+    CommandValue(const char* s) : type(CVT_String), intvalue(0), realvalue(0), stringvalue(s) {
+    }
+    CommandValue(const std::string& s) : type(CVT_String), intvalue(0), realvalue(0), stringvalue(s) {
+    }
+    CommandValue(const std::vector<int>& v) : type(CVT_Ints), intvalue(0), realvalue(0), intvalues(v) {
+    }
+    CommandValue(const std::vector<dReal>& v) : type(CVT_Reals), intvalue(0), realvalue(0), realvalues(v) {
+    }
+    CommandValue(const Transform& t) : type(CVT_Transform), intvalue(0), realvalue(0), transform(t) {
+    }
+
+    /// \brief writes the value in the text format of \ref InterfaceBase::SendCommand
+    void Write(std::ostream& O) const;
+
+    /// \brief reads a value of the given type from the text format of \ref InterfaceBase::SendCommand
+    ///
+    /// \return false if the stream does not contain a value of that type
+    bool Read(std::istream& I, CommandValueType newtype);
+
+    CommandValueType type;
+    int64_t intvalue;
+    dReal realvalue;
+    std::string stringvalue;
+    std::vector<int> intvalues;
+    std::vector<dReal> realvalues;
+    Transform transform;
+};
+
+/// \brief describes one argument of a structured command, see \ref InterfaceBase::RegisterStructuredCommand
+class OPENRAVE_API CommandArgument
+{
+public:
+    CommandArgument() : type(CVT_None), bOptional(false) {
+    }
+    CommandArgument(const std::string& newname, CommandValueType newtype, bool optional=false) : name(newname), type(newtype), bOptional(optional) {
+    }
+    std::string name; ///< name shown in the help string
+    CommandValueType type;
+    bool bOptional; ///< if true, the argument can be left out. Optional arguments have to come after the required ones.
+};
+
 /** \brief <b>[interface]</b> Base class for all interfaces that OpenRAVE provides. See \ref interface_concepts.
     \ingroup interfaces
  */
@@ -142,6 +224,23 @@ public:
      */
     virtual bool SendCommand(std::ostream& os, std::istream& is);
 
+    /** \brief Sends a command with typed arguments and returns typed results. <b>[multi-thread safe]</b>
+
+        Commands registered with \ref RegisterStructuredCommand receive the arguments directly after they are
+        checked against the argument schema, optional arguments that are not given are passed as CVT_None.
+        Commands registered with \ref RegisterCommand are called through their text format, the arguments are
+        written with \ref CommandValue::Write and the output is returned as one CVT_String result.
+
+        The command lookup does not lock the interface, so calls from many threads do not serialize on it. The
+        command map pointer is read with boost::atomic_load, which is guarded by a small spinlock pool, not lock-free.
+        \param cmd the command name, case is ignored
+        \param vargs the arguments of the command
+        \param vresults filled with the results of the command
+        \exception openrave_exception Throw if the command is not supported or the arguments do not match the schema.
+        \return true if the command is successfully processed, otherwise false.
+     */
+    virtual bool SendStructuredCommand(const std::string& cmd, const std::vector<CommandValue>& vargs, std::vector<CommandValue>& vresults);
+
     /// \biref Similar to \ref SendCommand except the inputs and outputs are a string
     ///
     /// This function should not be overridden by the user, therefore it isn't virtual.
@@ -178,6 +277,14 @@ protected:
     /// \param sout - output of the command
     /// \return If false, there was an error with the command, true if successful
     typedef boost::function<bool (std::ostream&, std::istream&)> InterfaceCommandFn;
+
+    /// \brief The function to be executed for every structured command.
+    ///
+    /// \param vargs - the arguments of the command, one for every entry of the argument schema
+    /// \param vresults - the results of the command, empty when called
+    /// \return If false, there was an error with the command, true if successful
+    typedef boost::function<bool (const std::vector<CommandValue>&, std::vector<CommandValue>&)> StructuredCommandFn;
+
     class OPENRAVE_API InterfaceCommand
     {
 public:
@@ -185,7 +292,11 @@ public:
         }
         InterfaceCommand(InterfaceCommandFn newfn, const std::string& newhelp) : fn(newfn), help(newhelp) {
         }
-        InterfaceCommandFn fn; ///< command function to run
+        InterfaceCommand(StructuredCommandFn newfn, const std::vector<CommandArgument>& newargs, const std::string& newhelp) : structuredfn(newfn), vargs(newargs), help(newhelp) {
+        }
+        InterfaceCommandFn fn; ///< command function to run, empty for structured commands
+        StructuredCommandFn structuredfn; ///< structured command function to run, empty for text commands
+        std::vector<CommandArgument> vargs; ///< argument schema of the structured command
         std::string help; ///< help string explaining command arguments
     };
 
@@ -197,6 +308,19 @@ public:
     /// \exception openrave_exception Throw if there exists a registered command already.
     virtual void RegisterCommand(const std::string& cmdname, InterfaceCommandFn fncmd, const std::string& strhelp);
 
+    /** \brief Registers a command with typed arguments and results. <b>[multi-thread safe]</b>
+
+        The command can be called with \ref SendStructuredCommand without any text conversions. It can also be
+        called with \ref SendCommand, in which case the arguments are read from the text in the order of vargs, any text left after them is an error,
+        and the results are written separated by spaces.
+        \param cmdname - command name, converted to lower case
+        \param fncmd function to execute for the command
+        \param vargs the argument schema of the command
+        \param strhelp - help string in reStructuredText, the arguments are appended to it
+        \exception openrave_exception Throw if there exists a registered command already or the schema is invalid.
+     */
+    virtual void RegisterStructuredCommand(const std::string& cmdname, StructuredCommandFn fncmd, const std::vector<CommandArgument>& vargs, const std::string& strhelp);
+
     /// \brief Unregisters the command. <b>[multi-thread safe]</b>
     virtual void UnregisterCommand(const std::string& cmdname);
 
@@ -209,9 +333,20 @@ public:
     }
 
 private:
+    typedef std::map<std::string, boost::shared_ptr<InterfaceCommand>, CaseInsensitiveCompare> CMDMAP;
+
     /// Write the help commands to an output stream
     virtual bool _GetCommandHelp(std::ostream& sout, std::istream& sinput) const;
 
+    /// \brief adds the command to the pending command map, _mutexInterface has to be locked
+    void _AddCommand(const std::string& cmdname, boost::shared_ptr<InterfaceCommand> cmd);
+
+    /// \brief returns the pending command map, creating it from the published one if necessary. _mutexInterface has to be locked
+    CMDMAP& _GetPendingCommands();
+
+    /// \brief returns the published command map, publishes the pending commands first if there are any
+    boost::shared_ptr<CMDMAP const> _GetCommands() const;
+
     inline InterfaceBase& operator=(const InterfaceBase&r) {
         throw openrave_exception("InterfaceBase copying not allowed");
     }
@@ -225,8 +360,16 @@ private:
     mutable std::map<std::string, UserDataPtr> __mapUserData; ///< \see GetUserData
 
     READERSMAP __mapReadableInterfaces; ///< pointers to extra interfaces that are included with this object
-    typedef std::map<std::string, boost::shared_ptr<InterfaceCommand>, CaseInsensitiveCompare> CMDMAP;
-    CMDMAP __mapCommands; ///< all registered commands
+    /// \brief all published commands.
+    ///
+    /// The map is never modified once published so that commands can be looked up without locking _mutexInterface.
+    /// boost::atomic_load/atomic_store on a shared_ptr take a spinlock from a global pool for the pointer copy, they are not lock-free.
+    mutable boost::shared_ptr<CMDMAP const> __mapCommands;
+    /// \brief commands registered or unregistered since the last publish, modified in place while _mutexInterface is locked.
+    ///
+    /// The constructors register all their commands into this map, it is swapped into __mapCommands by the first lookup, so
+    /// registering n commands copies the map once instead of n times.
+    mutable boost::shared_ptr<CMDMAP> __mapCommandsPending;
 
 #ifdef RAVE_PRIVATE
 #ifdef _MSC_VER
@@ -441,6 +441,13 @@ protected:
             return _info._t;
         }
 
+        /// \brief Return the \ref KinBody::GetUpdateStamp of the last change that moved this link.
+        ///
+        /// Links that a change did not move keep their stamp, so users that cache the link transforms only have to update the links whose stamp changed.
+        inline int GetTransformStamp() const {
+            return _nTransformStamp;
+        }
+
         /// \brief Return all the direct parent links in the kinematics hierarchy of this link.
         ///
         /// A parent link is is immediately connected to this link by a joint and has a path to the root joint so that it is possible
@@ -657,6 +664,7 @@ private:
         /// @name Private Link Variables
         //@{
         int _index;                  ///< \see GetIndex
+        int _nTransformStamp;         ///< \see GetTransformStamp
         KinBodyWeakPtr _parent;         ///< \see GetParent
         std::vector<int> _vParentLinks;         ///< \see GetParentLinks, IsParentLink
         std::vector<int> _vRigidlyAttachedLinks;         ///< \see IsRigidlyAttached, GetRigidlyAttachedLinks
@@ -1794,6 +1802,59 @@ private:
     /// \brief sets the link enable states
     virtual void SetLinkEnableStates(const std::vector<uint8_t>& enablestates);
 
+    /// \brief the joint axes on the path from the root link to a link and the jacobian columns they write to, see \ref GetJacobianChain
+    class JacobianChain
+    {
+public:
+        JacobianChain() : linkindex(-1), numcolumns(0), bHasMimic(false), _pbody(NULL), _nStamp(0) {
+        }
+
+        /// \brief one joint axis of the chain
+        struct Axis
+        {
+            JointPtr pjoint;
+            int jointaxis; ///< the axis of pjoint
+            int type; ///< 1 if revolute, 2 if prismatic, 0 if the joint type is not supported and the axis does not contribute
+            int column; ///< the jacobian column of the axis
+        };
+
+        int linkindex;
+        std::vector<int> dofindices; ///< the dof indices of the columns. If empty, the columns are all the dofs of the body
+        size_t numcolumns;
+        std::vector<Axis> vaxes; ///< ordered from the root link, every column appears at most once
+        bool bHasMimic; ///< if true, a mimic joint is on the path and \ref ComputeJacobians calls the std::vector functions, which allocate memory
+private:
+        KinBody const* _pbody; ///< the body the chain was computed for, the stamp is only valid for it
+        int _nStamp; ///< the value of KinBody::_nJacobianChainStamp when the chain was computed
+        friend class KinBody;
+    };
+    typedef boost::shared_ptr<JacobianChain> JacobianChainPtr;
+    typedef boost::shared_ptr<JacobianChain const> JacobianChainConstPtr;
+
+    /// \brief Returns the joint axes that contribute to the jacobians of a link.
+    ///
+    /// The chain is computed once for every link and set of dof indices, and is cached until the kinematics structure changes. Retrieving a cached chain does not allocate memory.
+    /// Only the most recently used sets of dof indices of every link are cached, returned chains stay valid when they are dropped from the cache.
+    /// \param linkindex of the link that defines the frame the position is attached to
+    /// \param dofindices the dof indices of the jacobian columns. If empty, will use all the dofs
+    virtual JacobianChainConstPtr GetJacobianChain(int linkindex, const std::vector<int>& dofindices=std::vector<int>()) const;
+
+    /** \brief Computes the translation and axis-angle jacobians and hessians of a link with one pass over its chain.
+
+        Writes into caller-provided buffers and does not allocate memory unless chain.bHasMimic is set. Any buffer can be NULL,
+        except that the translation hessian needs both jacobians and the axis-angle hessian needs the axis-angle jacobian.
+        Only the first chain.numcolumns columns of every row are written, so the jacobians of extra dofs (like the affine dofs of a robot) can be stored next to them.
+
+        \param chain returned by \ref GetJacobianChain of this body. Throws ORE_InvalidArguments if it is the chain of another body, and ORE_InvalidState if the kinematics structure changed since.
+        \param position position in world space where to compute derivatives from.
+        \param ptranslation 3xstride translation jacobian
+        \param paxisangle 3xstride axis-angle jacobian
+        \param phessiantranslation numcolumnsx3xstride translation hessian, H[i,j.k] = hessian[k+stride*(j+3*i)], see \ref ComputeHessianTranslation
+        \param phessianaxisangle numcolumnsx3xstride axis-angle hessian, see \ref ComputeHessianAxisAngle
+        \param stride the row stride of the buffers. If 0, uses chain.numcolumns
+     */
+    virtual void ComputeJacobians(const JacobianChain& chain, const Vector& position, dReal* ptranslation, dReal* paxisangle, dReal* phessiantranslation=NULL, dReal* phessianaxisangle=NULL, size_t stride=0) const;
+
     /// \brief Computes the translation jacobian with respect to a world position.
     ///
     /// Gets the jacobian with respect to a link by computing the partial differentials for all joints that in the path from the root node to GetLinks()[index]
@@ -1925,9 +1986,11 @@ private:
     /// \brief Returns the self-collision checker set specifically for this robot. If none has been set, return empty.
     virtual CollisionCheckerBasePtr GetSelfCollisionChecker() const;
 
-    /// \brief Check if body is self colliding. Links that are joined together are ignored.
-    ///
-    /// \param collisionchecker An option collision checker to use for checking self-collisions. If not specified, then will use the environment collision checker.
+    /** \brief Check if body is self colliding. Links that are joined together are ignored.
+
+        The link pairs to check are compiled once into a self-collision plan, see \ref _ComputeSelfCollisionPlan. When the previous check was collision-free with the same checker and options, only the pairs whose relative transform was changed by the DOFs that moved since then are checked. All pairs are checked when the checker has CO_Distance, CO_AllLinkCollisions or CO_ActiveDOFs set.
+        \param collisionchecker An option collision checker to use for checking self-collisions. If not specified, then will use the environment collision checker.
+     */
     virtual bool CheckSelfCollision(CollisionReportPtr report = CollisionReportPtr(), CollisionCheckerBasePtr collisionchecker=CollisionCheckerBasePtr()) const;
 
     /// \return true if two bodies should be considered as one during collision (ie one is grabbing the other)
@@ -2139,6 +2202,62 @@ protected:
     /// \brief resets cached information dependent on the collision checker (usually called when the collision checker is switched or some big mode is set.
     virtual void _ResetInternalCollisionCache();
 
+    /// \brief resets the cached jacobian chains, called whenever the joints on the link paths can change
+    void _ResetJacobianChains();
+
+    /// \brief the link pairs checked for self-collision and the DOFs that change their relative transforms
+    class SelfCollisionPlan
+    {
+public:
+        SelfCollisionPlan() : nmaskwords(0), coloptions(0), bHasGeometryGroup(false) {
+        }
+        std::vector<std::pair<LinkConstPtr, LinkConstPtr> > vpairs; ///< link pairs to check
+        std::vector<uint32_t> vpairlinkindices; ///< for every pair, i|(j<<16) where i and j are the indices of the links of this body that carry the two links of the pair
+        std::vector<KinBodyWeakPtr> vattachedbodies; ///< bodies whose links are part of vpairs and whose self-collision is checked too
+        std::vector<int> vattachedlinkindices; ///< for every body of vattachedbodies, the index of the link of this body that carries it
+        std::vector<uint64_t> vdofmasks; ///< for every DOF, nmaskwords words of a bitmask over vpairs. A bit is set if the DOF changes the relative transform of the pair
+        size_t nmaskwords;
+
+        std::vector<dReal> vdofvalues; ///< the DOF values at the last collision-free check. If empty, the next check has to test all pairs
+        std::vector<dReal> vattacheddofvalues; ///< the DOF values of vattachedbodies at the last collision-free check
+        std::vector<Transform> vattachedtransforms; ///< the link transforms of vattachedbodies relative to their carrying links at the last collision-free check. The bodies can be moved without changing any DOF values
+        boost::weak_ptr<CollisionCheckerBase> pchecker; ///< the checker of the last collision-free check
+        int coloptions; ///< the collision options of the last collision-free check
+        std::string geometrygroup; ///< the geometry group of the checker at the last collision-free check
+        bool bHasGeometryGroup; ///< true if the checker of the last collision-free check supports geometry groups
+        std::vector<dReal> vcurdofvalues, vcurattacheddofvalues, vtempvalues; ///< cache
+        std::vector<uint64_t> vcurmask; ///< cache
+    };
+    typedef boost::shared_ptr<SelfCollisionPlan> SelfCollisionPlanPtr;
+
+    /// \brief fills plan.vpairs, plan.vpairlinkindices, and plan.vattachedbodies with all the link pairs to check for self-collision. The DOF masks are computed afterwards from vpairlinkindices.
+    virtual void _ComputeSelfCollisionPlan(SelfCollisionPlan& plan) const;
+
+    /// \brief checks all the pairs for self-collision without using the self-collision plan
+    virtual bool _CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const;
+
+    /// \brief checks only the pairs of the self-collision plan affected by the DOFs that changed since the last collision-free check.
+    ///
+    /// \return 1 if in collision, 0 if not in collision, and -1 if the plan cannot be used and all pairs have to be checked
+    int _CheckSelfCollisionIncremental(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const;
+
+    /// \brief stores the state of a full self-collision check in the self-collision plan so the next check can be incremental
+    void _UpdateSelfCollisionPlan(bool bCollision, CollisionCheckerBasePtr collisionchecker) const;
+
+    /// \brief makes the next self-collision check test all pairs, called when links move independently of the DOF values
+    inline void _InvalidateSelfCollisionPlan() {
+        if( !!_pSelfCollisionPlan ) {
+            _pSelfCollisionPlan->vdofvalues.resize(0);
+        }
+    }
+
+    /// \brief sets the transform stamp of every link, called when all links moved
+    inline void _SetLinkTransformStamps(int stamp) const {
+        for(size_t i = 0; i < _veclinks.size(); ++i) {
+            _veclinks[i]->_nTransformStamp = stamp;
+        }
+    }
+
     std::string _name; ///< name of body
     std::vector<JointPtr> _vecjoints; ///< \see GetJoints
     std::vector<JointPtr> _vTopologicallySortedJoints; ///< \see GetDependencyOrderedJoints
@@ -2162,6 +2281,10 @@ protected:
     mutable boost::array<std::set<int>, 4> _setNonAdjacentLinks; ///< contains cached versions of the non-adjacent links depending on values in AdjacentOptions. Declared as mutable since data is cached.
     mutable int _nNonAdjacentLinkCache; ///< specifies what information is currently valid in the AdjacentOptions.  Declared as mutable since data is cached. If 0x80000000 (ie < 0), then everything needs to be recomputed including _setNonAdjacentLinks[0].
     std::vector<Transform> _vInitialLinkTransformations; ///< the initial transformations of each link specifying at least one pose where the robot is collision free
+    mutable SelfCollisionPlanPtr _pSelfCollisionPlan; ///< compiled self-collision pairs, reset whenever the pairs could change. Declared as mutable since data is cached.
+    mutable std::vector< std::vector<JacobianChainPtr> > _vJacobianChains; ///< \see GetJacobianChain, indexed by link index, every link keeps a bounded number of chains ordered from the least recently used. Declared as mutable since data is cached.
+    mutable boost::mutex _mutexJacobianChains; ///< protects _vJacobianChains
+    int _nJacobianChainStamp; ///< incremented every time _vJacobianChains is reset
 
     ConfigurationSpecification _spec;
     CollisionCheckerBasePtr _selfcollisionchecker; ///< optional checker to use for self-collisions
@@ -2185,11 +2308,15 @@ private:
     friend class OpenRAVEXMLParser::KinBodyXMLReader;
     friend class OpenRAVEXMLParser::JointXMLReader;
     friend class XFileReader;
+    friend class SnapshotReader;
+    friend class SnapshotWriter;
 #else
     friend class ::Environment;
     friend class ::OpenRAVEXMLParser::KinBodyXMLReader;
     friend class ::OpenRAVEXMLParser::JointXMLReader;
     friend class ::XFileReader;
+    friend class ::SnapshotReader;
+    friend class ::SnapshotWriter;
 #endif
 #endif
 
@@ -1000,6 +1000,7 @@ protected:
 
     /** \brief Converts from one specification to another.
 
+        Converts directly without building a \ref ConversionPlan, callers converting repeatedly between the same specifications should keep a plan instead.
         \param ittargetdata iterator pointing to start of target group data that should be overwritten
         \param targetspec the target configuration specification
         \param itsourcedata iterator pointing to start of source group data that should be read
@@ -1010,6 +1011,97 @@ protected:
      */
     static void ConvertData(std::vector<dReal>::iterator ittargetdata, const ConfigurationSpecification& targetspec, std::vector<dReal>::const_iterator itsourcedata, const ConfigurationSpecification& sourcespec, size_t numpoints, EnvironmentBaseConstPtr penv, bool filluninitialized = true);
 
+    /** \brief A precomputed conversion from data of a source specification to data of a target specification.
+
+        Building the plan matches the compatible groups and parses their names once, and flattens the conversion into
+        a list of strided copy, rotation conversion and default fill operations. Applying the plan does not allocate,
+        so callers converting many points between the same two specifications should build the plan once and keep it.
+
+        The default values of uninitialized target data are read from the environment when the plan is built. Long
+        lived plans can refresh them with \ref UpdateDefaults.
+     */
+    class OPENRAVE_API ConversionPlan
+    {
+public:
+        ConversionPlan();
+
+        /// \brief builds the plan, see \ref Init
+        ConversionPlan(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, EnvironmentBaseConstPtr penv, bool filluninitialized = true);
+
+        /** \brief builds the plan for converting data represented by sourcespec into data represented by targetspec.
+
+            \param penv [optional] The environment which might be needed to fill in unknown data. Assumes environment is locked.
+            \param filluninitialized If there exists target groups that cannot be initialized, then will set default values using the current environment.
+            \throw openrave_exception throw if groups are incompatible
+         */
+        void Init(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, EnvironmentBaseConstPtr penv, bool filluninitialized = true);
+
+        /** \brief builds the plan for converting the data of a single pair of compatible groups.
+
+            \param targetstride the number of elements that to go from the next target point.
+            \param sourcestride the number of elements that to go from the next source point.
+         */
+        void InitGroup(size_t targetstride, const Group& gtarget, size_t sourcestride, const Group& gsource, EnvironmentBaseConstPtr penv, bool filluninitialized = true);
+
+        /// \brief returns true if the plan was built from the two specifications with the same fill option
+        bool IsBuiltFor(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized) const;
+
+        /// \brief re-reads the default values of uninitialized target data from the bodies in the environment.
+        ///
+        /// Assumes environment is locked. Does not allocate after the first call.
+        void UpdateDefaults();
+
+        /** \brief converts numpoints of source data into target data.
+
+            \param ittargetdata iterator pointing to start of target data that should be overwritten
+            \param itsourcedata iterator pointing to start of source data that should be read
+         */
+        void Apply(std::vector<dReal>::iterator ittargetdata, std::vector<dReal>::const_iterator itsourcedata, size_t numpoints) const;
+
+        /// \brief the number of flattened operations performed for every point
+        inline size_t GetNumOperations() const {
+            return _voperations.size();
+        }
+
+private:
+        enum OperationType
+        {
+            OT_Copy=0, ///< copy count values from sourceindex to targetindex
+            OT_Fill=1, ///< copy count default values to targetindex
+            OT_Rotation=2, ///< call the rotation converter at index count
+        };
+        struct Operation
+        {
+            OperationType type;
+            int targetindex, sourceindex, count;
+        };
+        /// \brief where to read default values of a block of target data from
+        struct DefaultSource
+        {
+            KinBodyWeakPtr _pbody;
+            int _type; ///< 0 - dof values, 1 - dof velocities, 2 - affine transform
+            int _targetindex; ///< offset into _vdefaultvalues
+            int _affinedofs;
+            std::vector<int> _vdofindices;
+        };
+
+        void _Reset(size_t targetstride, size_t sourcestride);
+        void _AddGroupConversion(int targetoffset, const Group& gtarget, int sourceoffset, const Group& gsource, EnvironmentBaseConstPtr penv, bool filluninitialized);
+        void _AddGroupDefaults(int targetoffset, const Group& gtarget, EnvironmentBaseConstPtr penv);
+        void _AddTransfer(int targetindex, int sourceindex);
+        void _AddFill(int targetindex);
+        void _AddDefaultSource(EnvironmentBaseConstPtr penv, const std::string& targetbodyname, const std::string& sourcebodyname, int type, int targetindex, int affinedofs, const std::vector<int>& vdofindices);
+
+        std::vector<Operation> _voperations;
+        std::vector< boost::function<void(std::vector<dReal>::iterator, std::vector<dReal>::const_iterator)> > _vrotationconverters;
+        std::vector<DefaultSource> _vdefaultsources;
+        std::vector<dReal> _vdefaultvalues; ///< indexed by target index
+        std::vector<dReal> _vbodyvaluescache;
+        std::vector<Group> _vtargetgroups, _vsourcegroups; ///< the specification groups the plan was built from
+        size_t _targetstride, _sourcestride;
+        bool _bFillUninitialized;
+    };
+
     /// \brief gets the name of the interpolation that represents the derivative of the passed in interpolation.
     ///
     /// For example GetInterpolationDerivative("quadratic") -> "linear"
@@ -2323,6 +2415,8 @@ OPENRAVE_API std::string RaveFindDatabaseFile(const std::string& filename, bool
 /// Although environment creation will automatically make sure this function is called, users might want
 /// explicit control of when this happens.
 /// Will not do anything if OpenRAVE runtime is already initialized. If OPENRAVE_* environment variables must be re-read, first call \ref RaveDestroy.
+/// If OPENRAVE_PLUGIN_CACHE is set to a value other than 0, the interfaces offered by each plugin are read from and written to
+/// plugins.cache in \ref RaveGetHomeDirectory so that unchanged plugins are not opened at startup. The cache is off by default.
 /// \param bLoadAllPlugins If true will load all the openrave plugins automatically that can be found in the OPENRAVE_PLUGINS environment path
 /// \return 0 if successful, otherwise an error code
 OPENRAVE_API int RaveInitialize(bool bLoadAllPlugins=true, int level = Level_Info);
@@ -2489,6 +2583,116 @@ OPENRAVE_API std::string RaveGetDefaultViewerType();
  */
 OPENRAVE_API const char *RaveGetLocalizedTextForDomain(const std::string& domainname, const char *msgid);
 
+/// \brief Types of events reported to the trace handler, see \ref RaveSetTraceHandler
+enum TraceEventType
+{
+    TET_PlannerIteration=1, ///< a planner called its callbacks. name is the planner xml id and value is the iteration.
+    TET_CollisionQuery=2, ///< a collision query. name is the queried body or link and value is 1 if in collision.
+    TET_IkSolve=3, ///< an ik solver was called. name is the manipulator and value is the number of solutions.
+    TET_ConstraintFailure=4, ///< a configuration was rejected by a constraint. name is the reason, value is the failed \ref ConstraintFilterOptions, and the values are the configuration.
+};
+
+/** \brief Receives events from planners, collision checkers, and ik solvers for offline debugging.
+
+    TraceEvent is called from inside planning loops of any thread, so it has to be thread-safe and should only buffer the event.
+ */
+class OPENRAVE_API TraceHandlerBase
+{
+public:
+    virtual ~TraceHandlerBase() {
+    }
+
+    /// \param duration nanoseconds the traced operation took, 0 if not timed
+    /// \param pvalues optional values attached to the event, for example a configuration
+    virtual void TraceEvent(TraceEventType type, const std::string& name, int value, uint64_t duration, const dReal* pvalues=NULL, size_t numvalues=0) = 0;
+};
+
+typedef boost::shared_ptr<TraceHandlerBase> TraceHandlerBasePtr;
+
+/// \brief Sets the global trace handler, pass an empty pointer to stop tracing.
+OPENRAVE_API void RaveSetTraceHandler(TraceHandlerBasePtr handler);
+
+/// \brief Returns the global trace handler or an empty pointer if tracing is off. Reads the handler with boost::atomic_load, so it does not take a mutex.
+OPENRAVE_API TraceHandlerBasePtr RaveGetTraceHandler();
+
+/// \brief Accumulated timing of a profiling zone and the zones called inside it, see \ref RaveGetProfile
+class OPENRAVE_API ProfileNode
+{
+public:
+    ProfileNode() : numcalls(0), totaltime(0) {
+    }
+
+    /// \brief nanoseconds spent in the zone excluding its children
+    uint64_t GetSelfTime() const;
+
+    std::string name;
+    uint64_t numcalls;
+    uint64_t totaltime; ///< nanoseconds spent in the zone including its children
+    std::vector<ProfileNode> children;
+};
+
+/** \brief Times a scope and accumulates it into the call tree of the current thread, use through \ref OPENRAVE_PROFILE_ZONE.
+
+    Zones nest with the zones of the same environment that are active on the thread.
+ */
+class OPENRAVE_API ProfileZone
+{
+public:
+    /// \param penv environment the time is accounted to, if NULL nothing is recorded
+    /// \param name zone name, only the pointer is stored so it has to be a string literal
+    ProfileZone(const EnvironmentBase* penv, const char* name) : _pdata(NULL) {
+        if( !!penv ) {
+            _Enter(penv, name);
+        }
+    }
+    ~ProfileZone() {
+        if( !!_pdata ) {
+            _Exit();
+        }
+    }
+
+private:
+    void _Enter(const EnvironmentBase* penv, const char* name);
+    void _Exit();
+
+    void* _pdata;
+    int _node, _parentnode;
+    uint64_t _starttime;
+};
+
+/** \brief Enables recording of the profiling zones.
+
+    Zones are only compiled in when OpenRAVE was configured with OPT_PROFILING, otherwise this has no effect.
+    \param maxevents if > 0, every zone call is also recorded up to maxevents per thread for \ref RaveWriteProfileChromeTrace
+ */
+OPENRAVE_API void RaveSetProfiling(bool benable, size_t maxevents=0);
+
+/// \brief Returns true if profiling zones are being recorded. Does not lock.
+OPENRAVE_API bool RaveIsProfiling();
+
+/// \brief Merges the call trees of all threads for the environment. The root node holds the top-level zones as children.
+OPENRAVE_API void RaveGetProfile(EnvironmentBaseConstPtr penv, ProfileNode& root);
+
+/// \brief Resets the timing counters and recorded events of the environment
+OPENRAVE_API void RaveResetProfile(EnvironmentBaseConstPtr penv);
+
+/// \brief Releases the call trees and events of the environment, called when the environment is destroyed.
+OPENRAVE_API void RaveDestroyProfile(int environmentid);
+
+/// \brief Writes the recorded zone calls of the environment in the Chrome trace event JSON format (chrome://tracing).
+///
+/// If no calls were recorded (maxevents is 0), the merged call tree is written instead with the zones laid out one after another.
+OPENRAVE_API void RaveWriteProfileChromeTrace(EnvironmentBaseConstPtr penv, std::ostream& O);
+
+#if OPENRAVE_PROFILING
+#define OPENRAVE_PROFILE_ZONE_VAR2(line) __openraveprofilezone ## line
+#define OPENRAVE_PROFILE_ZONE_VAR(line) OPENRAVE_PROFILE_ZONE_VAR2(line)
+/// \brief Profiles the rest of the scope. penv is a raw environment pointer and is only evaluated when profiling is enabled.
+#define OPENRAVE_PROFILE_ZONE(penv, name) OpenRAVE::ProfileZone OPENRAVE_PROFILE_ZONE_VAR(__LINE__)(OpenRAVE::RaveIsProfiling() ? static_cast<const OpenRAVE::EnvironmentBase*>(penv) : NULL, name)
+#else
+#define OPENRAVE_PROFILE_ZONE(penv, name)
+#endif
+
 //@}
 
 /// \deprecated (11/06/03), use \ref SpaceSamplerBase
@@ -30,6 +30,39 @@ enum PhysicsEngineOptions
     PEO_SelfCollisions = 1, ///< if set, physics engine will use contact forces from self-collisions
 };
 
+/** \brief Describes a deterministic, fixed-step simulation of the physics engine and holds its results. See \ref PhysicsEngineBase::SimulateRollout
+
+    Bodies are referenced by name so that the same rollout can be run on any clone of the environment.
+ */
+class OPENRAVE_API PhysicsRollout
+{
+public:
+    PhysicsRollout() : fTimeStep(0.001), nSteps(0), nRecordStride(0) {
+    }
+    virtual ~PhysicsRollout() {
+    }
+
+    /// \brief torques added to the joints of a body at every step
+    struct BodyTorques
+    {
+        std::string bodyname;
+        std::vector<dReal> vtorques; ///< nSteps*body->GetDOF() values, the torques of step i start at i*body->GetDOF()
+    };
+
+    dReal fTimeStep; ///< the fixed time step passed to \ref PhysicsEngineBase::SimulateStep
+    int nSteps; ///< number of steps to simulate
+    int nRecordStride; ///< if > 0, records the link transformations every nRecordStride steps into vrecordedtransforms
+    std::vector<BodyTorques> vcontrols; ///< the control sequence
+
+    /// \name Results
+    //@{
+    std::vector<std::string> vbodynames; ///< the bodies of the environment in the order their links are stored
+    std::vector<Transform> vfinaltransforms; ///< the link transformations of all bodies after the last step
+    std::vector<std::pair<Vector,Vector> > vfinalvelocities; ///< the linear and angular link velocities of all bodies after the last step
+    std::vector< std::vector<Transform> > vrecordedtransforms; ///< the link transformations of all bodies at every recorded step
+    //@}
+};
+
 /** \brief <b>[interface]</b> The physics engine interfaces supporting simulations and dynamics. See \ref arch_physicsengine.
     \ingroup interfaces
  */
@@ -122,6 +155,15 @@ public:
     /// add torques to the joints of the body. Torques disappear after one timestep of simulation
     virtual void SimulateStep(dReal fTimeElapsed)=0;
 
+    /** \brief simulates a fixed number of steps with a control sequence and restores the state of the environment afterwards.
+
+        The simulation only calls \ref SimulateStep, so there is no sleeping, no controllers are stepped and nothing is published.
+        Starting from the same state, the results of a rollout are the same every time. Engines reset the state they keep between steps (sleeping bodies, cached contacts) before simulating.
+        The environment has to be locked.
+        \param[inout] rollout the steps to simulate, the results are written into it
+     */
+    virtual bool SimulateRollout(PhysicsRollout& rollout);
+
     /// \deprecated (10/11/18)
     virtual bool GetBodyVelocity(KinBodyConstPtr body, std::vector<Vector>& vLinearVelocities, std::vector<Vector>& vAngularVelocities) RAVE_DEPRECATED {
         std::vector<std::pair<Vector,Vector> > velocities;
@@ -159,6 +201,17 @@ private:
     }
 };
 
+/** \brief runs many physics rollouts of an environment in parallel. <b>[multi-thread safe]</b>
+
+    The environment is cloned once for every thread along with its physics engine, and each thread calls \ref PhysicsEngineBase::SimulateRollout on its clone. The state of penv is never changed.
+    Each rollout starts from the current state of penv, so the results do not depend on the number of threads.
+    \param penv the environment with the physics engine to simulate
+    \param[inout] vrollouts the rollouts, the results are written into them
+    \param nthreads the number of threads to use. If <= 1, the rollouts are simulated on a single clone by the calling thread
+    \return true if all rollouts succeeded
+ */
+OPENRAVE_API bool RaveSimulatePhysicsRollouts(EnvironmentBasePtr penv, std::vector<PhysicsRollout>& vrollouts, int nthreads);
+
 } // end namespace OpenRAVE
 
 #endif
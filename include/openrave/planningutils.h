@@ -434,6 +434,13 @@ public:
     /// \param bCallAfterCheckCollision if set, function will be called after check collision functions.
     virtual void SetUserCheckFunction(const boost::function<bool() >& usercheckfn, bool bCallAfterCheckCollision=false);
 
+    /// \brief if set, environment and self collisions of a segment are checked with CollisionCheckerBase::CheckContinuousCollision instead of stepping by _vConfigResolution.
+    ///
+    /// Only used when the configuration space holds the joint values of a single body. Segments fall back to stepping while the collision checkers do not support it.
+    /// With CFO_CheckWithPerturbation, the perturbed configurations are still checked for collisions at every step.
+    /// \param fmindistance the clearance below which the segment is reported as colliding
+    virtual void SetContinuousCollisionChecking(bool bcontinuous, dReal fmindistance=1e-4);
+
     /// \brief checks line collision. Uses the constructor's self-collisions
     virtual int Check(const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, IntervalType interval, int options = 0xffff, ConstraintFilterReturnPtr filterreturn = ConstraintFilterReturnPtr());
 
@@ -455,8 +462,19 @@ protected:
     virtual int _SetAndCheckState(PlannerBase::PlannerParametersConstPtr params, const std::vector<dReal>& vdofvalues, const std::vector<dReal>& vdofvelocities, const std::vector<dReal>& vdofaccels, int options, ConstraintFilterReturnPtr filterreturn);
     virtual void _PrintOnFailure(const std::string& prefix);
 
+    /// \brief reports the failed configuration to the trace handler if one is set, see \ref RaveSetTraceHandler
+    virtual void _TraceOnFailure(const char* reason, int failure);
+
+    /// \brief checks the env and self collisions of the segment continuously
+    ///
+    /// On a collision, filterreturn gets the configuration, velocities, and time of the first contact like the discretized checking.
+    /// \return the \ref ConstraintFilterOptions of the failure, 0 if free, or -1 if continuous checking could not be used
+    virtual int _CheckContinuousCollision(PlannerBase::PlannerParametersConstPtr params, const std::vector<dReal>& q0, const std::vector<dReal>& vdelta, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, int options, ConstraintFilterReturnPtr filterreturn);
+    virtual void _InitContinuousCollisionChecking(PlannerBase::PlannerParametersConstPtr params);
+
     PlannerBase::PlannerParametersWeakConstPtr _parameters;
     std::vector<dReal> _vtempconfig, _vtempvelconfig, dQ, _vtempveldelta, _vtempaccelconfig, _vperturbedvalues, _vcoeff2, _vcoeff1, _vprevtempconfig, _vprevtempvelconfig; ///< in configuration space
+    std::vector<dReal> _vtracevalues; ///< configuration reported by _TraceOnFailure
     CollisionReportPtr _report;
     std::list<KinBodyPtr> _listCheckBodies;
     int _filtermask;
@@ -470,6 +488,11 @@ protected:
     std::vector< int > _vdofindices;
     std::vector<dReal> _doftorques, _dofaccelerations; ///< in body DOF space
     boost::shared_ptr<ConfigurationSpecification::SetConfigurationStateFn> _setvelstatefn;
+
+    bool _bContinuousCollision; ///< if true, check segment collisions with CollisionCheckerBase::CheckContinuousCollision
+    dReal _fContinuousMinDistance;
+    std::vector<int> _vcontinuousdofindices, _vcontinuousconfigindices; ///< body dof index and configuration index of every planner dof, empty if the configuration cannot be checked continuously
+    std::vector<dReal> _vcontinuousq0, _vcontinuousq1, _vcontinuousdq0, _vcontinuousdq1; ///< in body DOF space
 };
 
 typedef boost::shared_ptr<DynamicsCollisionConstraint> DynamicsCollisionConstraintPtr;
@@ -944,6 +944,7 @@ private:
 
         Links that are joined together are ignored.
         Collisions between grabbed bodies are also considered as self-collisions for this body.
+        The robot specific checks are done in \ref _CheckSelfCollision, this only forwards to \ref KinBody::CheckSelfCollision.
         \param report [optional] collision report
      */
     virtual bool CheckSelfCollision(CollisionReportPtr report = CollisionReportPtr(), CollisionCheckerBasePtr collisionchecker=CollisionCheckerBasePtr()) const;
@@ -1019,6 +1020,16 @@ protected:
     /// This function in calls every registers calledback that is tracking the changes.
     virtual void _PostprocessChangedParameters(uint32_t parameters);
 
+    /// \brief adds the pairs between the grabbed bodies and the links they were not colliding with when grabbed
+    virtual void _ComputeSelfCollisionPlan(SelfCollisionPlan& plan) const;
+
+    /** \brief Check if body is self colliding with its links or its grabbed bodies.
+
+        Links that are joined together are ignored.
+        Collisions between grabbed bodies are also considered as self-collisions for this body.
+     */
+    virtual bool _CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const;
+
     std::vector<UserDataPtr> _vGrabbedBodies; ///< vector of grabbed bodies
     virtual void _UpdateGrabbedBodies();
     virtual void _UpdateAttachedSensors();
@@ -272,6 +272,9 @@ OPENRAVE_API std::string GetMD5HashString(const std::string& s);
 /// \brief compute the md5 hash of an array
 OPENRAVE_API std::string GetMD5HashString(const std::vector<uint8_t>& v);
 
+/// \brief writes the string as a quoted JSON string, escaping quotes, backslashes, and control characters
+OPENRAVE_API void WriteJSONString(std::ostream& O, const std::string& s);
+
 template<class T>
 inline T ClampOnRange(T value, T min, T max)
 {
@@ -244,6 +244,7 @@ If SetDesired is called, only joint values will be set at every timestep leaving
 
             _ptraj = RaveCreateTrajectory(GetEnv(),ptraj->GetXMLId());
             _ptraj->Clone(ptraj,0);
+            _sampleplan.Init(_samplespec,_ptraj->GetConfigurationSpecification(),GetEnv(),true);
             _bIsDone = false;
         }
 
@@ -258,8 +259,12 @@ If SetDesired is called, only joint values will be set at every timestep leaving
         boost::mutex::scoped_lock lock(_mutex);
         TrajectoryBaseConstPtr ptraj = _ptraj; // because of multi-threading setting issues
         if( !!ptraj ) {
-            vector<dReal> sampledata;
-            ptraj->Sample(sampledata,_fCommandTime,_samplespec);
+            // sample in the trajectory specification and convert with the plan built in SetPath
+            ptraj->Sample(_vtrajsample,_fCommandTime);
+            _sampleplan.UpdateDefaults();
+            _vsampledata.resize(_samplespec.GetDOF());
+            _sampleplan.Apply(_vsampledata.begin(),_vtrajsample.begin(),1);
+            const std::vector<dReal>& sampledata = _vsampledata;
 
             // already sampled, so change the command times before before setting values
             // incase the below functions fail
@@ -319,7 +324,8 @@ If SetDesired is called, only joint values will be set at every timestep leaving
                 }
             }
 
-            vector<dReal> vdofvalues;
+            std::vector<dReal>& vdofvalues = _vsampledofvalues;
+            vdofvalues.resize(0);
             if( _bTrajHasJoints && _dofindices.size() > 0 ) {
                 vdofvalues.resize(_dofindices.size());
                 _samplespec.ExtractJointValues(vdofvalues.begin(),sampledata.begin(), _probot, _dofindices, 0);
@@ -552,6 +558,8 @@ private:
     CollisionReportPtr _report;
     UserDataPtr _cblimits;
     ConfigurationSpecification _samplespec;
+    ConfigurationSpecification::ConversionPlan _sampleplan; ///< converts the data of _ptraj into _samplespec
+    std::vector<dReal> _vtrajsample, _vsampledata, _vsampledofvalues; ///< buffers of SimulationStep
     boost::shared_ptr<ConfigurationSpecification::Group> _gjointvalues, _gtransform;
     boost::mutex _mutex;
 };
@@ -146,6 +146,26 @@ public:
                     _physics->SetGravity(v);
                 }
             }
+            else if( name == "broadphase" ) {
+                _ss >> _physics->_broadphase_type;
+                std::transform(_physics->_broadphase_type.begin(), _physics->_broadphase_type.end(), _physics->_broadphase_type.begin(), ::tolower);
+                if( _physics->_broadphase_type != "dbvt" && _physics->_broadphase_type != "sap" ) {
+                    RAVELOG_WARN(str(boost::format("unknown broadphase %s, using dbvt\n")%_physics->_broadphase_type));
+                    _physics->_broadphase_type = "dbvt";
+                }
+            }
+            else if( name == "world_bounds" ) {
+                _ss >> _physics->_world_min.x >> _physics->_world_min.y >> _physics->_world_min.z >> _physics->_world_max.x >> _physics->_world_max.y >> _physics->_world_max.z;
+            }
+            else if( name == "fixed_timestep" ) {
+                _ss >> _physics->_fixed_timestep;
+            }
+            else if( name == "max_substeps" ) {
+                _ss >> _physics->_max_substeps;
+            }
+            else if( name == "contact_caching" ) {
+                _ss >> _physics->_contact_caching;
+            }
             else {
                 RAVELOG_ERROR("unknown field %s\n", name.c_str());
             }
@@ -168,9 +188,10 @@ public:
             }
         }
 
-        static const boost::array<string, 8>& GetTags() {
-        static const boost::array<string, 8> tags = {{"solver_iterations","margin_depth","linear_damping","rotation_damping",
-        "global_contact_force_mixing","global_friction","global_restitution","gravity" }};
+        static const boost::array<string, 13>& GetTags() {
+        static const boost::array<string, 13> tags = {{"solver_iterations","margin_depth","linear_damping","rotation_damping",
+        "global_contact_force_mixing","global_friction","global_restitution","gravity",
+        "broadphase","world_bounds","fixed_timestep","max_substeps","contact_caching" }};
             return tags;
         }
 
@@ -203,11 +224,22 @@ public:
         
         _super_damp = 0.3; 
         _super_damp2 = 0.9;
+
+        _broadphase_type = "dbvt";
+        _world_min = Vector(-10,-10,-10);
+        _world_max = Vector(10,10,10);
+        _fixed_timestep = 0.005;
+        _max_substeps = 0;
+        _contact_caching = false;
           
         FOREACHC(it, PhysicsPropertiesXMLReader::GetTags()) {
             ss << "**" << *it << "**, ";
         }
         ss << "\n\n";
+        ss << "**broadphase** is either dbvt (default, dynamic AABB trees) or sap (sweep and prune inside **world_bounds**, given as min and max corners). "
+           "If **max_substeps** is 0 (default), every step advances the world by **fixed_timestep**, otherwise the elapsed time is divided into at most max_substeps internal steps of fixed_timestep. "
+           "**contact_caching** keeps the contact impulses and friction directions of persistent manifolds between steps to warm start the solver.\n\n";
+        __description += ss.str();
          
 	
         /* relative links -->   http://bulletphysics.org/Bullet/BulletFull/btContactSolverInfo_8h_source.html
@@ -311,7 +343,13 @@ public:
          RAVELOG_VERBOSE("init bullet physics environment\n");
         _space->SetSynchronizationCallback(boost::bind(&BulletPhysicsEngine::_SyncCallback, shared_physics(),_1));
 
-        _broadphase.reset(new btDbvtBroadphase());
+        if( _broadphase_type == "sap" ) {
+            // incremental sweep and prune, faster than dbvt for many bodies inside known bounds
+            _broadphase.reset(new btAxisSweep3(btVector3(_world_min.x,_world_min.y,_world_min.z), btVector3(_world_max.x,_world_max.y,_world_max.z)));
+        }
+        else {
+            _broadphase.reset(new btDbvtBroadphase());
+        }
 
         // allowes configuration of collision detection
         _collisionConfiguration.reset(new btDefaultCollisionConfiguration());
@@ -341,6 +379,10 @@ public:
         //solverInfo. m_splitImpulsePenetrationThreshold = 0.5;
         
         solverInfo.m_solverMode |= SOLVER_SIMD | SOLVER_DISABLE_VELOCITY_DEPENDENT_FRICTION_DIRECTION |SOLVER_USE_2_FRICTION_DIRECTIONS; //SOLVER_ENABLE_FRICTION_DIRECTION_CACHING ;
+        if( _contact_caching ) {
+            // warm start from the impulses stored in the persistent manifolds
+            solverInfo.m_solverMode |= SOLVER_USE_WARMSTARTING | SOLVER_ENABLE_FRICTION_DIRECTION_CACHING;
+        }
         
 	//solverInfo.m_solverMode |=    SOLVER_FRICTION_SEPARATE  |SOLVER_USE_2_FRICTION_DIRECTIONS;
 	
@@ -464,6 +506,30 @@ public:
         return false;
     }
 
+    virtual void Clone(InterfaceBaseConstPtr preference, int cloningoptions)
+    {
+        PhysicsEngineBase::Clone(preference,cloningoptions);
+        boost::shared_ptr<BulletPhysicsEngine const> r = boost::dynamic_pointer_cast<BulletPhysicsEngine const>(preference);
+        // the world is created in InitEnvironment, so the parameters only have to be copied
+        _options = r->_options;
+        _global_friction = r->_global_friction;
+        _solver_iterations = r->_solver_iterations;
+        _margin_depth = r->_margin_depth;
+        _linear_damping = r->_linear_damping;
+        _rotation_damping = r->_rotation_damping;
+        _global_contact_force_mixing = r->_global_contact_force_mixing;
+        _global_restitution = r->_global_restitution;
+        _super_damp = r->_super_damp;
+        _super_damp2 = r->_super_damp2;
+        _broadphase_type = r->_broadphase_type;
+        _world_min = r->_world_min;
+        _world_max = r->_world_max;
+        _fixed_timestep = r->_fixed_timestep;
+        _max_substeps = r->_max_substeps;
+        _contact_caching = r->_contact_caching;
+        SetGravity(r->_gravity);
+    }
+
     virtual bool SetLinkVelocity(KinBody::LinkPtr plink, const Vector& linearvel, const Vector& angularvel)
     {
         BulletSpace::KinBodyInfoPtr pinfo = GetPhysicsInfo(plink->GetParent());
@@ -660,23 +726,63 @@ public:
         return _gravity;
     }
 
+    virtual bool SimulateRollout(PhysicsRollout& rollout)
+    {
+        // bullet caches the contact manifolds and the deactivation timers between steps, so clear them to start each rollout from the same state
+        _space->Synchronize();
+        _solver->reset();
+        GetEnv()->GetBodies(_vbodies);
+        FOREACHC(itbody, _vbodies) {
+            BulletSpace::KinBodyInfoPtr pinfo = GetPhysicsInfo(*itbody);
+            FOREACHC(itlink, pinfo->vlinks) {
+                btBroadphaseProxy* proxy = (*itlink)->obj->getBroadphaseHandle();
+                if( !!proxy ) {
+                    _broadphase->getOverlappingPairCache()->cleanProxyFromPairs(proxy, _dispatcher.get());
+                }
+                if( !(*itlink)->plink->IsStatic() && !!(*itlink)->_rigidbody ) {
+                    (*itlink)->_rigidbody->forceActivationState(ACTIVE_TAG);
+                    (*itlink)->_rigidbody->setDeactivationTime(0);
+                }
+            }
+        }
+        _vbodies.resize(0);
+        return PhysicsEngineBase::SimulateRollout(rollout);
+    }
+
     virtual void SimulateStep(dReal fTimeElapsed)
     {
         _space->Synchronize();
-        int maxSubSteps = 0;  // --> reduced sub steps
         //_dynamicsWorld->applyGravity();
-        _dynamicsWorld->stepSimulation(0.005,maxSubSteps); //-> reduced elapse time
+        if( _max_substeps > 0 ) {
+            _dynamicsWorld->stepSimulation(fTimeElapsed,_max_substeps,_fixed_timestep);
+        }
+        else {
+            _dynamicsWorld->stepSimulation(_fixed_timestep,0); //-> reduced elapse time
+        }
 
-        vector<KinBodyPtr> vbodies;
-        GetEnv()->GetBodies(vbodies);
-        FOREACHC(itbody, vbodies) {
+        // write back all links of all bodies in one pass, bodies that bullet put to sleep did not move
+        GetEnv()->GetBodies(_vbodies);
+        FOREACHC(itbody, _vbodies) {
             BulletSpace::KinBodyInfoPtr pinfo = GetPhysicsInfo(*itbody);
-            FOREACH(itlink, pinfo->vlinks) {
-                Transform t = BulletSpace::GetTransform((*itlink)->_rigidbody->getCenterOfMassTransform());
-                (*itlink)->plink->SetTransform(t*(*itlink)->tlocal.inverse());
+            bool bActive = false;
+            FOREACHC(itlink, pinfo->vlinks) {
+                if( !(*itlink)->plink->IsStatic() && (*itlink)->_rigidbody->isActive() ) {
+                    bActive = true;
+                    break;
+                }
+            }
+            if( bActive ) {
+                _vtranscache.resize(pinfo->vlinks.size());
+                for(size_t i = 0; i < pinfo->vlinks.size(); ++i) {
+                    const BulletSpace::KinBodyInfo::LINK& link = *pinfo->vlinks[i];
+                    _vtranscache[i] = BulletSpace::GetTransform(link._rigidbody->getCenterOfMassTransform())*link.tlocal.inverse();
+                }
+                (*itbody)->SetLinkTransformations(_vtranscache);
             }
             pinfo->nLastStamp = (*itbody)->GetUpdateStamp();
         }
+        // do not hold on to the bodies in case they are removed from the environment
+        _vbodies.resize(0);
         //_dynamicsWorld->clearForces();
     }
 
@@ -691,6 +797,11 @@ public:
     btScalar _global_restitution;
     btScalar _super_damp;
     btScalar _super_damp2;
+    std::string _broadphase_type; ///< dbvt or sap
+    Vector _world_min, _world_max; ///< bounds of the sap broadphase
+    btScalar _fixed_timestep;
+    int _max_substeps;
+    bool _contact_caching;
 
 private:
     static BulletSpace::KinBodyInfoPtr GetPhysicsInfo(KinBodyConstPtr pbody)
@@ -720,6 +831,9 @@ private:
 
     std::list<EnvironmentBase::CollisionCallbackFn> _listcallbacks;
     CollisionReportPtr _report;
+
+    std::vector<KinBodyPtr> _vbodies; ///< cache
+    std::vector<Transform> _vtranscache; ///< cache
 };
 
 
@@ -26,10 +26,10 @@ public:
                         "set up the cache to track a body state. [bodyname affinedofs]");
         RegisterCommand("GetTrackedRobot",boost::bind(&CacheCollisionChecker::_GetTrackedRobotCommand,this,_1,_2),
                         "get the robot being tracked by the collisionchecker");
-        RegisterCommand("GetCacheStatistics",boost::bind(&CacheCollisionChecker::_GetCacheStatisticsCommand,this,_1,_2),
-                        "get the cache statistics: cachecollisions, cachehits");
-        RegisterCommand("GetSelfCacheStatistics",boost::bind(&CacheCollisionChecker::_GetSelfCacheStatisticsCommand,this,_1,_2),
-                        "get the self collision cache statistics: selfcachecollisions, selfcachehits");
+        RegisterStructuredCommand("GetCacheStatistics",boost::bind(&CacheCollisionChecker::_GetCacheStatisticsCommand,this,_1,_2), std::vector<CommandArgument>(),
+                                  "get the cache statistics: cachecollisions, cachehits");
+        RegisterStructuredCommand("GetSelfCacheStatistics",boost::bind(&CacheCollisionChecker::_GetSelfCacheStatisticsCommand,this,_1,_2), std::vector<CommandArgument>(),
+                                  "get the self collision cache statistics: selfcachecollisions, selfcachehits");
         RegisterCommand("SetSelfCacheParameters",boost::bind(&CacheCollisionChecker::_SetSelfCacheParametersCommand,this,_1,_2),
                         "set the self collision cache parameters: collisionthreshold, freespacethreshold, insertiondistancemultiplier, base");
         RegisterCommand("SetCacheParameters",boost::bind(&CacheCollisionChecker::_SetCacheParametersCommand,this,_1,_2),
@@ -435,9 +435,12 @@ protected:
         return true;
     }
 
-    virtual bool _GetCacheStatisticsCommand(std::ostream& sout, std::istream& sinput)
+    virtual bool _GetCacheStatisticsCommand(const std::vector<CommandValue>& vargs, std::vector<CommandValue>& vresults)
     {
-        sout << _cachedcollisionchecks << " " << _cachedcollisionhits << " " << _cachedfreehits << " " << _cache->GetNumKnownNodes();
+        vresults.push_back(CommandValue(_cachedcollisionchecks));
+        vresults.push_back(CommandValue(_cachedcollisionhits));
+        vresults.push_back(CommandValue(_cachedfreehits));
+        vresults.push_back(CommandValue(_cache->GetNumKnownNodes()));
 
         _cachedcollisionchecks=0;
         _cachedcollisionhits=0;
@@ -445,9 +448,12 @@ protected:
         return true;
     }
 
-    virtual bool _GetSelfCacheStatisticsCommand(std::ostream& sout, std::istream& sinput)
+    virtual bool _GetSelfCacheStatisticsCommand(const std::vector<CommandValue>& vargs, std::vector<CommandValue>& vresults)
     {
-        sout << _selfcachedcollisionchecks << " " << _selfcachedcollisionhits << " " << _selfcachedfreehits << " " << _selfcache->GetNumKnownNodes();
+        vresults.push_back(CommandValue(_selfcachedcollisionchecks));
+        vresults.push_back(CommandValue(_selfcachedcollisionhits));
+        vresults.push_back(CommandValue(_selfcachedfreehits));
+        vresults.push_back(CommandValue(_selfcache->GetNumKnownNodes()));
 
         _selfcachedcollisionchecks=0;
         _selfcachedcollisionhits=0;
@@ -65,6 +65,84 @@ private:
 
     typedef boost::shared_ptr<CollisionCallbackData> CollisionCallbackDataPtr;
 
+    /// \brief data of a CO_Distance query, only run when the objects are not colliding
+    class DistanceCallbackData
+    {
+    public:
+        DistanceCallbackData(boost::shared_ptr<FCLCollisionChecker> pchecker, CollisionReportPtr report) : _pchecker(pchecker), _report(report), bselfCollision(false)
+        {
+            // pairs farther away than the threshold are pruned by the broadphase and never computed exactly
+            _fMinDistance = pchecker->GetDistanceThreshold();
+            _request.enable_nearest_points = false;
+            if( !!_report && _fMinDistance < _report->minDistance ) {
+                // if nothing is within the threshold, the bodies are at least that far apart. plink1 and plink2 stay empty
+                _report->minDistance = _fMinDistance;
+            }
+        }
+
+        boost::shared_ptr<FCLCollisionChecker> _pchecker;
+        fcl::DistanceRequest _request;
+        fcl::DistanceResult _result;
+        CollisionReportPtr _report;
+        fcl::FCL_REAL _fMinDistance; ///< the minimum distance found so far
+        bool bselfCollision; ///< true if currently checking for self collision.
+    };
+
+    /// \brief data of a ray query. The ray segment is represented in the broadphase by its axis-aligned box, candidate links are then intersected exactly with their collision meshes
+    class RayCallbackData
+    {
+    public:
+        RayCallbackData(boost::shared_ptr<FCLCollisionChecker> pchecker, const RAY& ray, CollisionReportPtr report) : _pchecker(pchecker), _ray(ray), _report(report), _bAnyHit(!!(pchecker->GetCollisionOptions() & OpenRAVE::CO_RayAnyHit)), _bStopChecking(false), _bCollision(false)
+        {
+            _fMaxDist = OpenRAVE::RaveSqrt(ray.dir.lengthsqr3());
+            if( OpenRAVE::RaveFabs(_fMaxDist-1) < 1e-4 ) {
+                RAVELOG_DEBUG("CheckCollision: ray direction length is 1.0, note that only collisions within a distance of 1.0 will be checked\n");
+            }
+            _vnormdir = _fMaxDist > 0 ? ray.dir*(1/_fMaxDist) : Vector(0,0,1);
+            _fHitDist = _fMaxDist;
+
+            Vector vend = ray.pos + ray.dir;
+            Vector vextents(OpenRAVE::RaveFabs(ray.dir.x), OpenRAVE::RaveFabs(ray.dir.y), OpenRAVE::RaveFabs(ray.dir.z));
+            // fcl does not accept degenerate boxes
+            const dReal fpad = 1e-6;
+            _pgeom = std::make_shared<fcl::Box>(vextents.x+fpad, vextents.y+fpad, vextents.z+fpad);
+            _pobject = boost::make_shared<fcl::CollisionObject>(_pgeom, fcl::Transform3f(fcl::Vec3f(0.5*(ray.pos.x+vend.x), 0.5*(ray.pos.y+vend.y), 0.5*(ray.pos.z+vend.z))));
+            _pobject->computeAABB();
+
+            // thin box along the ray that is collided with the mesh BVHs to find the triangles to intersect
+            // it only selects candidates, so it is thick enough for fcl to never miss a crossed triangle
+            const dReal fsegmentthickness = 1e-3;
+            _psegmentgeom = std::make_shared<fcl::Box>(fsegmentthickness, fsegmentthickness, _fMaxDist+fsegmentthickness);
+            Vector vsegmentrot = quatRotateDirection(Vector(0,0,1), _vnormdir);
+            _psegmentobject = boost::make_shared<fcl::CollisionObject>(_psegmentgeom, fcl::Transform3f(ConvertQuaternionToFCL(vsegmentrot), ConvertVectorToFCL(ray.pos + _vnormdir*(0.5*_fMaxDist))));
+            _triangleRequest.num_max_contacts = std::numeric_limits<int>::max();
+
+            if( !_report && pchecker->GetEnv()->HasRegisteredCollisionCallbacks() ) {
+                _report.reset(new CollisionReport());
+            }
+            if( !!_report ) {
+                _report->Reset(pchecker->GetCollisionOptions());
+            }
+        }
+
+        boost::shared_ptr<FCLCollisionChecker> _pchecker;
+        RAY _ray;
+        CollisionReportPtr _report;
+        Vector _vnormdir; ///< normalized ray direction
+        dReal _fMaxDist; ///< length of the ray
+        dReal _fHitDist; ///< distance of the closest hit found so far
+        CollisionGeometryPtr _pgeom;
+        CollisionObjectPtr _pobject; ///< box bounding the ray segment, used to query the broadphase
+        CollisionGeometryPtr _psegmentgeom;
+        CollisionObjectPtr _psegmentobject; ///< thin box along the ray segment, used to find the triangles of meshes it crosses
+        fcl::CollisionRequest _triangleRequest;
+        fcl::CollisionResult _triangleresult; ///< cache
+        std::vector<LinkConstPtr> _vcandidatelinks; ///< links whose bounding volumes overlap the ray
+        bool _bAnyHit; ///< if true, stop at the first hit rather than searching for the closest one
+        bool _bStopChecking; ///< if true, then stop the checking loop
+        bool _bCollision; ///< result of the query
+    };
+
 
     /// \brief Wraps a temporary broadphase manager to prepare for a collision against environment. Unregister objects from the broadphase manager corresponding to all the objects in the environment as needed and restore them upon destruction
     class TemporaryManagerAgainstEnv {
@@ -126,6 +204,13 @@ public:
             envManager->collide(_manager.get(), &query, &FCLCollisionChecker::CheckNarrowPhaseCollision);
         }
 
+        void Distance(DistanceCallbackData& query) {
+            BroadPhaseCollisionManagerPtr envManager = _pfclspace->GetEnvManager();
+            _manager->setup();
+            envManager->setup();
+            envManager->distance(_manager.get(), &query, &FCLCollisionChecker::CheckNarrowPhaseDistance);
+        }
+
         BroadPhaseCollisionManagerPtr GetManager() {
             return _manager;
         }
@@ -169,6 +254,12 @@ public:
             _manager1->collide(_manager2.get(), &query, &FCLCollisionChecker::CheckNarrowPhaseCollision);
         }
 
+        void Distance(DistanceCallbackData& query) {
+            _manager1->setup();
+            _manager2->setup();
+            _manager1->distance(_manager2.get(), &query, &FCLCollisionChecker::CheckNarrowPhaseDistance);
+        }
+
         BroadPhaseCollisionManagerPtr GetManager(bool firstManager) {
             return (firstManager ? _manager1 : _manager2);
         }
@@ -188,12 +279,14 @@ private:
         _fclspace.reset(new FCLSpace(penv, _userdatakey));
         _options = 0;
         _numMaxContacts = std::numeric_limits<int>::max(); // TODO
+        _fDistanceThreshold = 1e20;
         __description = ":Interface Author: Kenji Maillard\n\nFlexible Collision Library collision checker";
 
         RegisterCommand("SetBroadphaseAlgorithm", boost::bind(&FCLCollisionChecker::_SetBroadphaseAlgorithm, this, _1, _2), "sets the broadphase algorithm (Naive, SaP, SSaP, IntervalTree, DynamicAABBTree, DynamicAABBTree_Array)");
 
         RegisterCommand("SetBVHRepresentation", boost::bind(&FCLCollisionChecker::_SetBVHRepresentation, this, _1, _2), "sets the Bouding Volume Hierarchy representation for meshes (AABB, OBB, OBBRSS, RSS, kIDS)");
         // TODO : check that the coordinate are in the right order
+        RegisterCommand("SetDistanceThreshold", boost::bind(&FCLCollisionChecker::_SetDistanceThresholdCommand, this, _1, _2), "sets the distance above which CO_Distance queries stop computing exact distances. If nothing is closer, CollisionReport::minDistance is set to the threshold and plink1/plink2 are left empty");
         RegisterCommand("SetSpatialHashingBroadPhaseAlgorithm", boost::bind(&FCLCollisionChecker::SetSpatialHashingBroadPhaseAlgorithm, this, _1, _2), "sets the broadphase algorithm to spatial hashing with (cell size) (scene min x) (scene min y) (scene min z) (scene max x) (scene max y) (scene max z)");
         RAVELOG_VERBOSE_FORMAT("FCLCollisionChecker %s created in env %d", _userdatakey%penv->GetId());
 
@@ -233,6 +326,7 @@ private:
         // don't need to clone _bIsSelfCollisionChecker?
         _options = r->_options;
         _numMaxContacts = r->_numMaxContacts;
+        _fDistanceThreshold = r->_fDistanceThreshold;
         RAVELOG_VERBOSE(str(boost::format("FCL User data cloning env %d into env %d") % r->GetEnv()->GetId() % GetEnv()->GetId()));
     }
 
@@ -248,6 +342,27 @@ private:
         _numMaxContacts = numMaxContacts;
     }
 
+    dReal GetDistanceThreshold() const {
+        return _fDistanceThreshold;
+    }
+
+    void SetDistanceThreshold(dReal threshold) {
+        _fDistanceThreshold = threshold;
+    }
+
+    /// Sets the distance threshold for CO_Distance queries
+    /// e.g. "SetDistanceThreshold 0.05"
+    bool _SetDistanceThresholdCommand(ostream& sout, istream& sinput)
+    {
+        dReal threshold = 0;
+        sinput >> threshold;
+        if( !sinput ) {
+            return false;
+        }
+        SetDistanceThreshold(threshold);
+        return true;
+    }
+
     void SetGeometryGroup(const std::string& groupname)
     {
         _fclspace->SetGeometryGroup(groupname);
@@ -263,11 +378,6 @@ private:
     {
         _options = collision_options;
 
-        // TODO : remove when distance is implemented
-        if( _options & OpenRAVE::CO_Distance ) {
-            return false;
-        }
-
         if( _options & OpenRAVE::CO_RayAnyHit ) {
             return false;
         }
@@ -392,14 +502,13 @@ private:
         FillTemporaryManagerWithBody(pbody1, tmpManagerBody1Body2, !!(_options & OpenRAVE::CO_ActiveDOFs), true);
         FillTemporaryManagerWithBody(pbody2, tmpManagerBody1Body2, !!(_options & OpenRAVE::CO_ActiveDOFs), false);
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            RAVELOG_WARN("fcl doesn't support CO_Distance yet\n");
-            return false; //TODO
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            tmpManagerBody1Body2.Collide(query);
-            return query._bCollision;
+        CollisionCallbackData query(shared_checker(), report);
+        tmpManagerBody1Body2.Collide(query);
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            tmpManagerBody1Body2.Distance(distquery);
         }
+        return query._bCollision;
     }
 
     virtual bool CheckCollision(LinkConstPtr plink,CollisionReportPtr report = CollisionReportPtr())
@@ -424,14 +533,14 @@ private:
 
         CollisionObjectPtr pcollLink1 = _fclspace->GetLinkBV(plink1), pcollLink2 = _fclspace->GetLinkBV(plink2);
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            RAVELOG_WARN("fcl doesn't support CO_Distance yet\n");
-            return false; // TODO
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            CheckNarrowPhaseCollision(pcollLink1.get(), pcollLink2.get(), &query);
-            return query._bCollision;
+        CollisionCallbackData query(shared_checker(), report);
+        CheckNarrowPhaseCollision(pcollLink1.get(), pcollLink2.get(), &query);
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            fcl::FCL_REAL dist = distquery._fMinDistance;
+            CheckNarrowPhaseDistance(pcollLink1.get(), pcollLink2.get(), &distquery, dist);
         }
+        return query._bCollision;
     }
 
     virtual bool CheckCollision(LinkConstPtr plink, KinBodyConstPtr pbody,CollisionReportPtr report = CollisionReportPtr())
@@ -469,14 +578,13 @@ private:
         }
         tmpManagerBodyLink.Register(plink, false);
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            RAVELOG_WARN("fcl doesn't support CO_Distance yet\n");
-            return false; // TODO
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            tmpManagerBodyLink.Collide(query);
-            return query._bCollision;
+        CollisionCallbackData query(shared_checker(), report);
+        tmpManagerBodyLink.Collide(query);
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            tmpManagerBodyLink.Distance(distquery);
         }
+        return query._bCollision;
     }
 
     virtual bool CheckCollision(LinkConstPtr plink, std::vector<KinBodyConstPtr> const &vbodyexcluded, std::vector<LinkConstPtr> const &vlinkexcluded, CollisionReportPtr report = CollisionReportPtr())
@@ -526,13 +634,13 @@ private:
         }
 
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            return false;
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            tmpManagerLinkAgainstEnv.Collide(query);
-            return query._bCollision;
+        CollisionCallbackData query(shared_checker(), report);
+        tmpManagerLinkAgainstEnv.Collide(query);
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            tmpManagerLinkAgainstEnv.Distance(distquery);
         }
+        return query._bCollision;
     }
 
     virtual bool CheckCollision(KinBodyConstPtr pbody, std::vector<KinBodyConstPtr> const &vbodyexcluded, std::vector<LinkConstPtr> const &vlinkexcluded, CollisionReportPtr report = CollisionReportPtr())
@@ -552,32 +660,77 @@ private:
         FillTemporaryManagerAgainstEnvWithBody(pbody, tmpManagerBodyAgainstEnv, !!(_options & OpenRAVE::CO_ActiveDOFs), vbodyexcluded, vlinkexcluded);
 
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            RAVELOG_WARN("fcl doesn't support CO_Distance yet\n");
-            return false; // TODO
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            tmpManagerBodyAgainstEnv.Collide(query);
-            return query._bCollision;
+        CollisionCallbackData query(shared_checker(), report);
+        tmpManagerBodyAgainstEnv.Collide(query);
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            tmpManagerBodyAgainstEnv.Distance(distquery);
         }
+        return query._bCollision;
     }
 
     virtual bool CheckCollision(RAY const &ray, LinkConstPtr plink,CollisionReportPtr report = CollisionReportPtr())
     {
-        RAVELOG_WARN("fcl doesn't support Ray collisions\n");
-        return false; //TODO
+        if( !plink->IsEnabled() ) {
+            RAVELOG_VERBOSE(str(boost::format("calling collision on disabled link %s")%plink->GetName()));
+            return false;
+        }
+
+        _fclspace->Synchronize(plink->GetParent());
+
+        RayCallbackData query(shared_checker(), ray, report);
+        CollisionObjectPtr pcollLink = _fclspace->GetLinkBV(plink);
+        if( !pcollLink || !_RayIntersectsAABB(query, pcollLink->getAABB()) ) {
+            return false;
+        }
+        _CheckRayLink(plink, query);
+        return _FinishRayQuery(query);
     }
 
     virtual bool CheckCollision(RAY const &ray, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr())
     {
-        RAVELOG_WARN("fcl doesn't support Ray collisions\n");
-        return false; //TODO
+        _fclspace->Synchronize(pbody);
+        return _CheckRay(ray, _fclspace->GetKinBodyManager(pbody), report);
     }
 
     virtual bool CheckCollision(RAY const &ray, CollisionReportPtr report = CollisionReportPtr())
     {
-        RAVELOG_WARN("fcl doesn't support Ray collisions\n");
-        return false; //TODO
+        _fclspace->Synchronize();
+        return _CheckRay(ray, _fclspace->GetEnvManager(), report);
+    }
+
+    virtual int CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly=false)
+    {
+        // synchronize once for the whole batch
+        BroadPhaseCollisionManagerPtr manager;
+        if( !!pbody ) {
+            _fclspace->Synchronize(pbody);
+            manager = _fclspace->GetKinBodyManager(pbody);
+        }
+        else {
+            _fclspace->Synchronize();
+            manager = _fclspace->GetEnvManager();
+        }
+
+        CollisionReportPtr report(new CollisionReport());
+        RAY r;
+        int nhits = 0;
+        for(int i = 0; i < nrays; ++i, prays += 6, phits += 6) {
+            r.pos = Vector(prays[0], prays[1], prays[2]);
+            r.dir = Vector(prays[3], prays[4], prays[5]);
+            pcollision[i] = 0;
+            std::fill(phits, phits+6, dReal(0));
+            if( _CheckRay(r, manager, report) && report->contacts.size() > 0 ) {
+                const CollisionReport::CONTACT& c = report->contacts[0];
+                if( !bFrontFacingOnly || c.norm.dot3(r.dir) < 0 ) {
+                    pcollision[i] = 1;
+                    phits[0] = c.pos.x; phits[1] = c.pos.y; phits[2] = c.pos.z;
+                    phits[3] = c.norm.x; phits[4] = c.norm.y; phits[5] = c.norm.z;
+                    ++nhits;
+                }
+            }
+        }
+        return nhits;
     }
 
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr())
@@ -601,36 +754,45 @@ private:
 
         std::vector< CollisionGroup > vlinkCollisionGroups(pbody->GetLinks().size());
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            RAVELOG_WARN("fcl doesn't support CO_Distance yet\n");
-            return false; // TODO
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            query.bselfCollision = true;
+        CollisionCallbackData query(shared_checker(), report);
+        query.bselfCollision = true;
 
-            FOREACH(itset, nonadjacent) {
-                size_t index1 = *itset&0xffff, index2 = *itset>>16;
-                LinkConstPtr plink1(pbody->GetLinks().at(index1)), plink2(pbody->GetLinks().at(index2));
-                BOOST_ASSERT( plink1->IsEnabled() && plink2->IsEnabled() ); // should only get enabled links since got adjancency information with AO_Enabled
-                if( vlinkCollisionGroups.at(index1).empty() ) {
-                    _fclspace->GetLinkManager(pbody, index1)->getObjects(vlinkCollisionGroups[index1]);
-                }
-                if( vlinkCollisionGroups.at(index2).empty() ) {
-                    _fclspace->GetLinkManager(pbody, index2)->getObjects(vlinkCollisionGroups[index2]);
+        FOREACH(itset, nonadjacent) {
+            size_t index1 = *itset&0xffff, index2 = *itset>>16;
+            LinkConstPtr plink1(pbody->GetLinks().at(index1)), plink2(pbody->GetLinks().at(index2));
+            BOOST_ASSERT( plink1->IsEnabled() && plink2->IsEnabled() ); // should only get enabled links since got adjancency information with AO_Enabled
+            if( vlinkCollisionGroups.at(index1).empty() ) {
+                _fclspace->GetLinkManager(pbody, index1)->getObjects(vlinkCollisionGroups[index1]);
+            }
+            if( vlinkCollisionGroups.at(index2).empty() ) {
+                _fclspace->GetLinkManager(pbody, index2)->getObjects(vlinkCollisionGroups[index2]);
+            }
+
+            FOREACH(ito1, vlinkCollisionGroups[index1]) {
+                FOREACH(ito2, vlinkCollisionGroups[index2]) {
+                    // TODO : consider using the link BV
+                    CheckNarrowPhaseGeomCollision(*ito1, *ito2, &query);
+                    if( query._bStopChecking ) {
+                        return query._bCollision;
+                    }
                 }
+            }
+        }
 
-                FOREACH(ito1, vlinkCollisionGroups[index1]) {
-                    FOREACH(ito2, vlinkCollisionGroups[index2]) {
-                        // TODO : consider using the link BV
-                        CheckNarrowPhaseGeomCollision(*ito1, *ito2, &query);
-                        if( query._bStopChecking ) {
-                            return query._bCollision;
-                        }
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            distquery.bselfCollision = true;
+            fcl::FCL_REAL dist = distquery._fMinDistance;
+            FOREACH(itset, nonadjacent) {
+                size_t index1 = *itset&0xffff, index2 = *itset>>16;
+                FOREACH(ito1, vlinkCollisionGroups.at(index1)) {
+                    FOREACH(ito2, vlinkCollisionGroups.at(index2)) {
+                        CheckNarrowPhaseGeomDistance(*ito1, *ito2, &distquery, dist);
                     }
                 }
             }
-            return query._bCollision;
         }
+        return query._bCollision;
     }
 
     virtual bool CheckStandaloneSelfCollision(LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr())
@@ -666,16 +828,16 @@ private:
         linkManager->setup();
         bodyManager->setup();
 
-        if( _options & OpenRAVE::CO_Distance ) {
-            RAVELOG_WARN("fcl doesn't support CO_Distance yet\n");
-            return false; //TODO
-        } else {
-            CollisionCallbackData query(shared_checker(), report);
-            query.bselfCollision = true;
-            // TODO : consider using the link BV
-            linkManager->collide(bodyManager.get(), &query, &CheckNarrowPhaseGeomCollision);
-            return query._bCollision;
+        CollisionCallbackData query(shared_checker(), report);
+        query.bselfCollision = true;
+        // TODO : consider using the link BV
+        linkManager->collide(bodyManager.get(), &query, &CheckNarrowPhaseGeomCollision);
+        if( (_options & OpenRAVE::CO_Distance) && !!report && !query._bCollision ) {
+            DistanceCallbackData distquery(shared_checker(), report);
+            distquery.bselfCollision = true;
+            linkManager->distance(bodyManager.get(), &distquery, &CheckNarrowPhaseGeomDistance);
         }
+        return query._bCollision;
     }
 
 private:
@@ -985,12 +1147,383 @@ private:
         return false; // keep checking collision
     }
 
-    static bool CheckNarrowPhaseDistance(fcl::CollisionObject *o1, fcl::CollisionObject *o2, void *data)
+    static bool CheckNarrowPhaseDistance(fcl::CollisionObject *o1, fcl::CollisionObject *o2, void *data, fcl::FCL_REAL& dist) {
+        DistanceCallbackData* pcb = static_cast<DistanceCallbackData *>(data);
+        return pcb->_pchecker->CheckNarrowPhaseDistance(o1, o2, pcb, dist);
+    }
+
+    bool CheckNarrowPhaseDistance(fcl::CollisionObject *o1, fcl::CollisionObject *o2, DistanceCallbackData* pcb, fcl::FCL_REAL& dist)
+    {
+        LinkConstPtr plink1 = GetCollisionLink(*o1), plink2 = GetCollisionLink(*o2);
+
+        if( !plink1 || !plink2 ) {
+            return false;
+        }
+
+        if( !plink1->IsEnabled() || !plink2->IsEnabled() ) {
+            return false;
+        }
+
+        if( !pcb->bselfCollision && plink1->GetParent()->IsAttached(KinBodyConstPtr(plink2->GetParent())) ) {
+            return false;
+        }
+
+        if( _fclspace->HasMultipleGeometries(plink1) ) {
+            if( _fclspace->HasMultipleGeometries(plink2) ) {
+                BroadPhaseCollisionManagerPtr plink1Manager = _fclspace->GetLinkManager(plink1), plink2Manager = _fclspace->GetLinkManager(plink2);
+                plink1Manager->setup();
+                plink2Manager->setup();
+                plink1Manager->distance(plink2Manager.get(), pcb, &FCLCollisionChecker::CheckNarrowPhaseGeomDistance);
+            } else {
+                BroadPhaseCollisionManagerPtr plink1Manager = _fclspace->GetLinkManager(plink1);
+                plink1Manager->setup();
+                plink1Manager->distance(o2, pcb, &FCLCollisionChecker::CheckNarrowPhaseGeomDistance);
+            }
+        } else {
+            if( _fclspace->HasMultipleGeometries(plink2) ) {
+                BroadPhaseCollisionManagerPtr plink2Manager = _fclspace->GetLinkManager(plink2);
+                plink2Manager->setup();
+                plink2Manager->distance(o1, pcb, &FCLCollisionChecker::CheckNarrowPhaseGeomDistance);
+            } else {
+                CheckNarrowPhaseGeomDistance(o1, o2, pcb, dist);
+            }
+        }
+
+        // tell the broadphase to prune everything farther away than the closest pair found so far
+        dist = pcb->_fMinDistance;
+        return dist <= 0;
+    }
+
+    /// \brief broadphase callback of a ray query, only collects the links whose bounding volume is pierced by the ray
+    static bool CheckRayCandidate(fcl::CollisionObject *o1, fcl::CollisionObject *o2, void *data) {
+        RayCallbackData* pcb = static_cast<RayCallbackData *>(data);
+        return pcb->_pchecker->CheckRayCandidate(o1, o2, pcb);
+    }
+
+    bool CheckRayCandidate(fcl::CollisionObject *o1, fcl::CollisionObject *o2, RayCallbackData* pcb)
     {
-        // TODO
+        fcl::CollisionObject* pcoll = o1 == pcb->_pobject.get() ? o2 : o1;
+        LinkConstPtr plink = GetCollisionLink(*pcoll);
+        if( !!plink && plink->IsEnabled() && _RayIntersectsAABB(*pcb, pcoll->getAABB()) ) {
+            pcb->_vcandidatelinks.push_back(plink);
+        }
         return false;
     }
 
+    /// \brief slab test of the ray segment against a world axis-aligned box
+    static bool _RayIntersectsAABB(const RayCallbackData& query, const fcl::AABB& aabb)
+    {
+        dReal fmin = 0, fmax = query._fHitDist;
+        for(int i = 0; i < 3; ++i) {
+            dReal fpos = query._ray.pos[i], fdir = query._vnormdir[i];
+            if( OpenRAVE::RaveFabs(fdir) < 1e-12 ) {
+                if( fpos < aabb.min_[i] || fpos > aabb.max_[i] ) {
+                    return false;
+                }
+                continue;
+            }
+            dReal finv = 1/fdir;
+            dReal f0 = (aabb.min_[i]-fpos)*finv, f1 = (aabb.max_[i]-fpos)*finv;
+            if( f0 > f1 ) {
+                std::swap(f0, f1);
+            }
+            fmin = std::max(fmin, f0);
+            fmax = std::min(fmax, f1);
+            if( fmin > fmax ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void _CheckRayCandidateLinks(RayCallbackData& query)
+    {
+        FOREACHC(itlink, query._vcandidatelinks) {
+            _CheckRayLink(*itlink, query);
+            if( query._bStopChecking ) {
+                break;
+            }
+        }
+    }
+
+    /// \brief intersects the ray with the cached fcl geometries of the link, so the geometry group of the checker is respected
+    void _CheckRayLink(LinkConstPtr plink, RayCallbackData& query)
+    {
+        FCLSpace::KinBodyInfoPtr pinfo = _fclspace->GetInfo(plink->GetParent());
+        if( !pinfo ) {
+            return;
+        }
+        const FCLSpace::KinBodyInfo::LINK& link = *pinfo->vlinks.at(plink->GetIndex());
+        if( link.vgeoms.size() > 0 ) {
+            // the broadphase object of the link is only a bounding box of all the geometries
+            FOREACHC(itgeom, link.vgeoms) {
+                _CheckRayGeometry(plink, *itgeom->second, query);
+                if( query._bStopChecking ) {
+                    return;
+                }
+            }
+        }
+        else if( !!link.plinkBV ) {
+            _CheckRayGeometry(plink, *link.plinkBV->second, query);
+        }
+    }
+
+    /// \brief intersects the ray with one fcl geometry. The ray is moved into the geometry frame so the geometry is never transformed.
+    ///
+    /// Primitives are intersected analytically. For meshes, fcl collides the cached BVH with a thin box along the ray and only the triangles it returns are intersected exactly.
+    void _CheckRayGeometry(LinkConstPtr plink, fcl::CollisionObject& geomobject, RayCallbackData& query)
+    {
+        if( !_RayIntersectsAABB(query, geomobject.getAABB()) ) {
+            return;
+        }
+        const fcl::Transform3f& tfcl = geomobject.getTransform();
+        Transform tgeom(ConvertQuaternionFromFCL(tfcl.getQuatRotation()), ConvertVectorFromFCL(tfcl.getTranslation()));
+        Transform tinvgeom = tgeom.inverse();
+        Vector vpos = tinvgeom * query._ray.pos, vdir = tinvgeom.rotate(query._vnormdir);
+
+        dReal fhitdist = query._fHitDist;
+        Vector vhitnorm;
+        bool bhit = false;
+        const fcl::CollisionGeometry* pgeom = geomobject.collisionGeometry().get();
+        switch(pgeom->getNodeType()) {
+        case fcl::GEOM_BOX: {
+            const fcl::Vec3f& side = static_cast<const fcl::Box*>(pgeom)->side;
+            Vector vextents(0.5*side[0], 0.5*side[1], 0.5*side[2]);
+            for(int iaxis = 0; iaxis < 3; ++iaxis) {
+                for(int isign = -1; isign <= 1; isign += 2) {
+                    Vector vnorm; vnorm[iaxis] = isign;
+                    dReal t = fhitdist;
+                    if( _RayPlane(vpos, vdir, vnorm, vextents[iaxis], t) ) {
+                        Vector vhit = vpos + vdir*t;
+                        int i1 = (iaxis+1)%3, i2 = (iaxis+2)%3;
+                        if( OpenRAVE::RaveFabs(vhit[i1]) <= vextents[i1] && OpenRAVE::RaveFabs(vhit[i2]) <= vextents[i2] ) {
+                            fhitdist = t;
+                            vhitnorm = vnorm;
+                            bhit = true;
+                        }
+                    }
+                }
+            }
+            break;
+        }
+        case fcl::GEOM_SPHERE: {
+            dReal fradius = static_cast<const fcl::Sphere*>(pgeom)->radius;
+            // |vpos + t*vdir|^2 = r^2 with |vdir| = 1, take the first non-negative root
+            dReal b = vpos.dot3(vdir), c = vpos.lengthsqr3() - fradius*fradius;
+            dReal fdisc = b*b - c;
+            if( fdisc >= 0 ) {
+                dReal fsqrt = OpenRAVE::RaveSqrt(fdisc);
+                dReal t = -b - fsqrt >= 0 ? -b - fsqrt : -b + fsqrt;
+                if( t >= 0 && t <= fhitdist ) {
+                    fhitdist = t;
+                    vhitnorm = vpos + vdir*t;
+                    bhit = true;
+                }
+            }
+            break;
+        }
+        case fcl::GEOM_CYLINDER: {
+            const fcl::Cylinder* pcylinder = static_cast<const fcl::Cylinder*>(pgeom);
+            dReal fradius = pcylinder->radius, fhalfheight = 0.5*pcylinder->lz;
+            // the side, the cylinder axis is z
+            dReal a = vdir.x*vdir.x + vdir.y*vdir.y, b = vpos.x*vdir.x + vpos.y*vdir.y, c = vpos.x*vpos.x + vpos.y*vpos.y - fradius*fradius;
+            if( a > 1e-12 && b*b - a*c >= 0 ) {
+                dReal fsqrt = OpenRAVE::RaveSqrt(b*b - a*c);
+                for(int isign = -1; isign <= 1; isign += 2) {
+                    dReal t = (-b + isign*fsqrt)/a;
+                    if( t >= 0 && t <= fhitdist && OpenRAVE::RaveFabs(vpos.z + vdir.z*t) <= fhalfheight ) {
+                        fhitdist = t;
+                        vhitnorm = Vector(vpos.x + vdir.x*t, vpos.y + vdir.y*t, 0);
+                        bhit = true;
+                        break;
+                    }
+                }
+            }
+            // the caps
+            for(int isign = -1; isign <= 1; isign += 2) {
+                dReal t = fhitdist;
+                if( _RayPlane(vpos, vdir, Vector(0,0,isign), fhalfheight, t) ) {
+                    Vector vhit = vpos + vdir*t;
+                    if( vhit.x*vhit.x + vhit.y*vhit.y <= fradius*fradius ) {
+                        fhitdist = t;
+                        vhitnorm = Vector(0,0,isign);
+                        bhit = true;
+                    }
+                }
+            }
+            break;
+        }
+        default:
+            if( pgeom->getObjectType() == fcl::OT_BVH ) {
+                bhit = _RayBVH(geomobject, vpos, vdir, query, fhitdist, vhitnorm);
+            }
+            break;
+        }
+
+        if( !bhit ) {
+            return;
+        }
+
+        query._bCollision = true;
+        query._fHitDist = fhitdist;
+        if( query._bAnyHit || !query._report ) {
+            query._bStopChecking = true;
+        }
+        if( !!query._report ) {
+            // the outward normal of the geometry, so a ray leaving the geometry gets a normal along its direction and is not front facing
+            Vector vnorm = tgeom.rotate(vhitnorm.normalize3());
+            query._report->plink1 = plink;
+            query._report->minDistance = fhitdist;
+            query._report->contacts.resize(1);
+            query._report->contacts[0] = CollisionReport::CONTACT(query._ray.pos + query._vnormdir*fhitdist, vnorm, fhitdist);
+        }
+    }
+
+    /// \brief intersects the ray with the plane dot(vnorm,x) = foffset. fdist is only set if the intersection is in [0, fdist]
+    static bool _RayPlane(const Vector& vpos, const Vector& vdir, const Vector& vnorm, dReal foffset, dReal& fdist)
+    {
+        dReal fdot = vnorm.dot3(vdir);
+        if( OpenRAVE::RaveFabs(fdot) < 1e-12 ) {
+            return false;
+        }
+        dReal t = (foffset - vnorm.dot3(vpos))/fdot;
+        if( t < 0 || t > fdist ) {
+            return false;
+        }
+        fdist = t;
+        return true;
+    }
+
+    template <typename T>
+    static bool _GetBVHMesh(const fcl::CollisionGeometry* pgeom, const fcl::Vec3f*& pvertices, const fcl::Triangle*& ptriangles)
+    {
+        const fcl::BVHModel<T>* pmodel = static_cast<const fcl::BVHModel<T>*>(pgeom);
+        pvertices = pmodel->vertices;
+        ptriangles = pmodel->tri_indices;
+        return pvertices != NULL && ptriangles != NULL;
+    }
+
+    /// \brief intersects the ray with the triangles of a BVH that the thin box along the ray collides with
+    bool _RayBVH(fcl::CollisionObject& geomobject, const Vector& vpos, const Vector& vdir, RayCallbackData& query, dReal& fhitdist, Vector& vhitnorm)
+    {
+        const fcl::CollisionGeometry* pgeom = geomobject.collisionGeometry().get();
+        const fcl::Vec3f* pvertices = NULL;
+        const fcl::Triangle* ptriangles = NULL;
+        bool bmesh = false;
+        switch(pgeom->getNodeType()) {
+        case fcl::BV_AABB: bmesh = _GetBVHMesh<fcl::AABB>(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_OBB: bmesh = _GetBVHMesh<fcl::OBB>(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_RSS: bmesh = _GetBVHMesh<fcl::RSS>(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_OBBRSS: bmesh = _GetBVHMesh<fcl::OBBRSS>(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_kIOS: bmesh = _GetBVHMesh<fcl::kIOS>(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_KDOP16: bmesh = _GetBVHMesh< fcl::KDOP<16> >(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_KDOP18: bmesh = _GetBVHMesh< fcl::KDOP<18> >(pgeom, pvertices, ptriangles); break;
+        case fcl::BV_KDOP24: bmesh = _GetBVHMesh< fcl::KDOP<24> >(pgeom, pvertices, ptriangles); break;
+        default: break;
+        }
+        if( !bmesh ) {
+            return false;
+        }
+
+        query._triangleresult.clear();
+        fcl::collide(&geomobject, query._psegmentobject.get(), query._triangleRequest, query._triangleresult);
+        bool bhit = false;
+        for(size_t icontact = 0; icontact < query._triangleresult.numContacts(); ++icontact) {
+            // the mesh is the first object, so b1 is the triangle
+            const fcl::Triangle& tri = ptriangles[query._triangleresult.getContact(icontact).b1];
+            Vector v0 = ConvertVectorFromFCL(pvertices[tri[0]]);
+            Vector e1 = ConvertVectorFromFCL(pvertices[tri[1]]) - v0, e2 = ConvertVectorFromFCL(pvertices[tri[2]]) - v0;
+            Vector p = vdir.cross(e2);
+            dReal fdet = e1.dot3(p);
+            if( OpenRAVE::RaveFabs(fdet) < 1e-12 ) {
+                continue;
+            }
+            dReal finvdet = 1/fdet;
+            Vector t = vpos - v0;
+            dReal u = t.dot3(p)*finvdet;
+            if( u < 0 || u > 1 ) {
+                continue;
+            }
+            Vector q = t.cross(e1);
+            dReal v = vdir.dot3(q)*finvdet;
+            if( v < 0 || u + v > 1 ) {
+                continue;
+            }
+            dReal fdist = e2.dot3(q)*finvdet;
+            if( fdist >= 0 && fdist <= fhitdist ) {
+                fhitdist = fdist;
+                vhitnorm = e1.cross(e2);
+                bhit = true;
+                if( query._bAnyHit ) {
+                    break;
+                }
+            }
+        }
+        return bhit;
+    }
+
+    /// \brief ray query against the objects of an already synchronized manager
+    bool _CheckRay(const RAY& ray, BroadPhaseCollisionManagerPtr manager, CollisionReportPtr report)
+    {
+        RayCallbackData query(shared_checker(), ray, report);
+        if( !manager ) {
+            return false;
+        }
+        manager->collide(query._pobject.get(), &query, &FCLCollisionChecker::CheckRayCandidate);
+        _CheckRayCandidateLinks(query);
+        return _FinishRayQuery(query);
+    }
+
+    bool _FinishRayQuery(RayCallbackData& query)
+    {
+        if( query._bCollision && !!query._report && GetEnv()->HasRegisteredCollisionCallbacks() ) {
+            std::list<EnvironmentBase::CollisionCallbackFn> listcallbacks;
+            GetEnv()->GetRegisteredCollisionCallbacks(listcallbacks);
+            FOREACHC(itfn, listcallbacks) {
+                OpenRAVE::CollisionAction action = (*itfn)(query._report,false);
+                if( action != OpenRAVE::CA_DefaultAction ) {
+                    query._report->Reset(_options);
+                    return false;
+                }
+            }
+        }
+        return query._bCollision;
+    }
+
+    static bool CheckNarrowPhaseGeomDistance(fcl::CollisionObject *o1, fcl::CollisionObject *o2, void *data, fcl::FCL_REAL& dist) {
+        DistanceCallbackData* pcb = static_cast<DistanceCallbackData *>(data);
+        return pcb->_pchecker->CheckNarrowPhaseGeomDistance(o1, o2, pcb, dist);
+    }
+
+    bool CheckNarrowPhaseGeomDistance(fcl::CollisionObject *o1, fcl::CollisionObject *o2, DistanceCallbackData* pcb, fcl::FCL_REAL& dist)
+    {
+        LinkConstPtr plink1 = GetCollisionLink(*o1), plink2 = GetCollisionLink(*o2);
+
+        if( !plink1 || !plink2 ) {
+            return false;
+        }
+
+        if( !plink1->IsEnabled() || !plink2->IsEnabled() ) {
+            return false;
+        }
+
+        if( !pcb->bselfCollision && plink1->GetParent()->IsAttached(KinBodyConstPtr(plink2->GetParent())) ) {
+            return false;
+        }
+
+        pcb->_result.clear();
+        pcb->_result.min_distance = pcb->_fMinDistance;
+        fcl::distance(o1, o2, pcb->_request, pcb->_result);
+        if( pcb->_result.min_distance < pcb->_fMinDistance ) {
+            pcb->_fMinDistance = std::max(pcb->_result.min_distance, fcl::FCL_REAL(0));
+            pcb->_report->minDistance = pcb->_fMinDistance;
+            pcb->_report->plink1 = plink1;
+            pcb->_report->plink2 = plink2;
+        }
+        dist = pcb->_fMinDistance;
+        return dist <= 0;
+    }
+
     static LinkPair MakeLinkPair(LinkConstPtr plink1, LinkConstPtr plink2)
     {
         if( plink1.get() < plink2.get() ) {
@@ -1019,6 +1552,7 @@ private:
     int _options;
     boost::shared_ptr<FCLSpace> _fclspace;
     int _numMaxContacts;
+    dReal _fDistanceThreshold; ///< CO_Distance queries do not compute distances larger than this
     std::string _userdatakey;
     bool _bIsSelfCollisionChecker; ///< if true, then this collision checker will be solely used for self collision checking. a collision checker is environment if InitEnvironment is called.
     CollisionReport _reportcache; ///< cache the report
@@ -90,7 +90,7 @@ public:
 
         struct LINK
         {
-            LINK(KinBody::LinkPtr plink) : _plink(plink) {
+            LINK(KinBody::LinkPtr plink) : _plink(plink), nLastStamp(plink->GetTransformStamp()-1) {
             }
 
             virtual ~LINK() {
@@ -120,6 +120,7 @@ public:
             }
 
             KinBody::LinkWeakPtr _plink;
+            int nLastStamp; ///< KinBody::Link::GetTransformStamp at the last synchronization, links whose stamp did not change are not updated
 
             // TODO : What about a dynamic collection of managers containing this link ?
             BroadPhaseCollisionManagerPtr _envManager, _bodyManager, _linkManager;
@@ -634,48 +635,56 @@ private:
     {
         KinBodyPtr pbody = pinfo->GetBody();
         if( pinfo->nLastStamp != pbody->GetUpdateStamp()) {
-            vector<Transform> vtrans;
-            pbody->GetLinkTransformations(vtrans);
             pinfo->nLastStamp = pbody->GetUpdateStamp();
-            BOOST_ASSERT( pbody->GetLinks().size() == pinfo->vlinks.size() );
-            BOOST_ASSERT( vtrans.size() == pinfo->vlinks.size() );
-            for(size_t i = 0; i < vtrans.size(); ++i) {
-                FOREACHC(itgeomcoll, pinfo->vlinks[i]->vgeoms) {
-                    CollisionObjectPtr pcoll = (*itgeomcoll).second;
-                    Transform pose = vtrans[i] * (*itgeomcoll).first;
-                    fcl::Vec3f newPosition = ConvertVectorToFCL(pose.trans);
-                    fcl::Quaternion3f newOrientation = ConvertQuaternionToFCL(pose.rot);
-
-                    pcoll->setTranslation(newPosition);
-                    pcoll->setQuatRotation(newOrientation);
-                    // Why do we compute the AABB ?
-                    pcoll->computeAABB();
-
-                    pinfo->vlinks[i]->_linkManager->update(pcoll.get());
+            const std::vector<KinBody::LinkPtr>& vlinks = pbody->GetLinks();
+            BOOST_ASSERT( vlinks.size() == pinfo->vlinks.size() );
+            _vTempUpdatedBVs.resize(0);
+            for(size_t i = 0; i < vlinks.size(); ++i) {
+                // moving a joint only changes the stamps of the links after it, so the others are skipped
+                KinBodyInfo::LINK& link = *pinfo->vlinks[i];
+                if( link.nLastStamp == vlinks[i]->GetTransformStamp() ) {
+                    continue;
+                }
+                link.nLastStamp = vlinks[i]->GetTransformStamp();
+
+                Transform tlink = vlinks[i]->GetTransform();
+                if( link.vgeoms.size() > 0 ) {
+                    _vTempUpdatedGeoms.resize(0);
+                    FOREACHC(itgeomcoll, link.vgeoms) {
+                        CollisionObjectPtr pcoll = (*itgeomcoll).second;
+                        _SetCollisionObjectTransform(*pcoll, tlink * (*itgeomcoll).first);
+                        _vTempUpdatedGeoms.push_back(pcoll.get());
+                    }
+                    link._linkManager->update(_vTempUpdatedGeoms);
                 }
 
-                if( !!pinfo->vlinks[i]->plinkBV ) {
-                    CollisionObjectPtr pcoll = pinfo->vlinks[i]->plinkBV->second;
-                    Transform pose = vtrans[i] * pinfo->vlinks[i]->plinkBV->first;
-                    fcl::Vec3f newPosition = ConvertVectorToFCL(pose.trans);
-                    fcl::Quaternion3f newOrientation = ConvertQuaternionToFCL(pose.rot);
-
-                    pcoll->setTranslation(newPosition);
-                    pcoll->setQuatRotation(newOrientation);
-                    // Why do we compute the AABB ?
-                    pcoll->computeAABB();
-
-                    pinfo->_bodyManager->update(pcoll.get());
-                    _manager->update(pcoll.get());
+                if( !!link.plinkBV ) {
+                    CollisionObjectPtr pcoll = link.plinkBV->second;
+                    _SetCollisionObjectTransform(*pcoll, tlink * link.plinkBV->first);
+                    _vTempUpdatedBVs.push_back(pcoll.get());
                 }
             }
 
+            // update each broadphase manager once with all the moved link bounding volumes
+            if( _vTempUpdatedBVs.size() > 0 ) {
+                pinfo->_bodyManager->update(_vTempUpdatedBVs);
+                _manager->update(_vTempUpdatedBVs);
+            }
+
             if( !!_synccallback ) {
                 _synccallback(pinfo);
             }
         }
     }
 
+    static void _SetCollisionObjectTransform(fcl::CollisionObject& coll, const Transform& pose)
+    {
+        coll.setTranslation(ConvertVectorToFCL(pose.trans));
+        coll.setQuatRotation(ConvertQuaternionToFCL(pose.rot));
+        // the broadphase managers only look at the world AABB, which setTransform does not recompute
+        coll.computeAABB();
+    }
+
 
     void _ResetKinBodyCallback(boost::weak_ptr<KinBody const> _pbody)
     {
@@ -748,6 +757,8 @@ private:
 
     std::set<KinBodyConstPtr> _setInitializedBodies;
 
+    std::vector<fcl::CollisionObject*> _vTempUpdatedGeoms, _vTempUpdatedBVs; ///< cache, used in _Synchronize
+
 };
 
 
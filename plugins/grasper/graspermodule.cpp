@@ -63,12 +63,12 @@ class GrasperModule : public ModuleBase
     };
 
 public:
-    GrasperModule(EnvironmentBasePtr penv, std::istream& sinput)  : ModuleBase(penv), errfile(NULL) {
+    GrasperModule(EnvironmentBasePtr penv, std::istream& sinput)  : ModuleBase(penv), _nNextGraspId(0), errfile(NULL) {
         __description = ":Interface Author: Rosen Diankov\n\nUsed to simulate a hand grasping an object by closing its fingers until collision with all links. ";
         RegisterCommand("Grasp",boost::bind(&GrasperModule::_GraspCommand,this,_1,_2),
                         "Performs a grasp and returns contact points");
         RegisterCommand("GraspThreaded",boost::bind(&GrasperModule::_GraspThreadedCommand,this,_1,_2),
-                        "Parllelizes the computation of the grasp planning and force closure. Number of threads can be specified with 'numthreads'.");
+                        "Parllelizes the computation of the grasp planning and force closure. Number of threads can be specified with 'numthreads'. The cloned worker environments are kept between calls. With 'binaryresults 1' the results are returned as a flat buffer of float64 values in the same order as the text output.");
         RegisterCommand("ComputeDistanceMap",boost::bind(&GrasperModule::_ComputeDistanceMapCommand,this,_1,_2),
                         "Computes a distance map around a particular point in space");
         RegisterCommand("GetStableContacts",boost::bind(&GrasperModule::_GetStableContactsCommand,this,_1,_2),
@@ -85,6 +85,12 @@ public:
     {
         _planner.reset();
         _robot.reset();
+        FOREACH(itenv, _vWorkerEnvironments) {
+            if( !!*itenv ) {
+                (*itenv)->Destroy();
+            }
+        }
+        _vWorkerEnvironments.clear();
     }
 
     virtual int main(const std::string& args)
@@ -648,6 +654,15 @@ public:
         Vector affineaxis;
 
         bool bCheckGraspIK;
+
+        // the full preshape x roll x standoff x approach-ray x manipulator-direction product to evaluate
+        vector< pair<Vector, Vector> > approachrays;
+        vector<dReal> rolls;
+        vector< vector<dReal> > preshapes;
+        vector<Vector> manipulatordirections;
+        vector<dReal> standoffs;
+        size_t numgrasps; ///< size of the product
+        size_t maxgrasps; ///< workers stop pulling work once this many grasps succeeded
     };
 
     struct GraspParametersThread
@@ -677,13 +692,14 @@ public:
         WorkerParametersPtr worker_params(new WorkerParameters());
         int numthreads = 2;
         string cmd;
-        vector< pair<Vector, Vector> > approachrays;
-        vector<dReal> rolls;
-        vector< vector<dReal> > preshapes;
-        vector<Vector> manipulatordirections;
-        vector<dReal> standoffs;
+        vector< pair<Vector, Vector> >& approachrays = worker_params->approachrays;
+        vector<dReal>& rolls = worker_params->rolls;
+        vector< vector<dReal> >& preshapes = worker_params->preshapes;
+        vector<Vector>& manipulatordirections = worker_params->manipulatordirections;
+        vector<dReal>& standoffs = worker_params->standoffs;
         size_t startindex = 0;
         size_t maxgrasps = 0;
+        bool bBinaryResults = false;
 
         while(!sinput.eof()) {
             sinput >> cmd;
@@ -781,6 +797,9 @@ public:
             else if( cmd == "checkik" ) {
                 sinput >> worker_params->bCheckGraspIK;
             }
+            else if( cmd == "binaryresults" ) {
+                sinput >> bBinaryResults;
+            }
             else {
                 RAVELOG_WARN(str(boost::format("unrecognized command: %s\n")%cmd));
                 break;
@@ -797,56 +816,78 @@ public:
         worker_params->affinedofs = _robot->GetAffineDOF();
         worker_params->affineaxis = _robot->GetAffineRotationAxis();
 
-        EnvironmentBasePtr pcloneenv = GetEnv()->CloneSelf(Clone_Bodies|Clone_Simulation);
+        worker_params->numgrasps = approachrays.size()*rolls.size()*preshapes.size()*standoffs.size()*manipulatordirections.size();
+        worker_params->maxgrasps = maxgrasps == 0 ? worker_params->numgrasps : maxgrasps;
+        RAVELOG_INFO(str(boost::format("number of grasps to test: %d\n")%worker_params->numgrasps));
 
-        _bContinueWorker = true;
-        // start worker threads
-        vector<boost::shared_ptr<boost::thread> > listthreads(numthreads);
-        FOREACH(itthread,listthreads) {
-            itthread->reset(new boost::thread(boost::bind(&GrasperModule::_WorkerThread,this,worker_params,pcloneenv)));
+        // the worker environments are kept between calls and only re-synchronized, which re-uses all bodies that did not change
+        numthreads = max(1,numthreads);
+        if( (int)_vWorkerEnvironments.size() > numthreads ) {
+            for(size_t i = numthreads; i < _vWorkerEnvironments.size(); ++i) {
+                _vWorkerEnvironments[i]->Destroy();
+            }
         }
-
-        _listGraspResults.clear();
-        size_t numgrasps = approachrays.size()*rolls.size()*preshapes.size()*standoffs.size()*manipulatordirections.size();
-        if( maxgrasps == 0 ) {
-            maxgrasps = numgrasps;
-        }
-        RAVELOG_INFO(str(boost::format("number of grasps to test: %d\n")%numgrasps));
-        size_t id = startindex;
-        for(id=startindex; id < numgrasps; ++id) {
-            size_t istandoff = id % standoffs.size();
-            size_t ipreshape = (id / standoffs.size()) % preshapes.size();
-            size_t iroll = (id / (preshapes.size() * standoffs.size())) % rolls.size();
-            size_t iapproachray = (id / (rolls.size() * preshapes.size() * standoffs.size()))%approachrays.size();
-            size_t imanipulatordirection = (id / (rolls.size() * preshapes.size() * standoffs.size()*approachrays.size()));
-
-            boost::mutex::scoped_lock lock(_mutexGrasp);
-            if( _listGraspResults.size() >= maxgrasps ) {
-                break;
+        _vWorkerEnvironments.resize(numthreads);
+        FOREACH(itenv, _vWorkerEnvironments) {
+            if( !*itenv ) {
+                *itenv = GetEnv()->CloneSelf(Clone_Bodies|Clone_Simulation);
+            }
+            else {
+                (*itenv)->Clone(GetEnv(), Clone_Bodies|Clone_Simulation);
             }
-
-            // initialize _graspParamsWork
-            BOOST_ASSERT(!_graspParamsWork);
-            _graspParamsWork.reset(new GraspParametersThread());
-            _graspParamsWork->id = id;
-            _graspParamsWork->vtargetposition = approachrays.at(iapproachray).first;
-            _graspParamsWork->vtargetdirection = approachrays.at(iapproachray).second;
-            _graspParamsWork->vmanipulatordirection = manipulatordirections.at(imanipulatordirection);
-            _graspParamsWork->ftargetroll = rolls.at(iroll);
-            _graspParamsWork->fstandoff = standoffs.at(istandoff);
-            _graspParamsWork->preshape = preshapes.at(ipreshape);
-            _condGraspHasWork.notify_one();     // notify there is work
-            _condGraspReceivedWork.wait(lock);     // wait for more work
         }
 
-        // wait for workers
-        _bContinueWorker = false;
+        _listGraspResults.clear();
+        _nNextGraspId = startindex;
+        // start worker threads, each pulls the next grasp index from _nNextGraspId until the product is exhausted
+        vector<boost::shared_ptr<boost::thread> > listthreads(numthreads);
+        for(int i = 0; i < numthreads; ++i) {
+            listthreads[i].reset(new boost::thread(boost::bind(&GrasperModule::_WorkerThread,this,worker_params,_vWorkerEnvironments[i])));
+        }
         FOREACH(itthread,listthreads) {
-            _condGraspHasWork.notify_all();     // signal
             (*itthread)->join();
         }
         listthreads.clear();
 
+        // results arrive in completion order, sort them so that the output does not depend on the scheduling
+        _listGraspResults.sort(boost::bind(&GraspParametersThread::id,_1) < boost::bind(&GraspParametersThread::id,_2));
+        size_t id = min(_nNextGraspId, worker_params->numgrasps);
+        if( _listGraspResults.size() >= worker_params->maxgrasps ) {
+            // every pulled grasp is finished, so the results hold all successes of [startindex,_nNextGraspId).
+            // other threads could have finished more than maxgrasps, keep the first ones by index and resume after the last kept one
+            _listGraspResults.resize(worker_params->maxgrasps);
+            if( _listGraspResults.size() > 0 ) {
+                id = _listGraspResults.back()->id+1;
+            }
+        }
+
+        if( bBinaryResults ) {
+            // every value is written as a native float64 in the same order as the text output
+            std::vector<double> vresults;
+            vresults.push_back(id);
+            vresults.push_back(_listGraspResults.size());
+            FOREACH(itresult, _listGraspResults) {
+                const GraspParametersThread& r = **itresult;
+                vresults.push_back(r.vtargetposition.x); vresults.push_back(r.vtargetposition.y); vresults.push_back(r.vtargetposition.z);
+                vresults.push_back(r.vtargetdirection.x); vresults.push_back(r.vtargetdirection.y); vresults.push_back(r.vtargetdirection.z);
+                vresults.push_back(r.ftargetroll); vresults.push_back(r.fstandoff);
+                vresults.push_back(r.vmanipulatordirection.x); vresults.push_back(r.vmanipulatordirection.y); vresults.push_back(r.vmanipulatordirection.z);
+                vresults.push_back(r.mindist); vresults.push_back(r.volume);
+                vresults.insert(vresults.end(), r.preshape.begin(), r.preshape.end());
+                vresults.push_back(r.transfinal.rot.x); vresults.push_back(r.transfinal.rot.y); vresults.push_back(r.transfinal.rot.z); vresults.push_back(r.transfinal.rot.w);
+                vresults.push_back(r.transfinal.trans.x); vresults.push_back(r.transfinal.trans.y); vresults.push_back(r.transfinal.trans.z);
+                vresults.insert(vresults.end(), r.finalshape.begin(), r.finalshape.end());
+                vresults.push_back(r.contacts.size());
+                FOREACHC(itc, r.contacts) {
+                    const CollisionReport::CONTACT& c = itc->first;
+                    vresults.push_back(c.pos.x); vresults.push_back(c.pos.y); vresults.push_back(c.pos.z);
+                    vresults.push_back(c.norm.x); vresults.push_back(c.norm.y); vresults.push_back(c.norm.z);
+                }
+            }
+            sout.write((const char*)&vresults[0], vresults.size()*sizeof(vresults[0]));
+            return true;
+        }
+
         // parse results to output
         sout << id << " " << _listGraspResults.size() << " ";
         FOREACH(itresult, _listGraspResults) {
@@ -871,10 +912,29 @@ public:
         return true;
     }
 
-    void _WorkerThread(const WorkerParametersPtr worker_params, EnvironmentBasePtr penv)
+    /// \brief fills the parameters of grasp id of the product
+    GraspParametersThreadPtr _CreateGraspWork(const WorkerParameters& worker_params, size_t id)
+    {
+        size_t numstandoffs = worker_params.standoffs.size(), numpreshapes = worker_params.preshapes.size(), numrolls = worker_params.rolls.size(), numapproachrays = worker_params.approachrays.size();
+        size_t istandoff = id % numstandoffs;
+        size_t ipreshape = (id / numstandoffs) % numpreshapes;
+        size_t iroll = (id / (numpreshapes * numstandoffs)) % numrolls;
+        size_t iapproachray = (id / (numrolls * numpreshapes * numstandoffs))%numapproachrays;
+        size_t imanipulatordirection = (id / (numrolls * numpreshapes * numstandoffs*numapproachrays));
+
+        GraspParametersThreadPtr grasp_params(new GraspParametersThread());
+        grasp_params->id = id;
+        grasp_params->vtargetposition = worker_params.approachrays.at(iapproachray).first;
+        grasp_params->vtargetdirection = worker_params.approachrays.at(iapproachray).second;
+        grasp_params->vmanipulatordirection = worker_params.manipulatordirections.at(imanipulatordirection);
+        grasp_params->ftargetroll = worker_params.rolls.at(iroll);
+        grasp_params->fstandoff = worker_params.standoffs.at(istandoff);
+        grasp_params->preshape = worker_params.preshapes.at(ipreshape);
+        return grasp_params;
+    }
+
+    void _WorkerThread(const WorkerParametersPtr worker_params, EnvironmentBasePtr pcloneenv)
     {
-        // clone environment
-        EnvironmentBasePtr pcloneenv = penv->CloneSelf(Clone_Bodies|Clone_Simulation);
         {
             EnvironmentMutex::scoped_lock lock(pcloneenv->GetMutex());
             boost::shared_ptr<CollisionCheckerMngr> pcheckermngr(new CollisionCheckerMngr(pcloneenv, worker_params->collisionchecker));
@@ -911,20 +971,14 @@ public:
             coloptions &= ~CO_Contacts;
             pcloneenv->GetCollisionChecker()->SetCollisionOptions(coloptions|CO_Contacts);
 
-            while(_bContinueWorker) {
+            while(1) {
                 {
-                    // wait for work
+                    // pull the next piece of work
                     boost::mutex::scoped_lock lock(_mutexGrasp);
-                    if( !_graspParamsWork ) {
-                        _condGraspHasWork.wait(lock);
-                        // after signal
-                        if( !_graspParamsWork ) {
-                            continue;
-                        }
+                    if( _nNextGraspId >= worker_params->numgrasps || _listGraspResults.size() >= worker_params->maxgrasps ) {
+                        break;
                     }
-                    grasp_params = _graspParamsWork;
-                    _graspParamsWork.reset();
-                    _condGraspReceivedWork.notify_all();
+                    grasp_params = _CreateGraspWork(*worker_params, _nNextGraspId++);
                 }
 
                 RAVELOG_DEBUG(str(boost::format("grasp %d: start")%grasp_params->id));
@@ -1128,14 +1182,12 @@ public:
                 _listGraspResults.push_back(grasp_params);
             }
         }
-        pcloneenv->Destroy();
     }
 
-    bool _bContinueWorker;
     boost::mutex _mutexGrasp;
-    GraspParametersThreadPtr _graspParamsWork;
+    size_t _nNextGraspId; ///< next index of the grasp product to evaluate, protected by _mutexGrasp
     list<GraspParametersThreadPtr> _listGraspResults;
-    boost::condition _condGraspHasWork, _condGraspReceivedWork;
+    std::vector<EnvironmentBasePtr> _vWorkerEnvironments; ///< persistent clones used by the GraspThreaded workers
 
 protected:
     void _ComputeJointMaxLengths(vector<dReal>& vjointlengths)
@@ -33,8 +33,12 @@ class GrasperPlanner :  public PlannerBase
     };
 
 public:
-    GrasperPlanner(EnvironmentBasePtr penv, std::istream& sinput) : PlannerBase(penv), _report(new CollisionReport()) {
+    GrasperPlanner(EnvironmentBasePtr penv, std::istream& sinput) : PlannerBase(penv), _report(new CollisionReport()), _bDistanceStepping(true), _bUseDistance(false), _nCollisionChecks(0), _fLinkClearance(0), _fJointClearance(0) {
         __description = ":Interface Authors: Rosen Diankov, Dmitry Berenson\n\nSimple planner that performs a follow and squeeze operation of a robotic hand.";
+        RegisterCommand("SetDistanceStepping",boost::bind(&GrasperPlanner::_SetDistanceSteppingCommand,this,_1,_2),
+                        "1 (default) skips the environment checks of steps that stay within the clearance measured by distance queries, 0 checks every step");
+        RegisterCommand("GetCollisionCheckCount",boost::bind(&GrasperPlanner::_GetCollisionCheckCountCommand,this,_1,_2),
+                        "returns the number of environment collision checks of the last PlanPath");
     }
     bool InitPlan(RobotBasePtr pbase, PlannerParametersConstPtr pparams)
     {
@@ -106,6 +110,9 @@ public:
         }
 
         CollisionCheckerMngr checkermngr(GetEnv(),"");
+        // if the checker can measure distances, the approach and the fingers do not check the environment at steps that stay within the measured clearance
+        _bUseDistance = _bDistanceStepping && GetEnv()->GetCollisionChecker()->SetCollisionOptions(CO_Distance);
+        _nCollisionChecks = 0;
         GetEnv()->GetCollisionChecker()->SetCollisionOptions(0);
 
         // do not disable any links of the robot here!
@@ -428,9 +435,18 @@ public:
             if( num_iters <= 1 ) {
                 num_iters = 2; // need at least 2 iterations because of coarse/fine step tuning
             }
+
+            // the steps stay the same as without distances, only the environment checks of the steps that cannot reach anything are skipped.
+            // the links moved by a revolute joint move at most the rotation angle times their distance to the anchor
+            bool bskipchecks = _bUseDistance && !_IsDrivingMimicJoints(nDOFIndex);
+            dReal fradius = pjoint->IsPrismatic(nDOFIndex-pjoint->GetDOFIndex()) ? dReal(1) : _ComputeMaxDistanceFromAnchor(pjoint);
+            dReal fcleared = dofvals[ifing]; // value up to which the links cannot hit the environment
             _robot->SetActiveDOFValues(dofvals,KinBody::CLA_CheckLimitsSilent);
             _robot->GetActiveDOFValues(dofvals);
             int ct = _CheckCollision(KinBody::JointConstPtr(pjoint),KinBodyPtr());
+            if( bskipchecks && !(ct&CT_CollisionMask) && fradius > 0 ) {
+                fcleared = dofvals[ifing] + vchuckingdir[ifing]*_fJointClearance/(fradius*RaveFabs(vchuckingdir[ifing]));
+            }
             if( ct&CT_CollisionMask ) {
                 RAVELOG_DEBUG(str(boost::format("gripper initially in collision: %s\n")%_report->__str__()));
                 if( _parameters->bavoidcontact ) {
@@ -450,7 +466,15 @@ public:
                 dofvals[ifing] += vchuckingdir[ifing] * step_size;
                 _robot->SetActiveDOFValues(dofvals,KinBody::CLA_CheckLimitsSilent);
                 _robot->GetActiveDOFValues(dofvals);
-                ct = _CheckCollision(KinBody::JointConstPtr(pjoint),KinBodyPtr());
+                if( bskipchecks && (vchuckingdir[ifing] > 0 ? dofvals[ifing] < fcleared : dofvals[ifing] > fcleared) ) {
+                    ct = _CheckSelfCollision(KinBody::JointConstPtr(pjoint));
+                }
+                else {
+                    ct = _CheckCollision(KinBody::JointConstPtr(pjoint),KinBodyPtr());
+                    if( bskipchecks && !(ct&CT_CollisionMask) && fradius > 0 ) {
+                        fcleared = dofvals[ifing] + vchuckingdir[ifing]*_fJointClearance/(fradius*RaveFabs(vchuckingdir[ifing]));
+                    }
+                }
                 if( ct&CT_CollisionMask ) {
                     if(coarse_pass) {
                         //coarse step collided, back up and shrink step
@@ -525,24 +549,41 @@ public:
     virtual int _CheckCollision(KinBody::JointConstPtr pjoint, KinBodyPtr targetbody)
     {
         int ct = 0;
+        _fJointClearance = 1e20;
         for(int q = 0; q < (int)_vlinks.size(); q++) {
-            if(_robot->DoesAffect(pjoint->GetJointIndex(),_vlinks[q]->GetIndex())  && ((ct = _CheckCollision(KinBody::LinkConstPtr(_vlinks[q]), targetbody)) & CT_CollisionMask) ) {
-                break;
+            if( _robot->DoesAffect(pjoint->GetJointIndex(),_vlinks[q]->GetIndex()) ) {
+                ct = _CheckCollision(KinBody::LinkConstPtr(_vlinks[q]), targetbody);
+                if( ct & CT_CollisionMask ) {
+                    break;
+                }
+                _fJointClearance = min(_fJointClearance, _fLinkClearance);
             }
         }
         return ct;
     }
 
+    /// \brief checks the link against the environment (or targetbody) and the robot against itself
+    ///
+    /// If distances are available and there is no collision, _fLinkClearance is set to the distance from the link to the environment.
     virtual int _CheckCollision(KinBody::LinkConstPtr plink, KinBodyPtr targetbody)
     {
         int ct = (plink->GetIndex()<<CT_LinkMaskShift);
         bool bcollision;
-        if( !!targetbody ) {
-            bcollision = GetEnv()->CheckCollision(plink, KinBodyConstPtr(targetbody),_report);
-        }
-        else {
-            bcollision = GetEnv()->CheckCollision(plink,_report);
+        {
+            CollisionOptionsStateSaverPtr optionsaver;
+            if( _bUseDistance ) {
+                optionsaver.reset(new CollisionOptionsStateSaver(GetEnv()->GetCollisionChecker(), CO_Distance, false));
+            }
+            if( !!targetbody ) {
+                bcollision = GetEnv()->CheckCollision(plink, KinBodyConstPtr(targetbody),_report);
+            }
+            else {
+                bcollision = GetEnv()->CheckCollision(plink,_report);
+            }
         }
+        ++_nCollisionChecks;
+        // keep a small margin for the tolerance of the distance query
+        _fLinkClearance = (_bUseDistance && !bcollision) ? max(dReal(0), _report->minDistance-dReal(1e-4)) : dReal(0);
         if( bcollision ) {
             if( (!!_report->plink1 && _report->plink1->GetParent() == _parameters->targetbody) || (!!_report->plink2 && _report->plink2->GetParent() == _parameters->targetbody) ) {
                 ct |= CT_TargetCollision;
@@ -581,6 +622,42 @@ public:
     }
 
 protected:
+    /// \brief true if moving the DOF also moves mimic joints, in which case the clearance cannot be turned into a safe step
+    bool _IsDrivingMimicJoints(int dofindex) const
+    {
+        std::vector<int> vmimicdofs;
+        for(int itype = 0; itype < 2; ++itype) {
+            const std::vector<KinBody::JointPtr>& vjoints = itype == 0 ? _robot->GetJoints() : _robot->GetPassiveJoints();
+            FOREACHC(itjoint, vjoints) {
+                for(int iaxis = 0; iaxis < (*itjoint)->GetDOF(); ++iaxis) {
+                    if( (*itjoint)->IsMimic(iaxis) ) {
+                        (*itjoint)->GetMimicDOFIndices(vmimicdofs, iaxis);
+                        if( find(vmimicdofs.begin(), vmimicdofs.end(), dofindex) != vmimicdofs.end() ) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /// \brief upper bound on the distance of any point of the links moved by a revolute joint to its anchor
+    ///
+    /// Rotating by an angle a moves every point by at most a times this distance, which stays the same for the whole rotation.
+    dReal _ComputeMaxDistanceFromAnchor(KinBody::JointConstPtr pjoint) const
+    {
+        Vector vanchor = pjoint->GetAnchor();
+        dReal fmaxdist = 0;
+        FOREACHC(itlink, _vlinks) {
+            if( _robot->DoesAffect(pjoint->GetJointIndex(),(*itlink)->GetIndex()) ) {
+                AABB ab = (*itlink)->ComputeAABB();
+                fmaxdist = max(fmaxdist, RaveSqrt((ab.pos-vanchor).lengthsqr3()) + RaveSqrt(ab.extents.lengthsqr3()));
+            }
+        }
+        return fmaxdist;
+    }
+
     virtual int _MoveStraight(TrajectoryBasePtr ptraj, const Vector& vapproachdir, vector<dReal>& dofvals, int checkcollisions)
     {
         dReal* pX = NULL, *pY = NULL, *pZ = NULL;
@@ -600,19 +677,19 @@ protected:
         }
 
         bool bMoved = false;
-        Vector v = vapproachdir * (_parameters->fcoarsestep*_parameters->ftranslationstepmult);
+        // every link translates by the same amount, so the robot cannot hit anything before it travels further than the measured clearance.
+        // the steps stay the same as without distances, only the checks of the steps within the clearance are skipped
+        dReal ftraveled = 0, fcleared = 0;
+        dReal fstep = _parameters->fcoarsestep*_parameters->ftranslationstepmult;
+        Vector v = vapproachdir * fstep;
         int ct = 0;
         while(1) {
-            ct = 0;
-            for(int q = 0; q < (int)_vlinks.size(); q++) {
-                ct = _CheckCollision(KinBody::LinkConstPtr(_vlinks[q]), targetbody);
+            if( !_bUseDistance || ftraveled >= fcleared ) {
+                ct = _CheckStraightCollision(targetbody, checkcollisions, ftraveled, fcleared);
                 if( ct&checkcollisions ) {
                     break;
                 }
             }
-            if( ct&checkcollisions ) {
-                break;
-            }
 
             if(_parameters->breturntrajectory) {
                 ptraj->Insert(ptraj->GetNumWaypoints(),dofvals, _robot->GetActiveConfigurationSpecification());
@@ -628,6 +705,7 @@ protected:
                 *pZ += v.z;
             }
             _robot->SetActiveDOFValues(dofvals,KinBody::CLA_CheckLimitsSilent);
+            ftraveled += fstep;
             bMoved = true;
 
             // check if robot is already past all objects
@@ -651,8 +729,10 @@ protected:
         if( pZ != NULL ) {
             *pZ -= v.z;
         }
+        ftraveled -= fstep;
         // know the robot is not in collision at this point
-        v = vapproachdir * (_parameters->ffinestep*_parameters->ftranslationstepmult);
+        fstep = _parameters->ffinestep*_parameters->ftranslationstepmult;
+        v = vapproachdir * fstep;
         while(1) {
             if( pX != NULL ) {
                 *pX += v.x;
@@ -664,25 +744,77 @@ protected:
                 *pZ += v.z;
             }
             _robot->SetActiveDOFValues(dofvals,KinBody::CLA_CheckLimitsSilent);
+            ftraveled += fstep;
 
             if(_parameters->breturntrajectory) {
                 ptraj->Insert(ptraj->GetNumWaypoints(),dofvals, _robot->GetActiveConfigurationSpecification());
             }
 
-            ct = 0;
-            for(int q = 0; q < (int)_vlinks.size(); q++) {
-                ct = _CheckCollision(KinBody::LinkConstPtr(_vlinks[q]), targetbody);
+            if( !_bUseDistance || ftraveled >= fcleared ) {
+                ct = _CheckStraightCollision(targetbody, checkcollisions, ftraveled, fcleared);
                 if( ct&checkcollisions ) {
                     break;
                 }
             }
+        }
+
+        return ct;
+    }
+
+    /// \brief checks all links at the current position of a straight move
+    ///
+    /// If there is no collision and distances are available, fcleared is set to the travel distance up to which the robot cannot hit anything.
+    int _CheckStraightCollision(KinBodyPtr targetbody, int checkcollisions, dReal ftraveled, dReal& fcleared)
+    {
+        int ct = 0;
+        dReal fclearance = 1e20;
+        for(int q = 0; q < (int)_vlinks.size(); q++) {
+            ct = _CheckCollision(KinBody::LinkConstPtr(_vlinks[q]), targetbody);
             if( ct&checkcollisions ) {
-                break;
+                return ct;
             }
+            fclearance = min(fclearance, _fLinkClearance);
+        }
+        if( _bUseDistance ) {
+            fcleared = ftraveled + fclearance;
         }
-
         return ct;
     }
+
+    /// \brief checks the robot against itself, used for the finger steps that cannot reach the environment
+    ///
+    /// Returns the same flags as _CheckCollision of the joint would when none of its links hit the environment.
+    int _CheckSelfCollision(KinBody::JointConstPtr pjoint)
+    {
+        int ifirstlink = -1, ilastlink = -1;
+        for(int q = 0; q < (int)_vlinks.size(); q++) {
+            if( _robot->DoesAffect(pjoint->GetJointIndex(),_vlinks[q]->GetIndex()) ) {
+                if( ifirstlink < 0 ) {
+                    ifirstlink = _vlinks[q]->GetIndex();
+                }
+                ilastlink = _vlinks[q]->GetIndex();
+            }
+        }
+        if( ifirstlink < 0 ) {
+            return 0;
+        }
+        if( _robot->CheckSelfCollision(_report) ) {
+            return (ifirstlink<<CT_LinkMaskShift)|CT_SelfCollision;
+        }
+        return ilastlink<<CT_LinkMaskShift;
+    }
+
+    bool _SetDistanceSteppingCommand(std::ostream& sout, std::istream& sinput)
+    {
+        sinput >> _bDistanceStepping;
+        return !!sinput;
+    }
+
+    bool _GetCollisionCheckCountCommand(std::ostream& sout, std::istream& sinput)
+    {
+        sout << _nCollisionChecks;
+        return true;
+    }
     CollisionReportPtr _report;
     boost::shared_ptr<GraspParameters> _parameters;
     RobotBasePtr _robot;
@@ -690,6 +822,11 @@ protected:
     std::vector<KinBody::LinkPtr> _vlinks;
     Vector _vTargetCenter;
     dReal _fTargetRadius;
+    bool _bDistanceStepping; ///< if true, use distances to skip checks when the collision checker supports CO_Distance
+    bool _bUseDistance; ///< true if distances are used for the current plan
+    int _nCollisionChecks; ///< number of environment collision checks of the last PlanPath
+    dReal _fLinkClearance; ///< distance of the link to the environment measured by the last link check
+    dReal _fJointClearance; ///< minimum _fLinkClearance over the links moved by the joint of the last joint check
 };
 
 PlannerBasePtr CreateGrasperPlanner(EnvironmentBasePtr penv, std::istream& sinput)
@@ -22,6 +22,11 @@
 ModuleBasePtr CreateViewerRecorder(EnvironmentBasePtr penv, std::istream& sinput);
 void DestroyViewerRecordingStaticResources();
 #endif
+ModuleBasePtr CreateTraceLogger(EnvironmentBasePtr penv, std::istream& sinput);
+ModuleBasePtr CreateStateRecorder(EnvironmentBasePtr penv, std::istream& sinput);
+ModuleBasePtr CreateStatePlayer(EnvironmentBasePtr penv, std::istream& sinput);
+ModuleBasePtr CreateProfiler(EnvironmentBasePtr penv, std::istream& sinput);
+CollisionCheckerBasePtr CreateTraceCollisionChecker(EnvironmentBasePtr penv, std::istream& sinput);
 
 InterfaceBasePtr CreateInterfaceValidated(InterfaceType type, const std::string& interfacename, std::istream& sinput, EnvironmentBasePtr penv)
 {
@@ -32,6 +37,23 @@ InterfaceBasePtr CreateInterfaceValidated(InterfaceType type, const std::string&
             return CreateViewerRecorder(penv,sinput);
         }
 #endif
+        if( interfacename == "tracelogger" ) {
+            return CreateTraceLogger(penv,sinput);
+        }
+        else if( interfacename == "staterecorder" ) {
+            return CreateStateRecorder(penv,sinput);
+        }
+        else if( interfacename == "stateplayer" ) {
+            return CreateStatePlayer(penv,sinput);
+        }
+        else if( interfacename == "profiler" ) {
+            return CreateProfiler(penv,sinput);
+        }
+        break;
+    case OpenRAVE::PT_CollisionChecker:
+        if( interfacename == "tracecollisionchecker" ) {
+            return CreateTraceCollisionChecker(penv,sinput);
+        }
         break;
     default:
         break;
@@ -44,6 +66,11 @@ void GetPluginAttributesValidated(PLUGININFO& info)
 #ifdef ENABLE_VIDEORECORDING
     info.interfacenames[OpenRAVE::PT_Module].push_back("ViewerRecorder");
 #endif
+    info.interfacenames[OpenRAVE::PT_Module].push_back("TraceLogger");
+    info.interfacenames[OpenRAVE::PT_Module].push_back("StateRecorder");
+    info.interfacenames[OpenRAVE::PT_Module].push_back("StatePlayer");
+    info.interfacenames[OpenRAVE::PT_Module].push_back("Profiler");
+    info.interfacenames[OpenRAVE::PT_CollisionChecker].push_back("TraceCollisionChecker");
 }
 
 OPENRAVE_PLUGIN_API void DestroyPlugin()
@@ -0,0 +1,104 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2014 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+/// \brief exposes the profiling zones of the environment through commands
+class Profiler : public ModuleBase
+{
+public:
+    Profiler(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nQueries the profiling zones recorded for this environment. Zones are only recorded when OpenRAVE is configured with OPT_PROFILING.";
+        RegisterCommand("Start",boost::bind(&Profiler::_StartCommand,this,_1,_2),
+                        "Starts recording the profiling zones of all environments. Format::\n\n  Start [maxevents]\n\nmaxevents is the number of zone calls kept per thread for WriteChromeTrace (default 0).");
+        RegisterCommand("Stop",boost::bind(&Profiler::_StopCommand,this,_1,_2),
+                        "Stops recording the profiling zones.");
+        RegisterCommand("Reset",boost::bind(&Profiler::_ResetCommand,this,_1,_2),
+                        "Resets the timing counters of this environment.");
+        RegisterCommand("GetProfile",boost::bind(&Profiler::_GetProfileCommand,this,_1,_2),
+                        "Returns the call tree of this environment, one zone per line as: depth name numcalls totaltime selftime. Times are in seconds.");
+        RegisterCommand("WriteChromeTrace",boost::bind(&Profiler::_WriteChromeTraceCommand,this,_1,_2),
+                        "Writes the profile of this environment as Chrome trace JSON. Format::\n\n  WriteChromeTrace filename\n\n");
+        RegisterCommand("IsCompiled",boost::bind(&Profiler::_IsCompiledCommand,this,_1,_2),
+                        "Returns 1 if OpenRAVE was configured with OPT_PROFILING and the zones are recorded, otherwise 0.");
+    }
+
+protected:
+    bool _StartCommand(ostream& sout, istream& sinput)
+    {
+        size_t maxevents = 0;
+        sinput >> maxevents;
+        RaveSetProfiling(true, maxevents);
+        return true;
+    }
+
+    bool _IsCompiledCommand(ostream& sout, istream& sinput)
+    {
+        sout << OPENRAVE_PROFILING;
+        return true;
+    }
+
+    bool _StopCommand(ostream& sout, istream& sinput)
+    {
+        RaveSetProfiling(false);
+        return true;
+    }
+
+    bool _ResetCommand(ostream& sout, istream& sinput)
+    {
+        RaveResetProfile(GetEnv());
+        return true;
+    }
+
+    bool _GetProfileCommand(ostream& sout, istream& sinput)
+    {
+        ProfileNode root;
+        RaveGetProfile(GetEnv(), root);
+        FOREACHC(itchild, root.children) {
+            _WriteNode(sout, *itchild, 0);
+        }
+        return true;
+    }
+
+    bool _WriteChromeTraceCommand(ostream& sout, istream& sinput)
+    {
+        std::string filename;
+        sinput >> filename;
+        if( !sinput ) {
+            return false;
+        }
+        std::ofstream f(filename.c_str());
+        if( !f ) {
+            RAVELOG_WARN_FORMAT("failed to open %s", filename);
+            return false;
+        }
+        RaveWriteProfileChromeTrace(GetEnv(), f);
+        return !!f;
+    }
+
+    void _WriteNode(ostream& sout, const ProfileNode& node, int depth)
+    {
+        sout << depth << " " << node.name << " " << node.numcalls << " " << node.totaltime*1e-9 << " " << node.GetSelfTime()*1e-9 << endl;
+        FOREACHC(itchild, node.children) {
+            _WriteNode(sout, *itchild, depth+1);
+        }
+    }
+};
+
+ModuleBasePtr CreateProfiler(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new Profiler(penv,sinput));
+}
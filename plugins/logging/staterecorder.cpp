@@ -0,0 +1,970 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2011 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+#include <cstring>
+
+#ifdef OPENRAVE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+/** \brief State file layout, all values are in native byte order:
+
+    - 8 byte magic "ORSTATE1", uint32 sizeof(dReal), uint32 reserved
+    - blocks, each a StateBlockHeader followed by payloadsize bytes, zlib compressed if compressed is 1.
+
+    The payload of a block is a sequence of frames. Each frame is uint64 time (us), uint32 number of body records, and the body records.
+    Each body record is int32 body id, uint32 \ref StateChange bits, followed by the data of each set bit in increasing bit order.
+    The first frame of every block is a keyframe holding the full state of all bodies, so blocks can be decoded independently.
+ */
+struct StateBlockHeader
+{
+    uint64_t starttime; ///< time of the keyframe (us)
+    uint64_t endtime; ///< time of the last frame (us)
+    uint32_t payloadsize;
+    uint32_t uncompressedsize;
+    uint32_t numframes;
+    uint32_t compressed;
+};
+
+enum StateChange
+{
+    SC_Name=1, ///< uint32 length, characters
+    SC_Removed=2, ///< body was removed from the environment
+    SC_Transform=4, ///< 7 dReals: rotation quaternion, translation
+    SC_DOFValues=8, ///< uint32 dof, dof dReals
+    SC_DOFValuesDelta=0x10, ///< uint32 number of changed values, each uint32 dof index and dReal value
+    SC_LinkEnable=0x20, ///< uint32 number of links, one uint8 per link
+    SC_Grabbed=0x40, ///< uint32 number of grabbed bodies, each int32 grabbed body id, int32 robot link index, 7 dReals relative transform
+    SC_Snapshot=0x80, ///< uint32 size, a *.orsnap snapshot of the body (see \ref EnvironmentBase::Save). Only written with SC_Removed, so that the player can add the body back.
+    SC_All=SC_Name|SC_Transform|SC_DOFValues|SC_LinkEnable|SC_Grabbed,
+};
+
+static const char s_StateMagic[8] = { 'O', 'R', 'S', 'T', 'A', 'T', 'E', '1' };
+
+/// \brief appends binary values to a buffer
+class StateWriter
+{
+public:
+    StateWriter(std::vector<uint8_t>& data) : _data(data) {
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        size_t offset = _data.size();
+        _data.resize(offset+sizeof(T));
+        memcpy(&_data[offset], &value, sizeof(T));
+    }
+
+    void WriteBytes(const void* p, size_t size) {
+        if( size > 0 ) {
+            size_t offset = _data.size();
+            _data.resize(offset+size);
+            memcpy(&_data[offset], p, size);
+        }
+    }
+
+    void WriteTransform(const Transform& t) {
+        dReal values[7] = { t.rot.x, t.rot.y, t.rot.z, t.rot.w, t.trans.x, t.trans.y, t.trans.z };
+        WriteBytes(values, sizeof(values));
+    }
+
+private:
+    std::vector<uint8_t>& _data;
+};
+
+/// \brief reads binary values from a buffer, throws if reading past the end
+class StateReader
+{
+public:
+    StateReader(const std::vector<uint8_t>& data) : _data(data), _offset(0) {
+    }
+
+    template <typename T>
+    T Read() {
+        T value;
+        ReadBytes(&value, sizeof(T));
+        return value;
+    }
+
+    void ReadBytes(void* p, size_t size) {
+        if( _offset+size > _data.size() ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("state data is truncated at byte %d", _offset, ORE_InvalidState);
+        }
+        if( size > 0 ) {
+            memcpy(p, &_data[_offset], size);
+            _offset += size;
+        }
+    }
+
+    Transform ReadTransform() {
+        dReal values[7];
+        ReadBytes(values, sizeof(values));
+        Transform t;
+        t.rot = Vector(values[0], values[1], values[2], values[3]);
+        t.trans = Vector(values[4], values[5], values[6]);
+        return t;
+    }
+
+    bool IsEnd() const {
+        return _offset >= _data.size();
+    }
+
+private:
+    const std::vector<uint8_t>& _data;
+    size_t _offset;
+};
+
+/// \brief records the state changes of all bodies into a file.
+///
+/// Body change callbacks only mark bodies as changed, the state is read and compared when a frame is recorded. Blocks are compressed and written by a separate thread.
+class StateRecorder : public ModuleBase
+{
+    /// \brief last recorded state of a body
+    struct RecordedBody
+    {
+        RecordedBody() : bodyid(0), changes(SC_All), bremoved(false), updatestamp(0) {
+        }
+        KinBodyWeakPtr pbody;
+        int bodyid;
+        std::string name;
+        uint32_t changes; ///< StateChange bits that might have changed since the last frame
+        bool bremoved;
+        int updatestamp; ///< \see KinBody::GetUpdateStamp, used to detect moves since KinBody::SetTransform does not call the Prop_LinkTransforms callbacks
+        Transform t;
+        std::vector<dReal> vdofvalues;
+        std::vector<uint8_t> venablestates;
+        std::vector<uint8_t> vgrabbed; ///< encoded grabbed bodies
+        std::vector<uint8_t> vsnapshot; ///< snapshot of the body taken when it was removed
+        UserDataPtr enablehandle, grabbedhandle;
+    };
+    typedef boost::shared_ptr<RecordedBody> RecordedBodyPtr;
+
+    struct StateBlock
+    {
+        StateBlockHeader header;
+        std::vector<uint8_t> data;
+    };
+    typedef boost::shared_ptr<StateBlock> StateBlockPtr;
+
+public:
+    StateRecorder(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nRecords the transforms, DOF values, link enable states, and grabbed bodies of all bodies into a compressed binary file that can be replayed with StatePlayer. A frame is recorded every simulation step if the module was added to the environment, and with the Record command. Only bodies that changed since the last frame are stored, and a keyframe with the full state starts a new block every keyframe interval.";
+        RegisterCommand("Start",boost::bind(&StateRecorder::_StartCommand,this,_1,_2),
+                        "Starts recording into a file, overwriting it. Format::\n\n  Start filename [keyframeinterval] [usesimulationtime]\n\nkeyframeinterval is in seconds (default 1). If usesimulationtime is 0, frames are stamped with the real time since starting instead of the simulation time.");
+        RegisterCommand("Stop",boost::bind(&StateRecorder::_StopCommand,this,_1,_2),
+                        "Stops recording and writes the remaining frames.");
+        RegisterCommand("Record",boost::bind(&StateRecorder::_RecordCommand,this,_1,_2),
+                        "Records a frame of the bodies that changed now.");
+        _keyframeinterval = 1000000;
+        _bUseSimulationTime = true;
+        _starttime = 0;
+        _bRecording = false;
+        _bStopWriter = false;
+    }
+    virtual ~StateRecorder() {
+        _Stop();
+    }
+
+    virtual void Destroy() {
+        _Stop();
+        ModuleBase::Destroy();
+    }
+
+    virtual bool SimulationStep(dReal fElapsedTime) {
+        if( _bRecording ) {
+            _RecordFrame();
+        }
+        return false;
+    }
+
+protected:
+    bool _StartCommand(ostream& sout, istream& sinput)
+    {
+        std::string filename;
+        dReal keyframeinterval = 1;
+        int usesimulationtime = 1;
+        sinput >> filename;
+        if( !sinput ) {
+            return false;
+        }
+        sinput >> keyframeinterval >> usesimulationtime;
+        _Stop();
+
+        _file.open(filename.c_str(), ios::out|ios::binary);
+        if( !_file ) {
+            RAVELOG_WARN_FORMAT("failed to open %s", filename);
+            return false;
+        }
+        _snapshotfilename = filename + ".body.orsnap";
+        uint32_t sizes[2] = { sizeof(dReal), 0 };
+        _file.write(s_StateMagic, sizeof(s_StateMagic));
+        _file.write((const char*)sizes, sizeof(sizes));
+
+        EnvironmentMutex::scoped_lock lock(GetEnv()->GetMutex());
+        _keyframeinterval = static_cast<uint64_t>(std::max(keyframeinterval, dReal(0))*1000000);
+        _bUseSimulationTime = usesimulationtime != 0;
+        _starttime = utils::GetMicroTime();
+        _bStopWriter = false;
+        _threadwriter.reset(new boost::thread(boost::bind(&StateRecorder::_WriterThread, this)));
+
+        _handlebodycallback = GetEnv()->RegisterBodyCallback(boost::bind(&StateRecorder::_BodyCallback, this, _1, _2));
+        std::vector<KinBodyPtr> vbodies;
+        GetEnv()->GetBodies(vbodies);
+        FOREACH(itbody, vbodies) {
+            _AddBody(*itbody);
+        }
+        _bRecording = true;
+        _RecordFrame();
+        return true;
+    }
+
+    bool _StopCommand(ostream& sout, istream& sinput)
+    {
+        _Stop();
+        return true;
+    }
+
+    bool _RecordCommand(ostream& sout, istream& sinput)
+    {
+        EnvironmentMutex::scoped_lock lock(GetEnv()->GetMutex());
+        if( !_bRecording ) {
+            return false;
+        }
+        _RecordFrame();
+        return true;
+    }
+
+    void _Stop()
+    {
+        {
+            EnvironmentMutex::scoped_lock lock(GetEnv()->GetMutex());
+            if( !_bRecording ) {
+                return;
+            }
+            _bRecording = false;
+            _handlebodycallback.reset();
+            _FinishBlock();
+            _mapbodies.clear();
+        }
+        {
+            boost::mutex::scoped_lock lock(_mutexwriter);
+            _bStopWriter = true;
+            _condwriter.notify_all();
+        }
+        if( !!_threadwriter ) {
+            _threadwriter->join();
+            _threadwriter.reset();
+        }
+        _file.close();
+    }
+
+    void _BodyCallback(KinBodyPtr pbody, int action)
+    {
+        if( action == 1 ) {
+            _AddBody(pbody);
+        }
+        else {
+            // the environment id is already reset when the remove callback is called, so search by the body
+            FOREACH(it, _mapbodies) {
+                if( !it->second->bremoved && it->second->pbody.lock() == pbody ) {
+                    it->second->bremoved = true;
+                    _SnapshotBody(pbody, it->second->vsnapshot);
+                    it->second->enablehandle.reset();
+                    it->second->grabbedhandle.reset();
+                    break;
+                }
+            }
+        }
+    }
+
+    void _AddBody(KinBodyPtr pbody)
+    {
+        RecordedBodyPtr precord(new RecordedBody());
+        precord->pbody = pbody;
+        precord->bodyid = pbody->GetEnvironmentId();
+        precord->name = pbody->GetName();
+        RecordedBody* p = precord.get();
+        precord->updatestamp = pbody->GetUpdateStamp();
+        precord->enablehandle = pbody->RegisterChangeCallback(KinBody::Prop_LinkEnable, boost::bind(&StateRecorder::_BodyChanged, p, SC_LinkEnable));
+        if( pbody->IsRobot() ) {
+            precord->grabbedhandle = pbody->RegisterChangeCallback(KinBody::Prop_RobotGrabbed, boost::bind(&StateRecorder::_BodyChanged, p, SC_Grabbed));
+        }
+        _mapbodies[precord->bodyid] = precord;
+    }
+
+    /// \brief saves a snapshot of a body that was just removed from the environment
+    void _SnapshotBody(KinBodyPtr pbody, std::vector<uint8_t>& vsnapshot)
+    {
+        // the body is not part of the environment anymore, so save a copy of it from a temporary environment
+        EnvironmentBasePtr penv = GetEnv()->CloneSelf(0);
+        try {
+            KinBodyPtr pcopy;
+            if( pbody->IsRobot() ) {
+                pcopy = RaveCreateRobot(penv, pbody->GetXMLId());
+            }
+            else {
+                pcopy = RaveCreateKinBody(penv, pbody->GetXMLId());
+            }
+            pcopy->Clone(pbody, 0);
+            penv->Add(pcopy, true);
+            AttributesList atts;
+            atts.push_back(std::make_pair(std::string("target"), pcopy->GetName()));
+            penv->Save(_snapshotfilename, EnvironmentBase::SO_Body, atts);
+            std::ifstream f(_snapshotfilename.c_str(), ios::in|ios::binary);
+            vsnapshot.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        }
+        catch(const std::exception& ex) {
+            RAVELOG_WARN_FORMAT("failed to save removed body %s, it cannot be restored by seeking: %s", pbody->GetName()%ex.what());
+            vsnapshot.resize(0);
+        }
+        remove(_snapshotfilename.c_str());
+        penv->Destroy();
+    }
+
+    static void _BodyChanged(RecordedBody* precord, uint32_t changes)
+    {
+        precord->changes |= changes;
+    }
+
+    uint64_t _GetTime()
+    {
+        return _bUseSimulationTime ? GetEnv()->GetSimulationTime() : utils::GetMicroTime()-_starttime;
+    }
+
+    /// \brief records the bodies that changed, assumes the environment is locked
+    void _RecordFrame()
+    {
+        uint64_t curtime = _GetTime();
+        bool bkeyframe = !_block || curtime >= _block->header.starttime+_keyframeinterval || _block->data.size() > (1<<22);
+        if( bkeyframe ) {
+            _FinishBlock();
+            _block.reset(new StateBlock());
+            memset(&_block->header, 0, sizeof(_block->header));
+            _block->header.starttime = curtime;
+            // erase the removed bodies since they are not needed in the keyframe
+            std::map<int, RecordedBodyPtr>::iterator it = _mapbodies.begin();
+            while(it != _mapbodies.end()) {
+                if( it->second->bremoved ) {
+                    _mapbodies.erase(it++);
+                }
+                else {
+                    it->second->changes = SC_All;
+                    ++it;
+                }
+            }
+        }
+
+        StateWriter writer(_block->data);
+        size_t frameoffset = _block->data.size();
+        writer.Write(curtime);
+        writer.Write(uint32_t(0));
+        uint32_t numrecords = 0;
+        std::map<int, RecordedBodyPtr>::iterator it = _mapbodies.begin();
+        while(it != _mapbodies.end()) {
+            RecordedBody& record = *it->second;
+            if( record.bremoved ) {
+                writer.Write(int32_t(record.bodyid));
+                if( record.vsnapshot.size() > 0 ) {
+                    writer.Write(uint32_t(SC_Removed|SC_Snapshot));
+                    writer.Write(uint32_t(record.vsnapshot.size()));
+                    writer.WriteBytes(&record.vsnapshot[0], record.vsnapshot.size());
+                }
+                else {
+                    writer.Write(uint32_t(SC_Removed));
+                }
+                ++numrecords;
+                _mapbodies.erase(it++);
+                continue;
+            }
+            KinBodyPtr pbody = record.pbody.lock();
+            if( !!pbody && pbody->GetUpdateStamp() != record.updatestamp ) {
+                record.updatestamp = pbody->GetUpdateStamp();
+                record.changes |= SC_Transform|SC_DOFValues;
+            }
+            if( record.changes != 0 ) {
+                if( !!pbody && _WriteBody(writer, record, *pbody, bkeyframe) ) {
+                    ++numrecords;
+                }
+                record.changes = 0;
+            }
+            ++it;
+        }
+        memcpy(&_block->data[frameoffset+sizeof(uint64_t)], &numrecords, sizeof(numrecords));
+        _block->header.endtime = curtime;
+        _block->header.numframes++;
+    }
+
+    /// \brief writes the changed state of the body, returns false if nothing changed
+    bool _WriteBody(StateWriter& writer, RecordedBody& record, KinBody& body, bool bkeyframe)
+    {
+        uint32_t changes = 0;
+        if( record.changes & SC_Name ) {
+            changes |= SC_Name;
+        }
+        if( record.changes & SC_Transform ) {
+            Transform t = body.GetTransform();
+            if( bkeyframe || !_IsSameTransform(t, record.t) ) {
+                record.t = t;
+                changes |= SC_Transform;
+            }
+            body.GetDOFValues(_vdofvalues);
+            if( bkeyframe || _vdofvalues.size() != record.vdofvalues.size() ) {
+                record.vdofvalues = _vdofvalues;
+                changes |= SC_DOFValues;
+            }
+            else {
+                _vchangedindices.resize(0);
+                for(size_t i = 0; i < _vdofvalues.size(); ++i) {
+                    if( _vdofvalues[i] != record.vdofvalues[i] ) {
+                        _vchangedindices.push_back(i);
+                    }
+                }
+                if( _vchangedindices.size() > 0 ) {
+                    record.vdofvalues.swap(_vdofvalues);
+                    // index and value pairs are only smaller when less than half the values changed
+                    changes |= 2*_vchangedindices.size() < record.vdofvalues.size() ? SC_DOFValuesDelta : SC_DOFValues;
+                }
+            }
+        }
+        if( record.changes & SC_LinkEnable ) {
+            body.GetLinkEnableStates(_venablestates);
+            if( bkeyframe || _venablestates != record.venablestates ) {
+                record.venablestates.swap(_venablestates);
+                changes |= SC_LinkEnable;
+            }
+        }
+        if( (record.changes & SC_Grabbed) && body.IsRobot() ) {
+            _vgrabbed.resize(0);
+            StateWriter grabbedwriter(_vgrabbed);
+            RobotBase& robot = static_cast<RobotBase&>(body);
+            robot.GetGrabbedInfo(_vgrabbedinfo);
+            grabbedwriter.Write(uint32_t(_vgrabbedinfo.size()));
+            FOREACHC(itinfo, _vgrabbedinfo) {
+                KinBodyPtr pgrabbed = GetEnv()->GetKinBody((*itinfo)->_grabbedname);
+                KinBody::LinkPtr plink = robot.GetLink((*itinfo)->_robotlinkname);
+                grabbedwriter.Write(int32_t(!!pgrabbed ? pgrabbed->GetEnvironmentId() : 0));
+                grabbedwriter.Write(int32_t(!!plink ? plink->GetIndex() : -1));
+                grabbedwriter.WriteTransform((*itinfo)->_trelative);
+            }
+            if( bkeyframe || _vgrabbed != record.vgrabbed ) {
+                record.vgrabbed.swap(_vgrabbed);
+                changes |= SC_Grabbed;
+            }
+        }
+        if( changes == 0 ) {
+            return false;
+        }
+
+        writer.Write(int32_t(record.bodyid));
+        writer.Write(changes);
+        if( changes & SC_Name ) {
+            writer.Write(uint32_t(record.name.size()));
+            writer.WriteBytes(record.name.c_str(), record.name.size());
+        }
+        if( changes & SC_Transform ) {
+            writer.WriteTransform(record.t);
+        }
+        if( changes & SC_DOFValues ) {
+            writer.Write(uint32_t(record.vdofvalues.size()));
+            writer.WriteBytes(record.vdofvalues.size() > 0 ? &record.vdofvalues[0] : NULL, record.vdofvalues.size()*sizeof(dReal));
+        }
+        if( changes & SC_DOFValuesDelta ) {
+            writer.Write(uint32_t(_vchangedindices.size()));
+            FOREACHC(itindex, _vchangedindices) {
+                writer.Write(uint32_t(*itindex));
+                writer.Write(record.vdofvalues[*itindex]);
+            }
+        }
+        if( changes & SC_LinkEnable ) {
+            writer.Write(uint32_t(record.venablestates.size()));
+            writer.WriteBytes(record.venablestates.size() > 0 ? &record.venablestates[0] : NULL, record.venablestates.size());
+        }
+        if( changes & SC_Grabbed ) {
+            writer.WriteBytes(&record.vgrabbed[0], record.vgrabbed.size());
+        }
+        return true;
+    }
+
+    static bool _IsSameTransform(const Transform& t0, const Transform& t1)
+    {
+        return t0.rot.x == t1.rot.x && t0.rot.y == t1.rot.y && t0.rot.z == t1.rot.z && t0.rot.w == t1.rot.w && t0.trans.x == t1.trans.x && t0.trans.y == t1.trans.y && t0.trans.z == t1.trans.z;
+    }
+
+    /// \brief hands the current block to the writer thread
+    void _FinishBlock()
+    {
+        if( !!_block && _block->header.numframes > 0 ) {
+            boost::mutex::scoped_lock lock(_mutexwriter);
+            _listblocks.push_back(_block);
+            _condwriter.notify_all();
+        }
+        _block.reset();
+    }
+
+    void _WriterThread()
+    {
+        std::vector<uint8_t> vcompressed;
+        while(1) {
+            StateBlockPtr block;
+            {
+                boost::mutex::scoped_lock lock(_mutexwriter);
+                while(_listblocks.size() == 0 && !_bStopWriter) {
+                    _condwriter.wait(lock);
+                }
+                if( _listblocks.size() == 0 ) {
+                    break;
+                }
+                block = _listblocks.front();
+                _listblocks.pop_front();
+            }
+            StateBlockHeader header = block->header;
+            header.uncompressedsize = block->data.size();
+            header.payloadsize = block->data.size();
+            header.compressed = 0;
+            const uint8_t* ppayload = block->data.size() > 0 ? &block->data[0] : NULL;
+#ifdef OPENRAVE_HAS_ZLIB
+            uLongf compressedsize = compressBound(block->data.size());
+            vcompressed.resize(compressedsize);
+            if( compress2(&vcompressed[0], &compressedsize, ppayload, block->data.size(), Z_BEST_SPEED) == Z_OK ) {
+                header.payloadsize = compressedsize;
+                header.compressed = 1;
+                ppayload = &vcompressed[0];
+            }
+#endif
+            _file.write((const char*)&header, sizeof(header));
+            _file.write((const char*)ppayload, header.payloadsize);
+            _file.flush();
+        }
+    }
+
+    std::map<int, RecordedBodyPtr> _mapbodies; ///< indexed by environment id, which is never re-used by the environment
+    UserDataPtr _handlebodycallback;
+    std::string _snapshotfilename; ///< temporary file to snapshot removed bodies
+    StateBlockPtr _block; ///< block currently being recorded
+    uint64_t _keyframeinterval; ///< us
+    uint64_t _starttime;
+    bool _bUseSimulationTime;
+    bool _bRecording;
+
+    std::vector<dReal> _vdofvalues;
+    std::vector<size_t> _vchangedindices;
+    std::vector<uint8_t> _venablestates, _vgrabbed;
+    std::vector<RobotBase::GrabbedInfoPtr> _vgrabbedinfo;
+
+    std::ofstream _file;
+    boost::mutex _mutexwriter;
+    boost::condition _condwriter;
+    std::list<StateBlockPtr> _listblocks; ///< blocks waiting to be written
+    bool _bStopWriter;
+    boost::shared_ptr<boost::thread> _threadwriter;
+};
+
+/// \brief restores the environment to any time of a file recorded with StateRecorder
+class StatePlayer : public ModuleBase
+{
+    /// \brief accumulated state of a body while decoding frames
+    struct PlayerBody
+    {
+        PlayerBody() : bremoved(false), bhastransform(false) {
+        }
+        std::string name;
+        bool bremoved, bhastransform;
+        Transform t;
+        std::vector<dReal> vdofvalues;
+        std::vector<uint8_t> venablestates;
+        std::vector< std::pair<int, int> > vgrabbed; ///< grabbed body id and robot link index
+        std::vector<Transform> vgrabbedtransforms;
+        std::vector<uint8_t> vsnapshot;
+    };
+
+    struct BlockIndex
+    {
+        StateBlockHeader header;
+        std::streamoff offset; ///< file offset of the payload
+    };
+
+public:
+    StatePlayer(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nRestores the environment to any time of a file recorded with StateRecorder. Bodies are matched by name, so the environment should contain the same bodies as the recorded one. Recorded bodies that do not exist at the seeked time are removed from the environment and added back when seeking to a time they exist. Bodies removed during the recording are re-created from the snapshot saved when they were removed.";
+        RegisterCommand("Open",boost::bind(&StatePlayer::_OpenCommand,this,_1,_2),
+                        "Opens a recorded file and indexes its blocks. Format::\n\n  Open filename\n\n");
+        RegisterCommand("GetTimeRange",boost::bind(&StatePlayer::_GetTimeRangeCommand,this,_1,_2),
+                        "Returns the time of the first and last recorded frames in seconds.");
+        RegisterCommand("Seek",boost::bind(&StatePlayer::_SeekCommand,this,_1,_2),
+                        "Sets the environment to the state of the last frame recorded at or before the time in seconds. Format::\n\n  Seek time\n\n");
+        _cachedblockindex = -1;
+        _realsize = sizeof(dReal);
+    }
+
+    virtual void Destroy() {
+        _mapremovedbodies.clear();
+        ModuleBase::Destroy();
+    }
+
+protected:
+    bool _OpenCommand(ostream& sout, istream& sinput)
+    {
+        std::string filename;
+        sinput >> filename;
+        if( !sinput ) {
+            return false;
+        }
+        _file.close();
+        _file.clear();
+        _vblocks.resize(0);
+        _cachedblockindex = -1;
+        _snapshotfilename = filename + ".body.orsnap";
+        _file.open(filename.c_str(), ios::in|ios::binary);
+        if( !_file ) {
+            RAVELOG_WARN_FORMAT("failed to open %s", filename);
+            return false;
+        }
+        char magic[8];
+        uint32_t sizes[2];
+        _file.read(magic, sizeof(magic));
+        _file.read((char*)sizes, sizeof(sizes));
+        if( !_file || memcmp(magic, s_StateMagic, sizeof(magic)) != 0 ) {
+            RAVELOG_WARN_FORMAT("%s is not a state file", filename);
+            return false;
+        }
+        _realsize = sizes[0];
+        if( _realsize != sizeof(dReal) ) {
+            RAVELOG_WARN_FORMAT("%s was recorded with %d byte reals, but this build uses %d", filename%_realsize%sizeof(dReal));
+            return false;
+        }
+        while(1) {
+            BlockIndex block;
+            _file.read((char*)&block.header, sizeof(block.header));
+            if( !_file ) {
+                break;
+            }
+            block.offset = _file.tellg();
+            _file.seekg(block.header.payloadsize, ios::cur);
+            if( !_file ) {
+                // the last block can be truncated if the recorder did not stop cleanly
+                break;
+            }
+            _vblocks.push_back(block);
+        }
+        _file.clear();
+        RAVELOG_DEBUG_FORMAT("%s has %d blocks", filename%_vblocks.size());
+
+        // gather the names of all recorded bodies, so seeking knows which environment bodies it is allowed to remove, and the snapshots of the removed ones
+        _setrecordednames.clear();
+        _mapsnapshots.clear();
+        for(size_t iblock = 0; iblock < _vblocks.size(); ++iblock) {
+            if( !_LoadBlock(iblock) ) {
+                _vblocks.resize(iblock);
+                break;
+            }
+            std::map<int, PlayerBody> mapbodies;
+            try {
+                _ReadFrames(_vblocks[iblock].header.endtime, mapbodies);
+            }
+            catch(const std::exception& ex) {
+                RAVELOG_WARN_FORMAT("failed to decode block %d: %s", iblock%ex.what());
+                _vblocks.resize(iblock);
+                break;
+            }
+            FOREACH(itbody, mapbodies) {
+                if( itbody->second.name.size() > 0 ) {
+                    _setrecordednames.insert(itbody->second.name);
+                    if( itbody->second.vsnapshot.size() > 0 ) {
+                        _mapsnapshots[itbody->second.name].swap(itbody->second.vsnapshot);
+                    }
+                }
+            }
+        }
+        return _vblocks.size() > 0;
+    }
+
+    bool _GetTimeRangeCommand(ostream& sout, istream& sinput)
+    {
+        if( _vblocks.size() == 0 ) {
+            return false;
+        }
+        sout << _vblocks.front().header.starttime*1e-6 << " " << _vblocks.back().header.endtime*1e-6;
+        return true;
+    }
+
+    bool _SeekCommand(ostream& sout, istream& sinput)
+    {
+        dReal time = 0;
+        sinput >> time;
+        if( !sinput || _vblocks.size() == 0 ) {
+            return false;
+        }
+        uint64_t seektime = time <= 0 ? 0 : static_cast<uint64_t>(time*1000000+0.5);
+        // find the last block starting at or before the time
+        int blockindex = 0;
+        int low = 0, high = (int)_vblocks.size()-1;
+        while(low <= high) {
+            int mid = (low+high)/2;
+            if( _vblocks[mid].header.starttime <= seektime ) {
+                blockindex = mid;
+                low = mid+1;
+            }
+            else {
+                high = mid-1;
+            }
+        }
+        if( !_LoadBlock(blockindex) ) {
+            return false;
+        }
+
+        std::map<int, PlayerBody> mapbodies;
+        _ReadFrames(seektime, mapbodies);
+
+        EnvironmentMutex::scoped_lock lock(GetEnv()->GetMutex());
+        // remove the recorded bodies that do not exist at this time, and add back the ones removed by earlier seeks that do
+        std::set<std::string> setalivenames;
+        FOREACHC(itbody, mapbodies) {
+            if( !itbody->second.bremoved && itbody->second.name.size() > 0 ) {
+                setalivenames.insert(itbody->second.name);
+            }
+        }
+        FOREACHC(itname, _setrecordednames) {
+            if( setalivenames.find(*itname) == setalivenames.end() ) {
+                KinBodyPtr pbody = GetEnv()->GetKinBody(*itname);
+                if( !!pbody ) {
+                    GetEnv()->Remove(pbody);
+                    _mapremovedbodies[*itname] = pbody;
+                }
+            }
+        }
+        FOREACHC(itname, setalivenames) {
+            std::map<std::string, KinBodyPtr>::iterator itremoved = _mapremovedbodies.find(*itname);
+            if( itremoved != _mapremovedbodies.end() ) {
+                if( !GetEnv()->GetKinBody(*itname) ) {
+                    GetEnv()->Add(itremoved->second);
+                }
+                _mapremovedbodies.erase(itremoved);
+            }
+            else if( !GetEnv()->GetKinBody(*itname) ) {
+                _LoadSnapshot(*itname);
+            }
+        }
+        FOREACHC(itbody, mapbodies) {
+            _RestoreBody(itbody->second, mapbodies);
+        }
+        return true;
+    }
+
+    /// \brief adds a body that was removed during the recording back from its snapshot
+    void _LoadSnapshot(const std::string& name)
+    {
+        std::map<std::string, std::vector<uint8_t> >::const_iterator itsnapshot = _mapsnapshots.find(name);
+        if( itsnapshot == _mapsnapshots.end() ) {
+            RAVELOG_VERBOSE_FORMAT("recorded body %s is not in the environment", name);
+            return;
+        }
+        {
+            std::ofstream f(_snapshotfilename.c_str(), ios::out|ios::binary);
+            f.write((const char*)&itsnapshot->second[0], itsnapshot->second.size());
+        }
+        try {
+            if( !GetEnv()->Load(_snapshotfilename) ) {
+                RAVELOG_WARN_FORMAT("failed to load the snapshot of body %s", name);
+            }
+        }
+        catch(const std::exception& ex) {
+            RAVELOG_WARN_FORMAT("failed to load the snapshot of body %s: %s", name%ex.what());
+        }
+        remove(_snapshotfilename.c_str());
+    }
+
+    /// \brief decodes the frames of the cached block recorded at or before seektime. The keyframe is always decoded.
+    void _ReadFrames(uint64_t seektime, std::map<int, PlayerBody>& mapbodies)
+    {
+        StateReader reader(_vblockdata);
+        bool bkeyframe = true;
+        while(!reader.IsEnd()) {
+            uint64_t frametime = reader.Read<uint64_t>();
+            if( frametime > seektime && !bkeyframe ) {
+                break;
+            }
+            bkeyframe = false;
+            uint32_t numrecords = reader.Read<uint32_t>();
+            for(uint32_t irecord = 0; irecord < numrecords; ++irecord) {
+                int32_t bodyid = reader.Read<int32_t>();
+                _ReadBody(reader, mapbodies[bodyid]);
+            }
+        }
+    }
+
+    bool _LoadBlock(int blockindex)
+    {
+        if( _cachedblockindex == blockindex ) {
+            return true;
+        }
+        const BlockIndex& block = _vblocks.at(blockindex);
+        _vcompressed.resize(block.header.payloadsize);
+        _file.seekg(block.offset);
+        if( block.header.payloadsize > 0 ) {
+            _file.read((char*)&_vcompressed[0], block.header.payloadsize);
+        }
+        if( !_file ) {
+            _file.clear();
+            RAVELOG_WARN_FORMAT("failed to read block %d", blockindex);
+            return false;
+        }
+        if( block.header.compressed ) {
+#ifdef OPENRAVE_HAS_ZLIB
+            _vblockdata.resize(block.header.uncompressedsize);
+            uLongf uncompressedsize = block.header.uncompressedsize;
+            if( uncompress(&_vblockdata[0], &uncompressedsize, &_vcompressed[0], _vcompressed.size()) != Z_OK || uncompressedsize != block.header.uncompressedsize ) {
+                RAVELOG_WARN_FORMAT("failed to uncompress block %d", blockindex);
+                return false;
+            }
+#else
+            RAVELOG_WARN("state file is compressed, but zlib support was not compiled in");
+            return false;
+#endif
+        }
+        else {
+            _vblockdata.swap(_vcompressed);
+        }
+        _cachedblockindex = blockindex;
+        return true;
+    }
+
+    void _ReadBody(StateReader& reader, PlayerBody& body)
+    {
+        uint32_t changes = reader.Read<uint32_t>();
+        if( changes & SC_Name ) {
+            body.name.resize(reader.Read<uint32_t>());
+            if( body.name.size() > 0 ) {
+                reader.ReadBytes(&body.name[0], body.name.size());
+            }
+            body.bremoved = false;
+        }
+        if( changes & SC_Removed ) {
+            body.bremoved = true;
+        }
+        if( changes & SC_Transform ) {
+            body.t = reader.ReadTransform();
+            body.bhastransform = true;
+        }
+        if( changes & SC_DOFValues ) {
+            body.vdofvalues.resize(reader.Read<uint32_t>());
+            if( body.vdofvalues.size() > 0 ) {
+                reader.ReadBytes(&body.vdofvalues[0], body.vdofvalues.size()*sizeof(dReal));
+            }
+        }
+        if( changes & SC_DOFValuesDelta ) {
+            uint32_t numchanged = reader.Read<uint32_t>();
+            for(uint32_t i = 0; i < numchanged; ++i) {
+                uint32_t index = reader.Read<uint32_t>();
+                dReal value = reader.Read<dReal>();
+                if( index < body.vdofvalues.size() ) {
+                    body.vdofvalues[index] = value;
+                }
+            }
+        }
+        if( changes & SC_LinkEnable ) {
+            body.venablestates.resize(reader.Read<uint32_t>());
+            if( body.venablestates.size() > 0 ) {
+                reader.ReadBytes(&body.venablestates[0], body.venablestates.size());
+            }
+        }
+        if( changes & SC_Grabbed ) {
+            uint32_t numgrabbed = reader.Read<uint32_t>();
+            body.vgrabbed.resize(numgrabbed);
+            body.vgrabbedtransforms.resize(numgrabbed);
+            for(uint32_t i = 0; i < numgrabbed; ++i) {
+                body.vgrabbed[i].first = reader.Read<int32_t>();
+                body.vgrabbed[i].second = reader.Read<int32_t>();
+                body.vgrabbedtransforms[i] = reader.ReadTransform();
+            }
+        }
+        if( changes & SC_Snapshot ) {
+            body.vsnapshot.resize(reader.Read<uint32_t>());
+            if( body.vsnapshot.size() > 0 ) {
+                reader.ReadBytes(&body.vsnapshot[0], body.vsnapshot.size());
+            }
+        }
+    }
+
+    void _RestoreBody(const PlayerBody& state, const std::map<int, PlayerBody>& mapbodies)
+    {
+        if( state.bremoved || state.name.size() == 0 ) {
+            return;
+        }
+        KinBodyPtr pbody = GetEnv()->GetKinBody(state.name);
+        if( !pbody ) {
+            RAVELOG_VERBOSE_FORMAT("recorded body %s is not in the environment", state.name);
+            return;
+        }
+        if( state.venablestates.size() == pbody->GetLinks().size() ) {
+            pbody->SetLinkEnableStates(state.venablestates);
+        }
+        if( (int)state.vdofvalues.size() == pbody->GetDOF() ) {
+            if( state.bhastransform ) {
+                pbody->SetDOFValues(state.vdofvalues, state.t, KinBody::CLA_Nothing);
+            }
+            else {
+                pbody->SetDOFValues(state.vdofvalues, KinBody::CLA_Nothing);
+            }
+        }
+        else if( state.bhastransform ) {
+            pbody->SetTransform(state.t);
+        }
+        if( pbody->IsRobot() ) {
+            RobotBasePtr probot = RaveInterfaceCast<RobotBase>(pbody);
+            std::vector<RobotBase::GrabbedInfoConstPtr> vgrabbedinfo;
+            for(size_t i = 0; i < state.vgrabbed.size(); ++i) {
+                std::map<int, PlayerBody>::const_iterator itgrabbed = mapbodies.find(state.vgrabbed[i].first);
+                int linkindex = state.vgrabbed[i].second;
+                if( itgrabbed == mapbodies.end() || linkindex < 0 || linkindex >= (int)probot->GetLinks().size() ) {
+                    continue;
+                }
+                RobotBase::GrabbedInfoPtr pinfo(new RobotBase::GrabbedInfo());
+                pinfo->_grabbedname = itgrabbed->second.name;
+                pinfo->_robotlinkname = probot->GetLinks()[linkindex]->GetName();
+                pinfo->_trelative = state.vgrabbedtransforms[i];
+                vgrabbedinfo.push_back(pinfo);
+            }
+            probot->ResetGrabbed(vgrabbedinfo);
+        }
+    }
+
+    std::ifstream _file;
+    std::vector<BlockIndex> _vblocks;
+    std::vector<uint8_t> _vcompressed, _vblockdata; ///< payload of the cached block
+    int _cachedblockindex;
+    uint32_t _realsize;
+    std::set<std::string> _setrecordednames; ///< names of all bodies in the file
+    std::map<std::string, std::vector<uint8_t> > _mapsnapshots; ///< snapshots of the bodies removed during the recording
+    std::map<std::string, KinBodyPtr> _mapremovedbodies; ///< bodies removed by seeking, added back when seeking to a time they exist
+    std::string _snapshotfilename; ///< temporary file to load snapshots from
+};
+
+ModuleBasePtr CreateStateRecorder(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new StateRecorder(penv,sinput));
+}
+
+ModuleBasePtr CreateStatePlayer(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new StatePlayer(penv,sinput));
+}
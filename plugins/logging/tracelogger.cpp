@@ -0,0 +1,587 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2011 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "plugindefs.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/atomic.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <cstring>
+
+/** \brief Trace file layout, all values are in native byte order:
+
+    - 8 byte magic "ORTRACE1", uint32 sizeof(dReal), uint32 sizeof(TraceRecordHeader)
+    - records, each a TraceRecordHeader followed by numvalues dReals.
+
+    Records of type 0 define names: nameid is the id used by the other records, value is the number of characters following the header.
+ */
+struct TraceRecordHeader
+{
+    uint16_t type; ///< \ref TraceEventType or 0 for name definitions
+    uint16_t numvalues;
+    uint32_t threadid; ///< hash of the thread id that recorded the event
+    uint64_t timestamp; ///< nanoseconds since tracing started
+    uint64_t duration; ///< nanoseconds
+    int32_t value;
+    uint32_t nameid;
+};
+
+static const char s_TraceMagic[8] = { 'O', 'R', 'T', 'R', 'A', 'C', 'E', '1' };
+
+/// \brief ring buffer of the events of one thread. The thread is the only producer and the writer thread the only consumer, so neither locks.
+class TraceThreadBuffer
+{
+public:
+    TraceThreadBuffer(size_t capacity) : bClosed(false), _data(capacity), _head(0), _tail(0), _numdropped(0) {
+        threadid = static_cast<uint32_t>(boost::hash<boost::thread::id>()(boost::this_thread::get_id()));
+    }
+
+    /// \brief appends a record, returns the number of bytes waiting to be written or 0 if the record was dropped. Only called by the owning thread.
+    size_t Push(const TraceRecordHeader& header, const dReal* pvalues, size_t valuessize)
+    {
+        size_t head = _head.load(boost::memory_order_relaxed);
+        size_t tail = _tail.load(boost::memory_order_acquire);
+        size_t recordsize = sizeof(header)+valuessize;
+        if( head-tail+recordsize > _data.size() ) {
+            // writer cannot keep up, so drop the event rather than slow down planning
+            _numdropped.fetch_add(1, boost::memory_order_relaxed);
+            return 0;
+        }
+        _Copy(head, (const uint8_t*)&header, sizeof(header));
+        if( valuessize > 0 ) {
+            _Copy(head+sizeof(header), (const uint8_t*)pvalues, valuessize);
+        }
+        _head.store(head+recordsize, boost::memory_order_release);
+        return head+recordsize-tail;
+    }
+
+    /// \brief moves all complete records to the end of vdata. Only called by the writer thread.
+    void Pop(std::vector<uint8_t>& vdata)
+    {
+        size_t tail = _tail.load(boost::memory_order_relaxed);
+        size_t head = _head.load(boost::memory_order_acquire);
+        if( head == tail ) {
+            return;
+        }
+        size_t offset = vdata.size(), numbytes = head-tail;
+        vdata.resize(offset+numbytes);
+        size_t start = tail % _data.size(), first = std::min(numbytes, _data.size()-start);
+        memcpy(&vdata[offset], &_data[start], first);
+        if( first < numbytes ) {
+            memcpy(&vdata[offset+first], &_data[0], numbytes-first);
+        }
+        _tail.store(head, boost::memory_order_release);
+    }
+
+    uint64_t GetNumDropped() const {
+        return _numdropped.load(boost::memory_order_relaxed);
+    }
+
+    std::map<std::string, uint32_t> mapnameids; ///< names already assigned an id, so the global name table does not have to be locked. Only used by the owning thread.
+    uint32_t threadid;
+    boost::atomic<bool> bClosed; ///< set when the handler stopped, so the owning thread can release the buffer
+
+private:
+    void _Copy(size_t pos, const uint8_t* psrc, size_t numbytes)
+    {
+        size_t start = pos % _data.size(), first = std::min(numbytes, _data.size()-start);
+        memcpy(&_data[start], psrc, first);
+        if( first < numbytes ) {
+            memcpy(&_data[0], psrc+first, numbytes-first);
+        }
+    }
+
+    std::vector<uint8_t> _data;
+    boost::atomic<size_t> _head, _tail; ///< total bytes written and read, only ever increase
+    boost::atomic<uint64_t> _numdropped;
+};
+typedef boost::shared_ptr<TraceThreadBuffer> TraceThreadBufferPtr;
+
+/// \brief buffers of the calling thread for every handler it has traced into, keyed by the handler id
+typedef std::vector< std::pair<uint64_t, TraceThreadBufferPtr> > TraceThreadBuffers;
+static boost::thread_specific_ptr<TraceThreadBuffers> s_threadbuffers;
+static boost::atomic<uint64_t> s_nexthandlerid(1);
+
+/// \brief buffers trace events of all threads and writes them to a file from a separate thread
+class TraceLogHandler : public TraceHandlerBase
+{
+public:
+    TraceLogHandler(const std::string& filename, size_t maxslotsize) : _id(s_nexthandlerid.fetch_add(1)), _maxslotsize(maxslotsize), _flushsize(maxslotsize/2), _numrecords(0), _numbytes(0), _bStop(false)
+    {
+        _file.open(filename.c_str(), ios::out|ios::binary);
+        if( !_file ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("failed to open trace file %s", filename, ORE_InvalidArguments);
+        }
+        uint32_t sizes[2] = { sizeof(dReal), sizeof(TraceRecordHeader) };
+        _file.write(s_TraceMagic, sizeof(s_TraceMagic));
+        _file.write((const char*)sizes, sizeof(sizes));
+        _starttime = utils::GetNanoPerformanceTime();
+        _threadwriter.reset(new boost::thread(boost::bind(&TraceLogHandler::_WriterThread, this)));
+    }
+
+    virtual ~TraceLogHandler() {
+        Stop();
+    }
+
+    /// \brief stops the writer thread and writes all remaining events
+    void Stop()
+    {
+        {
+            boost::mutex::scoped_lock lock(_mutexflush);
+            _bStop = true;
+            _condflush.notify_all();
+        }
+        if( !!_threadwriter ) {
+            _threadwriter->join();
+            _threadwriter.reset();
+        }
+        boost::mutex::scoped_lock lock(_mutexbuffers);
+        FOREACH(itbuffer, _vbuffers) {
+            (*itbuffer)->bClosed = true;
+        }
+    }
+
+    virtual void TraceEvent(TraceEventType type, const std::string& name, int value, uint64_t duration, const dReal* pvalues, size_t numvalues)
+    {
+        TraceThreadBuffer& buffer = _GetThreadBuffer();
+        TraceRecordHeader header;
+        header.type = static_cast<uint16_t>(type);
+        header.numvalues = static_cast<uint16_t>(std::min(numvalues, size_t(0xffff)));
+        header.threadid = buffer.threadid;
+        header.timestamp = utils::GetNanoPerformanceTime()-_starttime;
+        header.duration = duration;
+        header.value = value;
+        header.nameid = _GetNameId(buffer, name);
+        if( buffer.Push(header, pvalues, header.numvalues*sizeof(dReal)) >= _flushsize ) {
+            _condflush.notify_all();
+        }
+    }
+
+    void GetStatistics(uint64_t& numrecords, uint64_t& numbytes, uint64_t& numdropped)
+    {
+        {
+            boost::mutex::scoped_lock lock(_mutexflush);
+            numrecords = _numrecords;
+            numbytes = _numbytes;
+        }
+        numdropped = 0;
+        boost::mutex::scoped_lock lock(_mutexbuffers);
+        FOREACH(itbuffer, _vbuffers) {
+            numdropped += (*itbuffer)->GetNumDropped();
+        }
+    }
+
+protected:
+    /// \brief returns the buffer of the calling thread, only locks the first time a thread traces into this handler
+    TraceThreadBuffer& _GetThreadBuffer()
+    {
+        TraceThreadBuffers* pbuffers = s_threadbuffers.get();
+        if( !pbuffers ) {
+            pbuffers = new TraceThreadBuffers();
+            s_threadbuffers.reset(pbuffers);
+        }
+        FOREACH(itbuffer, *pbuffers) {
+            if( itbuffer->first == _id ) {
+                return *itbuffer->second;
+            }
+        }
+        // release the buffers of stopped handlers
+        size_t index = 0;
+        for(size_t i = 0; i < pbuffers->size(); ++i) {
+            if( !(*pbuffers)[i].second->bClosed ) {
+                (*pbuffers)[index++] = (*pbuffers)[i];
+            }
+        }
+        pbuffers->resize(index);
+        TraceThreadBufferPtr pbuffer(new TraceThreadBuffer(_maxslotsize));
+        {
+            boost::mutex::scoped_lock lock(_mutexbuffers);
+            _vbuffers.push_back(pbuffer);
+        }
+        pbuffers->push_back(std::make_pair(_id, pbuffer));
+        return *pbuffer;
+    }
+
+    /// \brief returns the id of the name, only locks the first time the thread uses the name
+    uint32_t _GetNameId(TraceThreadBuffer& buffer, const std::string& name)
+    {
+        std::map<std::string, uint32_t>::iterator it = buffer.mapnameids.find(name);
+        if( it != buffer.mapnameids.end() ) {
+            return it->second;
+        }
+        uint32_t nameid;
+        {
+            boost::mutex::scoped_lock lock(_mutexnames);
+            std::map<std::string, uint32_t>::iterator itglobal = _mapnameids.find(name);
+            if( itglobal != _mapnameids.end() ) {
+                nameid = itglobal->second;
+            }
+            else {
+                nameid = _mapnameids.size();
+                _mapnameids[name] = nameid;
+                TraceRecordHeader header;
+                memset(&header, 0, sizeof(header));
+                header.value = name.size();
+                header.nameid = nameid;
+                size_t offset = _vnamedata.size();
+                _vnamedata.resize(offset+sizeof(header)+name.size());
+                memcpy(&_vnamedata[offset], &header, sizeof(header));
+                if( name.size() > 0 ) {
+                    memcpy(&_vnamedata[offset+sizeof(header)], name.c_str(), name.size());
+                }
+            }
+        }
+        buffer.mapnameids[name] = nameid;
+        return nameid;
+    }
+
+    void _WriterThread()
+    {
+        bool bStop = false;
+        while(!bStop) {
+            {
+                boost::mutex::scoped_lock lock(_mutexflush);
+                if( !_bStop ) {
+                    _condflush.timed_wait(lock, boost::posix_time::milliseconds(100));
+                }
+                bStop = _bStop;
+            }
+            _Flush();
+        }
+        _file.flush();
+    }
+
+    void _Flush()
+    {
+        // take out the records of all buffers first, then write the names, so that every name is written before the records using it
+        {
+            boost::mutex::scoped_lock lock(_mutexbuffers);
+            _vflushbuffers = _vbuffers;
+        }
+        FOREACH(itbuffer, _vflushbuffers) {
+            (*itbuffer)->Pop(_vflushdata);
+        }
+        {
+            boost::mutex::scoped_lock lock(_mutexnames);
+            _vnameflushdata.swap(_vnamedata);
+        }
+        uint64_t numrecords = 0, numbytes = 0;
+        if( _vnameflushdata.size() > 0 ) {
+            _file.write((const char*)&_vnameflushdata[0], _vnameflushdata.size());
+            numbytes += _vnameflushdata.size();
+            _vnameflushdata.resize(0);
+        }
+        if( _vflushdata.size() > 0 ) {
+            // count the records
+            size_t offset = 0;
+            while(offset < _vflushdata.size()) {
+                const TraceRecordHeader* pheader = (const TraceRecordHeader*)&_vflushdata[offset];
+                offset += sizeof(TraceRecordHeader)+pheader->numvalues*sizeof(dReal);
+                ++numrecords;
+            }
+            _file.write((const char*)&_vflushdata[0], _vflushdata.size());
+            numbytes += _vflushdata.size();
+            _vflushdata.resize(0);
+        }
+        boost::mutex::scoped_lock lock(_mutexflush);
+        _numrecords += numrecords;
+        _numbytes += numbytes;
+    }
+
+    std::ofstream _file;
+    uint64_t _id; ///< unique id to find the buffers of this handler in the calling threads
+    uint64_t _starttime;
+    size_t _maxslotsize, _flushsize;
+
+    boost::mutex _mutexbuffers; ///< protects _vbuffers
+    std::vector<TraceThreadBufferPtr> _vbuffers; ///< buffers of every thread that traced into this handler
+    std::vector<TraceThreadBufferPtr> _vflushbuffers; ///< only used by the writer thread
+    std::vector<uint8_t> _vflushdata; ///< only used by the writer thread
+
+    boost::mutex _mutexnames; ///< protects _mapnameids and _vnamedata
+    std::map<std::string, uint32_t> _mapnameids;
+    std::vector<uint8_t> _vnamedata, _vnameflushdata;
+
+    boost::mutex _mutexflush;
+    boost::condition _condflush;
+    uint64_t _numrecords, _numbytes;
+    bool _bStop;
+    boost::shared_ptr<boost::thread> _threadwriter;
+};
+
+typedef boost::shared_ptr<TraceLogHandler> TraceLogHandlerPtr;
+
+class TraceLogger : public ModuleBase
+{
+public:
+    TraceLogger(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nRecords planner iterations, collision queries, ik calls, and constraint failures into a compact binary file without going through the text logging. Events are buffered by the calling threads and written by a separate thread. Collision queries are only recorded when the environment uses a TraceCollisionChecker. Use openravepy.misc.LoadTraceLog to decode the file. Only one trace can be recorded at a time.";
+        RegisterCommand("Start",boost::bind(&TraceLogger::_StartCommand,this,_1,_2),
+                        "Starts tracing into a file, overwriting it. Format::\n\n  Start filename [maxbuffersize]\n\nmaxbuffersize is the number of bytes buffered for each thread before events are dropped.");
+        RegisterCommand("Stop",boost::bind(&TraceLogger::_StopCommand,this,_1,_2),
+                        "Stops tracing and writes the remaining events.");
+        RegisterCommand("GetStatistics",boost::bind(&TraceLogger::_GetStatisticsCommand,this,_1,_2),
+                        "Returns the number of records and bytes written, and the number of dropped events: [numrecords] [numbytes] [numdropped]");
+        _numrecords = _numbytes = _numdropped = 0;
+    }
+    virtual ~TraceLogger() {
+        _Stop();
+    }
+
+    virtual void Destroy() {
+        _Stop();
+        ModuleBase::Destroy();
+    }
+
+protected:
+    bool _StartCommand(ostream& sout, istream& sinput)
+    {
+        std::string filename;
+        size_t maxbuffersize = 1<<20;
+        sinput >> filename;
+        if( !sinput ) {
+            return false;
+        }
+        sinput >> maxbuffersize;
+        _Stop();
+        if( !!RaveGetTraceHandler() ) {
+            RAVELOG_WARN("another trace handler is already set\n");
+            return false;
+        }
+        _handler.reset(new TraceLogHandler(filename, std::max(maxbuffersize, size_t(1024))));
+        RaveSetTraceHandler(_handler);
+        RAVELOG_DEBUG_FORMAT("tracing to %s", filename);
+        return true;
+    }
+
+    bool _StopCommand(ostream& sout, istream& sinput)
+    {
+        _Stop();
+        return true;
+    }
+
+    bool _GetStatisticsCommand(ostream& sout, istream& sinput)
+    {
+        uint64_t numrecords = 0, numbytes = 0, numdropped = 0;
+        if( !!_handler ) {
+            _handler->GetStatistics(numrecords, numbytes, numdropped);
+        }
+        else {
+            numrecords = _numrecords;
+            numbytes = _numbytes;
+            numdropped = _numdropped;
+        }
+        sout << numrecords << " " << numbytes << " " << numdropped;
+        return true;
+    }
+
+    void _Stop()
+    {
+        if( !!_handler ) {
+            if( RaveGetTraceHandler() == _handler ) {
+                RaveSetTraceHandler(TraceHandlerBasePtr());
+            }
+            _handler->Stop();
+            _handler->GetStatistics(_numrecords, _numbytes, _numdropped);
+            _handler.reset();
+        }
+    }
+
+    TraceLogHandlerPtr _handler;
+    uint64_t _numrecords, _numbytes, _numdropped; ///< statistics of the last trace
+};
+
+/// \brief times a collision query and reports it to the trace handler when going out of scope
+class CollisionQueryTracer
+{
+public:
+    CollisionQueryTracer(const std::string& name) : _name(name), _tracer(RaveGetTraceHandler()), _starttime(0), _bCollision(false) {
+        if( !!_tracer ) {
+            _starttime = utils::GetNanoPerformanceTime();
+        }
+    }
+    ~CollisionQueryTracer() {
+        if( !!_tracer ) {
+            _tracer->TraceEvent(TET_CollisionQuery, _name, _bCollision, utils::GetNanoPerformanceTime()-_starttime);
+        }
+    }
+
+    /// \brief records the result and returns it
+    bool operator()(bool bCollision) {
+        _bCollision = bCollision;
+        return bCollision;
+    }
+
+private:
+    const std::string& _name;
+    TraceHandlerBasePtr _tracer;
+    uint64_t _starttime;
+    bool _bCollision;
+};
+
+/// \brief forwards all queries to another collision checker and traces them
+class TraceCollisionChecker : public CollisionCheckerBase
+{
+public:
+    TraceCollisionChecker(EnvironmentBasePtr penv, std::istream& sinput) : CollisionCheckerBase(penv)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nForwards all queries to the collision checker given as the first argument (default is ode) and records them with their timings while a trace is running. See the TraceLogger module.";
+        std::string collisionname="ode";
+        sinput >> collisionname;
+        _pintchecker = RaveCreateCollisionChecker(GetEnv(), collisionname);
+        OPENRAVE_ASSERT_FORMAT(!!_pintchecker, "internal checker %s is not valid", collisionname, ORE_Assert);
+    }
+
+    virtual bool SetCollisionOptions(int collisionoptions) {
+        return _pintchecker->SetCollisionOptions(collisionoptions);
+    }
+
+    virtual int GetCollisionOptions() const {
+        return _pintchecker->GetCollisionOptions();
+    }
+
+    virtual void SetTolerance(dReal tolerance) {
+        _pintchecker->SetTolerance(tolerance);
+    }
+
+    virtual void SetGeometryGroup(const std::string& groupname) {
+        _pintchecker->SetGeometryGroup(groupname);
+    }
+
+    virtual const std::string& GetGeometryGroup() const {
+        return _pintchecker->GetGeometryGroup();
+    }
+
+    virtual bool InitEnvironment() {
+        return _pintchecker->InitEnvironment();
+    }
+
+    virtual void DestroyEnvironment() {
+        if( !!_pintchecker ) {
+            _pintchecker->DestroyEnvironment();
+        }
+    }
+
+    virtual void Clone(InterfaceBaseConstPtr preference, int cloningoptions)
+    {
+        CollisionCheckerBase::Clone(preference, cloningoptions);
+        boost::shared_ptr<TraceCollisionChecker const> clone = boost::dynamic_pointer_cast<TraceCollisionChecker const> (preference);
+        DestroyEnvironment();
+        _pintchecker = RaveCreateCollisionChecker(GetEnv(),clone->_pintchecker->GetXMLId());
+        _pintchecker->Clone(clone->_pintchecker,cloningoptions);
+        _pintchecker->InitEnvironment();
+    }
+
+    virtual bool InitKinBody(KinBodyPtr pbody) {
+        return _pintchecker->InitKinBody(pbody);
+    }
+
+    virtual void RemoveKinBody(KinBodyPtr pbody) {
+        _pintchecker->RemoveKinBody(pbody);
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody1, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(pbody1->GetName());
+        return trace(_pintchecker->CheckCollision(pbody1, report));
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(pbody1->GetName());
+        return trace(_pintchecker->CheckCollision(pbody1, pbody2, report));
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(plink->GetName());
+        return trace(_pintchecker->CheckCollision(plink, report));
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(plink1->GetName());
+        return trace(_pintchecker->CheckCollision(plink1, plink2, report));
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(plink->GetName());
+        return trace(_pintchecker->CheckCollision(plink, pbody, report));
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(plink->GetName());
+        return trace(_pintchecker->CheckCollision(plink, vbodyexcluded, vlinkexcluded, report));
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(pbody->GetName());
+        return trace(_pintchecker->CheckCollision(pbody, vbodyexcluded, vlinkexcluded, report));
+    }
+
+    virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(plink->GetName());
+        return trace(_pintchecker->CheckCollision(ray, plink, report));
+    }
+
+    virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(pbody->GetName());
+        return trace(_pintchecker->CheckCollision(ray, pbody, report));
+    }
+
+    virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(s_RayName);
+        return trace(_pintchecker->CheckCollision(ray, report));
+    }
+
+    virtual int CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly=false) {
+        CollisionQueryTracer trace(!!pbody ? pbody->GetName() : s_RayName);
+        int numcollisions = _pintchecker->CheckCollisionRays(prays, nrays, pbody, pcollision, phits, bFrontFacingOnly);
+        trace(numcollisions > 0);
+        return numcollisions;
+    }
+
+    virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(pbody->GetName());
+        return trace(_pintchecker->CheckStandaloneSelfCollision(pbody, report));
+    }
+
+    virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        CollisionQueryTracer trace(plink->GetName());
+        return trace(_pintchecker->CheckStandaloneSelfCollision(plink, report));
+    }
+
+    virtual bool CheckContinuousCollision(KinBodyPtr pbody, const std::vector<int>& vdofindices, const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, dReal fmindistance=1e-4, CollisionReportPtr report = CollisionReportPtr(), dReal* ptimeofimpact = NULL) {
+        CollisionQueryTracer trace(pbody->GetName());
+        return trace(_pintchecker->CheckContinuousCollision(pbody, vdofindices, q0, q1, dq0, dq1, timeelapsed, fmindistance, report, ptimeofimpact));
+    }
+
+protected:
+    static const std::string s_RayName;
+    CollisionCheckerBasePtr _pintchecker;
+};
+
+const std::string TraceCollisionChecker::s_RayName("ray");
+
+ModuleBasePtr CreateTraceLogger(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new TraceLogger(penv,sinput));
+}
+
+CollisionCheckerBasePtr CreateTraceCollisionChecker(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return CollisionCheckerBasePtr(new TraceCollisionChecker(penv,sinput));
+}
@@ -148,6 +148,17 @@ public:
                 }
                 RAVELOG_DEBUG("Setting surface layer depth to: %f\n",_physics->_surfacelayer);
             }
+            else if( name == "autodisable" ) {
+                // bodies that come to rest are not simulated until something touches or moves them
+                _ss >> _physics->_bAutoDisable;
+            }
+            else if( name == "autodisablesteps" ) {
+                int temp=0;
+                _ss >> temp;
+                if (temp > 0) {
+                    _physics->_nAutoDisableSteps = temp;
+                }
+            }
             else {
                 RAVELOG_ERROR("unknown field %s\n", name.c_str());
             }
@@ -170,8 +181,8 @@ public:
             }
         }
 
-        static const boost::array<string, 11>& GetTags() {
-            static const boost::array<string, 11> tags = {{"friction","selfcollision", "gravity", "contact", "erp", "cfm", "elastic_reduction_parameter", "constraint_force_mixing", "dcontactapprox", "numiterations", "surfacelayer" }};
+        static const boost::array<string, 13>& GetTags() {
+            static const boost::array<string, 13> tags = {{"friction","selfcollision", "gravity", "contact", "erp", "cfm", "elastic_reduction_parameter", "constraint_force_mixing", "dcontactapprox", "numiterations", "surfacelayer", "autodisable", "autodisablesteps" }};
             return tags;
         }
 
@@ -187,7 +198,7 @@ public:
         return BaseXMLReaderPtr(new PhysicsPropertiesXMLReader(boost::dynamic_pointer_cast<ODEPhysicsEngine>(ptr),atts));
     }
 
-    ODEPhysicsEngine(OpenRAVE::EnvironmentBasePtr penv) : OpenRAVE::PhysicsEngineBase(penv), _odespace(new ODESpace(penv, "odephysics", true)) {
+    ODEPhysicsEngine(OpenRAVE::EnvironmentBasePtr penv) : OpenRAVE::PhysicsEngineBase(penv), _odespace(new ODESpace(penv, "odephysics", true)), _nNumPendingContacts(0) {
         stringstream ss;
         ss << ":Interface Author: Rosen Diankov\n\nODE physics engine\n\n\
 It is possible to set ODE physics engine and its properties inside the <environment> XML tags by typing:\n\n\
@@ -199,6 +210,7 @@ It is possible to set ODE physics engine and its properties inside the <environm
       <selfcollision>1</selfcollision>\n\
       <dcontactapprox>1</dcontactapprox>\n\
       <numiterations>1</numiterations>\n\
+      <autodisable>1</autodisable>\n\
     </odeproperties>\n\
   </physicsengine>\n\n\
 The possible properties that can be set are: ";
@@ -215,6 +227,8 @@ The possible properties that can be set are: ";
         //enable the friction pyramid model.
         _surface_mode = 0;
         _surfacelayer = 0.001;
+        _bAutoDisable = false;
+        _nAutoDisableSteps = 10;
         _options = OpenRAVE::PEO_SelfCollisions;
 
         memset(_jointadd, 0, sizeof(_jointadd));
@@ -260,6 +274,8 @@ The possible properties that can be set are: ";
         dWorldSetCFM(_odespace->GetWorld(),_globalcfm);
         dWorldSetQuickStepNumIterations (_odespace->GetWorld(), _num_iterations);
         dWorldSetContactSurfaceLayer(_odespace->GetWorld(), _surfacelayer);
+        dWorldSetAutoDisableFlag(_odespace->GetWorld(), _bAutoDisable);
+        dWorldSetAutoDisableSteps(_odespace->GetWorld(), _nAutoDisableSteps);
         return true;
     }
 
@@ -321,10 +337,14 @@ The possible properties that can be set are: ";
         _globalerp = r->_globalerp;
         _surface_mode = r->_surface_mode;
         _num_iterations = r->_num_iterations;
+        _bAutoDisable = r->_bAutoDisable;
+        _nAutoDisableSteps = r->_nAutoDisableSteps;
         if( !!_odespace && _odespace->IsInitialized() ) {
             dWorldSetERP(_odespace->GetWorld(),_globalerp);
             dWorldSetCFM(_odespace->GetWorld(),_globalcfm);
             dWorldSetQuickStepNumIterations (_odespace->GetWorld(), _num_iterations);
+            dWorldSetAutoDisableFlag(_odespace->GetWorld(), _bAutoDisable);
+            dWorldSetAutoDisableSteps(_odespace->GetWorld(), _nAutoDisableSteps);
         }
     }
 
@@ -489,10 +509,29 @@ The possible properties that can be set are: ";
         return _gravity;
     }
 
-    virtual void SimulateStep(OpenRAVE::dReal fTimeElapsed)
+    virtual bool SimulateRollout(PhysicsRollout& rollout)
     {
+        // ODE keeps the sleeping state and idle counters of every body between steps, so wake everything up to start each rollout from the same state
         _odespace->Synchronize();
+        GetEnv()->GetBodies(_vbodies);
+        FOREACHC(itbody, _vbodies) {
+            if( !(*itbody)->IsEnabled() ) {
+                continue;
+            }
+            ODESpace::KinBodyInfoPtr pinfo = _odespace->GetInfo(*itbody);
+            FOREACHC(itlink, pinfo->vlinks) {
+                if( (*itlink)->_bEnabled && !!(*itlink)->body ) {
+                    dBodySetAutoDisableDefaults((*itlink)->body);
+                    dBodyEnable((*itlink)->body);
+                }
+            }
+        }
+        _vbodies.resize(0);
+        return PhysicsEngineBase::SimulateRollout(rollout);
+    }
 
+    virtual void SimulateStep(OpenRAVE::dReal fTimeElapsed)
+    {
         bool bHasCallbacks = GetEnv()->HasRegisteredCollisionCallbacks();
         if( bHasCallbacks ) {
             GetEnv()->GetRegisteredCollisionCallbacks(_listcallbacks);
@@ -501,54 +540,95 @@ The possible properties that can be set are: ";
             _listcallbacks.clear();
         }
 
-        dSpaceCollide (_odespace->GetSpace(),this,nearCallback);
+        {
+#ifndef ODE_USE_MULTITHREAD
+            // ODE collision detection uses global data, so only the world stepping can run in parallel with other environments (see RaveSimulatePhysicsRollouts).
+            // The contacts are only gathered while locked, user collision callbacks can call the ode collision checker.
+            boost::mutex::scoped_lock lockcollision(_mutexode);
+#endif
+            _odespace->Synchronize();
+            dSpaceCollide (_odespace->GetSpace(),this,nearCallback);
+        }
+        _ProcessContacts();
 
-        vector<KinBodyPtr> vbodies;
-        GetEnv()->GetBodies(vbodies);
+        // disabled bodies and bodies put to sleep by ODE are not moved by this step, so skip them when colliding and copying the results back
+        GetEnv()->GetBodies(_vbodies);
+        _vbodyinfos.resize(_vbodies.size());
+        _vbodyawake.resize(_vbodies.size());
+        for(size_t ibody = 0; ibody < _vbodies.size(); ++ibody) {
+            _vbodyinfos[ibody] = _odespace->GetInfo(_vbodies[ibody]);
+            _vbodyawake[ibody] = _vbodies[ibody]->IsEnabled() && _IsAwake(*_vbodyinfos[ibody]);
+        }
 
         if( _options & OpenRAVE::PEO_SelfCollisions ) {
-            FOREACHC(itbody, vbodies) {
-                if( (*itbody)->GetLinks().size() > 1 ) {
-                    // more than one link, check collision
-                    dSpaceCollide(_odespace->GetBodySpace(*itbody), this, nearCallback);
+            {
+#ifndef ODE_USE_MULTITHREAD
+                boost::mutex::scoped_lock lockcollision(_mutexode);
+#endif
+                for(size_t ibody = 0; ibody < _vbodies.size(); ++ibody) {
+                    if( _vbodyawake[ibody] && _vbodies[ibody]->GetLinks().size() > 1 ) {
+                        // more than one link, check collision
+                        dSpaceCollide(_vbodyinfos[ibody]->space, this, nearCallback);
+                    }
                 }
             }
+            _ProcessContacts();
         }
 
         dWorldQuickStep(_odespace->GetWorld(), fTimeElapsed);
         dJointGroupEmpty (_odespace->GetContactGroup());
 
         // synchronize all the objects from the ODE world to the OpenRAVE world
-        Transform t;
-        FOREACHC(itbody, vbodies) {
-            ODESpace::KinBodyInfoPtr pinfo = _odespace->GetInfo(*itbody);
-            BOOST_ASSERT( pinfo->vlinks.size() == (*itbody)->GetLinks().size());
-            if( (*itbody)->IsEnabled() ) {
-                vector<Transform> vtrans(pinfo->vlinks.size());
+        for(size_t ibody = 0; ibody < _vbodies.size(); ++ibody) {
+            KinBodyPtr pbody = _vbodies[ibody];
+            ODESpace::KinBodyInfoPtr pinfo = _vbodyinfos[ibody];
+            BOOST_ASSERT( pinfo->vlinks.size() == pbody->GetLinks().size());
+            if( pbody->IsEnabled() ) {
+                if( !_vbodyawake[ibody] ) {
+                    // nothing moved
+                    pinfo->nLastStamp = pbody->GetUpdateStamp();
+                    continue;
+                }
+                vector<Transform>& vtrans = pinfo->_vtranscache;
+                vtrans.resize(pinfo->vlinks.size());
                 for(size_t i = 0; i < pinfo->vlinks.size(); ++i) {
                     const dReal* prot = dBodyGetQuaternion(pinfo->vlinks[i]->body);
                     Vector vrot(prot[0],prot[1],prot[2],prot[3]);
                     if( vrot.lengthsqr4() == 0 ) {
-                        RAVELOG_ERROR(str(boost::format("odephysics in body %s is returning invalid rotation!")%(*itbody)->GetName()));
+                        RAVELOG_ERROR(str(boost::format("odephysics in body %s is returning invalid rotation!")%pbody->GetName()));
                         continue;
                     }
                     const dReal* ptrans = dBodyGetPosition(pinfo->vlinks[i]->body);
-                    vtrans.at(i) = Transform(vrot,Vector(ptrans[0],ptrans[1],ptrans[2])) * pinfo->vlinks[i]->tlinkmassinv;
+                    vtrans[i] = Transform(vrot,Vector(ptrans[0],ptrans[1],ptrans[2])) * pinfo->vlinks[i]->tlinkmassinv;
                 }
-                (*itbody)->SetLinkTransformations(vtrans,pinfo->_vdofbranches);
-                pinfo->nLastStamp = (*itbody)->GetUpdateStamp();
+                pbody->SetLinkTransformations(vtrans,pinfo->_vdofbranches);
+                pinfo->nLastStamp = pbody->GetUpdateStamp();
             }
             else {
                 // the body isn't enabled, so set a different timestamp in order for physics to synchornize it on the next run.
-                pinfo->nLastStamp = (*itbody)->GetUpdateStamp()-1;
+                pinfo->nLastStamp = pbody->GetUpdateStamp()-1;
             }
         }
 
+        // do not hold on to the bodies in case they are removed from the environment
+        _vbodies.resize(0);
+        _vbodyinfos.resize(0);
         _listcallbacks.clear();
     }
 
 
 private:
+    /// \brief returns true if at least one of the dynamic links of the body is simulated by ODE
+    static bool _IsAwake(const ODESpace::KinBodyInfo& info)
+    {
+        FOREACHC(itlink, info.vlinks) {
+            if( (*itlink)->_bEnabled && !!(*itlink)->body && dBodyIsEnabled((*itlink)->body) ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     static void nearCallback(void *data, dGeomID o1, dGeomID o2)
     {
         ((ODEPhysicsEngine*)data)->_nearCallback(o1,o2);
@@ -601,22 +681,50 @@ private:
                 return;
         }
 
-        const int N = 16;
-        dContact contact[N];
-        int n = dCollide (o1,o2,N,&contact[0].geom,sizeof(dContact));
-        if( n <= 0 ) {
+        if( _nNumPendingContacts >= _vpendingcontacts.size() ) {
+            _vpendingcontacts.resize(_nNumPendingContacts+1);
+        }
+        PendingContacts& pending = _vpendingcontacts[_nNumPendingContacts];
+        pending.ncontacts = dCollide (o1,o2,PendingContacts::MAX_CONTACTS,&pending.contacts[0].geom,sizeof(dContact));
+        if( pending.ncontacts <= 0 ) {
             return;
         }
+        pending.b1 = b1;
+        pending.b2 = b2;
+        pending.checkgeom1 = dGeomGetClass(o1) == dGeomTransformClass ? dGeomTransformGetGeom(o1) : o1;
+        pending.plink1 = pkb1;
+        pending.plink2 = pkb2;
+        ++_nNumPendingContacts;
+    }
 
+    /// \brief calls the collision callbacks for the contacts gathered by _nearCallback and adds the contact joints to the world.
+    ///
+    /// Has to be called without holding _mutexode since the callbacks can check collisions.
+    void _ProcessContacts()
+    {
+        for(size_t ipending = 0; ipending < _nNumPendingContacts; ++ipending) {
+            _ProcessPendingContacts(ipending);
+            _vpendingcontacts[ipending].plink1.reset();
+            _vpendingcontacts[ipending].plink2.reset();
+        }
+        _nNumPendingContacts = 0;
+    }
+
+    void _ProcessPendingContacts(size_t ipending)
+    {
+        PendingContacts& pending = _vpendingcontacts[ipending];
+        dBodyID b1 = pending.b1, b2 = pending.b2;
+        KinBody::LinkPtr pkb1 = pending.plink1, pkb2 = pending.plink2;
+        dContact* contact = pending.contacts;
+        int n = pending.ncontacts;
         if( _listcallbacks.size() > 0 ) {
             // fill the collision report
             _report->Reset(OpenRAVE::CO_Contacts);
             _report->plink1 = pkb1;
             _report->plink2 = pkb2;
 
-            dGeomID checkgeom1 = dGeomGetClass(o1) == dGeomTransformClass ? dGeomTransformGetGeom(o1) : o1;
             for(int i = 0; i < n; ++i) {
-                _report->contacts.push_back(CollisionReport::CONTACT(contact[i].geom.pos, checkgeom1 != contact[i].geom.g1 ? -Vector(contact[i].geom.normal) : Vector(contact[i].geom.normal), contact[i].geom.depth));
+                _report->contacts.push_back(CollisionReport::CONTACT(contact[i].geom.pos, pending.checkgeom1 != contact[i].geom.g1 ? -Vector(contact[i].geom.normal) : Vector(contact[i].geom.normal), contact[i].geom.depth));
             }
 
             FOREACH(itfn, _listcallbacks) {
@@ -627,6 +735,16 @@ private:
             }
         }
 
+        if( _bAutoDisable ) {
+            // a simulated body touched a sleeping one, so wake it up instead of treating it as static
+            if( !!b1 && !dBodyIsEnabled(b1) && !!pkb1 && !pkb1->IsStatic() ) {
+                dBodyEnable(b1);
+            }
+            if( !!b2 && !dBodyIsEnabled(b2) && !!pkb2 && !pkb2->IsStatic() ) {
+                dBodyEnable(b2);
+            }
+        }
+
         // process collisions
         for (int i=0; i<n; i++) {
             contact[i].surface.mode = _surface_mode;
@@ -696,6 +814,8 @@ private:
     float _surfacelayer;  ///> Surface layer depth
 
     int _num_iterations; ///> Max QuickStep iterations for each timestep
+    bool _bAutoDisable; ///> if true, ODE puts bodies at rest to sleep
+    int _nAutoDisableSteps; ///> number of steps a body has to be at rest before being put to sleep
 
     typedef void (*JointSetFn)(dJointID, int param, dReal val);
     typedef dReal (*JointGetFn)(dJointID);
@@ -706,6 +826,24 @@ private:
     vector<JointGetFn> _jointgetvel[12];
     std::list<EnvironmentBase::CollisionCallbackFn> _listcallbacks;
     CollisionReportPtr _report;
+
+    /// \brief the contacts of a pair of geometries found while colliding the space, processed after _mutexode is released
+    struct PendingContacts
+    {
+        enum { MAX_CONTACTS = 16 };
+        dBodyID b1, b2;
+        dGeomID checkgeom1;
+        KinBody::LinkPtr plink1, plink2;
+        int ncontacts;
+        dContact contacts[MAX_CONTACTS];
+    };
+    std::vector<PendingContacts> _vpendingcontacts; ///< only the first _nNumPendingContacts are valid
+    size_t _nNumPendingContacts;
+
+    // cached per step to avoid allocations
+    std::vector<KinBodyPtr> _vbodies;
+    std::vector<ODESpace::KinBodyInfoPtr> _vbodyinfos;
+    std::vector<uint8_t> _vbodyawake;
 };
 
 #endif
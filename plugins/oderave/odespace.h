@@ -211,6 +211,7 @@ public:
 
         vector<boost::shared_ptr<LINK> > vlinks;         ///< if body is disabled, then geom is static (it can't be connected to a joint!)
         vector<OpenRAVE::dReal> _vdofbranches;
+        vector<Transform> _vtranscache; ///< cache of the link transforms used when synchronizing
 
         ///< the pointer to this Link is the userdata
         vector<dJointID> vjoints;
@@ -528,13 +529,13 @@ private:
         dAllocateODEDataForThread(dAllocateMaskAll);
 #endif
         boost::mutex::scoped_lock lockode(_ode->_mutex);
-        vector<KinBodyPtr> vbodies;
-        _penv->GetBodies(vbodies);
-        FOREACHC(itbody, vbodies) {
+        _penv->GetBodies(_vbodiescache);
+        FOREACHC(itbody, _vbodiescache) {
             KinBodyInfoPtr pinfo = GetCreateInfo(*itbody, false).first;
             BOOST_ASSERT( pinfo->GetBody() == *itbody );
             _Synchronize(pinfo,false);
         }
+        _vbodiescache.resize(0);
     }
 
     void Synchronize(KinBodyConstPtr pbody)
@@ -689,7 +690,7 @@ private:
             if( block ) {
                 lockode.reset(new boost::mutex::scoped_lock(_ode->_mutex));
             }
-            vector<Transform> vtrans;
+            vector<Transform>& vtrans = pinfo->_vtranscache;
             KinBodyPtr pbody = pinfo->GetBody();
             pbody->GetLinkTransformations(vtrans, pinfo->_vdofbranches);
             pinfo->nLastStamp = pbody->GetUpdateStamp();
@@ -704,6 +705,10 @@ private:
             // update stamps also reflect enable links
             FOREACH(it, pinfo->vlinks) {
                 (*it)->Enable((*it)->GetLink()->IsEnabled());
+                if( (*it)->_bEnabled && !!(*it)->body ) {
+                    // the link was moved externally, so wake it up in case the physics engine put it to sleep
+                    dBodyEnable((*it)->body);
+                }
             }
             if( !!_synccallback ) {
                 _synccallback(pinfo);
@@ -729,6 +734,7 @@ private:
     std::string _geometrygroup;
     SynchronizeCallbackFn _synccallback;
     std::set<KinBodyConstPtr> _setInitializedBodies; ///< set of bodies that have been initialized and user data is set
+    std::vector<KinBodyPtr> _vbodiescache; ///< used in Synchronize to avoid allocations
     bool _bUsingPhysics;
 };
 
@@ -552,8 +552,10 @@ public:
 
         // separate all the acceleration switches into individual points
         _vtrajpointscache.resize(newspec.GetDOF());
-        ConfigurationSpecification::ConvertData(_vtrajpointscache.begin(),newspec,ramps.front().x0.begin(),posspec,1,GetEnv(),true);
-        ConfigurationSpecification::ConvertData(_vtrajpointscache.begin(),newspec,ramps.front().dx0.begin(),velspec,1,GetEnv(),false);
+        // every ramp end point is converted with the same specifications, so resolve the groups once
+        ConfigurationSpecification::ConversionPlan posplan(newspec, posspec, GetEnv(), true), velplan(newspec, velspec, GetEnv(), false);
+        posplan.Apply(_vtrajpointscache.begin(),ramps.front().x0.begin(),1);
+        velplan.Apply(_vtrajpointscache.begin(),ramps.front().dx0.begin(),1);
         _vtrajpointscache.at(waypointoffset) = 1;
         _vtrajpointscache.at(timeoffset) = 0;
         _dummytraj->Insert(_dummytraj->GetNumWaypoints(),_vtrajpointscache);
@@ -587,8 +589,9 @@ public:
 
             _vtrajpointscache.resize(newspec.GetDOF());
             vector<dReal>::iterator ittargetdata = _vtrajpointscache.begin();
-            ConfigurationSpecification::ConvertData(ittargetdata,newspec,itrampnd->x1.begin(),posspec,1,GetEnv(),true);
-            ConfigurationSpecification::ConvertData(ittargetdata,newspec,itrampnd->dx1.begin(),velspec,1,GetEnv(),false);
+            posplan.UpdateDefaults(); // checking the ramp could have moved the bodies
+            posplan.Apply(ittargetdata,itrampnd->x1.begin(),1);
+            velplan.Apply(ittargetdata,itrampnd->dx1.begin(),1);
             *(ittargetdata+timeoffset) = itrampnd->endTime;
             *(ittargetdata+waypointoffset) = 1;
             ittargetdata += newspec.GetDOF();
@@ -122,7 +122,7 @@ protected:
         return true;
     }
 
-    dReal _ComputeMinimumTimeJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
+    dReal _ComputeMinimumTimeJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
         dReal mintime = 0;
         _v0pos.resize(info->gpos.dof);
         _v1pos.resize(info->gpos.dof);
@@ -160,7 +160,7 @@ protected:
         return -1;
     }
 
-    void _ComputeVelocitiesJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    void _ComputeVelocitiesJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         if( info->orgveloffset >= 0 ) {
             for(int i=0; i < info->gvel.dof; ++i) {
                 *(itdata+info->gvel.offset+i) = *(itorgdiff+info->orgveloffset+i);
@@ -173,7 +173,7 @@ protected:
         }
     }
 
-    bool _CheckJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
+    bool _CheckJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
         dReal deltatime = *(itdata+_timeoffset);
         dReal ideltatime = 1/deltatime;
         dReal ideltatime2 = ideltatime*ideltatime;
@@ -238,7 +238,7 @@ protected:
         return true;
     }
 
-    bool _WriteJointValues(GroupInfoConstPtr inforaw, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    bool _WriteJointValues(const GroupInfoConstPtr& inforaw, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         CubicGroupInfoConstPtr info = boost::dynamic_pointer_cast<CubicGroupInfo const>(inforaw);
         _v0pos.resize(info->gpos.dof);
         _v1pos.resize(info->gpos.dof);
@@ -267,36 +267,36 @@ protected:
         return true;
     }
 
-    dReal _ComputeMinimumTimeAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
+    dReal _ComputeMinimumTimeAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_ComputeMinimumTimeAffine not implemented"), ORE_NotImplemented);
     }
 
-    void _ComputeVelocitiesAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    void _ComputeVelocitiesAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_ComputeVelocitiesAffine not implemented"), ORE_NotImplemented);
     }
 
-    bool _CheckAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
+    bool _CheckAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("not implemented"), ORE_NotImplemented);
     }
 
-    bool _WriteAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    bool _WriteAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_WriteAffine not implemented"), ORE_NotImplemented);
     }
 
-    dReal _ComputeMinimumTimeIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
+    dReal _ComputeMinimumTimeIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_ComputeMinimumTimeIk not implemented"), ORE_NotImplemented);
     }
 
-    void _ComputeVelocitiesIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    void _ComputeVelocitiesIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_ComputeVelocitiesIk not implemented"), ORE_NotImplemented);
     }
 
-    bool _CheckIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
+    bool _CheckIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("not implemented"), ORE_NotImplemented);
         return true;
     }
 
-    bool _WriteIk(GroupInfoConstPtr inforaw, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    bool _WriteIk(const GroupInfoConstPtr& inforaw, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_WriteIk not implemented"), ORE_NotImplemented);
     }
 
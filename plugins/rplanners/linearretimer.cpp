@@ -40,7 +40,7 @@ protected:
         return TrajectoryRetimer::_InitPlan();
     }
 
-    dReal _ComputeMinimumTimeJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
+    dReal _ComputeMinimumTimeJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
     {
         dReal bestmintime = 0;
         if( info->orgveloffset >= 0 ) {
@@ -58,7 +58,7 @@ protected:
         return bestmintime;
     }
 
-    void _ComputeVelocitiesJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
+    void _ComputeVelocitiesJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
     {
         if( *(itdata+_timeoffset) > 0 ) {
             dReal invdeltatime = 1.0 / *(itdata+_timeoffset);
@@ -74,7 +74,7 @@ protected:
         }
     }
 
-    dReal _ComputeMinimumTimeAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
+    dReal _ComputeMinimumTimeAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
     {
         dReal bestmintime = 0;
         const boost::array<DOFAffine,4> testdofs={{DOF_X,DOF_Y,DOF_Z,DOF_RotationAxis}};
@@ -113,7 +113,7 @@ protected:
         return bestmintime;
     }
 
-    void _ComputeVelocitiesAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
+    void _ComputeVelocitiesAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
     {
         if( *(itdata+_timeoffset) > 0 ) {
             dReal invdeltatime = 1.0 / *(itdata+_timeoffset);
@@ -142,7 +142,7 @@ protected:
         }
     }
 
-    dReal _ComputeMinimumTimeIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
+    dReal _ComputeMinimumTimeIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
     {
         IkParameterization ikparamprev, ikparam;
         ikparamprev.Set(itdataprev+info->gpos.offset,iktype);
@@ -221,7 +221,7 @@ protected:
         }
     }
 
-    void _ComputeVelocitiesIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
+    void _ComputeVelocitiesIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
     {
         if( *(itdata+_timeoffset) > 0 ) {
             dReal invdeltatime = 1.0 / *(itdata+_timeoffset);
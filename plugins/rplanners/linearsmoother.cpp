@@ -68,6 +68,7 @@ public:
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj)
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "LinearSmoother::PlanPath");
         BOOST_ASSERT(!!_parameters && !!ptraj );
         if( ptraj->GetNumWaypoints() < 2 ) {
             return PS_Failed;
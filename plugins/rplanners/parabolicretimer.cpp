@@ -77,7 +77,7 @@ protected:
         }
     }
 
-    dReal _ComputeMinimumTimeJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
+    dReal _ComputeMinimumTimeJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
         _v0pos.resize(info->gpos.dof);
         _v1pos.resize(info->gpos.dof);
         for(int i = 0; i < info->gpos.dof; ++i) {
@@ -106,7 +106,7 @@ protected:
         return mintime;
     }
 
-    void _ComputeVelocitiesJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    void _ComputeVelocitiesJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         if( info->orgveloffset >= 0 ) {
             for(int i=0; i < info->gvel.dof; ++i) {
                 *(itdata+info->gvel.offset+i) = *(itorgdiff+info->orgveloffset+i);
@@ -119,7 +119,7 @@ protected:
         }
     }
 
-    bool _CheckJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
+    bool _CheckJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
         dReal deltatime = *(itdata+_timeoffset);
         for(int i=0; i < info->gvel.dof; ++i) {
             dReal fvel = *(itdata+info->gvel.offset+i);
@@ -139,7 +139,7 @@ protected:
         return true;
     }
 
-    bool _WriteJointValues(GroupInfoConstPtr inforaw, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    bool _WriteJointValues(const GroupInfoConstPtr& inforaw, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         ParabolicGroupInfoConstPtr info = boost::dynamic_pointer_cast<ParabolicGroupInfo const>(inforaw);
         if( _parameters->_outputaccelchanges ) {
             _v0pos.resize(info->gpos.dof);
@@ -262,26 +262,26 @@ protected:
         return true;
     }
 
-    dReal _ComputeMinimumTimeAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
+    dReal _ComputeMinimumTimeAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_ComputeMinimumTimeAffine not implemented"), ORE_NotImplemented);
     }
 
-    void _ComputeVelocitiesAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    void _ComputeVelocitiesAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_ComputeVelocitiesAffine not implemented"), ORE_NotImplemented);
     }
 
-    bool _CheckAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
+    bool _CheckAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("not implemented"), ORE_NotImplemented);
     }
 
-    bool _WriteAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    bool _WriteAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         throw OPENRAVE_EXCEPTION_FORMAT0(_("_WriteAffine not implemented"), ORE_NotImplemented);
     }
 
     // speed of rotations is always the speed of the angle along the minimum rotation
     // speed of translations is always the combined xyz speed
     // TODO ParabolicRamp::SolveMinTimeBounded can only consider max vel/accel per dimension rather than combined together....
-    dReal _ComputeMinimumTimeIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
+    dReal _ComputeMinimumTimeIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) {
         ParabolicRamp::ParabolicRamp1D ramp;
         IkParameterization ikparamprev, ikparam;
         ikparamprev.Set(itdataprev+info->gpos.offset,iktype);
@@ -397,7 +397,7 @@ protected:
         return mintime;
     }
 
-    void _ComputeVelocitiesIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    void _ComputeVelocitiesIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         if( info->orgveloffset >= 0 ) {
             for(int i=0; i < info->gvel.dof; ++i) {
                 *(itdata+info->gvel.offset+i) = *(itorgdiff+info->orgveloffset+i);
@@ -410,7 +410,7 @@ protected:
         }
     }
 
-    bool _CheckIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions)
+    bool _CheckIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions)
     {
         dReal deltatime = *(itdata+_timeoffset);
         int transoffset = -1;
@@ -494,7 +494,7 @@ protected:
         return true;
     }
 
-    bool _WriteIk(GroupInfoConstPtr inforaw, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    bool _WriteIk(const GroupInfoConstPtr& inforaw, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         ParabolicGroupInfoConstPtr info = boost::dynamic_pointer_cast<ParabolicGroupInfo const>(inforaw);
         if( _parameters->_outputaccelchanges ) {
             dReal deltatime = *(itdata+_timeoffset);
@@ -809,8 +809,8 @@ protected:
         ptraj->Init(newspec);
         if( _parameters->_outputaccelchanges ) {
             std::list<TrajectoryBaseConstPtr> listtrajectories;
-            FOREACH(it,_listgroupinfo) {
-                listtrajectories.push_back(boost::dynamic_pointer_cast<ParabolicGroupInfo>(*it)->ptraj);
+            FOREACH(ithandler,_vgrouphandlers) {
+                listtrajectories.push_back(boost::dynamic_pointer_cast<ParabolicGroupInfo>(ithandler->info)->ptraj);
             }
             TrajectoryBasePtr pmergedtraj = planningutils::MergeTrajectories(listtrajectories);
             if( pmergedtraj->GetNumWaypoints() > 0 ) {
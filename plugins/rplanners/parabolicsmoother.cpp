@@ -229,6 +229,7 @@ public:
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj)
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "ParabolicSmoother::PlanPath");
         BOOST_ASSERT(!!_parameters && !!ptraj);
         if( ptraj->GetNumWaypoints() < 2 ) {
             return PS_Failed;
@@ -435,8 +436,10 @@ public:
             // separate all the acceleration switches into individual points
             vtrajpoints.resize(newspec.GetDOF());
             OPENRAVE_ASSERT_OP(dynamicpath.ramps.at(0).x0.size(), ==, _parameters->GetDOF());
-            ConfigurationSpecification::ConvertData(vtrajpoints.begin(),newspec,dynamicpath.ramps.at(0).x0.begin(), posspec,1,GetEnv(),true);
-            ConfigurationSpecification::ConvertData(vtrajpoints.begin(),newspec,dynamicpath.ramps.at(0).dx0.begin(),velspec,1,GetEnv(),false);
+            // every ramp switch point is converted with the same specifications, so resolve the groups once
+            ConfigurationSpecification::ConversionPlan posplan(newspec, posspec, GetEnv(), true), velplan(newspec, velspec, GetEnv(), false);
+            posplan.Apply(vtrajpoints.begin(),dynamicpath.ramps.at(0).x0.begin(),1);
+            velplan.Apply(vtrajpoints.begin(),dynamicpath.ramps.at(0).dx0.begin(),1);
             vtrajpoints.at(waypointoffset) = 1;
             vtrajpoints.at(timeoffset) = 0;
             _dummytraj->Insert(_dummytraj->GetNumWaypoints(),vtrajpoints);
@@ -571,11 +574,12 @@ public:
                     vtrajpoints.resize(newspec.GetDOF()*vswitchtimes.size());
                     vector<dReal>::iterator ittargetdata = vtrajpoints.begin();
                     dReal prevtime = 0;
+                    posplan.UpdateDefaults(); // checking the ramp could have moved the bodies
                     for(size_t i = 0; i < vswitchtimes.size(); ++i) {
                         rampnd.Evaluate(vswitchtimes[i],vconfig);
-                        ConfigurationSpecification::ConvertData(ittargetdata,newspec,vconfig.begin(),posspec,1,GetEnv(),true);
+                        posplan.Apply(ittargetdata,vconfig.begin(),1);
                         rampnd.Derivative(vswitchtimes[i],vconfig);
-                        ConfigurationSpecification::ConvertData(ittargetdata,newspec,vconfig.begin(),velspec,1,GetEnv(),false);
+                        velplan.Apply(ittargetdata,vconfig.begin(),1);
                         *(ittargetdata+timeoffset) = vswitchtimes[i]-prevtime;
                         *(ittargetdata+waypointoffset) = dReal(i+1==vswitchtimes.size());
                         ittargetdata += newspec.GetDOF();
@@ -0,0 +1,681 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2014 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "openraveplugindefs.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_01.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace plannerbenchmark {
+
+/// \brief forwards all queries to another collision checker and counts them
+///
+/// Only used inside the cloned environments of PlannerBenchmark, so every instance is accessed by one thread.
+class CountingCollisionChecker : public CollisionCheckerBase
+{
+public:
+    CountingCollisionChecker(EnvironmentBasePtr penv, CollisionCheckerBasePtr pintchecker) : CollisionCheckerBase(penv), _pintchecker(pintchecker), _numchecks(0)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nCounts the queries forwarded to another collision checker.";
+    }
+
+    uint64_t GetNumChecks() const {
+        return _numchecks;
+    }
+
+    void ResetNumChecks() {
+        _numchecks = 0;
+    }
+
+    virtual bool SetCollisionOptions(int collisionoptions) {
+        return _pintchecker->SetCollisionOptions(collisionoptions);
+    }
+
+    virtual int GetCollisionOptions() const {
+        return _pintchecker->GetCollisionOptions();
+    }
+
+    virtual void SetTolerance(dReal tolerance) {
+        _pintchecker->SetTolerance(tolerance);
+    }
+
+    virtual void SetGeometryGroup(const std::string& groupname) {
+        _pintchecker->SetGeometryGroup(groupname);
+    }
+
+    virtual const std::string& GetGeometryGroup() const {
+        return _pintchecker->GetGeometryGroup();
+    }
+
+    virtual bool InitEnvironment() {
+        return _pintchecker->InitEnvironment();
+    }
+
+    virtual void DestroyEnvironment() {
+        _pintchecker->DestroyEnvironment();
+    }
+
+    virtual bool InitKinBody(KinBodyPtr pbody) {
+        return _pintchecker->InitKinBody(pbody);
+    }
+
+    virtual void RemoveKinBody(KinBodyPtr pbody) {
+        _pintchecker->RemoveKinBody(pbody);
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody1, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(pbody1, report);
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(pbody1, pbody2, report);
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(plink, report);
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(plink1, plink2, report);
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(plink, pbody, report);
+    }
+
+    virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(plink, vbodyexcluded, vlinkexcluded, report);
+    }
+
+    virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(pbody, vbodyexcluded, vlinkexcluded, report);
+    }
+
+    virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(ray, plink, report);
+    }
+
+    virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(ray, pbody, report);
+    }
+
+    virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckCollision(ray, report);
+    }
+
+    virtual int CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly=false) {
+        _numchecks += nrays;
+        return _pintchecker->CheckCollisionRays(prays, nrays, pbody, pcollision, phits, bFrontFacingOnly);
+    }
+
+    virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckStandaloneSelfCollision(pbody, report);
+    }
+
+    virtual bool CheckStandaloneSelfCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report = CollisionReportPtr()) {
+        ++_numchecks;
+        return _pintchecker->CheckStandaloneSelfCollision(plink, report);
+    }
+
+    virtual bool CheckContinuousCollision(KinBodyPtr pbody, const std::vector<int>& vdofindices, const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, dReal fmindistance=1e-4, CollisionReportPtr report = CollisionReportPtr(), dReal* ptimeofimpact = NULL) {
+        ++_numchecks;
+        return _pintchecker->CheckContinuousCollision(pbody, vdofindices, q0, q1, dq0, dq1, timeelapsed, fmindistance, report, ptimeofimpact);
+    }
+
+protected:
+    CollisionCheckerBasePtr _pintchecker;
+    uint64_t _numchecks;
+};
+
+typedef boost::shared_ptr<CountingCollisionChecker> CountingCollisionCheckerPtr;
+
+/// \brief the planner configuration that is benchmarked
+struct BenchmarkSettings
+{
+    BenchmarkSettings() : numseeds(10), seedstart(0), numthreads(0), numqueries(5), maxiterations(-1), steplength(-1), timeout(0), bSetPostProcessing(false) {
+    }
+    std::string plannername, robotname, manipname, smoothername;
+    int numseeds;
+    uint32_t seedstart;
+    int numthreads;
+    int numqueries; ///< number of random queries generated per scene when none are given
+    int maxiterations; ///< if >= 0, overrides PlannerParameters::_nMaxIterations
+    dReal steplength; ///< if >= 0, overrides PlannerParameters::_fStepLength
+    dReal timeout; ///< if > 0, the planner is interrupted after this many seconds
+    bool bSetPostProcessing;
+    std::string postprocessingplanner, postprocessingparameters;
+    std::vector<std::string> vscenes;
+};
+
+/// \brief the result of planning one query with one seed
+struct RunResult
+{
+    RunResult() : scene(0), query(0), seed(0), bSuccess(false), status(PS_Failed), planningtime(0), smoothingtime(0), numchecks(0), pathlength(0), duration(0) {
+    }
+    size_t scene, query;
+    uint32_t seed;
+    bool bSuccess;
+    PlannerStatus status;
+    dReal planningtime, smoothingtime; ///< seconds
+    uint64_t numchecks;
+    dReal pathlength; ///< sum of the active dof distances between consecutive waypoints
+    dReal duration; ///< duration of the timed trajectory, 0 if the trajectory is not retimed
+};
+
+/// \brief one scene with its robot state and queries, shared by all the workers
+struct SceneInfo
+{
+    std::string name;
+    EnvironmentBasePtr penv;
+    std::string robotname;
+    std::vector<int> vactivedofs;
+    int affinedofs;
+    Vector vaffinerotationaxis;
+    std::vector< std::pair<std::vector<dReal>, std::vector<dReal> > > vqueries;
+};
+
+/// \brief runs a range of queries on its own clone of the scene environment
+class BenchmarkWorker
+{
+public:
+    BenchmarkWorker(const BenchmarkSettings& settings, const SceneInfo& scene, size_t sceneindex) : _settings(settings), _scene(scene), _sceneindex(sceneindex)
+    {
+        // cloning locks the original environment, so do it from the calling thread
+        _penv = scene.penv->CloneSelf(Clone_Bodies);
+        if( !_penv->GetCollisionChecker() ) {
+            _penv->Destroy();
+            throw OPENRAVE_EXCEPTION_FORMAT("scene %s has no collision checker to count the checks of", scene.name, ORE_InvalidState);
+        }
+        _pchecker.reset(new CountingCollisionChecker(_penv, _penv->GetCollisionChecker()));
+        _penv->SetCollisionChecker(_pchecker);
+        _probot = _penv->GetRobot(scene.robotname);
+        _probot->SetActiveDOFs(scene.vactivedofs, scene.affinedofs, scene.vaffinerotationaxis);
+        _planner = RaveCreatePlanner(_penv, settings.plannername);
+        _ptraj = RaveCreateTrajectory(_penv, "");
+    }
+
+    virtual ~BenchmarkWorker() {
+        _planner.reset();
+        _ptraj.reset();
+        _probot.reset();
+        _penv->Destroy();
+    }
+
+    bool IsValid() const {
+        return !!_planner;
+    }
+
+    /// \brief runs all the jobs in [0, numjobs) that are not taken by other workers
+    void Run(size_t& nextjob, size_t numjobs, boost::mutex& mutex, std::vector<RunResult>& vresults)
+    {
+        while(1) {
+            size_t job;
+            {
+                boost::mutex::scoped_lock lock(mutex);
+                if( nextjob >= numjobs ) {
+                    break;
+                }
+                job = nextjob++;
+            }
+            RunResult& result = vresults.at(job);
+            result.scene = _sceneindex;
+            result.query = job/_settings.numseeds;
+            result.seed = _settings.seedstart + job%_settings.numseeds;
+            try {
+                _RunQuery(result);
+            }
+            catch(const std::exception& ex) {
+                RAVELOG_WARN_FORMAT("scene %d query %d seed %d failed: %s", _sceneindex%result.query%result.seed%ex.what());
+                result.bSuccess = false;
+            }
+        }
+    }
+
+protected:
+    void _RunQuery(RunResult& result)
+    {
+        EnvironmentMutex::scoped_lock lock(_penv->GetMutex());
+        const std::pair<std::vector<dReal>, std::vector<dReal> >& query = _scene.vqueries.at(result.query);
+        _probot->SetActiveDOFValues(query.first);
+
+        PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+        params->SetRobotActiveJoints(_probot);
+        params->vinitialconfig = query.first;
+        params->vgoalconfig = query.second;
+        params->_nRandomGeneratorSeed = result.seed;
+        if( _settings.maxiterations >= 0 ) {
+            params->_nMaxIterations = _settings.maxiterations;
+        }
+        if( _settings.steplength >= 0 ) {
+            params->_fStepLength = _settings.steplength;
+        }
+        if( _settings.bSetPostProcessing ) {
+            params->_sPostProcessingPlanner = _settings.postprocessingplanner;
+            params->_sPostProcessingParameters = _settings.postprocessingparameters;
+        }
+
+        UserDataPtr callbackhandle;
+        if( _settings.timeout > 0 ) {
+            callbackhandle = _planner->RegisterPlanCallback(boost::bind(&BenchmarkWorker::_PlanCallback, this, _1));
+        }
+        _pchecker->ResetNumChecks();
+        _ptraj->Init(_probot->GetActiveConfigurationSpecification());
+
+        _starttime = utils::GetNanoPerformanceTime();
+        if( _planner->InitPlan(_probot, params) ) {
+            result.status = _planner->PlanPath(_ptraj);
+        }
+        else {
+            result.status = PS_FailedDueToInitial;
+        }
+        result.planningtime = (utils::GetNanoPerformanceTime()-_starttime)*1e-9;
+        result.bSuccess = (result.status & PS_HasSolution) && !(result.status & PS_Interrupted) && _ptraj->GetNumWaypoints() > 0;
+        if( result.bSuccess && _settings.smoothername.size() > 0 ) {
+            uint64_t smoothstarttime = utils::GetNanoPerformanceTime();
+            PlannerStatus smoothstatus = planningutils::SmoothActiveDOFTrajectory(_ptraj, _probot, 1, 1, _settings.smoothername);
+            result.smoothingtime = (utils::GetNanoPerformanceTime()-smoothstarttime)*1e-9;
+            result.bSuccess = !!(smoothstatus & PS_HasSolution);
+        }
+        result.numchecks = _pchecker->GetNumChecks();
+        if( result.bSuccess ) {
+            result.pathlength = _ComputePathLength();
+            result.duration = _ptraj->GetDuration();
+        }
+    }
+
+    PlannerAction _PlanCallback(const PlannerBase::PlannerProgress& progress)
+    {
+        if( (utils::GetNanoPerformanceTime()-_starttime)*1e-9 > _settings.timeout ) {
+            return PA_Interrupt;
+        }
+        return PA_None;
+    }
+
+    dReal _ComputePathLength()
+    {
+        ConfigurationSpecification spec = _probot->GetActiveConfigurationSpecification();
+        std::vector<dReal> vdata, vprev, vcur(spec.GetDOF());
+        _ptraj->GetWaypoints(0, _ptraj->GetNumWaypoints(), vdata, spec);
+        dReal pathlength = 0;
+        for(size_t i = 0; i+vcur.size() <= vdata.size(); i += vcur.size()) {
+            std::copy(vdata.begin()+i, vdata.begin()+i+vcur.size(), vcur.begin());
+            if( vprev.size() > 0 ) {
+                std::vector<dReal> vdiff = vcur;
+                _probot->SubtractActiveDOFValues(vdiff, vprev);
+                dReal dist = 0;
+                FOREACHC(itdiff, vdiff) {
+                    dist += *itdiff * *itdiff;
+                }
+                pathlength += RaveSqrt(dist);
+            }
+            vprev = vcur;
+        }
+        return pathlength;
+    }
+
+    const BenchmarkSettings& _settings;
+    const SceneInfo& _scene;
+    size_t _sceneindex;
+    EnvironmentBasePtr _penv;
+    CountingCollisionCheckerPtr _pchecker;
+    RobotBasePtr _probot;
+    PlannerBasePtr _planner;
+    TrajectoryBasePtr _ptraj;
+    uint64_t _starttime;
+};
+
+typedef boost::shared_ptr<BenchmarkWorker> BenchmarkWorkerPtr;
+
+/// \brief plans fixed queries with a range of random seeds and reports statistics of the results
+class PlannerBenchmark : public ModuleBase
+{
+public:
+    PlannerBenchmark(EnvironmentBasePtr penv, std::istream& sinput) : ModuleBase(penv)
+    {
+        __description = ":Interface Author: Rosen Diankov\n\nPlans a set of start/goal queries with a fixed range of random generator seeds so that planner configurations can be compared on the same data. Every seed runs on its own clone of the environment, so the results only depend on the scene, the query and the seed.";
+        RegisterCommand("Run",boost::bind(&PlannerBenchmark::_RunCommand,this,_1,_2),
+                        "Runs the benchmark and returns the results as JSON. Format::\n\n"
+                        "  Run [planner name] [robot name] [manip name] [numseeds N] [seedstart S] [numthreads T] [maxiterations N] [steplength L] [timeout seconds] [smoother name] [numqueries N] [query start... goal...]... [scene filename]... [postprocessingplanner name] [postprocessingparameters xml]\n\n"
+                        "The planner uses the active dofs of the robot unless manip is given. When no queries are given, numqueries collision-free start/goal pairs are sampled from a fixed seed. When no scenes are given, the current environment is used. postprocessingparameters takes the rest of the line. "
+                        "Each run reports the planning time, the number of collision checks, the path length in the active dof space and the duration of the trajectory after smoothing.");
+    }
+
+    virtual ~PlannerBenchmark() {
+    }
+
+protected:
+    bool _RunCommand(ostream& sout, istream& sinput)
+    {
+        BenchmarkSettings settings;
+        settings.plannername = "birrt";
+        settings.numthreads = std::max(1u, boost::thread::hardware_concurrency());
+        std::vector< std::vector<dReal> > vqueryvalues;
+        string cmd;
+        while(!sinput.eof()) {
+            sinput >> cmd;
+            if( !sinput ) {
+                break;
+            }
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+
+            if( cmd == "planner" ) {
+                sinput >> settings.plannername;
+            }
+            else if( cmd == "robot" ) {
+                sinput >> settings.robotname;
+            }
+            else if( cmd == "manip" ) {
+                sinput >> settings.manipname;
+            }
+            else if( cmd == "numseeds" ) {
+                sinput >> settings.numseeds;
+            }
+            else if( cmd == "seedstart" ) {
+                sinput >> settings.seedstart;
+            }
+            else if( cmd == "numthreads" ) {
+                sinput >> settings.numthreads;
+            }
+            else if( cmd == "maxiterations" ) {
+                sinput >> settings.maxiterations;
+            }
+            else if( cmd == "steplength" ) {
+                sinput >> settings.steplength;
+            }
+            else if( cmd == "timeout" ) {
+                sinput >> settings.timeout;
+            }
+            else if( cmd == "smoother" ) {
+                sinput >> settings.smoothername;
+            }
+            else if( cmd == "numqueries" ) {
+                sinput >> settings.numqueries;
+            }
+            else if( cmd == "query" ) {
+                // the number of values is only known once the robot is found
+                std::vector<dReal> vvalues;
+                dReal f;
+                while(sinput >> f) {
+                    vvalues.push_back(f);
+                }
+                sinput.clear();
+                vqueryvalues.push_back(vvalues);
+            }
+            else if( cmd == "scene" ) {
+                std::string filename;
+                sinput >> filename;
+                settings.vscenes.push_back(filename);
+            }
+            else if( cmd == "postprocessingplanner" ) {
+                sinput >> settings.postprocessingplanner;
+                settings.bSetPostProcessing = true;
+            }
+            else if( cmd == "postprocessingparameters" ) {
+                getline(sinput, settings.postprocessingparameters);
+                boost::trim(settings.postprocessingparameters);
+                settings.bSetPostProcessing = true;
+            }
+            else {
+                RAVELOG_WARN(str(boost::format("unrecognized command: %s\n")%cmd));
+                return false;
+            }
+
+            if( !sinput ) {
+                RAVELOG_ERROR(str(boost::format("failed processing command %s\n")%cmd));
+                return false;
+            }
+        }
+        OPENRAVE_ASSERT_OP(settings.numseeds,>,0);
+        OPENRAVE_ASSERT_OP(settings.numthreads,>,0);
+
+        std::vector<SceneInfo> vscenes;
+        if( settings.vscenes.size() == 0 ) {
+            vscenes.push_back(SceneInfo());
+            vscenes.back().penv = GetEnv();
+        }
+        else {
+            FOREACHC(itfilename, settings.vscenes) {
+                vscenes.push_back(SceneInfo());
+                vscenes.back().name = *itfilename;
+                // an empty clone gives a new environment with the same checkers without linking to openrave-core
+                vscenes.back().penv = GetEnv()->CloneSelf(0);
+                if( !vscenes.back().penv->Load(*itfilename) ) {
+                    _DestroyScenes(vscenes);
+                    throw OPENRAVE_EXCEPTION_FORMAT("failed to load scene %s", *itfilename, ORE_InvalidArguments);
+                }
+            }
+        }
+
+        std::vector< std::vector<RunResult> > vsceneresults(vscenes.size());
+        try {
+            for(size_t iscene = 0; iscene < vscenes.size(); ++iscene) {
+                _InitScene(settings, vqueryvalues, vscenes[iscene]);
+                _RunScene(settings, vscenes[iscene], iscene, vsceneresults[iscene]);
+            }
+        }
+        catch(...) {
+            _DestroyScenes(vscenes);
+            throw;
+        }
+        _DestroyScenes(vscenes);
+
+        sout << "{\"planner\": ";
+        utils::WriteJSONString(sout, settings.plannername);
+        sout << ", \"numseeds\": " << settings.numseeds << ", \"seedstart\": " << settings.seedstart
+             << ", \"maxiterations\": " << settings.maxiterations << ", \"steplength\": " << settings.steplength << ", \"smoother\": ";
+        utils::WriteJSONString(sout, settings.smoothername);
+        if( settings.bSetPostProcessing ) {
+            sout << ", \"postprocessingplanner\": ";
+            utils::WriteJSONString(sout, settings.postprocessingplanner);
+        }
+        sout << ",\n \"scenes\": [";
+        std::vector<RunResult> vallresults;
+        for(size_t iscene = 0; iscene < vscenes.size(); ++iscene) {
+            sout << (iscene > 0 ? ",\n  " : "\n  ") << "{\"scene\": ";
+            utils::WriteJSONString(sout, vscenes[iscene].name);
+            sout << ", \"numqueries\": " << vscenes[iscene].vqueries.size() << ", \"summary\": ";
+            _WriteSummary(sout, vsceneresults[iscene]);
+            sout << ",\n   \"runs\": [";
+            for(size_t irun = 0; irun < vsceneresults[iscene].size(); ++irun) {
+                const RunResult& result = vsceneresults[iscene][irun];
+                sout << (irun > 0 ? ",\n    " : "\n    ") << "{\"query\": " << result.query << ", \"seed\": " << result.seed << ", \"success\": " << (result.bSuccess ? "true" : "false")
+                     << ", \"status\": " << result.status << ", \"planningtime\": " << result.planningtime << ", \"smoothingtime\": " << result.smoothingtime
+                     << ", \"collisionchecks\": " << result.numchecks << ", \"pathlength\": " << result.pathlength << ", \"duration\": " << result.duration << "}";
+            }
+            sout << "]}";
+            vallresults.insert(vallresults.end(), vsceneresults[iscene].begin(), vsceneresults[iscene].end());
+        }
+        sout << "\n ],\n \"summary\": ";
+        _WriteSummary(sout, vallresults);
+        sout << "\n}";
+        return true;
+    }
+
+    /// \brief finds the robot and its active dofs and sets up the queries of the scene
+    void _InitScene(const BenchmarkSettings& settings, const std::vector< std::vector<dReal> >& vqueryvalues, SceneInfo& scene)
+    {
+        EnvironmentMutex::scoped_lock lock(scene.penv->GetMutex());
+        RobotBasePtr probot;
+        if( settings.robotname.size() > 0 ) {
+            probot = scene.penv->GetRobot(settings.robotname);
+        }
+        else {
+            std::vector<RobotBasePtr> vrobots;
+            scene.penv->GetRobots(vrobots);
+            if( vrobots.size() > 0 ) {
+                probot = vrobots.at(0);
+            }
+        }
+        if( !probot ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("scene %s has no robot %s", scene.name%settings.robotname, ORE_InvalidArguments);
+        }
+        RobotBase::RobotStateSaver saver(probot);
+        if( settings.manipname.size() > 0 ) {
+            RobotBase::ManipulatorPtr pmanip = probot->GetManipulator(settings.manipname);
+            if( !pmanip ) {
+                throw OPENRAVE_EXCEPTION_FORMAT("robot %s has no manipulator %s", probot->GetName()%settings.manipname, ORE_InvalidArguments);
+            }
+            probot->SetActiveDOFs(pmanip->GetArmIndices());
+        }
+        scene.robotname = probot->GetName();
+        scene.vactivedofs = probot->GetActiveDOFIndices();
+        scene.affinedofs = probot->GetAffineDOF();
+        scene.vaffinerotationaxis = probot->GetAffineRotationAxis();
+
+        int dof = probot->GetActiveDOF();
+        scene.vqueries.resize(0);
+        FOREACHC(itvalues, vqueryvalues) {
+            if( (int)itvalues->size() != 2*dof ) {
+                throw OPENRAVE_EXCEPTION_FORMAT("query has %d values, expected %d for start and goal", itvalues->size()%(2*dof), ORE_InvalidArguments);
+            }
+            scene.vqueries.push_back(std::make_pair(std::vector<dReal>(itvalues->begin(), itvalues->begin()+dof), std::vector<dReal>(itvalues->begin()+dof, itvalues->end())));
+        }
+        if( scene.vqueries.size() == 0 ) {
+            // the queries only depend on the scene so that all planner configurations see the same ones
+            boost::mt19937 rng(0);
+            std::vector<dReal> vlower, vupper;
+            probot->GetActiveDOFLimits(vlower, vupper);
+            std::vector<dReal> vstart, vgoal;
+            for(int i = 0; i < settings.numqueries; ++i) {
+                if( !_SampleCollisionFree(probot, vlower, vupper, rng, vstart) || !_SampleCollisionFree(probot, vlower, vupper, rng, vgoal) ) {
+                    RAVELOG_WARN_FORMAT("failed to sample a collision-free query in scene %s", scene.name);
+                    break;
+                }
+                scene.vqueries.push_back(std::make_pair(vstart, vgoal));
+            }
+        }
+        if( scene.vqueries.size() == 0 ) {
+            throw OPENRAVE_EXCEPTION_FORMAT("scene %s has no queries", scene.name, ORE_InvalidArguments);
+        }
+    }
+
+    static bool _SampleCollisionFree(RobotBasePtr probot, const std::vector<dReal>& vlower, const std::vector<dReal>& vupper, boost::mt19937& rng, std::vector<dReal>& vvalues)
+    {
+        boost::uniform_01<boost::mt19937&> uniform(rng);
+        vvalues.resize(vlower.size());
+        for(int itry = 0; itry < 1000; ++itry) {
+            for(size_t i = 0; i < vvalues.size(); ++i) {
+                vvalues[i] = vlower[i] + (vupper[i]-vlower[i])*uniform();
+            }
+            probot->SetActiveDOFValues(vvalues);
+            if( !probot->GetEnv()->CheckCollision(KinBodyConstPtr(probot)) && !probot->CheckSelfCollision() ) {
+                probot->GetActiveDOFValues(vvalues);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void _RunScene(const BenchmarkSettings& settings, const SceneInfo& scene, size_t sceneindex, std::vector<RunResult>& vresults)
+    {
+        size_t numjobs = scene.vqueries.size()*settings.numseeds;
+        vresults.resize(numjobs);
+        std::vector<BenchmarkWorkerPtr> vworkers(std::min(numjobs, (size_t)settings.numthreads));
+        for(size_t i = 0; i < vworkers.size(); ++i) {
+            vworkers[i].reset(new BenchmarkWorker(settings, scene, sceneindex));
+            if( !vworkers[i]->IsValid() ) {
+                throw OPENRAVE_EXCEPTION_FORMAT("failed to create planner %s", settings.plannername, ORE_InvalidArguments);
+            }
+        }
+
+        size_t nextjob = 0;
+        boost::mutex mutex;
+        boost::thread_group threads;
+        for(size_t i = 1; i < vworkers.size(); ++i) {
+            threads.create_thread(boost::bind(&BenchmarkWorker::Run, vworkers[i], boost::ref(nextjob), numjobs, boost::ref(mutex), boost::ref(vresults)));
+        }
+        vworkers.at(0)->Run(nextjob, numjobs, mutex, vresults);
+        threads.join_all();
+    }
+
+    void _DestroyScenes(std::vector<SceneInfo>& vscenes)
+    {
+        FOREACH(itscene, vscenes) {
+            if( !!itscene->penv && itscene->penv != GetEnv() ) {
+                itscene->penv->Destroy();
+            }
+            itscene->penv.reset();
+        }
+    }
+
+    /// \brief writes min, mean and the 50/90/99 percentiles of the values
+    static void _WriteStatistics(ostream& sout, std::vector<dReal>& vvalues)
+    {
+        if( vvalues.size() == 0 ) {
+            sout << "null";
+            return;
+        }
+        std::sort(vvalues.begin(), vvalues.end());
+        dReal sum = 0;
+        FOREACHC(itvalue, vvalues) {
+            sum += *itvalue;
+        }
+        sout << "{\"min\": " << vvalues.front() << ", \"mean\": " << sum/vvalues.size() << ", \"p50\": " << _GetPercentile(vvalues, 0.5)
+             << ", \"p90\": " << _GetPercentile(vvalues, 0.9) << ", \"p99\": " << _GetPercentile(vvalues, 0.99) << ", \"max\": " << vvalues.back() << "}";
+    }
+
+    /// \brief nearest-rank percentile of sorted values
+    static dReal _GetPercentile(const std::vector<dReal>& vsorted, dReal fraction)
+    {
+        size_t index = (size_t)ceil(fraction*vsorted.size());
+        return vsorted.at(index > 0 ? index-1 : 0);
+    }
+
+    /// \brief time and collision checks are over all runs, the path statistics only over the successful ones
+    static void _WriteSummary(ostream& sout, const std::vector<RunResult>& vresults)
+    {
+        std::vector<dReal> vtimes, vchecks, vlengths, vdurations;
+        size_t numsuccess = 0;
+        FOREACHC(itresult, vresults) {
+            vtimes.push_back(itresult->planningtime+itresult->smoothingtime);
+            vchecks.push_back(itresult->numchecks);
+            if( itresult->bSuccess ) {
+                ++numsuccess;
+                vlengths.push_back(itresult->pathlength);
+                vdurations.push_back(itresult->duration);
+            }
+        }
+        sout << "{\"numruns\": " << vresults.size() << ", \"successrate\": " << (vresults.size() > 0 ? dReal(numsuccess)/vresults.size() : dReal(0)) << ", \"time\": ";
+        _WriteStatistics(sout, vtimes);
+        sout << ", \"collisionchecks\": ";
+        _WriteStatistics(sout, vchecks);
+        sout << ", \"pathlength\": ";
+        _WriteStatistics(sout, vlengths);
+        sout << ", \"duration\": ";
+        _WriteStatistics(sout, vdurations);
+        sout << "}";
+    }
+};
+
+} // end namespace plannerbenchmark
+
+ModuleBasePtr CreatePlannerBenchmark(EnvironmentBasePtr penv, std::istream& sinput)
+{
+    return ModuleBasePtr(new plannerbenchmark::PlannerBenchmark(penv,sinput));
+}
@@ -28,6 +28,7 @@ PlannerBasePtr CreateParabolicTrajectoryRetimer(EnvironmentBasePtr penv, std::is
 PlannerBasePtr CreateCubicTrajectoryRetimer(EnvironmentBasePtr penv, std::istream& sinput);
 PlannerBasePtr CreateLinearSmoother(EnvironmentBasePtr penv, std::istream& sinput);
 PlannerBasePtr CreateConstraintParabolicSmoother(EnvironmentBasePtr penv, std::istream& sinput);
+ModuleBasePtr CreatePlannerBenchmark(EnvironmentBasePtr penv, std::istream& sinput);
 
 namespace rplanners {    
 PlannerBasePtr CreateParabolicSmoother(EnvironmentBasePtr penv, std::istream& sinput);
@@ -81,6 +82,11 @@ InterfaceBasePtr CreateInterfaceValidated(InterfaceType type, const std::string&
             return CreateConstraintParabolicSmoother(penv,sinput);
         }
         break;
+    case PT_Module:
+        if( interfacename == "plannerbenchmark" ) {
+            return CreatePlannerBenchmark(penv,sinput);
+        }
+        break;
     default:
         break;
     }
@@ -102,6 +108,7 @@ void GetPluginAttributesValidated(PLUGININFO& info)
     info.interfacenames[PT_Planner].push_back("LinearSmoother");
     info.interfacenames[PT_Planner].push_back("ParabolicSmoother");
     info.interfacenames[PT_Planner].push_back("ConstraintParabolicSmoother");
+    info.interfacenames[PT_Module].push_back("PlannerBenchmark");
 }
 
 OPENRAVE_PLUGIN_API void DestroyPlugin()
@@ -354,6 +354,7 @@ Some python code to display data::\n\
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj)
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "BirrtPlanner::PlanPath");
         _goalindex = -1;
         _startindex = -1;
         if(!_parameters) {
@@ -703,6 +704,7 @@ public:
 
     PlannerStatus PlanPath(TrajectoryBasePtr ptraj)
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "BasicRrtPlanner::PlanPath");
         if(!_parameters) {
             RAVELOG_WARN("RrtPlanner::PlanPath - Error, planner not initialized\n");
             return PS_Failed;
@@ -925,6 +927,7 @@ public:
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj)
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "ExplorationPlanner::PlanPath");
         _goalindex = -1;
         _startindex = -1;
         if( !_parameters ) {
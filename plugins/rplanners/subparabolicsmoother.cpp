@@ -187,8 +187,10 @@ public:
 
             // separate all the acceleration switches into individual points
             vtrajpoints.resize(newspec.GetDOF());
-            ConfigurationSpecification::ConvertData(vtrajpoints.begin(),newspec,dynamicpath.ramps.at(0).x0.begin(),oldspec,1,GetEnv(),true);
-            ConfigurationSpecification::ConvertData(vtrajpoints.begin(),newspec,dynamicpath.ramps.at(0).dx0.begin(),velspec,1,GetEnv(),false);
+            // every ramp switch point is converted with the same specifications, so resolve the groups once
+            ConfigurationSpecification::ConversionPlan posplan(newspec, oldspec, GetEnv(), true), velplan(newspec, velspec, GetEnv(), false);
+            posplan.Apply(vtrajpoints.begin(),dynamicpath.ramps.at(0).x0.begin(),1);
+            velplan.Apply(vtrajpoints.begin(),dynamicpath.ramps.at(0).dx0.begin(),1);
             vtrajpoints.at(waypointoffset) = 1;
             vtrajpoints.at(timeoffset) = 0;
             _dummytraj->Insert(_dummytraj->GetNumWaypoints(),vtrajpoints);
@@ -265,11 +267,12 @@ public:
                     vtrajpoints.resize(newspec.GetDOF()*vswitchtimes.size());
                     vector<dReal>::iterator ittargetdata = vtrajpoints.begin();
                     dReal prevtime = 0;
+                    posplan.UpdateDefaults(); // checking the ramp could have moved the bodies
                     for(size_t i = 0; i < vswitchtimes.size(); ++i) {
                         rampnd.Evaluate(vswitchtimes[i],vconfig);
-                        ConfigurationSpecification::ConvertData(ittargetdata,newspec,vconfig.begin(),oldspec,1,GetEnv(),true);
+                        posplan.Apply(ittargetdata,vconfig.begin(),1);
                         rampnd.Derivative(vswitchtimes[i],vconfig);
-                        ConfigurationSpecification::ConvertData(ittargetdata,newspec,vconfig.begin(),velspec,1,GetEnv(),false);
+                        velplan.Apply(ittargetdata,vconfig.begin(),1);
                         *(ittargetdata+timeoffset) = vswitchtimes[i]-prevtime;
                         *(ittargetdata+waypointoffset) = dReal(i+1==vswitchtimes.size());
                         ittargetdata += newspec.GetDOF();
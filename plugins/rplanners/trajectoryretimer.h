@@ -40,10 +40,33 @@ public:
     typedef boost::shared_ptr<GroupInfo> GroupInfoPtr;
     typedef boost::shared_ptr<GroupInfo const> GroupInfoConstPtr;
 
+    enum GroupType
+    {
+        GT_JointValues=0,
+        GT_Affine=1,
+        GT_Ik=2,
+    };
+
+    /// \brief the handlers of one supported group, dispatched with a switch rather than through bound functions
+    class GroupHandler
+    {
+public:
+        GroupHandler() : grouptype(GT_JointValues), affinedofs(0), iktype(IKP_None) {
+        }
+        GroupInfoPtr info;
+        GroupInfoConstPtr constinfo; ///< same as info, kept so calls do not have to convert the pointer
+        GroupType grouptype;
+        int affinedofs;
+        IkParameterizationType iktype;
+    };
+
 public:
     TrajectoryRetimer(EnvironmentBasePtr penv, std::istream& sinput) : PlannerBase(penv)
     {
         __description = ":Interface Author: Rosen Diankov\nTrajectory re-timing without modifying any of the points. Overwrites the velocities and timestamps.";
+        _nMaxThreads = std::max(1, (int)boost::thread::hardware_concurrency());
+        RegisterCommand("SetMaxThreads",boost::bind(&TrajectoryRetimer::_SetMaxThreadsCommand,this,_1,_2),
+                        "sets the maximum number of threads used to check long trajectories whose timestamps and velocities are given");
     }
 
     virtual bool InitPlan(RobotBasePtr pbase, PlannerParametersConstPtr params)
@@ -90,6 +113,7 @@ public:
 
     virtual PlannerStatus PlanPath(TrajectoryBasePtr ptraj)
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "TrajectoryRetimer::PlanPath");
         // TODO there's a lot of info that is being recomputed which could be cached depending on the configurationspace of the incoming trajectory
         BOOST_ASSERT(!!_parameters && !!ptraj && ptraj->GetEnv()==GetEnv());
         BOOST_ASSERT(_parameters->GetDOF() == _parameters->_configurationspecification.GetDOF());
@@ -144,7 +168,13 @@ public:
 
         _vdata.resize(numpoints*newspec.GetDOF());
         std::fill(_vdata.begin(), _vdata.end(), 0);
-        ConfigurationSpecification::ConvertData(_vdata.begin(), newspec, _vdiffdata.begin(), _parameters->_configurationspecification, numpoints, GetEnv());
+        if( _initialplan.IsBuiltFor(newspec, _parameters->_configurationspecification, true) ) {
+            _initialplan.UpdateDefaults();
+        }
+        else {
+            _initialplan.Init(newspec, _parameters->_configurationspecification, GetEnv(), true);
+        }
+        _initialplan.Apply(_vdata.begin(), _vdiffdata.begin(), numpoints);
         int degree = 1;
 
 //        {
@@ -159,11 +189,7 @@ public:
             // analyze the configuration space and set the necessary converters
             const string& posinterpolation = _parameters->_interpolation;
             if( _cachedoldspec != _parameters->_configurationspecification || posinterpolation != _cachedposinterpolation ) {
-                _listgroupinfo.clear();
-                _listmintimefns.clear();
-                _listvelocityfns.clear();
-                _listcheckvelocityfns.clear();
-                _listwritefns.clear();
+                _vgrouphandlers.resize(0);
                 _cachednewspec = newspec;
                 _cachedoldspec = _parameters->_configurationspecification;
                 _cachedposinterpolation = posinterpolation;
@@ -190,72 +216,34 @@ public:
                     std::vector<ConfigurationSpecification::Group>::iterator itvelgroup = _cachednewspec._vgroups.begin()+(_cachednewspec.FindTimeDerivativeGroup(gpos)-_cachednewspec._vgroups.begin());
                     BOOST_ASSERT(itvelgroup != _cachednewspec._vgroups.end());
                     std::vector<ConfigurationSpecification::Group>::const_iterator itaccelgroupc = _cachednewspec.FindTimeDerivativeGroup(*itvelgroup);
-                    _listgroupinfo.push_back(CreateGroupInfo(degree, _cachednewspec, gpos, *itvelgroup));
-                    _listgroupinfo.back()->orgposoffset = orgposoffset;
-                    _listgroupinfo.back()->_vConfigVelocityLimit = std::vector<dReal>(_parameters->_vConfigVelocityLimit.begin()+itgroup->offset, _parameters->_vConfigVelocityLimit.begin()+itgroup->offset+itgroup->dof);
-                    _listgroupinfo.back()->_vConfigAccelerationLimit = std::vector<dReal>(_parameters->_vConfigAccelerationLimit.begin()+itgroup->offset, _parameters->_vConfigAccelerationLimit.begin()+itgroup->offset+itgroup->dof);
-                    _listgroupinfo.back()->_vConfigLowerLimit = std::vector<dReal>(_parameters->_vConfigLowerLimit.begin()+itgroup->offset, _parameters->_vConfigLowerLimit.begin()+itgroup->offset+itgroup->dof);
-                    _listgroupinfo.back()->_vConfigUpperLimit = std::vector<dReal>(_parameters->_vConfigUpperLimit.begin()+itgroup->offset, _parameters->_vConfigUpperLimit.begin()+itgroup->offset+itgroup->dof);
+                    GroupInfoPtr info = CreateGroupInfo(degree, _cachednewspec, gpos, *itvelgroup);
+                    info->orgposoffset = orgposoffset;
+                    info->_vConfigVelocityLimit = std::vector<dReal>(_parameters->_vConfigVelocityLimit.begin()+itgroup->offset, _parameters->_vConfigVelocityLimit.begin()+itgroup->offset+itgroup->dof);
+                    info->_vConfigAccelerationLimit = std::vector<dReal>(_parameters->_vConfigAccelerationLimit.begin()+itgroup->offset, _parameters->_vConfigAccelerationLimit.begin()+itgroup->offset+itgroup->dof);
+                    info->_vConfigLowerLimit = std::vector<dReal>(_parameters->_vConfigLowerLimit.begin()+itgroup->offset, _parameters->_vConfigLowerLimit.begin()+itgroup->offset+itgroup->dof);
+                    info->_vConfigUpperLimit = std::vector<dReal>(_parameters->_vConfigUpperLimit.begin()+itgroup->offset, _parameters->_vConfigUpperLimit.begin()+itgroup->offset+itgroup->dof);
 
                     itgroup = _cachedoldspec.FindCompatibleGroup(*itvelgroup);
                     if( itgroup != _cachedoldspec._vgroups.end() ) {
                         // velocity is optional
-                        _listgroupinfo.back()->orgveloffset = itgroup->offset;
+                        info->orgveloffset = itgroup->offset;
                     }
 
+                    GroupHandler handler;
+                    handler.info = info;
+                    handler.constinfo = info;
+                    handler.grouptype = static_cast<GroupType>(igrouptype);
                     stringstream ss(gpos.name.substr(supportedgroups[igrouptype].size()));
-                    string bodyname;
-                    int affinedofs=0;
-                    IkParameterizationType iktype=IKP_None;
                     if( igrouptype == 1 ) {
-                        ss >> bodyname >> affinedofs;
+                        string bodyname;
+                        ss >> bodyname >> handler.affinedofs;
                     }
                     else if( igrouptype == 2 ) {
                         int niktype=0;
                         ss >> niktype;
-                        iktype = static_cast<IkParameterizationType>(niktype);
-                    }
-
-                    {
-                        // if _parameters->_hastimestamps, then use this for double checking that times are feasible
-                        if( igrouptype == 0 ) {
-                            _listmintimefns.push_back(boost::bind(&TrajectoryRetimer::_ComputeMinimumTimeJointValues,this,_listgroupinfo.back(),_1,_2,_3,_4));
-                        }
-                        else if( igrouptype == 1 ) {
-                            _listmintimefns.push_back(boost::bind(&TrajectoryRetimer::_ComputeMinimumTimeAffine,this,_listgroupinfo.back(),affinedofs,_1,_2,_3,_4));
-                        }
-                        else if( igrouptype == 2 ) {
-                            _listmintimefns.push_back(boost::bind(&TrajectoryRetimer::_ComputeMinimumTimeIk,this,_listgroupinfo.back(),iktype,_1,_2,_3,_4));
-                        }
-                    }
-
-                    if( igrouptype == 0 ) {
-                        if( _parameters->_hasvelocities ) {
-                            _listcheckvelocityfns.push_back(boost::bind(&TrajectoryRetimer::_CheckJointValues,this,_listgroupinfo.back(),_1,_2,_3));
-                        }
-                        else {
-                            _listvelocityfns.push_back(boost::bind(&TrajectoryRetimer::_ComputeVelocitiesJointValues,this,_listgroupinfo.back(),_1,_2,_3));
-                        }
-                        _listwritefns.push_back(boost::bind(&TrajectoryRetimer::_WriteJointValues,this,_listgroupinfo.back(),_1,_2,_3));
-                    }
-                    else if( igrouptype == 1 ) {
-                        if( _parameters->_hasvelocities ) {
-                            _listcheckvelocityfns.push_back(boost::bind(&TrajectoryRetimer::_CheckAffine,this,_listgroupinfo.back(),affinedofs,_1,_2,_3));
-                        }
-                        else {
-                            _listvelocityfns.push_back(boost::bind(&TrajectoryRetimer::_ComputeVelocitiesAffine,this,_listgroupinfo.back(),affinedofs,_1,_2,_3));
-                        }
-                        _listwritefns.push_back(boost::bind(&TrajectoryRetimer::_WriteAffine,this,_listgroupinfo.back(),affinedofs,_1,_2,_3));
-                    }
-                    else if( igrouptype == 2 ) {
-                        if( _parameters->_hasvelocities ) {
-                            _listcheckvelocityfns.push_back(boost::bind(&TrajectoryRetimer::_CheckIk,this,_listgroupinfo.back(),iktype,_1,_2,_3));
-                        }
-                        else {
-                            _listvelocityfns.push_back(boost::bind(&TrajectoryRetimer::_ComputeVelocitiesIk,this,_listgroupinfo.back(),iktype,_1,_2,_3));
-                        }
-                        _listwritefns.push_back(boost::bind(&TrajectoryRetimer::_WriteIk,this,_listgroupinfo.back(),iktype,_1,_2,_3));
+                        handler.iktype = static_cast<IkParameterizationType>(niktype);
                     }
+                    _vgrouphandlers.push_back(handler);
 
                     gpos.interpolation = posinterpolation;
                     itvelgroup->interpolation = velinterpolation;
@@ -272,8 +260,8 @@ public:
                 }
             }
             else {
-                FOREACH(it, _listgroupinfo) {
-                    ResetCachedGroupInfo(*it);
+                FOREACH(ithandler, _vgrouphandlers) {
+                    ResetCachedGroupInfo(ithandler->info);
                 }
             }
 
@@ -282,55 +270,69 @@ public:
             std::vector<dReal>::iterator itdata = _vdata.begin();
             _vdata.at(_timeoffset) = 0;
             // set velocities to 0
-            FOREACH(it, _listgroupinfo) {
-                int offset = (*it)->gvel.offset;
-                for(int j = 0; j < (*it)->gvel.dof; ++j) {
+            FOREACHC(ithandler, _vgrouphandlers) {
+                int offset = ithandler->info->gvel.offset;
+                for(int j = 0; j < ithandler->info->gvel.dof; ++j) {
                     _vdata.at(offset+j) = 0; // initial
                     _vdata.at(_vdata.size()-dof+offset+j) = 0; // end
                 }
             }
 
-            // get the diff states
-            vector<dReal>& vprev = _vtempdata0; vprev.resize(_cachedoldspec.GetDOF());
-            vector<dReal>& vnext = _vtempdata1; vnext.resize(_cachedoldspec.GetDOF());
-            std::copy(_vdiffdata.end()-_cachedoldspec.GetDOF(),_vdiffdata.end(),vnext.begin());
+            // get the diff states, swapping the buffers so that no point is copied twice
+            int olddof = _cachedoldspec.GetDOF();
+            vector<dReal>& vprev = _vtempdata0; vprev.resize(olddof);
+            vector<dReal>& vnext = _vtempdata1; vnext.resize(olddof);
+            std::copy(_vdiffdata.end()-olddof,_vdiffdata.end(),vnext.begin());
             for(size_t i = numpoints-1; i > 0; --i) {
-                std::copy(_vdiffdata.begin()+(i-1)*_cachedoldspec.GetDOF(),_vdiffdata.begin()+(i)*_cachedoldspec.GetDOF(),vprev.begin());
+                std::copy(_vdiffdata.begin()+(i-1)*olddof,_vdiffdata.begin()+i*olddof,vprev.begin());
                 _parameters->_diffstatefn(vnext,vprev);
-                std::copy(vnext.begin(),vnext.end(),_vdiffdata.begin()+i*_cachedoldspec.GetDOF());
-                vnext = vprev;
+                std::copy(vnext.begin(),vnext.end(),_vdiffdata.begin()+i*olddof);
+                vnext.swap(vprev);
             }
 
             if( _parameters->_hastimestamps ) {
                 ptraj->GetWaypoints(0, numpoints, _vtempdata0,*itoldgrouptime);
-                ConfigurationSpecification::ConvertData(_vdata.begin(), _cachednewspec, _vtempdata0.begin(), *itoldgrouptime, numpoints, GetEnv(), false);
+                ConfigurationSpecification timespec(*itoldgrouptime);
+                if( !_timeplan.IsBuiltFor(_cachednewspec, timespec, false) ) {
+                    _timeplan.Init(_cachednewspec, timespec, GetEnv(), false);
+                }
+                _timeplan.Apply(_vdata.begin(), _vtempdata0.begin(), numpoints);
             }
             if( _parameters->_hasvelocities ) {
                 ptraj->GetWaypoints(0,numpoints,_vtempdata0,velspec);
-                ConfigurationSpecification::ConvertData(_vdata.begin(),_cachednewspec,_vtempdata0.begin(),velspec,numpoints,GetEnv(),false);
+                if( !_velocityplan.IsBuiltFor(_cachednewspec, velspec, false) ) {
+                    _velocityplan.Init(_cachednewspec, velspec, GetEnv(), false);
+                }
+                _velocityplan.Apply(_vdata.begin(), _vtempdata0.begin(), numpoints);
             }
             try {
-                std::vector<dReal>::iterator itorgdiff = _vdiffdata.begin()+_cachedoldspec.GetDOF();
-                std::vector<dReal>::iterator itdataprev = itdata;
-                itdata += dof;
-                for(size_t i = 1; i < numpoints; ++i, itdata += dof, itorgdiff += _cachedoldspec.GetDOF()) {
-                    dReal mintime = 0;
-                    bool bUseEndVelocity = i+1==numpoints;
-                    if( _parameters->_hastimestamps && _parameters->_hasvelocities ) {
-                        // positions, velocities, and timestamps already filled, so check everything
-                        FOREACH(itfn, _listcheckvelocityfns) {
-                            if( !(*itfn)(itdataprev, itdata, 7) ) {
-                                RAVELOG_VERBOSE_FORMAT("point %d/%d has unreachable velocity", i%numpoints);
-                                if( IS_DEBUGLEVEL(Level_Verbose) ) {
-                                    (*itfn)(itdataprev, itdata, 7);
+                bool bTimesFixed = _parameters->_hastimestamps && _parameters->_hasvelocities;
+                if( bTimesFixed ) {
+                    // positions, velocities, and timestamps already filled, so every segment can be checked independently
+                    size_t ifailed = _CheckSegmentsParallel(numpoints, dof);
+                    if( ifailed < numpoints ) {
+                        RAVELOG_VERBOSE_FORMAT("point %d/%d has unreachable velocity", ifailed%numpoints);
+                        if( IS_DEBUGLEVEL(Level_Verbose) ) {
+                            // check the failed segment again on this thread so the group handlers log why it failed
+                            std::vector<dReal>::iterator itfailed = _vdata.begin()+ifailed*dof;
+                            FOREACHC(ithandler, _vgrouphandlers) {
+                                if( !_Check(*ithandler, itfailed-dof, itfailed, 7) ) {
+                                    break;
                                 }
-                                return PS_Failed;
                             }
                         }
+                        return PS_Failed;
                     }
-                    else {
-                        FOREACH(itmin, _listmintimefns) {
-                            dReal fgrouptime = (*itmin)(itorgdiff, itdataprev, itdata,bUseEndVelocity);
+                }
+                std::vector<dReal>::iterator itorgdiff = _vdiffdata.begin()+olddof;
+                std::vector<dReal>::iterator itdataprev = itdata;
+                itdata += dof;
+                for(size_t i = 1; i < numpoints; ++i, itdata += dof, itorgdiff += olddof) {
+                    dReal mintime = 0;
+                    bool bUseEndVelocity = i+1==numpoints;
+                    if( !bTimesFixed ) {
+                        FOREACHC(ithandler, _vgrouphandlers) {
+                            dReal fgrouptime = _ComputeMinimumTime(*ithandler, itorgdiff, itdataprev, itdata, bUseEndVelocity);
                             if( fgrouptime < 0 ) {
                                 RAVELOG_VERBOSE_FORMAT("point %d/%d has uncomputable minimum time, possibly due to boundary constraints", i%numpoints);
                                 return PS_Failed;
@@ -359,8 +361,8 @@ public:
                             *(itdata+_timeoffset) = mintime;
                         }
                         if( _parameters->_hasvelocities ) {
-                            FOREACH(itfn,_listcheckvelocityfns) {
-                                if( !(*itfn)(itdataprev, itdata, 6) ) {
+                            FOREACHC(ithandler, _vgrouphandlers) {
+                                if( !_Check(*ithandler, itdataprev, itdata, 6) ) {
                                     RAVELOG_WARN(str(boost::format("point %d/%d has unreachable velocity")%i%numpoints));
                                     return PS_Failed;
                                 }
@@ -368,14 +370,14 @@ public:
                         }
                         else {
                             // given the mintime, fill the velocities
-                            FOREACH(itfn,_listvelocityfns) {
-                                (*itfn)(itorgdiff, itdataprev, itdata);
+                            FOREACHC(ithandler, _vgrouphandlers) {
+                                _ComputeVelocities(*ithandler, itorgdiff, itdataprev, itdata);
                             }
                         }
                     }
-                    FOREACH(itfn,_listwritefns) {
+                    FOREACHC(ithandler, _vgrouphandlers) {
                         // because the initial time for each ramp could have been stretched to accomodate other points, it is possible for this to fail
-                        if( !(*itfn)(itorgdiff, itdataprev, itdata) ) {
+                        if( !_Write(*ithandler, itorgdiff, itdataprev, itdata) ) {
                             RAVELOG_VERBOSE_FORMAT("point %d/%d has unreachable new time %es, probably due to acceleration limtis violated.", i%numpoints%(*(itdata+_timeoffset)));
                             return PS_Failed;
                         }
@@ -406,6 +408,116 @@ public:
     }
 
 protected:
+    bool _SetMaxThreadsCommand(std::ostream& sout, std::istream& sinput)
+    {
+        int nMaxThreads = 0;
+        sinput >> nMaxThreads;
+        if( !sinput || nMaxThreads <= 0 ) {
+            return false;
+        }
+        _nMaxThreads = nMaxThreads;
+        return true;
+    }
+
+    inline dReal _ComputeMinimumTime(const GroupHandler& handler, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity)
+    {
+        switch(handler.grouptype) {
+        case GT_JointValues: return _ComputeMinimumTimeJointValues(handler.constinfo, itorgdiff, itdataprev, itdata, bUseEndVelocity);
+        case GT_Affine: return _ComputeMinimumTimeAffine(handler.constinfo, handler.affinedofs, itorgdiff, itdataprev, itdata, bUseEndVelocity);
+        case GT_Ik: return _ComputeMinimumTimeIk(handler.constinfo, handler.iktype, itorgdiff, itdataprev, itdata, bUseEndVelocity);
+        }
+        return -1;
+    }
+
+    inline void _ComputeVelocities(const GroupHandler& handler, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
+    {
+        switch(handler.grouptype) {
+        case GT_JointValues: _ComputeVelocitiesJointValues(handler.constinfo, itorgdiff, itdataprev, itdata); break;
+        case GT_Affine: _ComputeVelocitiesAffine(handler.constinfo, handler.affinedofs, itorgdiff, itdataprev, itdata); break;
+        case GT_Ik: _ComputeVelocitiesIk(handler.constinfo, handler.iktype, itorgdiff, itdataprev, itdata); break;
+        }
+    }
+
+    inline bool _Check(const GroupHandler& handler, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions)
+    {
+        switch(handler.grouptype) {
+        case GT_JointValues: return _CheckJointValues(handler.constinfo, itdataprev, itdata, checkoptions);
+        case GT_Affine: return _CheckAffine(handler.constinfo, handler.affinedofs, itdataprev, itdata, checkoptions);
+        case GT_Ik: return _CheckIk(handler.constinfo, handler.iktype, itdataprev, itdata, checkoptions);
+        }
+        return false;
+    }
+
+    inline bool _Write(const GroupHandler& handler, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata)
+    {
+        switch(handler.grouptype) {
+        case GT_JointValues: return _WriteJointValues(handler.constinfo, itorgdiff, itdataprev, itdata);
+        case GT_Affine: return _WriteAffine(handler.constinfo, handler.affinedofs, itorgdiff, itdataprev, itdata);
+        case GT_Ik: return _WriteIk(handler.constinfo, handler.iktype, itorgdiff, itdataprev, itdata);
+        }
+        return false;
+    }
+
+    /// \brief checks all groups of the segments ending at points [istart,iend) of _vdata. Sets ifailed to the first failing point, or iend.
+    void _CheckSegments(size_t istart, size_t iend, int dof, size_t& ifailed, std::string& error)
+    {
+        ifailed = iend;
+        try {
+            std::vector<dReal>::iterator itdata = _vdata.begin()+istart*dof;
+            for(size_t i = istart; i < iend; ++i, itdata += dof) {
+                FOREACHC(ithandler, _vgrouphandlers) {
+                    if( !_Check(*ithandler, itdata-dof, itdata, 7) ) {
+                        ifailed = i;
+                        return;
+                    }
+                }
+            }
+        }
+        catch(const std::exception& ex) {
+            ifailed = istart;
+            error = ex.what();
+        }
+    }
+
+    /// \brief checks all the segments of _vdata in blocks, one block per thread when the trajectory is long enough. Returns the first failing point or numpoints.
+    size_t _CheckSegmentsParallel(size_t numpoints, int dof)
+    {
+        static const size_t s_nMinSegmentsPerThread = 512;
+        size_t numsegments = numpoints-1;
+        size_t numthreads = std::min((size_t)_nMaxThreads, numsegments/s_nMinSegmentsPerThread);
+        if( numthreads <= 1 ) {
+            size_t ifailed = numpoints;
+            std::string error;
+            _CheckSegments(1, numpoints, dof, ifailed, error);
+            if( error.size() > 0 ) {
+                throw openrave_exception(error);
+            }
+            return ifailed;
+        }
+
+        size_t blocksize = (numsegments+numthreads-1)/numthreads;
+        std::vector<size_t> vfailed(numthreads, numpoints);
+        std::vector<std::string> verrors(numthreads);
+        boost::thread_group threads;
+        for(size_t ithread = 0; ithread < numthreads; ++ithread) {
+            size_t istart = 1+ithread*blocksize, iend = std::min(numpoints, istart+blocksize);
+            if( istart < iend ) {
+                threads.create_thread(boost::bind(&TrajectoryRetimer::_CheckSegments, this, istart, iend, dof, boost::ref(vfailed[ithread]), boost::ref(verrors[ithread])));
+            }
+        }
+        threads.join_all();
+        for(size_t ithread = 0; ithread < numthreads; ++ithread) {
+            if( verrors[ithread].size() > 0 ) {
+                throw openrave_exception(verrors[ithread]);
+            }
+            size_t iend = std::min(numpoints, 1+(ithread+1)*blocksize);
+            if( vfailed[ithread] < iend ) {
+                return vfailed[ithread];
+            }
+        }
+        return numpoints;
+    }
+
     // method to be overriden by individual timing types
 
     /// \brief createa s group info
@@ -419,35 +531,36 @@ protected:
     virtual bool _SupportInterpolation() = 0;
     
     /// \brief compute the minimum time to achieve the point. returns a mintime>=0 if successeeded, otherwise returns value < 0.
-    virtual dReal _ComputeMinimumTimeJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) = 0;
+    virtual dReal _ComputeMinimumTimeJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) = 0;
     /// \brief given the delta time, compute the velocities in the data
-    virtual void _ComputeVelocitiesJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) = 0;
+    virtual void _ComputeVelocitiesJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) = 0;
     /// \brief given the computed deltatime and velocities at each point, check position, velocity, and acceleration limits
     /// checkoptions. If 1 checks positions. If 2, checks velocities, If 4, checks accelerations
-    virtual bool _CheckJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
+    /// The check functions can be called from several threads at once, so they should not modify any members.
+    virtual bool _CheckJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
         return true;
     }
-    virtual bool _WriteJointValues(GroupInfoConstPtr info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    virtual bool _WriteJointValues(const GroupInfoConstPtr& info, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         return true;
     }
 
-    virtual dReal _ComputeMinimumTimeAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) = 0;
-    virtual void _ComputeVelocitiesAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) = 0;
-    virtual bool _CheckAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
+    virtual dReal _ComputeMinimumTimeAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) = 0;
+    virtual void _ComputeVelocitiesAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) = 0;
+    virtual bool _CheckAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
         return true;
     }
-    virtual bool _WriteAffine(GroupInfoConstPtr info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    virtual bool _WriteAffine(const GroupInfoConstPtr& info, int affinedofs, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         return true;
     }
 
     // speed of rotations is always the speed of the angle along the minimum rotation
     // speed of translations is always the combined xyz speed
-    virtual dReal _ComputeMinimumTimeIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) = 0;
-    virtual void _ComputeVelocitiesIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) = 0;
-    virtual bool _CheckIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
+    virtual dReal _ComputeMinimumTimeIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::const_iterator itdata, bool bUseEndVelocity) = 0;
+    virtual void _ComputeVelocitiesIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) = 0;
+    virtual bool _CheckIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata, int checkoptions=0xffffffff) {
         return true;
     }
-    virtual bool _WriteIk(GroupInfoConstPtr info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
+    virtual bool _WriteIk(const GroupInfoConstPtr& info, IkParameterizationType iktype, std::vector<dReal>::const_iterator itorgdiff, std::vector<dReal>::const_iterator itdataprev, std::vector<dReal>::iterator itdata) {
         return true;
     }
 
@@ -461,14 +574,12 @@ protected:
     // caching
     ConfigurationSpecification _cachedoldspec, _cachednewspec; ///< the configuration specification that the cached structures have been set for
     std::string _cachedposinterpolation;
-    std::list< boost::function<dReal(std::vector<dReal>::const_iterator,std::vector<dReal>::const_iterator,std::vector<dReal>::const_iterator,bool) > > _listmintimefns;
-    std::list< boost::function<void(std::vector<dReal>::const_iterator,std::vector<dReal>::const_iterator,std::vector<dReal>::iterator) > > _listvelocityfns;
-    std::list< boost::function<bool(std::vector<dReal>::const_iterator,std::vector<dReal>::iterator, int) > > _listcheckvelocityfns;
-    std::list< boost::function<bool(std::vector<dReal>::const_iterator,std::vector<dReal>::const_iterator,std::vector<dReal>::iterator) > > _listwritefns;
+    std::vector<GroupHandler> _vgrouphandlers;
+    ConfigurationSpecification::ConversionPlan _initialplan, _timeplan, _velocityplan;
     std::vector<dReal> _vimaxvel, _vimaxaccel;
     std::vector<dReal> _vdiffdata, _vdata;
     int _timeoffset;
-    std::list<GroupInfoPtr> _listgroupinfo;
+    int _nMaxThreads; ///< maximum number of threads for checking segments
     vector<dReal> _vtempdata0, _vtempdata1;
 };
 
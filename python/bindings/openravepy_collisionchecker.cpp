@@ -166,12 +166,19 @@ public:
     bool CheckCollision(PyKinBodyPtr pbody1)
     {
         CHECK_POINTER(pbody1);
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
         return _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)));
     }
     bool CheckCollision(PyKinBodyPtr pbody1, PyCollisionReportPtr pReport)
     {
         CHECK_POINTER(pbody1);
-        bool bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+            bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,_pyenv);
         return bCollision;
     }
@@ -180,6 +187,8 @@ public:
     {
         CHECK_POINTER(pbody1);
         CHECK_POINTER(pbody2);
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
         return _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)));
     }
 
@@ -187,7 +196,12 @@ public:
     {
         CHECK_POINTER(pbody1);
         CHECK_POINTER(pbody2);
-        bool bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+            bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,_pyenv);
         return bCollision;
     }
@@ -197,10 +211,14 @@ public:
         CHECK_POINTER(o1);
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             return _pCollisionChecker->CheckCollision(plink);
         }
         KinBodyConstPtr pbody = openravepy::GetKinBody(o1);
         if( !!pbody ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             return _pCollisionChecker->CheckCollision(pbody);
         }
         throw OPENRAVE_EXCEPTION_FORMAT0(_("CheckCollision(object) invalid argument"),ORE_InvalidArguments);
@@ -212,11 +230,15 @@ public:
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         bool bCollision;
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             bCollision = _pCollisionChecker->CheckCollision(plink,openravepy::GetCollisionReport(pReport));
         }
         else {
             KinBodyConstPtr pbody = openravepy::GetKinBody(o1);
             if( !!pbody ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 bCollision = _pCollisionChecker->CheckCollision(pbody,openravepy::GetCollisionReport(pReport));
             }
             else {
@@ -235,15 +257,24 @@ public:
         if( !!plink ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 return _pCollisionChecker->CheckCollision(plink,plink2);
             }
             KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
             if( !!pbody2 ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 return _pCollisionChecker->CheckCollision(plink,pbody2);
             }
             CollisionReportPtr preport2 = openravepy::GetCollisionReport(o2);
             if( !!preport2 ) {
-                bool bCollision = _pCollisionChecker->CheckCollision(plink,preport2);
+                bool bCollision;
+                {
+                    openravepy::PythonThreadSaver threadsaver;
+                    EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+                    bCollision = _pCollisionChecker->CheckCollision(plink,preport2);
+                }
                 openravepy::UpdateCollisionReport(o2,_pyenv);
                 return bCollision;
             }
@@ -253,15 +284,24 @@ public:
         if( !!pbody ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 return _pCollisionChecker->CheckCollision(plink2,pbody);
             }
             KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
             if( !!pbody2 ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 return _pCollisionChecker->CheckCollision(pbody,pbody2);
             }
             CollisionReportPtr preport2 = openravepy::GetCollisionReport(o2);
             if( !!preport2 ) {
-                bool bCollision = _pCollisionChecker->CheckCollision(pbody,preport2);
+                bool bCollision;
+                {
+                    openravepy::PythonThreadSaver threadsaver;
+                    EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+                    bCollision = _pCollisionChecker->CheckCollision(pbody,preport2);
+                }
                 openravepy::UpdateCollisionReport(o2,_pyenv);
                 return bCollision;
             }
@@ -278,11 +318,15 @@ public:
         if( !!plink ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 bCollision = _pCollisionChecker->CheckCollision(plink,plink2, openravepy::GetCollisionReport(pReport));
             }
             else {
                 KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
                 if( !!pbody2 ) {
+                    openravepy::PythonThreadSaver threadsaver;
+                    EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                     bCollision = _pCollisionChecker->CheckCollision(plink,pbody2, openravepy::GetCollisionReport(pReport));
                 }
                 else {
@@ -295,11 +339,15 @@ public:
             if( !!pbody ) {
                 KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
                 if( !!plink2 ) {
+                    openravepy::PythonThreadSaver threadsaver;
+                    EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                     bCollision = _pCollisionChecker->CheckCollision(plink2,pbody, openravepy::GetCollisionReport(pReport));
                 }
                 else {
                     KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
                     if( !!pbody2 ) {
+                        openravepy::PythonThreadSaver threadsaver;
+                        EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                         bCollision = _pCollisionChecker->CheckCollision(pbody,pbody2, openravepy::GetCollisionReport(pReport));
                     }
                     else {
@@ -322,10 +370,14 @@ public:
         KinBodyConstPtr pbody2 = openravepy::GetKinBody(pybody2);
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             return _pCollisionChecker->CheckCollision(plink,pbody2);
         }
         KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
         if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             return _pCollisionChecker->CheckCollision(pbody1,pbody2);
         }
         throw OPENRAVE_EXCEPTION_FORMAT0(_("CheckCollision(object) invalid argument"),ORE_InvalidArguments);
@@ -339,11 +391,15 @@ public:
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         bool bCollision = false;
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             bCollision = _pCollisionChecker->CheckCollision(plink,pbody2,openravepy::GetCollisionReport(pReport));
         }
         else {
             KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
             if( !!pbody1 ) {
+                openravepy::PythonThreadSaver threadsaver;
+                EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
                 bCollision = _pCollisionChecker->CheckCollision(pbody1,pbody2,openravepy::GetCollisionReport(pReport));
             }
             else {
@@ -385,9 +441,13 @@ public:
             }
         }
         if( !!plink1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             return _pCollisionChecker->CheckCollision(plink1,vbodyexcluded,vlinkexcluded);
         }
         else if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             return _pCollisionChecker->CheckCollision(pbody1,vbodyexcluded,vlinkexcluded);
         }
         else {
@@ -423,9 +483,13 @@ public:
 
         bool bCollision=false;
         if( !!plink1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             bCollision = _pCollisionChecker->CheckCollision(plink1, vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
         }
         else if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             bCollision = _pCollisionChecker->CheckCollision(pbody1, vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
         }
         else {
@@ -458,6 +522,8 @@ public:
                 RAVELOG_ERROR("failed to get excluded link\n");
             }
         }
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
         return _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)),vbodyexcluded,vlinkexcluded);
     }
 
@@ -484,96 +550,90 @@ public:
             }
         }
 
-        bool bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)), vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+            bCollision = _pCollisionChecker->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)), vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,_pyenv);
         return bCollision;
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray, PyKinBodyPtr pbody)
     {
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
         return _pCollisionChecker->CheckCollision(pyray->r,KinBodyConstPtr(openravepy::GetKinBody(pbody)));
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray, PyKinBodyPtr pbody, PyCollisionReportPtr pReport)
     {
-        bool bCollision = _pCollisionChecker->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+            bCollision = _pCollisionChecker->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,_pyenv);
         return bCollision;
     }
 
     object CheckCollisionRays(object rays, PyKinBodyPtr pbody,bool bFrontFacingOnly=false)
     {
-        object shape = rays.attr("shape");
-        int num = extract<int>(shape[0]);
-        if( num == 0 ) {
-            return boost::python::make_tuple(numeric::array(boost::python::list()).astype("i4"),numeric::array(boost::python::list()));
-        }
-        if( extract<int>(shape[1]) != 6 ) {
-            throw openrave_exception(_("rays object needs to be a Nx6 vector\n"));
-        }
-        CollisionReport report;
-        CollisionReportPtr preport(&report,null_deleter());
-
-        RAY r;
-        npy_intp dims[] = { num,6};
-        PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-        dReal* ppos = (dReal*)PyArray_DATA(pypos);
-        PyObject* pycollision = PyArray_SimpleNew(1,&dims[0], PyArray_BOOL);
-        bool* pcollision = (bool*)PyArray_DATA(pycollision);
-        for(int i = 0; i < num; ++i, ppos += 6) {
-            vector<dReal> ray = ExtractArray<dReal>(rays[i]);
-            r.pos.x = ray[0];
-            r.pos.y = ray[1];
-            r.pos.z = ray[2];
-            r.dir.x = ray[3];
-            r.dir.y = ray[4];
-            r.dir.z = ray[5];
-            bool bCollision;
-            if( !pbody ) {
-                bCollision = _pCollisionChecker->CheckCollision(r, preport);
-            }
-            else {
-                bCollision = _pCollisionChecker->CheckCollision(r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
-            }
-            pcollision[i] = false;
-            ppos[0] = 0; ppos[1] = 0; ppos[2] = 0; ppos[3] = 0; ppos[4] = 0; ppos[5] = 0;
-            if( bCollision &&( report.contacts.size() > 0) ) {
-                if( !bFrontFacingOnly ||( report.contacts[0].norm.dot3(r.dir)<0) ) {
-                    pcollision[i] = true;
-                    ppos[0] = report.contacts[0].pos.x;
-                    ppos[1] = report.contacts[0].pos.y;
-                    ppos[2] = report.contacts[0].pos.z;
-                    ppos[3] = report.contacts[0].norm.x;
-                    ppos[4] = report.contacts[0].norm.y;
-                    ppos[5] = report.contacts[0].norm.z;
-                }
-            }
-        }
-
-        return boost::python::make_tuple(static_cast<numeric::array>(handle<>(pycollision)),static_cast<numeric::array>(handle<>(pypos)));
+        return openravepy::CheckCollisionRays(EnvironmentBasePtr(), _pCollisionChecker, rays, !pbody ? KinBodyConstPtr() : KinBodyConstPtr(openravepy::GetKinBody(pbody)), bFrontFacingOnly);
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray)
     {
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
         return _pCollisionChecker->CheckCollision(pyray->r);
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray, PyCollisionReportPtr pReport)
     {
-        bool bCollision = _pCollisionChecker->CheckCollision(pyray->r, openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
+            bCollision = _pCollisionChecker->CheckCollision(pyray->r, openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,_pyenv);
         return bCollision;
     }
 
+    bool CheckContinuousCollision(PyKinBodyPtr pybody, object odofindices, object oq0, object oq1, object odq0=object(), object odq1=object(), dReal timeelapsed=0, dReal fmindistance=1e-4, PyCollisionReportPtr pReport=PyCollisionReportPtr())
+    {
+        CHECK_POINTER(pybody);
+        std::vector<int> vdofindices = ExtractArray<int>(odofindices);
+        std::vector<dReal> q0 = ExtractArray<dReal>(oq0), q1 = ExtractArray<dReal>(oq1), dq0, dq1;
+        if( !IS_PYTHONOBJECT_NONE(odq0) ) {
+            dq0 = ExtractArray<dReal>(odq0);
+        }
+        if( !IS_PYTHONOBJECT_NONE(odq1) ) {
+            dq1 = ExtractArray<dReal>(odq1);
+        }
+        bool bCollision = _pCollisionChecker->CheckContinuousCollision(openravepy::GetKinBody(pybody), vdofindices, q0, q1, dq0, dq1, timeelapsed, fmindistance, openravepy::GetCollisionReport(pReport));
+        if( !!pReport ) {
+            openravepy::UpdateCollisionReport(pReport,_pyenv);
+        }
+        return bCollision;
+    }
+
     virtual bool CheckSelfCollision(object o1, PyCollisionReportPtr pReport)
     {
         KinBody::LinkConstPtr plink1 = openravepy::GetKinBodyLinkConst(o1);
         KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
         bool bCollision;
         if( !!plink1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             bCollision = _pCollisionChecker->CheckSelfCollision(plink1, openravepy::GetCollisionReport(pReport));
         }
         else if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_pCollisionChecker->GetEnv()->GetMutex());
             bCollision = _pCollisionChecker->CheckSelfCollision(pbody1, openravepy::GetCollisionReport(pReport));
         }
         else {
@@ -584,6 +644,42 @@ public:
     }
 };
 
+object CheckCollisionRays(EnvironmentBasePtr penv, CollisionCheckerBasePtr pchecker, object rays, KinBodyConstPtr pbody, bool bFrontFacingOnly)
+{
+    // view the rays as a contiguous Nx6 array, only copies if the input has another type or layout
+    PyObject* pyrays = PyArray_FROMANY(rays.ptr(), sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT, 1, 2, NPY_C_CONTIGUOUS|NPY_ALIGNED);
+    if( !pyrays ) {
+        throw_error_already_set();
+    }
+    handle<> hrays(pyrays);
+    npy_intp num = PyArray_DIM(pyrays, 0);
+    if( num == 0 ) {
+        return boost::python::make_tuple(numeric::array(boost::python::list()).astype("i4"),numeric::array(boost::python::list()));
+    }
+    if( PyArray_NDIM(pyrays) != 2 || PyArray_DIM(pyrays, 1) != 6 ) {
+        throw openrave_exception(_("rays object needs to be a Nx6 vector\n"));
+    }
+
+    npy_intp dims[] = { num,6};
+    PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
+    handle<> hpos(pypos);
+    PyObject* pycollision = PyArray_SimpleNew(1,&dims[0], PyArray_BOOL);
+    handle<> hcollision(pycollision);
+    const dReal* prays = (const dReal*)PyArray_DATA(pyrays);
+    {
+        // the results are written straight into the numpy arrays, so python is not needed for the whole batch
+        openravepy::PythonThreadSaver threadsaver;
+        if( !!penv ) {
+            penv->CheckCollisionRays(prays, (int)num, pbody, (uint8_t*)PyArray_DATA(pycollision), (dReal*)PyArray_DATA(pypos), bFrontFacingOnly);
+        }
+        else {
+            EnvironmentMutex::scoped_lock lockenv(pchecker->GetEnv()->GetMutex());
+            pchecker->CheckCollisionRays(prays, (int)num, pbody, (uint8_t*)PyArray_DATA(pycollision), (dReal*)PyArray_DATA(pypos), bFrontFacingOnly);
+        }
+    }
+    return boost::python::make_tuple(static_cast<numeric::array>(hcollision),static_cast<numeric::array>(hpos));
+}
+
 CollisionCheckerBasePtr GetCollisionChecker(PyCollisionCheckerBasePtr pyCollisionChecker)
 {
     return !pyCollisionChecker ? CollisionCheckerBasePtr() : pyCollisionChecker->GetCollisionChecker();
@@ -646,6 +742,7 @@ PyCollisionCheckerBasePtr RaveCreateCollisionChecker(PyEnvironmentBasePtr pyenv,
 }
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CheckCollisionRays_overloads, CheckCollisionRays, 2, 3)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CheckContinuousCollision_overloads, CheckContinuousCollision, 4, 9)
 
 void init_openravepy_collisionchecker()
 {
@@ -730,6 +827,8 @@ void init_openravepy_collisionchecker()
     .def("CheckCollision",pcoly,args("ray"), DOXY_FN(CollisionCheckerBase,CheckCollision "const RAY; CollisionReportPtr"))
     .def("CheckCollision",pcolyr,args("ray", "report"), DOXY_FN(CollisionCheckerBase,CheckCollision "const RAY; CollisionReportPtr"))
     .def("CheckSelfCollision",&PyCollisionCheckerBase::CheckSelfCollision,args("linkbody", "report"), DOXY_FN(CollisionCheckerBase,CheckSelfCollision "KinBodyConstPtr, CollisionReportPtr"))
+    .def("CheckContinuousCollision",&PyCollisionCheckerBase::CheckContinuousCollision,
+         CheckContinuousCollision_overloads(args("body","dofindices","q0","q1","dq0","dq1","timeelapsed","mindistance","report"), DOXY_FN(CollisionCheckerBase,CheckContinuousCollision)))
     .def("CheckCollisionRays",&PyCollisionCheckerBase::CheckCollisionRays,
          CheckCollisionRays_overloads(args("rays","body","front_facing_only"),
                                       "Check if any rays hit the body and returns their contact points along with a vector specifying if a collision occured or not. Rays is a Nx6 array, first 3 columsn are position, last 3 are direction+range."))
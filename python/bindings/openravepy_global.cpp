@@ -1085,6 +1085,12 @@ void init_openravepy_global()
     .value("Real",SDT_Real)
     .value("Uint32",SDT_Uint32)
     ;
+    enum_<TraceEventType>("TraceEventType" DOXY_ENUM(TraceEventType))
+    .value("PlannerIteration",TET_PlannerIteration)
+    .value("CollisionQuery",TET_CollisionQuery)
+    .value("IkSolve",TET_IkSolve)
+    .value("ConstraintFailure",TET_ConstraintFailure)
+    ;
 
     class_<UserData, UserDataPtr >("UserData", DOXY_CLASS(UserData))
     ;
@@ -63,6 +63,25 @@ object toPyArray(const Transform& t)
     return static_cast<numeric::array>(handle<>(pyvalues));
 }
 
+dReal* ExtractOutputArray(object oout, size_t N)
+{
+    PyObject* pyout = oout.ptr();
+    if( !PyArray_Check(pyout) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0(_("out needs to be a numpy array"), ORE_InvalidArguments);
+    }
+    PyArrayObject* pyarray = (PyArrayObject*)pyout;
+    if( PyArray_TYPE(pyarray) != (sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0(_("out needs to have the same float type as dReal"), ORE_InvalidArguments);
+    }
+    if( !PyArray_ISCARRAY(pyarray) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0(_("out needs to be a writeable, aligned and C-contiguous array"), ORE_InvalidArguments);
+    }
+    if( (size_t)PyArray_SIZE(pyarray) != N ) {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("out has %d elements, but %d are needed"), (int)PyArray_SIZE(pyarray)%(int)N, ORE_InvalidArguments);
+    }
+    return (dReal*)PyArray_DATA(pyarray);
+}
+
 AttributesList toAttributesList(boost::python::dict odict)
 {
     AttributesList atts;
@@ -385,6 +404,7 @@ bool PyInterfaceBase::SupportsCommand(const string& cmd)
 object PyInterfaceBase::SendCommand(const string& in, bool releasegil, bool lockenv)
 {
     stringstream sin(in), sout;
+    bool bSuccess;
     {
         openravepy::PythonThreadSaverPtr statesaver;
         openravepy::PyEnvironmentLockSaverPtr envsaver;
@@ -402,13 +422,117 @@ object PyInterfaceBase::SendCommand(const string& in, bool releasegil, bool lock
             }
         }
         sout << std::setprecision(std::numeric_limits<dReal>::digits10+1);     /// have to do this or otherwise precision gets lost
-        if( !_pbase->SendCommand(sout,sin) ) {
-            return object();
-        }
+        bSuccess = _pbase->SendCommand(sout,sin);
+    }
+    // python objects can only be created once the GIL is held again
+    if( !bSuccess ) {
+        return object();
     }
     return object(sout.str());
 }
 
+/// \brief converts a python value to a CommandValue. Lists of integers are CVT_Ints, other lists are CVT_Reals and matrices are CVT_Transform.
+static CommandValue ExtractCommandValue(object o)
+{
+    if( IS_PYTHONOBJECT_NONE(o) ) {
+        return CommandValue();
+    }
+    if( PyBool_Check(o.ptr()) ) {
+        return CommandValue((bool)extract<bool>(o));
+    }
+    extract<int64_t> xint(o);
+    if( xint.check() ) {
+        return CommandValue((int64_t)xint);
+    }
+    extract<dReal> xreal(o);
+    if( xreal.check() ) {
+        return CommandValue((dReal)xreal);
+    }
+    extract<std::string> xstring(o);
+    if( xstring.check() ) {
+        return CommandValue((std::string)xstring);
+    }
+    size_t num = len(o);
+    if( num > 0 && !extract<dReal>(o[0]).check() ) {
+        // rows of a 4x4 or 3x4 matrix
+        return CommandValue(ExtractTransform(o));
+    }
+    bool bints = num > 0;
+    if( PyObject_HasAttrString(o.ptr(), "dtype") ) {
+        std::string kind = extract<std::string>(o.attr("dtype").attr("kind"));
+        bints = kind == "i" || kind == "u";
+    }
+    else {
+        for(size_t i = 0; i < num && bints; ++i) {
+            bints = extract<int64_t>(o[i]).check();
+        }
+    }
+    if( bints ) {
+        return CommandValue(ExtractArray<int>(o));
+    }
+    return CommandValue(ExtractArray<dReal>(o));
+}
+
+static object toPyCommandValue(const CommandValue& value)
+{
+    switch(value.type) {
+    case CVT_None:
+        break;
+    case CVT_Bool:
+        return object(value.intvalue != 0);
+    case CVT_Int:
+        return object(value.intvalue);
+    case CVT_Real:
+        return object(value.realvalue);
+    case CVT_String:
+        return object(value.stringvalue);
+    case CVT_Ints:
+        return toPyArray(value.intvalues);
+    case CVT_Reals:
+        return toPyArray(value.realvalues);
+    case CVT_Transform:
+        return ReturnTransform(value.transform);
+    }
+    return object();
+}
+
+object PyInterfaceBase::SendStructuredCommand(const string& cmd, object oargs, bool releasegil, bool lockenv)
+{
+    std::vector<CommandValue> vargs, vresults;
+    if( !IS_PYTHONOBJECT_NONE(oargs) ) {
+        size_t num = len(oargs);
+        vargs.reserve(num);
+        for(size_t i = 0; i < num; ++i) {
+            vargs.push_back(ExtractCommandValue(oargs[i]));
+        }
+    }
+    bool bSuccess;
+    {
+        openravepy::PythonThreadSaverPtr statesaver;
+        openravepy::PyEnvironmentLockSaverPtr envsaver;
+        if( releasegil ) {
+            statesaver.reset(new openravepy::PythonThreadSaver());
+            if( lockenv ) {
+                envsaver.reset(new openravepy::PyEnvironmentLockSaver(_pyenv, true));
+            }
+        }
+        else {
+            if( lockenv ) {
+                envsaver.reset(new openravepy::PyEnvironmentLockSaver(_pyenv, false));
+            }
+        }
+        bSuccess = _pbase->SendStructuredCommand(cmd, vargs, vresults);
+    }
+    if( !bSuccess ) {
+        return object();
+    }
+    boost::python::list oresults;
+    FOREACHC(itresult, vresults) {
+        oresults.append(toPyCommandValue(*itresult));
+    }
+    return oresults;
+}
+
 object PyInterfaceBase::GetReadableInterfaces()
 {
     boost::python::dict ointerfaces;
@@ -436,6 +560,23 @@ class PyEnvironmentBase : public boost::enable_shared_from_this<PyEnvironmentBas
 #endif
 protected:
     EnvironmentBasePtr _penv;
+    std::vector<KinBody*> _vcachebodies; ///< reused by the batch state queries. Raw pointers so the environment does not keep the bodies alive after a query, the python objects passed in hold them during the query.
+    std::vector<dReal> _vcachevalues;
+
+    /// \brief extracts the bodies of a python list into _vcachebodies and returns the size of the output needed for the batch
+    size_t _ExtractBatchBodies(object obodies, bool bdofvalues)
+    {
+        size_t numbodies = len(obodies), numvalues = 0;
+        _vcachebodies.resize(numbodies);
+        for(size_t i = 0; i < numbodies; ++i) {
+            _vcachebodies[i] = openravepy::GetKinBody(obodies[i]).get();
+            if( !_vcachebodies[i] ) {
+                throw OPENRAVE_EXCEPTION_FORMAT(_("bodies[%d] is not a KinBody"), i, ORE_InvalidArguments);
+            }
+            numvalues += bdofvalues ? _vcachebodies[i]->GetDOF() : 7*_vcachebodies[i]->GetLinks().size();
+        }
+        return numvalues;
+    }
 
     PyInterfaceBasePtr _toPyInterface(InterfaceBasePtr pinterface)
     {
@@ -462,7 +603,6 @@ protected:
 
     void _BodyCallback(object fncallback, KinBodyPtr pbody, int action)
     {
-        object res;
         PyGILState_STATE gstate = PyGILState_Ensure();
         try {
             fncallback(openravepy::toPyKinBody(pbody, shared_from_this()), action);
@@ -476,28 +616,31 @@ protected:
 
     CollisionAction _CollisionCallback(object fncallback, CollisionReportPtr preport, bool bFromPhysics)
     {
-        object res;
+        // the callback can fire from a thread that released the GIL, so every python object has to be destroyed before releasing it again
         PyGILState_STATE gstate = PyGILState_Ensure();
-        try {
-            res = fncallback(openravepy::toPyCollisionReport(preport,shared_from_this()),bFromPhysics);
-        }
-        catch(...) {
-            RAVELOG_ERROR("exception occured in python collision callback:\n");
-            PyErr_Print();
-        }
         CollisionAction ret = CA_DefaultAction;
-        if( IS_PYTHONOBJECT_NONE(res) || !res ) {
-            ret = CA_DefaultAction;
-            RAVELOG_WARN("collision callback nothing returning, so executing default action\n");
-        }
-        else {
-            extract<int> xi(res);
-            if( xi.check() ) {
-                ret = (CollisionAction)(int) xi;
+        {
+            object res;
+            try {
+                res = fncallback(openravepy::toPyCollisionReport(preport,shared_from_this()),bFromPhysics);
             }
-            else {
+            catch(...) {
+                RAVELOG_ERROR("exception occured in python collision callback:\n");
+                PyErr_Print();
+            }
+            if( IS_PYTHONOBJECT_NONE(res) || !res ) {
+                ret = CA_DefaultAction;
                 RAVELOG_WARN("collision callback nothing returning, so executing default action\n");
             }
+            else {
+                extract<int> xi(res);
+                if( xi.check() ) {
+                    ret = (CollisionAction)(int) xi;
+                }
+                else {
+                    RAVELOG_WARN("collision callback nothing returning, so executing default action\n");
+                }
+            }
         }
         PyGILState_Release(gstate);
         return ret;
@@ -572,12 +715,17 @@ public:
     bool CheckCollision(PyKinBodyPtr pbody1)
     {
         CHECK_POINTER(pbody1);
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)));
     }
     bool CheckCollision(PyKinBodyPtr pbody1, PyCollisionReportPtr pReport)
     {
         CHECK_POINTER(pbody1);
-        bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
@@ -586,6 +734,7 @@ public:
     {
         CHECK_POINTER(pbody1);
         CHECK_POINTER(pbody2);
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)));
     }
 
@@ -593,7 +742,11 @@ public:
     {
         CHECK_POINTER(pbody1);
         CHECK_POINTER(pbody2);
-        bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody1)), KinBodyConstPtr(openravepy::GetKinBody(pbody2)), openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
@@ -603,10 +756,12 @@ public:
         CHECK_POINTER(o1);
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(plink);
         }
         KinBodyConstPtr pbody = openravepy::GetKinBody(o1);
         if( !!pbody ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(pbody);
         }
         throw OPENRAVE_EXCEPTION_FORMAT0(_("CheckCollision(object) invalid argument"),ORE_InvalidArguments);
@@ -618,11 +773,13 @@ public:
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         bool bCollision;
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(plink,openravepy::GetCollisionReport(pReport));
         }
         else {
             KinBodyConstPtr pbody = openravepy::GetKinBody(o1);
             if( !!pbody ) {
+                openravepy::PythonThreadSaver threadsaver;
                 bCollision = _penv->CheckCollision(pbody,openravepy::GetCollisionReport(pReport));
             }
             else {
@@ -641,15 +798,21 @@ public:
         if( !!plink ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 return _penv->CheckCollision(plink,plink2);
             }
             KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
             if( !!pbody2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 return _penv->CheckCollision(plink,pbody2);
             }
             CollisionReportPtr preport2 = openravepy::GetCollisionReport(o2);
             if( !!preport2 ) {
-                bool bCollision = _penv->CheckCollision(plink,preport2);
+                bool bCollision;
+                {
+                    openravepy::PythonThreadSaver threadsaver;
+                    bCollision = _penv->CheckCollision(plink,preport2);
+                }
                 openravepy::UpdateCollisionReport(o2,shared_from_this());
                 return bCollision;
             }
@@ -659,15 +822,21 @@ public:
         if( !!pbody ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 return _penv->CheckCollision(plink2,pbody);
             }
             KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
             if( !!pbody2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 return _penv->CheckCollision(pbody,pbody2);
             }
             CollisionReportPtr preport2 = openravepy::GetCollisionReport(o2);
             if( !!preport2 ) {
-                bool bCollision = _penv->CheckCollision(pbody,preport2);
+                bool bCollision;
+                {
+                    openravepy::PythonThreadSaver threadsaver;
+                    bCollision = _penv->CheckCollision(pbody,preport2);
+                }
                 openravepy::UpdateCollisionReport(o2,shared_from_this());
                 return bCollision;
             }
@@ -684,11 +853,13 @@ public:
         if( !!plink ) {
             KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
             if( !!plink2 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 bCollision = _penv->CheckCollision(plink,plink2, openravepy::GetCollisionReport(pReport));
             }
             else {
                 KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
                 if( !!pbody2 ) {
+                    openravepy::PythonThreadSaver threadsaver;
                     bCollision = _penv->CheckCollision(plink,pbody2, openravepy::GetCollisionReport(pReport));
                 }
                 else {
@@ -701,11 +872,13 @@ public:
             if( !!pbody ) {
                 KinBody::LinkConstPtr plink2 = openravepy::GetKinBodyLinkConst(o2);
                 if( !!plink2 ) {
+                    openravepy::PythonThreadSaver threadsaver;
                     bCollision = _penv->CheckCollision(plink2,pbody, openravepy::GetCollisionReport(pReport));
                 }
                 else {
                     KinBodyConstPtr pbody2 = openravepy::GetKinBody(o2);
                     if( !!pbody2 ) {
+                        openravepy::PythonThreadSaver threadsaver;
                         bCollision = _penv->CheckCollision(pbody,pbody2, openravepy::GetCollisionReport(pReport));
                     }
                     else {
@@ -728,10 +901,12 @@ public:
         KinBodyConstPtr pbody2 = openravepy::GetKinBody(pybody2);
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(plink,pbody2);
         }
         KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
         if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(pbody1,pbody2);
         }
         throw OPENRAVE_EXCEPTION_FORMAT0(_("CheckCollision(object) invalid argument"),ORE_InvalidArguments);
@@ -745,11 +920,13 @@ public:
         KinBody::LinkConstPtr plink = openravepy::GetKinBodyLinkConst(o1);
         bool bCollision = false;
         if( !!plink ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(plink,pbody2,openravepy::GetCollisionReport(pReport));
         }
         else {
             KinBodyConstPtr pbody1 = openravepy::GetKinBody(o1);
             if( !!pbody1 ) {
+                openravepy::PythonThreadSaver threadsaver;
                 bCollision = _penv->CheckCollision(pbody1,pbody2,openravepy::GetCollisionReport(pReport));
             }
             else {
@@ -791,9 +968,11 @@ public:
             }
         }
         if( !!plink1 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(plink1,vbodyexcluded,vlinkexcluded);
         }
         else if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
             return _penv->CheckCollision(pbody1,vbodyexcluded,vlinkexcluded);
         }
         else {
@@ -829,9 +1008,11 @@ public:
 
         bool bCollision=false;
         if( !!plink1 ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(plink1, vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
         }
         else if( !!pbody1 ) {
+            openravepy::PythonThreadSaver threadsaver;
             bCollision = _penv->CheckCollision(pbody1, vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
         }
         else {
@@ -864,6 +1045,7 @@ public:
                 RAVELOG_ERROR("failed to get excluded link\n");
             }
         }
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)),vbodyexcluded,vlinkexcluded);
     }
 
@@ -890,101 +1072,76 @@ public:
             }
         }
 
-        bool bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)), vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(KinBodyConstPtr(openravepy::GetKinBody(pbody)), vbodyexcluded, vlinkexcluded, openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray, PyKinBodyPtr pbody)
     {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(pyray->r,KinBodyConstPtr(openravepy::GetKinBody(pbody)));
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray, PyKinBodyPtr pbody, PyCollisionReportPtr pReport)
     {
-        bool bCollision = _penv->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(pyray->r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
 
     object CheckCollisionRays(object rays, PyKinBodyPtr pbody,bool bFrontFacingOnly=false)
     {
-        object shape = rays.attr("shape");
-        int num = extract<int>(shape[0]);
-        if( num == 0 ) {
-            return boost::python::make_tuple(numeric::array(boost::python::list()).astype("i4"),numeric::array(boost::python::list()));
-        }
-        if( extract<int>(shape[1]) != 6 ) {
-            throw openrave_exception(_("rays object needs to be a Nx6 vector\n"));
-        }
-        CollisionReport report;
-        CollisionReportPtr preport(&report,null_deleter());
-
-        RAY r;
-        npy_intp dims[] = { num,6};
-        PyObject *pypos = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
-        dReal* ppos = (dReal*)PyArray_DATA(pypos);
-        PyObject* pycollision = PyArray_SimpleNew(1,&dims[0], PyArray_BOOL);
-        bool* pcollision = (bool*)PyArray_DATA(pycollision);
-        for(int i = 0; i < num; ++i, ppos += 6) {
-            vector<dReal> ray = ExtractArray<dReal>(rays[i]);
-            r.pos.x = ray[0];
-            r.pos.y = ray[1];
-            r.pos.z = ray[2];
-            r.dir.x = ray[3];
-            r.dir.y = ray[4];
-            r.dir.z = ray[5];
-            bool bCollision;
-            if( !pbody ) {
-                bCollision = _penv->CheckCollision(r, preport);
-            }
-            else {
-                bCollision = _penv->CheckCollision(r, KinBodyConstPtr(openravepy::GetKinBody(pbody)), preport);
-            }
-            pcollision[i] = false;
-            ppos[0] = 0; ppos[1] = 0; ppos[2] = 0; ppos[3] = 0; ppos[4] = 0; ppos[5] = 0;
-            if( bCollision &&( report.contacts.size() > 0) ) {
-                if( !bFrontFacingOnly ||( report.contacts[0].norm.dot3(r.dir)<0) ) {
-                    pcollision[i] = true;
-                    ppos[0] = report.contacts[0].pos.x;
-                    ppos[1] = report.contacts[0].pos.y;
-                    ppos[2] = report.contacts[0].pos.z;
-                    ppos[3] = report.contacts[0].norm.x;
-                    ppos[4] = report.contacts[0].norm.y;
-                    ppos[5] = report.contacts[0].norm.z;
-                }
-            }
-        }
-
-        return boost::python::make_tuple(static_cast<numeric::array>(handle<>(pycollision)),static_cast<numeric::array>(handle<>(pypos)));
+        return openravepy::CheckCollisionRays(_penv, CollisionCheckerBasePtr(), rays, !pbody ? KinBodyConstPtr() : KinBodyConstPtr(openravepy::GetKinBody(pbody)), bFrontFacingOnly);
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray)
     {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->CheckCollision(pyray->r);
     }
 
     bool CheckCollision(boost::shared_ptr<PyRay> pyray, PyCollisionReportPtr pReport)
     {
-        bool bCollision = _penv->CheckCollision(pyray->r, openravepy::GetCollisionReport(pReport));
+        bool bCollision;
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            bCollision = _penv->CheckCollision(pyray->r, openravepy::GetCollisionReport(pReport));
+        }
         openravepy::UpdateCollisionReport(pReport,shared_from_this());
         return bCollision;
     }
 
     bool Load(const string &filename) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->Load(filename);
     }
     bool Load(const string &filename, object odictatts) {
-        return _penv->Load(filename, toAttributesList(odictatts));
+        AttributesList atts = toAttributesList(odictatts);
+        openravepy::PythonThreadSaver threadsaver;
+        return _penv->Load(filename, atts);
     }
     bool LoadURI(const string &filename, object odictatts=object()) {
-        return _penv->LoadURI(filename, toAttributesList(odictatts));
+        AttributesList atts = toAttributesList(odictatts);
+        openravepy::PythonThreadSaver threadsaver;
+        return _penv->LoadURI(filename, atts);
     }
     bool LoadData(const string &data) {
+        openravepy::PythonThreadSaver threadsaver;
         return _penv->LoadData(data);
     }
     bool LoadData(const string &data, object odictatts) {
-        return _penv->LoadData(data, toAttributesList(odictatts));
+        AttributesList atts = toAttributesList(odictatts);
+        openravepy::PythonThreadSaver threadsaver;
+        return _penv->LoadData(data, atts);
     }
 
     void Save(const string &filename, EnvironmentBase::SelectionOptions options=EnvironmentBase::SO_Everything, object odictatts=object()) {
@@ -1563,6 +1720,45 @@ public:
         return bodies;
     }
 
+    /// \brief concatenates the DOF values of all bodies into one contiguous array, written into out if it is not None
+    object GetBodiesDOFValues(object obodies, object oout=object())
+    {
+        size_t numvalues = _ExtractBatchBodies(obodies, true);
+        if( IS_PYTHONOBJECT_NONE(oout) ) {
+            oout = toPyArrayN((dReal*)NULL, numvalues);
+        }
+        dReal* pout = ExtractOutputArray(oout, numvalues);
+        FOREACHC(itbody, _vcachebodies) {
+            (*itbody)->GetDOFValues(_vcachevalues);
+            pout = std::copy(_vcachevalues.begin(), _vcachevalues.end(), pout);
+        }
+        return oout;
+    }
+
+    /// \brief concatenates the link poses [quat, trans] of all bodies into one contiguous Nx7 array, written into out if it is not None
+    object GetBodiesLinkTransformationPoses(object obodies, object oout=object())
+    {
+        size_t numvalues = _ExtractBatchBodies(obodies, false);
+        if( IS_PYTHONOBJECT_NONE(oout) ) {
+            std::vector<npy_intp> dims(2);
+            dims[0] = numvalues/7; dims[1] = 7;
+            if( numvalues == 0 ) {
+                return numeric::array(boost::python::list());
+            }
+            oout = toPyArrayN((dReal*)NULL, dims);
+        }
+        dReal* pout = ExtractOutputArray(oout, numvalues);
+        FOREACHC(itbody, _vcachebodies) {
+            FOREACHC(itlink, (*itbody)->GetLinks()) {
+                const Transform& t = (*itlink)->GetTransform();
+                pout[0] = t.rot.x; pout[1] = t.rot.y; pout[2] = t.rot.z; pout[3] = t.rot.w;
+                pout[4] = t.trans.x; pout[5] = t.trans.y; pout[6] = t.trans.z;
+                pout += 7;
+            }
+        }
+        return oout;
+    }
+
     object GetRobots()
     {
         std::vector<RobotBasePtr> vrobots;
@@ -1619,14 +1815,20 @@ public:
     {
         CHECK_POINTER(pbody);
         TriMesh mesh;
-        _penv->Triangulate(mesh,openravepy::GetKinBody(pbody));
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            _penv->Triangulate(mesh,openravepy::GetKinBody(pbody));
+        }
         return toPyTriMesh(mesh);
     }
 
     object TriangulateScene(EnvironmentBase::SelectionOptions options, const string &name)
     {
         TriMesh mesh;
-        _penv->TriangulateScene(mesh,options,name);
+        {
+            openravepy::PythonThreadSaver threadsaver;
+            _penv->TriangulateScene(mesh,options,name);
+        }
         return toPyTriMesh(mesh);
     }
 
@@ -1808,10 +2010,13 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(drawarrow_overloads, drawarrow, 2, 4)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(drawbox_overloads, drawbox, 2, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(drawtrimesh_overloads, drawtrimesh, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SendCommand_overloads, SendCommand, 1, 3)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SendStructuredCommand_overloads, SendStructuredCommand, 1, 4)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Add_overloads, Add, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Save_overloads, Save, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetUserData_overloads, GetUserData, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetPublishedBodies_overloads, GetPublishedBodies, 0, 1)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetBodiesDOFValues_overloads, GetBodiesDOFValues, 1, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetBodiesLinkTransformationPoses_overloads, GetBodiesLinkTransformationPoses, 1, 2)
 
 object get_openrave_exception_unicode(openrave_exception* p)
 {
@@ -1891,6 +2096,10 @@ In python, the syntax is::\n\n\
   success = OUT is not None\n\n\n\
 The **releasegil** parameter controls whether the python Global Interpreter Lock should be released when executing this code. For calls that take a long time and if there are many threads running called from different python threads, releasing the GIL could speed up things a lot. Please keep in mind that releasing and re-acquiring the GIL also takes computation time.\n\
 Because race conditions can pop up when trying to lock the openrave environment without releasing the GIL, if lockenv=True is specified, the system can try to safely lock the openrave environment without causing a deadlock with the python GIL and other threads.\n");
+        std::string sSendStructuredCommandDoc = std::string(DOXY_FN(InterfaceBase,SendStructuredCommand)) + std::string("In python, the syntax is::\n\n\
+  results = SendStructuredCommand(cmd,args,releasegil,lockenv)\n\
+  success = results is not None\n\n\
+args is a list of values: bool, int, float and str are passed as the corresponding types, lists or arrays of integers as ints, other lists or arrays as reals, and 4x4 matrices as transforms. An empty list is passed as reals. results is a list with the values converted back.\n");
         class_<PyInterfaceBase, boost::shared_ptr<PyInterfaceBase> >("Interface", DOXY_CLASS(InterfaceBase), no_init)
         .def("GetInterfaceType",&PyInterfaceBase::GetInterfaceType, DOXY_FN(InterfaceBase,GetInterfaceType))
         .def("GetXMLId",&PyInterfaceBase::GetXMLId, DOXY_FN(InterfaceBase,GetXMLId))
@@ -1907,6 +2116,7 @@ Because race conditions can pop up when trying to lock the openrave environment
         .def("GetUserData",&PyInterfaceBase::GetUserData, GetUserData_overloads(args("key"), DOXY_FN(InterfaceBase,GetUserData)))
         .def("SupportsCommand",&PyInterfaceBase::SupportsCommand, args("cmd"), DOXY_FN(InterfaceBase,SupportsCommand))
         .def("SendCommand",&PyInterfaceBase::SendCommand, SendCommand_overloads(args("cmd","releasegil","lockenv"), sSendCommandDoc.c_str()))
+        .def("SendStructuredCommand",&PyInterfaceBase::SendStructuredCommand, SendStructuredCommand_overloads(args("cmd","args","releasegil","lockenv"), sSendStructuredCommandDoc.c_str()))
         .def("GetReadableInterfaces",&PyInterfaceBase::GetReadableInterfaces,DOXY_FN(InterfaceBase,GetReadableInterfaces))
         .def("GetReadableInterface",&PyInterfaceBase::GetReadableInterface,DOXY_FN(InterfaceBase,GetReadableInterface))
         .def("SetReadableInterface",&PyInterfaceBase::SetReadableInterface,args("xmltag","xmlreadable"), DOXY_FN(InterfaceBase,SetReadableInterface))
@@ -2081,6 +2291,8 @@ Because race conditions can pop up when trying to lock the openrave environment
                     .def("drawtrimesh",&PyEnvironmentBase::drawtrimesh,drawtrimesh_overloads(args("points","indices","colors"), DOXY_FN(EnvironmentBase,drawtrimesh "const float; int; const int; int; const boost::multi_array")))
                     .def("GetRobots",&PyEnvironmentBase::GetRobots, DOXY_FN(EnvironmentBase,GetRobots))
                     .def("GetBodies",&PyEnvironmentBase::GetBodies, DOXY_FN(EnvironmentBase,GetBodies))
+                    .def("GetBodiesDOFValues",&PyEnvironmentBase::GetBodiesDOFValues, GetBodiesDOFValues_overloads(args("bodies","out"), "Returns the DOF values of all bodies concatenated into one array. If out is given, it has to be a contiguous array of the right size and is filled in place."))
+                    .def("GetBodiesLinkTransformationPoses",&PyEnvironmentBase::GetBodiesLinkTransformationPoses, GetBodiesLinkTransformationPoses_overloads(args("bodies","out"), "Returns the link poses [quat, trans] of all bodies as one Nx7 array. If out is given, it has to be a contiguous array of the right size and is filled in place."))
                     .def("GetSensors",&PyEnvironmentBase::GetSensors, DOXY_FN(EnvironmentBase,GetSensors))
                     .def("UpdatePublishedBodies",&PyEnvironmentBase::UpdatePublishedBodies, DOXY_FN(EnvironmentBase,UpdatePublishedBodies))
                     .def("GetPublishedBodies",&PyEnvironmentBase::GetPublishedBodies, GetPublishedBodies_overloads(args("timeout"), DOXY_FN(EnvironmentBase,GetPublishedBodies)))
@@ -566,6 +566,8 @@ public:
 
     object SendCommand(const string& in, bool releasegil=false, bool lockenv=false);
 
+    object SendStructuredCommand(const string& cmd, object oargs=object(), bool releasegil=false, bool lockenv=false);
+
     virtual object GetReadableInterfaces();
     virtual object GetReadableInterface(const std::string& xmltag);
 
@@ -621,6 +623,26 @@ PyEnvironmentBasePtr RaveGetEnvironment(int id);
 
 void init_openravepy_collisionchecker();
 CollisionCheckerBasePtr GetCollisionChecker(PyCollisionCheckerBasePtr);
+/// \brief checks a Nx6 array of rays, returns a tuple of the N collision flags and the Nx6 hit positions and normals
+///
+/// \param penv if not empty, checks through the environment and its current collision checker, otherwise checks with pchecker directly. The environment lock is taken after the GIL is released.
+object CheckCollisionRays(EnvironmentBasePtr penv, CollisionCheckerBasePtr pchecker, object rays, KinBodyConstPtr pbody, bool bFrontFacingOnly);
+
+/// \brief returns the data of an output array passed in from python so that results can be written into it without allocating a new array
+///
+/// The array has to be a writeable, aligned, C-contiguous array of dReal with exactly N elements, otherwise ORE_InvalidArguments is thrown.
+dReal* ExtractOutputArray(object oout, size_t N);
+
+/// \brief views a python (N x numcols) batch as contiguous dReal rows, only copies if the input has another type or layout
+///
+/// \param hrows holds the viewed array, the returned pointer is valid as long as it is alive
+const dReal* ExtractBatchArray(object orows, size_t numcols, size_t& numrows, handle<>& hrows);
+
+/// \brief splits the N rows of a batch query over private copies of pbody and calls fn(pclone, startrow, endrow) from worker threads
+///
+/// The copies are never added to the environment, so the state of pbody is not touched. Has to be called with the GIL released.
+/// \param numthreads if <= 0, uses the number of cores
+void RunKinBodyBatch(KinBodyPtr pbody, size_t N, int numthreads, const boost::function<void(KinBodyPtr, size_t, size_t)>& fn);
 PyInterfaceBasePtr toPyCollisionChecker(CollisionCheckerBasePtr, PyEnvironmentBasePtr);
 CollisionReportPtr GetCollisionReport(object);
 CollisionReportPtr GetCollisionReport(PyCollisionReportPtr);
@@ -1490,6 +1490,23 @@ object PyKinBody::GetDOFValues(object oindices) const
     _pbody->GetDOFValues(values,vindices);
     return toPyArray(values);
 }
+object PyKinBody::GetDOFValues(object oindices, object oout) const
+{
+    if( IS_PYTHONOBJECT_NONE(oout) ) {
+        return IS_PYTHONOBJECT_NONE(oindices) ? GetDOFValues() : GetDOFValues(oindices);
+    }
+    if( IS_PYTHONOBJECT_NONE(oindices) ) {
+        _pbody->GetDOFValues(_vcachevalues);
+    }
+    else {
+        _pbody->GetDOFValues(_vcachevalues,ExtractArray<int>(oindices));
+    }
+    dReal* pout = ExtractOutputArray(oout, _vcachevalues.size());
+    if( _vcachevalues.size() > 0 ) {
+        std::copy(_vcachevalues.begin(), _vcachevalues.end(), pout);
+    }
+    return oout;
+}
 
 object PyKinBody::GetDOFVelocities() const
 {
@@ -1832,8 +1849,38 @@ object PyKinBody::GetTransformPose() const {
     return toPyArray(_pbody->GetTransform());
 }
 
-object PyKinBody::GetLinkTransformations(bool returndoflastvlaues) const
-{
+object PyKinBody::GetLinkTransformations(bool returndoflastvlaues, object oout) const
+{
+    if( !IS_PYTHONOBJECT_NONE(oout) ) {
+        // fill a Nx7 array of poses or a Nx4x4 array of matrices depending on the size of out
+        _pbody->GetLinkTransformations(_vcachetransforms, _vcachevalues);
+        size_t numlinks = _vcachetransforms.size();
+        PyObject* pyout = oout.ptr();
+        size_t numelements = PyArray_Check(pyout) ? (size_t)PyArray_SIZE((PyArrayObject*)pyout) : 0;
+        if( numlinks > 0 && numelements == 16*numlinks ) {
+            dReal* pdata = ExtractOutputArray(oout, 16*numlinks);
+            for(size_t i = 0; i < numlinks; ++i, pdata += 16) {
+                TransformMatrix t(_vcachetransforms[i]);
+                pdata[0] = t.m[0]; pdata[1] = t.m[1]; pdata[2] = t.m[2]; pdata[3] = t.trans.x;
+                pdata[4] = t.m[4]; pdata[5] = t.m[5]; pdata[6] = t.m[6]; pdata[7] = t.trans.y;
+                pdata[8] = t.m[8]; pdata[9] = t.m[9]; pdata[10] = t.m[10]; pdata[11] = t.trans.z;
+                pdata[12] = 0; pdata[13] = 0; pdata[14] = 0; pdata[15] = 1;
+            }
+        }
+        else {
+            dReal* pdata = ExtractOutputArray(oout, 7*numlinks);
+            for(size_t i = 0; i < numlinks; ++i, pdata += 7) {
+                const Transform& t = _vcachetransforms[i];
+                pdata[0] = t.rot.x; pdata[1] = t.rot.y; pdata[2] = t.rot.z; pdata[3] = t.rot.w;
+                pdata[4] = t.trans.x; pdata[5] = t.trans.y; pdata[6] = t.trans.z;
+            }
+        }
+        if( returndoflastvlaues ) {
+            return boost::python::make_tuple(oout, toPyArray(_vcachevalues));
+        }
+        return oout;
+    }
+
     boost::python::list otransforms;
     vector<Transform> vtransforms;
     std::vector<dReal> vdoflastsetvalues;
@@ -1933,14 +1980,27 @@ void PyKinBody::SetDOFVelocities(object odofvelocities, uint32_t checklimits, ob
     }
 }
 
-object PyKinBody::GetLinkVelocities() const
+object PyKinBody::GetLinkVelocities(object oout) const
 {
-    if( _pbody->GetLinks().size() == 0 ) {
+    if( _pbody->GetLinks().size() == 0 && IS_PYTHONOBJECT_NONE(oout) ) {
         return numeric::array(boost::python::list());
     }
-    std::vector<std::pair<Vector,Vector> > velocities;
+    std::vector<std::pair<Vector,Vector> >& velocities = _vcachevelocities;
     _pbody->GetLinkVelocities(velocities);
 
+    if( !IS_PYTHONOBJECT_NONE(oout) ) {
+        dReal* pfvel = ExtractOutputArray(oout, 6*velocities.size());
+        for(size_t i = 0; i < velocities.size(); ++i) {
+            pfvel[6*i+0] = velocities[i].first.x;
+            pfvel[6*i+1] = velocities[i].first.y;
+            pfvel[6*i+2] = velocities[i].first.z;
+            pfvel[6*i+3] = velocities[i].second.x;
+            pfvel[6*i+4] = velocities[i].second.y;
+            pfvel[6*i+5] = velocities[i].second.z;
+        }
+        return oout;
+    }
+
     npy_intp dims[] = {npy_intp(velocities.size()),npy_intp(6)};
     PyObject *pyvel = PyArray_SimpleNew(2,dims, sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT);
     dReal* pfvel = (dReal*)PyArray_DATA(pyvel);
@@ -2124,6 +2184,8 @@ void PyKinBody::SetDOFValues(object o)
     if( (int)values.size() != GetDOF() ) {
         throw openrave_exception(_("values do not equal to body degrees of freedom"));
     }
+    openravepy::PythonThreadSaver threadsaver;
+    EnvironmentMutex::scoped_lock lockenv(_pbody->GetEnv()->GetMutex());
     _pbody->SetDOFValues(values,KinBody::CLA_CheckLimits);
 }
 void PyKinBody::SetTransformWithDOFValues(object otrans,object ojoints)
@@ -2136,7 +2198,10 @@ void PyKinBody::SetTransformWithDOFValues(object otrans,object ojoints)
     if( (int)values.size() != GetDOF() ) {
         throw openrave_exception(_("values do not equal to body degrees of freedom"));
     }
-    _pbody->SetDOFValues(values,ExtractTransform(otrans),KinBody::CLA_CheckLimits);
+    Transform t = ExtractTransform(otrans);
+    openravepy::PythonThreadSaver threadsaver;
+    EnvironmentMutex::scoped_lock lockenv(_pbody->GetEnv()->GetMutex());
+    _pbody->SetDOFValues(values,t,KinBody::CLA_CheckLimits);
 }
 
 void PyKinBody::SetDOFValues(object o, object indices, uint32_t checklimits)
@@ -2146,6 +2211,8 @@ void PyKinBody::SetDOFValues(object o, object indices, uint32_t checklimits)
     }
     vector<dReal> vsetvalues = ExtractArray<dReal>(o);
     if( IS_PYTHONOBJECT_NONE(indices) ) {
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pbody->GetEnv()->GetMutex());
         _pbody->SetDOFValues(vsetvalues,checklimits);
     }
     else {
@@ -2153,6 +2220,8 @@ void PyKinBody::SetDOFValues(object o, object indices, uint32_t checklimits)
             return;
         }
         vector<int> vindices = ExtractArray<int>(indices);
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pbody->GetEnv()->GetMutex());
         _pbody->SetDOFValues(vsetvalues,checklimits, vindices);
     }
 }
@@ -2304,7 +2373,12 @@ PyInterfaceBasePtr PyKinBody::GetSelfCollisionChecker()
 
 bool PyKinBody::CheckSelfCollision(PyCollisionReportPtr pReport, PyCollisionCheckerBasePtr pycollisionchecker)
 {
-    bool bCollision = _pbody->CheckSelfCollision(openravepy::GetCollisionReport(pReport), openravepy::GetCollisionChecker(pycollisionchecker));
+    bool bCollision;
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        EnvironmentMutex::scoped_lock lockenv(_pbody->GetEnv()->GetMutex());
+        bCollision = _pbody->CheckSelfCollision(openravepy::GetCollisionReport(pReport), openravepy::GetCollisionChecker(pycollisionchecker));
+    }
     openravepy::UpdateCollisionReport(pReport,GetEnv());
     return bCollision;
 }
@@ -2559,6 +2633,156 @@ std::string strPyKinBodyJoint(object o)
     return std::string();
 }
 
+const dReal* ExtractBatchArray(object orows, size_t numcols, size_t& numrows, handle<>& hrows)
+{
+    PyObject* pyrows = PyArray_FROMANY(orows.ptr(), sizeof(dReal)==8 ? PyArray_DOUBLE : PyArray_FLOAT, 1, 2, NPY_C_CONTIGUOUS|NPY_ALIGNED);
+    if( !pyrows ) {
+        throw_error_already_set();
+    }
+    hrows = handle<>(pyrows);
+    numrows = PyArray_DIM(pyrows, 0);
+    if( numrows > 0 && (PyArray_NDIM(pyrows) != 2 || (size_t)PyArray_DIM(pyrows, 1) != numcols) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("batch needs to be a Nx%d array"), numcols, ORE_InvalidArguments);
+    }
+    return (const dReal*)PyArray_DATA(pyrows);
+}
+
+static void _RunKinBodyBatchThread(const boost::function<void(KinBodyPtr, size_t, size_t)>& fn, KinBodyPtr pclone, size_t startrow, size_t endrow, std::string& error)
+{
+    try {
+        fn(pclone, startrow, endrow);
+    }
+    catch(const std::exception& ex) {
+        error = ex.what();
+    }
+}
+
+/// \brief kinematics copies of a body that batch queries run on, kept in the body's user data so geometry is not copied on every query
+///
+/// The copies are initialized by a private environment that does not hold them afterwards, so the environment is released
+/// with the last copy and the cache never has to destroy an environment from inside the destruction of the body.
+class KinBodyBatchCache : public UserData
+{
+public:
+    boost::mutex _mutex; ///< held for the duration of a batch query
+    std::string _hashkinematics; ///< kinematics hash of the body the clones were made from
+    std::vector<KinBodyPtr> _vclones;
+};
+typedef boost::shared_ptr<KinBodyBatchCache> KinBodyBatchCachePtr;
+
+static boost::mutex s_mutexBatchCache; ///< protects creating the cache user data
+
+void RunKinBodyBatch(KinBodyPtr pbody, size_t N, int numthreads, const boost::function<void(KinBodyPtr, size_t, size_t)>& fn)
+{
+    if( N == 0 ) {
+        return;
+    }
+    if( numthreads <= 0 ) {
+        numthreads = max(1, (int)boost::thread::hardware_concurrency());
+    }
+    numthreads = min(numthreads, (int)N);
+    size_t rowsperthread = (N+numthreads-1)/numthreads;
+    numthreads = (N+rowsperthread-1)/rowsperthread;
+
+    KinBodyBatchCachePtr pcache;
+    {
+        boost::mutex::scoped_lock lock(s_mutexBatchCache);
+        pcache = boost::dynamic_pointer_cast<KinBodyBatchCache>(pbody->GetUserData("openravepybatch"));
+        if( !pcache ) {
+            pcache.reset(new KinBodyBatchCache());
+            pbody->SetUserData("openravepybatch", pcache);
+        }
+    }
+
+    boost::mutex::scoped_lock lockcache(pcache->_mutex);
+    {
+        EnvironmentMutex::scoped_lock lock(pbody->GetEnv()->GetMutex());
+        if( pcache->_hashkinematics != pbody->GetKinematicsGeometryHash() ) {
+            pcache->_vclones.resize(0);
+            pcache->_hashkinematics = pbody->GetKinematicsGeometryHash();
+        }
+        if( (int)pcache->_vclones.size() < numthreads ) {
+            EnvironmentBasePtr penv;
+            if( pcache->_vclones.size() > 0 ) {
+                penv = pcache->_vclones[0]->GetEnv();
+            }
+            else {
+                penv = RaveCreateEnvironment(0);
+                penv->SetCollisionChecker(CollisionCheckerBasePtr());
+            }
+            while( (int)pcache->_vclones.size() < numthreads ) {
+                // plain kinbody copies do not grab anything, so setting their joints cannot move other bodies.
+                // adding to the environment computes the internal information (hierarchy, mimic equations) like cloning an environment does,
+                // removing it again keeps the environment from referencing the copy
+                KinBodyPtr pclone = RaveCreateKinBody(penv, "");
+                pclone->Clone(pbody, 0);
+                penv->Add(pclone, true);
+                penv->Remove(pclone);
+                pcache->_vclones.push_back(pclone);
+            }
+        }
+        std::vector<dReal> vlower, vupper;
+        pbody->GetDOFLimits(vlower, vupper);
+        for(int i = 0; i < numthreads; ++i) {
+            pcache->_vclones[i]->SetDOFLimits(vlower, vupper);
+            pcache->_vclones[i]->SetTransform(pbody->GetTransform());
+        }
+    }
+    if( numthreads == 1 ) {
+        fn(pcache->_vclones[0], 0, N);
+        return;
+    }
+
+    std::vector<std::string> verrors(numthreads);
+    boost::thread_group threads;
+    for(int i = 0; i < numthreads; ++i) {
+        threads.create_thread(boost::bind(_RunKinBodyBatchThread, boost::cref(fn), pcache->_vclones[i], i*rowsperthread, min(N, (i+1)*rowsperthread), boost::ref(verrors[i])));
+    }
+    threads.join_all();
+    FOREACHC(iterror, verrors) {
+        if( iterror->size() > 0 ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("batch query failed: %s"), *iterror, ORE_Failed);
+        }
+    }
+}
+
+static void _ComputeBatchLinkTransformationPoses(const dReal* pvalues, dReal* pout, KinBodyPtr pbody, size_t startrow, size_t endrow)
+{
+    size_t dof = pbody->GetDOF(), numlinks = pbody->GetLinks().size();
+    std::vector<dReal> vvalues(dof);
+    for(size_t i = startrow; i < endrow; ++i) {
+        std::copy(pvalues+i*dof, pvalues+(i+1)*dof, vvalues.begin());
+        pbody->SetDOFValues(vvalues, KinBody::CLA_CheckLimitsSilent);
+        dReal* pdata = pout + i*numlinks*7;
+        FOREACHC(itlink, pbody->GetLinks()) {
+            const Transform& t = (*itlink)->GetTransform();
+            pdata[0] = t.rot.x; pdata[1] = t.rot.y; pdata[2] = t.rot.z; pdata[3] = t.rot.w;
+            pdata[4] = t.trans.x; pdata[5] = t.trans.y; pdata[6] = t.trans.z;
+            pdata += 7;
+        }
+    }
+}
+
+object PyKinBody::ComputeBatchLinkTransformationPoses(object odofvalues, object oout, int numthreads) const
+{
+    size_t numrows = 0, numlinks = _pbody->GetLinks().size();
+    handle<> hvalues;
+    const dReal* pvalues = ExtractBatchArray(odofvalues, _pbody->GetDOF(), numrows, hvalues);
+    if( IS_PYTHONOBJECT_NONE(oout) ) {
+        if( numrows == 0 || numlinks == 0 ) {
+            return numeric::array(boost::python::list());
+        }
+        std::vector<npy_intp> dims(3); dims[0] = numrows; dims[1] = numlinks; dims[2] = 7;
+        oout = toPyArrayN((dReal*)NULL, dims);
+    }
+    dReal* pout = ExtractOutputArray(oout, numrows*numlinks*7);
+    {
+        openravepy::PythonThreadSaver threadsaver;
+        RunKinBodyBatch(_pbody, numrows, numthreads, boost::bind(_ComputeBatchLinkTransformationPoses, pvalues, pout, _1, _2, _3));
+    }
+    return oout;
+}
+
 KinBodyPtr GetKinBody(object o)
 {
     extract<PyKinBodyPtr> pykinbody(o);
@@ -2755,7 +2979,9 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetMaxTorque_overloads, GetMaxTorque, 0,
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetInstantaneousTorqueLimits_overloads, GetInstantaneousTorqueLimits, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetNominalTorqueLimits_overloads, GetNominalTorqueLimits, 0, 1)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetMaxInertia_overloads, GetMaxInertia, 0, 1)
-BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetLinkTransformations_overloads, GetLinkTransformations, 0, 1)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetLinkTransformations_overloads, GetLinkTransformations, 0, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetLinkVelocities_overloads, GetLinkVelocities, 0, 1)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ComputeBatchLinkTransformationPoses_overloads, ComputeBatchLinkTransformationPoses, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SetLinkTransformations_overloads, SetLinkTransformations, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SetDOFLimits_overloads, SetDOFLimits, 2, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(SubtractDOFValues_overloads, SubtractDOFValues, 2, 3)
@@ -2827,6 +3053,7 @@ void init_openravepy_kinbody()
         void (PyKinBody::*psetdofvalues3)(object,object,uint32_t) = &PyKinBody::SetDOFValues;
         object (PyKinBody::*getdofvalues1)() const = &PyKinBody::GetDOFValues;
         object (PyKinBody::*getdofvalues2)(object) const = &PyKinBody::GetDOFValues;
+        object (PyKinBody::*getdofvalues3)(object,object) const = &PyKinBody::GetDOFValues;
         object (PyKinBody::*getdofvelocities1)() const = &PyKinBody::GetDOFVelocities;
         object (PyKinBody::*getdofvelocities2)(object) const = &PyKinBody::GetDOFVelocities;
         object (PyKinBody::*getdoflimits1)() const = &PyKinBody::GetDOFLimits;
@@ -2866,6 +3093,7 @@ void init_openravepy_kinbody()
                         .def("GetDOF",&PyKinBody::GetDOF,DOXY_FN(KinBody,GetDOF))
                         .def("GetDOFValues",getdofvalues1,DOXY_FN(KinBody,GetDOFValues))
                         .def("GetDOFValues",getdofvalues2,args("indices"),DOXY_FN(KinBody,GetDOFValues))
+                        .def("GetDOFValues",getdofvalues3,args("indices","out"),"Fills the contiguous numpy array out with the DOF values of indices (all DOFs if indices is None) and returns it.")
                         .def("GetDOFVelocities",getdofvelocities1, DOXY_FN(KinBody,GetDOFVelocities))
                         .def("GetDOFVelocities",getdofvelocities2, args("indices"), DOXY_FN(KinBody,GetDOFVelocities))
                         .def("GetDOFLimits",getdoflimits1, DOXY_FN(KinBody,GetDOFLimits))
@@ -2905,8 +3133,8 @@ void init_openravepy_kinbody()
                         .def("GetJointFromDOFIndex",&PyKinBody::GetJointFromDOFIndex,args("dofindex"), DOXY_FN(KinBody,GetJointFromDOFIndex))
                         .def("GetTransform",&PyKinBody::GetTransform, DOXY_FN(KinBody,GetTransform))
                         .def("GetTransformPose",&PyKinBody::GetTransformPose, DOXY_FN(KinBody,GetTransform))
-                        .def("GetLinkTransformations",&PyKinBody::GetLinkTransformations, GetLinkTransformations_overloads(args("returndoflastvlaues"), DOXY_FN(KinBody,GetLinkTransformations)))
-                        .def("GetBodyTransformations",&PyKinBody::GetLinkTransformations, DOXY_FN(KinBody,GetLinkTransformations))
+                        .def("GetLinkTransformations",&PyKinBody::GetLinkTransformations, GetLinkTransformations_overloads(args("returndoflastvlaues","out"), DOXY_FN(KinBody,GetLinkTransformations)))
+                        .def("GetBodyTransformations",&PyKinBody::GetLinkTransformations, GetLinkTransformations_overloads(args("returndoflastvlaues","out"), DOXY_FN(KinBody,GetLinkTransformations)))
                         .def("SetLinkTransformations",&PyKinBody::SetLinkTransformations,SetLinkTransformations_overloads(args("transforms","doflastsetvalues"), DOXY_FN(KinBody,SetLinkTransformations)))
                         .def("SetBodyTransformations",&PyKinBody::SetLinkTransformations,args("transforms"), DOXY_FN(KinBody,SetLinkTransformations))
                         .def("SetLinkVelocities",&PyKinBody::SetLinkVelocities,args("velocities"), DOXY_FN(KinBody,SetLinkVelocities))
@@ -2915,7 +3143,8 @@ void init_openravepy_kinbody()
                         .def("SetDOFVelocities",setdofvelocities2, args("dofvelocities","linear","angular"), DOXY_FN(KinBody,SetDOFVelocities "const std::vector; const Vector; const Vector; uint32_t"))
                         .def("SetDOFVelocities",setdofvelocities3, args("dofvelocities","checklimits","indices"), DOXY_FN(KinBody,SetDOFVelocities "const std::vector; uint32_t; const std::vector"))
                         .def("SetDOFVelocities",setdofvelocities4, args("dofvelocities","linear","angular","checklimits"), DOXY_FN(KinBody,SetDOFVelocities "const std::vector; const Vector; const Vector; uint32_t"))
-                        .def("GetLinkVelocities",&PyKinBody::GetLinkVelocities, DOXY_FN(KinBody,GetLinkVelocities))
+                        .def("GetLinkVelocities",&PyKinBody::GetLinkVelocities, GetLinkVelocities_overloads(args("out"), DOXY_FN(KinBody,GetLinkVelocities)))
+                        .def("ComputeBatchLinkTransformationPoses",&PyKinBody::ComputeBatchLinkTransformationPoses, ComputeBatchLinkTransformationPoses_overloads(args("dofvalues","out","numthreads"), "Computes the link poses [quat, trans] for every row of the (N x DOF) dofvalues and returns them as a (N x links x 7) array. Runs on private copies of the body over numthreads threads (all cores if <= 0) with the GIL released, the body itself is not modified."))
                         .def("GetLinkAccelerations",&PyKinBody::GetLinkAccelerations, GetLinkAccelerations_overloads(args("dofaccelerations", "externalaccelerations"), DOXY_FN(KinBody,GetLinkAccelerations)))
                         .def("GetLinkEnableStates",&PyKinBody::GetLinkEnableStates, DOXY_FN(KinBody,GetLinkEnableStates))
                         .def("SetLinkEnableStates",&PyKinBody::SetLinkEnableStates, DOXY_FN(KinBody,SetLinkEnableStates))
@@ -89,6 +89,9 @@ class PyKinBody : public PyInterfaceBase
 protected:
     KinBodyPtr _pbody;
     std::list<boost::shared_ptr<void> > _listStateSavers;
+    mutable std::vector<dReal> _vcachevalues; ///< reused when filling output arrays so that repeated queries do not allocate
+    mutable std::vector<Transform> _vcachetransforms;
+    mutable std::vector<std::pair<Vector,Vector> > _vcachevelocities;
 
 public:
     PyKinBody(KinBodyPtr pbody, PyEnvironmentBasePtr pyenv);
@@ -106,6 +109,7 @@ public:
     int GetDOF() const;
     object GetDOFValues() const;
     object GetDOFValues(object oindices) const;
+    object GetDOFValues(object oindices, object oout) const;
     object GetDOFVelocities() const;
     object GetDOFVelocities(object oindices) const;
     object GetDOFLimits() const;
@@ -139,7 +143,7 @@ public:
     object GetJointFromDOFIndex(int dofindex) const;
     object GetTransform() const;
     object GetTransformPose() const;
-    object GetLinkTransformations(bool returndoflastvlaues=false) const;
+    object GetLinkTransformations(bool returndoflastvlaues=false, object oout=object()) const;
     void SetLinkTransformations(object transforms, object odoflastvalues=object());
     void SetLinkVelocities(object ovelocities);
     object GetLinkEnableStates() const;
@@ -149,7 +153,8 @@ public:
     void SetDOFVelocities(object odofvelocities, object olinearvel, object oangularvel);
     void SetDOFVelocities(object odofvelocities);
     void SetDOFVelocities(object odofvelocities, uint32_t checklimits=KinBody::CLA_CheckLimits, object oindices = object());
-    object GetLinkVelocities() const;
+    object GetLinkVelocities(object oout=object()) const;
+    object ComputeBatchLinkTransformationPoses(object odofvalues, object oout=object(), int numthreads=0) const;
     object GetLinkAccelerations(object odofaccelerations, object oexternalaccelerations) const;
     object ComputeAABB();
     object GetCenterOfMass() const;
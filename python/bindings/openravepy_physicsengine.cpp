@@ -19,6 +19,95 @@
 
 namespace openravepy {
 
+/// \brief python version of PhysicsRollout, the results are converted when the rollout is simulated
+class PyPhysicsRollout
+{
+public:
+    PyPhysicsRollout() {
+        PhysicsRollout rollout;
+        fTimeStep = rollout.fTimeStep;
+        nSteps = rollout.nSteps;
+        nRecordStride = rollout.nRecordStride;
+    }
+
+    /// \brief adds the torques of a body, torques is a nSteps x body.GetDOF() array
+    void AddControls(const std::string& bodyname, object torques)
+    {
+        vcontrols.append(boost::python::make_tuple(bodyname, torques));
+    }
+
+    void GetPhysicsRollout(PhysicsRollout& rollout) const
+    {
+        rollout.fTimeStep = fTimeStep;
+        rollout.nSteps = nSteps;
+        rollout.nRecordStride = nRecordStride;
+        rollout.vcontrols.resize(len(vcontrols));
+        for(size_t i = 0; i < rollout.vcontrols.size(); ++i) {
+            rollout.vcontrols[i].bodyname = boost::python::extract<std::string>(vcontrols[i][0]);
+            object otorques = vcontrols[i][1];
+            rollout.vcontrols[i].vtorques.resize(0);
+            for(int j = 0; j < len(otorques); ++j) {
+                // each step can be its own array
+                std::vector<dReal> vsteptorques = ExtractArray<dReal>(otorques[j]);
+                rollout.vcontrols[i].vtorques.insert(rollout.vcontrols[i].vtorques.end(), vsteptorques.begin(), vsteptorques.end());
+            }
+        }
+    }
+
+    void SetResults(const PhysicsRollout& rollout)
+    {
+        vbodynames = boost::python::list();
+        FOREACHC(itname, rollout.vbodynames) {
+            vbodynames.append(*itname);
+        }
+        vfinaltransforms = _toPyPoses(rollout.vfinaltransforms);
+        std::vector<dReal> vvelocities(6*rollout.vfinalvelocities.size());
+        for(size_t i = 0; i < rollout.vfinalvelocities.size(); ++i) {
+            for(int j = 0; j < 3; ++j) {
+                vvelocities[6*i+j] = rollout.vfinalvelocities[i].first[j];
+                vvelocities[6*i+3+j] = rollout.vfinalvelocities[i].second[j];
+            }
+        }
+        std::vector<npy_intp> dims(2);
+        dims[0] = rollout.vfinalvelocities.size();
+        dims[1] = 6;
+        vfinalvelocities = toPyArray(vvelocities, dims);
+        vrecordedtransforms = boost::python::list();
+        FOREACHC(itrecorded, rollout.vrecordedtransforms) {
+            vrecordedtransforms.append(_toPyPoses(*itrecorded));
+        }
+    }
+
+    dReal fTimeStep;
+    int nSteps;
+    int nRecordStride;
+    boost::python::list vcontrols; ///< list of (bodyname, torques)
+    boost::python::list vbodynames;
+    object vfinaltransforms; ///< Nx7 array of the link poses
+    object vfinalvelocities; ///< Nx6 array of the linear and angular link velocities
+    boost::python::list vrecordedtransforms; ///< list of Nx7 arrays of the link poses
+
+private:
+    static object _toPyPoses(const std::vector<Transform>& vtransforms)
+    {
+        std::vector<dReal> vposes(7*vtransforms.size());
+        for(size_t i = 0; i < vtransforms.size(); ++i) {
+            for(int j = 0; j < 4; ++j) {
+                vposes[7*i+j] = vtransforms[i].rot[j];
+            }
+            for(int j = 0; j < 3; ++j) {
+                vposes[7*i+4+j] = vtransforms[i].trans[j];
+            }
+        }
+        std::vector<npy_intp> dims(2);
+        dims[0] = vtransforms.size();
+        dims[1] = 7;
+        return toPyArray(vposes, dims);
+    }
+};
+
+typedef boost::shared_ptr<PyPhysicsRollout> PyPhysicsRolloutPtr;
+
 class PyPhysicsEngineBase : public PyInterfaceBase
 {
 protected:
@@ -155,6 +244,16 @@ public:
     void SimulateStep(dReal fTimeElapsed) {
         _pPhysicsEngine->SimulateStep(fTimeElapsed);
     }
+
+    bool SimulateRollout(PyPhysicsRolloutPtr pyrollout)
+    {
+        CHECK_POINTER(pyrollout);
+        PhysicsRollout rollout;
+        pyrollout->GetPhysicsRollout(rollout);
+        bool bsuccess = _pPhysicsEngine->SimulateRollout(rollout);
+        pyrollout->SetResults(rollout);
+        return bsuccess;
+    }
 };
 
 PhysicsEngineBasePtr GetPhysicsEngine(PyPhysicsEngineBasePtr pyPhysicsEngine)
@@ -176,6 +275,22 @@ PyPhysicsEngineBasePtr RaveCreatePhysicsEngine(PyEnvironmentBasePtr pyenv, const
     return PyPhysicsEngineBasePtr(new PyPhysicsEngineBase(p,pyenv));
 }
 
+bool RaveSimulatePhysicsRollouts(PyEnvironmentBasePtr pyenv, object opyrollouts, int nthreads)
+{
+    std::vector<PyPhysicsRolloutPtr> vpyrollouts(len(opyrollouts));
+    std::vector<PhysicsRollout> vrollouts(vpyrollouts.size());
+    for(size_t i = 0; i < vpyrollouts.size(); ++i) {
+        vpyrollouts[i] = boost::python::extract<PyPhysicsRolloutPtr>(opyrollouts[i]);
+        CHECK_POINTER(vpyrollouts[i]);
+        vpyrollouts[i]->GetPhysicsRollout(vrollouts[i]);
+    }
+    bool bsuccess = OpenRAVE::RaveSimulatePhysicsRollouts(GetEnvironment(pyenv), vrollouts, nthreads);
+    for(size_t i = 0; i < vpyrollouts.size(); ++i) {
+        vpyrollouts[i]->SetResults(vrollouts[i]);
+    }
+    return bsuccess;
+}
+
 void init_openravepy_physicsengine()
 {
     class_<PyPhysicsEngineBase, boost::shared_ptr<PyPhysicsEngineBase>, bases<PyInterfaceBase> >("PhysicsEngine", DOXY_CLASS(PhysicsEngineBase), no_init)
@@ -196,9 +311,23 @@ void init_openravepy_physicsengine()
     .def("SetGravity",&PyPhysicsEngineBase::SetGravity, DOXY_FN(PhysicsEngineBase,SetGravity))
     .def("GetGravity",&PyPhysicsEngineBase::GetGravity, DOXY_FN(PhysicsEngineBase,GetGravity))
     .def("SimulateStep",&PyPhysicsEngineBase::SimulateStep, DOXY_FN(PhysicsEngineBase,SimulateStep))
+    .def("SimulateRollout",&PyPhysicsEngineBase::SimulateRollout, args("rollout"), DOXY_FN(PhysicsEngineBase,SimulateRollout))
+    ;
+
+    class_<PyPhysicsRollout, PyPhysicsRolloutPtr >("PhysicsRollout", DOXY_CLASS(PhysicsRollout))
+    .def_readwrite("fTimeStep",&PyPhysicsRollout::fTimeStep)
+    .def_readwrite("nSteps",&PyPhysicsRollout::nSteps)
+    .def_readwrite("nRecordStride",&PyPhysicsRollout::nRecordStride)
+    .def_readwrite("vcontrols",&PyPhysicsRollout::vcontrols)
+    .def_readonly("vbodynames",&PyPhysicsRollout::vbodynames)
+    .def_readonly("vfinaltransforms",&PyPhysicsRollout::vfinaltransforms)
+    .def_readonly("vfinalvelocities",&PyPhysicsRollout::vfinalvelocities)
+    .def_readonly("vrecordedtransforms",&PyPhysicsRollout::vrecordedtransforms)
+    .def("AddControls",&PyPhysicsRollout::AddControls, args("bodyname","torques"), "Adds the torques of a body, torques is a nSteps x body.GetDOF() array")
     ;
 
     def("RaveCreatePhysicsEngine",openravepy::RaveCreatePhysicsEngine,args("env","name"),DOXY_FN1(RaveCreatePhysicsEngine));
+    def("RaveSimulatePhysicsRollouts",openravepy::RaveSimulatePhysicsRollouts,args("env","rollouts","nthreads"),DOXY_FN1(RaveSimulatePhysicsRollouts));
 }
 
 }
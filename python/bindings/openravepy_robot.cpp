@@ -19,6 +19,23 @@
 
 namespace openravepy {
 
+/// \brief fills a 6 x armdof Jacobian per row, translation of the manipulator frame on top of its angular velocity
+static void _ComputeBatchManipulatorJacobians(const dReal* pvalues, dReal* pout, const std::vector<int>& varmindices, int ieffector, const Transform& tlocaltool, KinBodyPtr pbody, size_t startrow, size_t endrow)
+{
+    size_t armdof = varmindices.size();
+    std::vector<dReal> vvalues(armdof), vjacobian;
+    for(size_t i = startrow; i < endrow; ++i) {
+        std::copy(pvalues+i*armdof, pvalues+(i+1)*armdof, vvalues.begin());
+        pbody->SetDOFValues(vvalues, KinBody::CLA_CheckLimitsSilent, varmindices);
+        KinBody::LinkPtr peffector = pbody->GetLinks().at(ieffector);
+        dReal* pdata = pout + i*6*armdof;
+        pbody->ComputeJacobianTranslation(ieffector, peffector->GetTransform() * tlocaltool.trans, vjacobian, varmindices);
+        std::copy(vjacobian.begin(), vjacobian.end(), pdata);
+        pbody->ComputeJacobianAxisAngle(ieffector, vjacobian, varmindices);
+        std::copy(vjacobian.begin(), vjacobian.end(), pdata+3*armdof);
+    }
+}
+
 class PyRobotBase : public PyKinBody
 {
 protected:
@@ -298,7 +315,12 @@ public:
         object FindIKSolution(object oparam, int filteroptions, bool ikreturn=false, bool releasegil=false) const
         {
             IkParameterization ikparam;
-            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex()); // lock just in case since many users call this without locking...
+            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex(), boost::defer_lock_t()); // lock just in case since many users call this without locking...
+            {
+                // python ik filters lock the environment before the GIL, so never wait for the environment while holding the GIL
+                openravepy::PythonThreadSaver threadsaver;
+                lock.lock();
+            }
             if( ExtractIkParameterization(oparam,ikparam) ) {
                 if( ikreturn ) {
                     IkReturn ikreturn(IKRA_Reject);
@@ -334,7 +356,12 @@ public:
         {
             vector<dReal> vfreeparams = ExtractArray<dReal>(freeparams);
             IkParameterization ikparam;
-            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex()); // lock just in case since many users call this without locking...
+            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex(), boost::defer_lock_t()); // lock just in case since many users call this without locking...
+            {
+                // python ik filters lock the environment before the GIL, so never wait for the environment while holding the GIL
+                openravepy::PythonThreadSaver threadsaver;
+                lock.lock();
+            }
             if( ExtractIkParameterization(oparam,ikparam) ) {
                 if( ikreturn ) {
                     IkReturn ikreturn(IKRA_Reject);
@@ -369,7 +396,12 @@ public:
         object FindIKSolutions(object oparam, int filteroptions, bool ikreturn=false, bool releasegil=false) const
         {
             IkParameterization ikparam;
-            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex()); // lock just in case since many users call this without locking...
+            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex(), boost::defer_lock_t()); // lock just in case since many users call this without locking...
+            {
+                // python ik filters lock the environment before the GIL, so never wait for the environment while holding the GIL
+                openravepy::PythonThreadSaver threadsaver;
+                lock.lock();
+            }
             if( ikreturn ) {
                 std::vector<IkReturnPtr> vikreturns;
                 if( ExtractIkParameterization(oparam,ikparam) ) {
@@ -416,7 +448,12 @@ public:
         {
             vector<dReal> vfreeparams = ExtractArray<dReal>(freeparams);
             IkParameterization ikparam;
-            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex()); // lock just in case since many users call this without locking...
+            EnvironmentMutex::scoped_lock lock(openravepy::GetEnvironment(_pyenv)->GetMutex(), boost::defer_lock_t()); // lock just in case since many users call this without locking...
+            {
+                // python ik filters lock the environment before the GIL, so never wait for the environment while holding the GIL
+                openravepy::PythonThreadSaver threadsaver;
+                lock.lock();
+            }
             if( ikreturn ) {
                 std::vector<IkReturnPtr> vikreturns;
                 if( ExtractIkParameterization(oparam,ikparam) ) {
@@ -579,6 +616,27 @@ public:
             return toPyArray(vjacobian,dims);
         }
 
+        object CalculateBatchJacobians(object oarmvalues, object oout=object(), int numthreads=0) const
+        {
+            const std::vector<int>& varmindices = _pmanip->GetArmIndices();
+            size_t numrows = 0;
+            handle<> hvalues;
+            const dReal* pvalues = ExtractBatchArray(oarmvalues, varmindices.size(), numrows, hvalues);
+            if( IS_PYTHONOBJECT_NONE(oout) ) {
+                if( numrows == 0 || varmindices.size() == 0 ) {
+                    return numeric::array(boost::python::list());
+                }
+                std::vector<npy_intp> dims(3); dims[0] = numrows; dims[1] = 6; dims[2] = varmindices.size();
+                oout = toPyArrayN((dReal*)NULL, dims);
+            }
+            dReal* pout = ExtractOutputArray(oout, numrows*6*varmindices.size());
+            {
+                openravepy::PythonThreadSaver threadsaver;
+                RunKinBodyBatch(_pmanip->GetRobot(), numrows, numthreads, boost::bind(_ComputeBatchManipulatorJacobians, pvalues, pout, boost::cref(varmindices), _pmanip->GetEndEffector()->GetIndex(), _pmanip->GetLocalToolTransform(), _1, _2, _3));
+            }
+            return oout;
+        }
+
         object GetInfo() {
             return object(PyManipulatorInfoPtr(new PyManipulatorInfo(_pmanip->GetInfo())));
         }
@@ -1104,6 +1162,8 @@ public:
     {
         vector<dReal> vvalues = ExtractArray<dReal>(values);
         if( vvalues.size() > 0 ) {
+            openravepy::PythonThreadSaver threadsaver;
+            EnvironmentMutex::scoped_lock lockenv(_probot->GetEnv()->GetMutex());
             _probot->SetActiveDOFValues(vvalues,checklimits);
         }
         else {
@@ -1447,6 +1507,7 @@ PyRobotBasePtr RaveCreateRobot(PyEnvironmentBasePtr pyenv, const std::string& na
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(GetIkParameterization_overloads, GetIkParameterization, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CheckEndEffectorCollision_overloads, CheckEndEffectorCollision, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(FindIKSolution_overloads, FindIKSolution, 2, 4)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(CalculateBatchJacobians_overloads, CalculateBatchJacobians, 1, 3)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(FindIKSolutionFree_overloads, FindIKSolution, 3, 5)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(FindIKSolutions_overloads, FindIKSolutions, 2, 4)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(FindIKSolutionsFree_overloads, FindIKSolutions, 3, 5)
@@ -1682,6 +1743,7 @@ void init_openravepy_robot()
         .def("CalculateJacobian",&PyRobotBase::PyManipulator::CalculateJacobian,DOXY_FN(RobotBase::Manipulator,CalculateJacobian))
         .def("CalculateRotationJacobian",&PyRobotBase::PyManipulator::CalculateRotationJacobian,DOXY_FN(RobotBase::Manipulator,CalculateRotationJacobian))
         .def("CalculateAngularVelocityJacobian",&PyRobotBase::PyManipulator::CalculateAngularVelocityJacobian,DOXY_FN(RobotBase::Manipulator,CalculateAngularVelocityJacobian))
+        .def("CalculateBatchJacobians",&PyRobotBase::PyManipulator::CalculateBatchJacobians,CalculateBatchJacobians_overloads(args("armvalues","out","numthreads"), "Computes the (N x 6 x armdof) Jacobians for every row of the (N x armdof) armvalues, the first 3 rows are CalculateJacobian and the last 3 CalculateAngularVelocityJacobian. The other joints keep their current values. Runs on private copies of the robot over numthreads threads (all cores if <= 0) with the GIL released, the robot itself is not modified."))
         .def("GetStructureHash",&PyRobotBase::PyManipulator::GetStructureHash, DOXY_FN(RobotBase::Manipulator,GetStructureHash))
         .def("GetKinematicsStructureHash",&PyRobotBase::PyManipulator::GetKinematicsStructureHash, DOXY_FN(RobotBase::Manipulator,GetKinematicsStructureHash))
         .def("GetInverseKinematicsStructureHash",&PyRobotBase::PyManipulator::GetInverseKinematicsStructureHash, args("iktype"), DOXY_FN(RobotBase::Manipulator,GetInverseKinematicsStructureHash))
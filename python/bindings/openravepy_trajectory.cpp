@@ -23,6 +23,7 @@ class PyTrajectoryBase : public PyInterfaceBase
 {
 protected:
     TrajectoryBasePtr _ptrajectory;
+    mutable std::vector<dReal> _vcachevalues; ///< reused when filling output arrays
 public:
     PyTrajectoryBase(TrajectoryBasePtr pTrajectory, PyEnvironmentBasePtr pyenv) : PyInterfaceBase(pTrajectory, pyenv),_ptrajectory(pTrajectory) {
     }
@@ -128,6 +129,23 @@ public:
         return toPyArray(values);
     }
 
+    // fills the output array instead of allocating a new one, spec can be None
+    object GetWaypoints(size_t startindex, size_t endindex, PyConfigurationSpecificationPtr pyspec, object oout) const
+    {
+        if( !pyspec ) {
+            _ptrajectory->GetWaypoints(startindex,endindex,_vcachevalues);
+        }
+        else {
+            _ptrajectory->GetWaypoints(startindex,endindex,_vcachevalues,openravepy::GetConfigurationSpecification(pyspec));
+        }
+        if( IS_PYTHONOBJECT_NONE(oout) ) {
+            return toPyArray(_vcachevalues);
+        }
+        dReal* pout = ExtractOutputArray(oout, _vcachevalues.size());
+        std::copy(_vcachevalues.begin(), _vcachevalues.end(), pout);
+        return oout;
+    }
+
     // similar to GetWaypoints except returns a 2D array, one row for every waypoint
     object GetWaypoints2D(size_t startindex, size_t endindex) const
     {
@@ -275,6 +293,7 @@ void init_openravepy_trajectory()
     object (PyTrajectoryBase::*SamplePoints2D2)(object, PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::SamplePoints2D;
     object (PyTrajectoryBase::*GetWaypoints1)(size_t,size_t) const = &PyTrajectoryBase::GetWaypoints;
     object (PyTrajectoryBase::*GetWaypoints2)(size_t,size_t,PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::GetWaypoints;
+    object (PyTrajectoryBase::*GetWaypoints3)(size_t,size_t,PyConfigurationSpecificationPtr,object) const = &PyTrajectoryBase::GetWaypoints;
     object (PyTrajectoryBase::*GetWaypoints2D1)(size_t,size_t) const = &PyTrajectoryBase::GetWaypoints2D;
     object (PyTrajectoryBase::*GetWaypoints2D2)(size_t,size_t,PyConfigurationSpecificationPtr) const = &PyTrajectoryBase::GetWaypoints2D;
     object (PyTrajectoryBase::*GetAllWaypoints2D1)() const = &PyTrajectoryBase::GetAllWaypoints2D;
@@ -296,6 +315,7 @@ void init_openravepy_trajectory()
     .def("GetNumWaypoints",&PyTrajectoryBase::GetNumWaypoints,DOXY_FN(TrajectoryBase,GetNumWaypoints))
     .def("GetWaypoints",GetWaypoints1,args("startindex","endindex"),DOXY_FN(TrajectoryBase, GetWaypoints "size_t; size_t; std::vector"))
     .def("GetWaypoints",GetWaypoints2,args("startindex","endindex","spec"),DOXY_FN(TrajectoryBase, GetWaypoints "size_t; size_t; std::vector, const ConfigurationSpecification&"))
+    .def("GetWaypoints",GetWaypoints3,args("startindex","endindex","spec","out"),"Fills the contiguous numpy array out with the waypoints in [startindex,endindex) and returns it. spec can be None.")
     .def("GetWaypoints2D",GetWaypoints2D1,args("startindex","endindex"),DOXY_FN(TrajectoryBase, GetWaypoints "size_t; size_t; std::vector"))
     .def("GetWaypoints2D",GetWaypoints2D2,args("startindex","endindex","spec"),DOXY_FN(TrajectoryBase, GetWaypoints "size_t; size_t; std::vector, const ConfigurationSpecification&"))
     .def("GetAllWaypoints2D",GetAllWaypoints2D1,DOXY_FN(TrajectoryBase, GetWaypoints "size_t; size_t; std::vector"))
@@ -134,42 +134,40 @@ class Grasper:
             cmd += 'finestep %.15e '%finestep
         if numthreads is not None:
             cmd += 'numthreads %d '%numthreads
-        cmd += 'approachrays %d '%len(approachrays)
-        for f in approachrays.flat:
-            cmd += str(f) + ' '
-        cmd += 'rolls %d '%len(rolls)
-        for f in rolls.flat:
-            cmd += str(f) + ' '
-        cmd += 'standoffs %d '%len(standoffs)
-        for f in standoffs.flat:
-            cmd += str(f) + ' '
-        cmd += 'preshapes %d '%len(preshapes)
-        for f in preshapes.flat:
-            cmd += str(f) + ' '
-        cmd += 'manipulatordirections %d '%len(manipulatordirections)
-        for f in manipulatordirections.flat:
-            cmd += str(f) + ' '
+        cmd += 'approachrays %d '%len(approachrays) + ' '.join(repr(f) for f in approachrays.flat) + ' '
+        cmd += 'rolls %d '%len(rolls) + ' '.join(repr(f) for f in rolls.flat) + ' '
+        cmd += 'standoffs %d '%len(standoffs) + ' '.join(repr(f) for f in standoffs.flat) + ' '
+        cmd += 'preshapes %d '%len(preshapes) + ' '.join(repr(f) for f in preshapes.flat) + ' '
+        cmd += 'manipulatordirections %d '%len(manipulatordirections) + ' '.join(repr(f) for f in manipulatordirections.flat) + ' '
         res = self.prob.SendCommand(cmd)
         if res is None:
             raise PlanningError('Grasp failed')
-        resultgrasps = res.split()
+        resultgrasps = array(res.split(),float64)
         resvalues=[]
-        nextid = int(resultgrasps.pop(0))
+        nextid = int(resultgrasps[0])
+        numresults = int(resultgrasps[1])
+        index = 2
         preshapelen = len(self.robot.GetActiveManipulator().GetGripperIndices())
-        for i in range(int(resultgrasps.pop(0))):
-            position = array([float64(resultgrasps.pop(0)) for i in range(3)])
-            direction = array([float64(resultgrasps.pop(0)) for i in range(3)])
-            roll = float64(resultgrasps.pop(0))
-            standoff = float64(resultgrasps.pop(0))
-            manipulatordirection = array([float64(resultgrasps.pop(0)) for i in range(3)])
-            mindist = float64(resultgrasps.pop(0))
-            volume = float64(resultgrasps.pop(0))
-            preshape = [float64(resultgrasps.pop(0)) for i in range(preshapelen)]
-            Tfinal = matrixFromPose([float64(resultgrasps.pop(0)) for i in range(7)])
-            finalshape = array([float64(resultgrasps.pop(0)) for i in range(self.robot.GetDOF())])
-            contacts_num=int(resultgrasps.pop(0))
-            contacts=[float64(resultgrasps.pop(0)) for i in range(contacts_num*6)]
-            contacts = reshape(contacts,(contacts_num,6))
+        dof = self.robot.GetDOF()
+        for i in range(numresults):
+            position = array(resultgrasps[index:index+3])
+            direction = array(resultgrasps[index+3:index+6])
+            roll = resultgrasps[index+6]
+            standoff = resultgrasps[index+7]
+            manipulatordirection = array(resultgrasps[index+8:index+11])
+            mindist = resultgrasps[index+11]
+            volume = resultgrasps[index+12]
+            index += 13
+            preshape = list(resultgrasps[index:index+preshapelen])
+            index += preshapelen
+            Tfinal = matrixFromPose(resultgrasps[index:index+7])
+            index += 7
+            finalshape = array(resultgrasps[index:index+dof])
+            index += dof
+            contacts_num = int(resultgrasps[index])
+            index += 1
+            contacts = reshape(array(resultgrasps[index:index+6*contacts_num]),(contacts_num,6))
+            index += 6*contacts_num
             resvalues.append([position, direction, roll, standoff, manipulatordirection, mindist, volume, preshape,Tfinal,finalshape,contacts])
         return nextid, resvalues
 
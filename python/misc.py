@@ -60,6 +60,34 @@ except ImportError:
 def LoadTrajectoryFromFile(env,trajfile,trajtype=''):
     return openravepy_int.RaveCreateTrajectory(env,trajtype).deserialize(open(trajfile,'r').read())
 
+def LoadTraceLog(filename):
+    """Decodes a binary trace file written by the TraceLogger module.
+
+    Returns a list of events ordered by time. Each event is a tuple (type, name, value, timestamp, duration, threadid, values) where type is a TraceEventType value, timestamp and duration are in seconds, and values is a numpy array (usually empty).
+    """
+    import struct
+    data = open(filename,'rb').read()
+    if data[0:8] != b'ORTRACE1':
+        raise ValueError('%s is not a trace file'%filename)
+    realsize, headersize = struct.unpack('=II',data[8:16])
+    realtype = numpy.float64 if realsize == 8 else numpy.float32
+    headerformat = '=HHIQQiI'
+    names = {}
+    events = []
+    offset = 16
+    while offset+headersize <= len(data):
+        eventtype, numvalues, threadid, timestamp, duration, value, nameid = struct.unpack(headerformat, data[offset:offset+headersize])
+        offset += headersize
+        if eventtype == 0:
+            names[nameid] = data[offset:offset+value].decode('utf-8')
+            offset += value
+        else:
+            values = numpy.frombuffer(data[offset:offset+numvalues*realsize], dtype=realtype)
+            offset += numvalues*realsize
+            events.append((eventtype, names.get(nameid,''), value, timestamp*1e-9, duration*1e-9, threadid, values))
+    events.sort(key=lambda event: event[3])
+    return events
+
 def InitOpenRAVELogging(stream=stdout):
     """Sets the python logging **openravepy** scope to the same debug level as OpenRAVE and initializes handles if they are not present
     """
@@ -0,0 +1,885 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2014 Rosen Diankov <rosen.diankov@gmail.com>
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/** \file binarysnapshot.cpp
+    \brief Reads and writes fully initialized bodies into a versioned binary snapshot (*.orsnap).
+
+    The snapshot stores the link, joint, manipulator, and attached sensor infos along with the collision meshes of
+    every geometry, so loading does not need to parse any xml/collada nor import any mesh files. It also stores the
+    adjacent and non-adjacent link sets, which otherwise require running the collision checker on all the link pairs
+    of the body. When reading, the kinematics geometry hash of each body is recomputed and compared with the stored
+    one. If anything is different, the whole snapshot is rejected. The link infos are stored at the zero joint values and
+    the dof values are set after the body is created. Element counts are checked against the remaining file size, so a
+    corrupt or truncated snapshot throws ORE_InvalidArguments instead of allocating memory.
+
+    Layout (native endianness, checked through the header):
+    \verbatim
+    header: magic[8] version(uint32) endian(uint32) sizeof(dReal)(uint32) numbodies(uint32)
+    body:   flags(uint32) name xmlid uri transform dofvalues links joints passivejoints [robot] adjacent nonadjacent hash [robothash]
+    \endverbatim
+ */
+#include "ravep.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace {
+
+static const char s_snapshotmagic[8] = { 'O', 'R', 'S', 'N', 'A', 'P', 0, 0 };
+static const uint32_t s_snapshotversion = 2;
+static const uint32_t s_snapshotendian = 0x01020304;
+
+enum SnapshotBodyFlags
+{
+    SBF_Robot = 1,
+    SBF_Enabled = 2,
+    SBF_Visible = 4,
+    SBF_MakeJoinedLinksAdjacent = 8,
+};
+
+}
+
+/// \brief serializes bodies into the binary snapshot format
+class SnapshotWriter
+{
+public:
+    SnapshotWriter(std::ostream& O) : _O(O) {
+    }
+
+    void WriteHeader(uint32_t numbodies)
+    {
+        _O.write(s_snapshotmagic, sizeof(s_snapshotmagic));
+        _WritePOD(s_snapshotversion);
+        _WritePOD(s_snapshotendian);
+        _WritePOD(static_cast<uint32_t>(sizeof(dReal)));
+        _WritePOD(numbodies);
+    }
+
+    void WriteBody(KinBodyPtr pbody)
+    {
+        uint32_t flags = 0;
+        if( pbody->IsRobot() ) {
+            flags |= SBF_Robot;
+        }
+        if( pbody->IsEnabled() ) {
+            flags |= SBF_Enabled;
+        }
+        if( pbody->IsVisible() ) {
+            flags |= SBF_Visible;
+        }
+        if( pbody->_bMakeJoinedLinksAdjacent ) {
+            flags |= SBF_MakeJoinedLinksAdjacent;
+        }
+        _WritePOD(flags);
+        _WriteString(pbody->GetName());
+        _WriteString(pbody->GetXMLId());
+        _WriteString(pbody->GetURI());
+        _WriteTransform(pbody->GetTransform());
+        std::vector<dReal> vdofvalues;
+        pbody->GetDOFValues(vdofvalues);
+        _WriteVector(vdofvalues);
+
+        std::vector<Transform> vlinktransforms;
+        _ComputeZeroLinkTransforms(pbody, vlinktransforms);
+        _WritePOD(static_cast<uint32_t>(pbody->GetLinks().size()));
+        FOREACHC(itlink, pbody->GetLinks()) {
+            // the geometry infos of the link are not always updated, so take them directly from the geometries
+            KinBody::LinkInfo info = (*itlink)->GetInfo();
+            info._t = vlinktransforms.at((*itlink)->GetIndex());
+            info._bIsEnabled = (*itlink)->IsEnabled();
+            // the forced adjacent links of the body are a superset of the ones of the link infos
+            info._vForcedAdjacentLinks.resize(0);
+            FOREACHC(itadjacent, pbody->_vForcedAdjacentLinks) {
+                if( itadjacent->first == info._name ) {
+                    info._vForcedAdjacentLinks.push_back(itadjacent->second);
+                }
+            }
+            info._vgeometryinfos.resize(0);
+            FOREACHC(itgeom, (*itlink)->GetGeometries()) {
+                info._vgeometryinfos.push_back(KinBody::GeometryInfoPtr(new KinBody::GeometryInfo((*itgeom)->GetInfo())));
+            }
+            _WriteLinkInfo(info);
+        }
+        _WritePOD(static_cast<uint32_t>(pbody->GetJoints().size()));
+        FOREACHC(itjoint, pbody->GetJoints()) {
+            _WriteJointInfo(**itjoint);
+        }
+        _WritePOD(static_cast<uint32_t>(pbody->GetPassiveJoints().size()));
+        FOREACHC(itjoint, pbody->GetPassiveJoints()) {
+            _WriteJointInfo(**itjoint);
+        }
+
+        if( pbody->IsRobot() ) {
+            RobotBasePtr probot = RaveInterfaceCast<RobotBase>(pbody);
+            _WritePOD(static_cast<uint32_t>(probot->GetManipulators().size()));
+            FOREACHC(itmanip, probot->GetManipulators()) {
+                _WriteManipulatorInfo((*itmanip)->GetInfo());
+            }
+            _WritePOD(static_cast<uint32_t>(probot->GetAttachedSensors().size()));
+            FOREACHC(itsensor, probot->GetAttachedSensors()) {
+                _WriteAttachedSensorInfo((*itsensor)->UpdateAndGetInfo());
+            }
+            RobotBase::ManipulatorPtr pmanip = probot->GetActiveManipulator();
+            _WriteString(!pmanip ? std::string() : pmanip->GetName());
+            _WriteVector(probot->GetActiveDOFIndices());
+            _WritePOD(static_cast<int32_t>(probot->GetAffineDOF()));
+        }
+
+        _WriteSet(pbody->GetAdjacentLinks());
+        _WriteSet(pbody->GetNonAdjacentLinks(0));
+        _WriteString(pbody->GetKinematicsGeometryHash());
+        if( pbody->IsRobot() ) {
+            _WriteString(RaveInterfaceCast<RobotBase>(pbody)->GetRobotStructureHash());
+        }
+    }
+
+protected:
+    /// \brief computes the link transforms when all the joints are at their zero values
+    ///
+    /// The joints are initialized from the link transforms, so storing the links at the zero values makes the joints
+    /// split their transformations the same way as when the body was first loaded, which keeps the kinematics hash.
+    void _ComputeZeroLinkTransforms(KinBodyPtr pbody, std::vector<Transform>& vlinktransforms)
+    {
+        const std::vector<KinBody::LinkPtr>& vlinks = pbody->GetLinks();
+        std::vector<KinBody::JointPtr> vjoints = pbody->GetJoints();
+        vjoints.insert(vjoints.end(), pbody->GetPassiveJoints().begin(), pbody->GetPassiveJoints().end());
+        vlinktransforms.resize(vlinks.size());
+        std::vector<uint8_t> vcomputed(vlinks.size(), 1);
+        FOREACHC(itjoint, vjoints) {
+            vcomputed.at((*itjoint)->GetSecondAttached()->GetIndex()) = 0;
+        }
+        // links that are not moved by any joint keep their transforms
+        for(size_t i = 0; i < vlinks.size(); ++i) {
+            vlinktransforms[i] = vlinks[i]->GetTransform();
+        }
+        bool bchanged = true;
+        while(bchanged) {
+            bchanged = false;
+            FOREACHC(itjoint, vjoints) {
+                KinBody::LinkPtr plink0 = (*itjoint)->GetFirstAttached(), plink1 = (*itjoint)->GetSecondAttached();
+                if( !!plink0 && vcomputed.at(plink0->GetIndex()) && !vcomputed.at(plink1->GetIndex()) ) {
+                    vlinktransforms.at(plink1->GetIndex()) = vlinktransforms.at(plink0->GetIndex()) * (*itjoint)->GetInternalHierarchyLeftTransform() * (*itjoint)->GetInternalHierarchyRightTransform();
+                    vcomputed.at(plink1->GetIndex()) = 1;
+                    bchanged = true;
+                }
+            }
+        }
+    }
+
+    /// \brief writes the joint info at the zero values, see \ref _ComputeZeroLinkTransforms
+    void _WriteJointInfo(KinBody::Joint& joint)
+    {
+        KinBody::JointInfo info = joint.UpdateAndGetInfo();
+        info._vcurrentvalues.resize(0);
+        _WriteJointInfo(info);
+    }
+
+    template <typename T>
+    void _WritePOD(const T& value)
+    {
+        _O.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void _WriteString(const std::string& s)
+    {
+        _WritePOD(static_cast<uint32_t>(s.size()));
+        if( s.size() > 0 ) {
+            _O.write(s.c_str(), s.size());
+        }
+    }
+
+    template <typename T>
+    void _WriteVector(const std::vector<T>& v)
+    {
+        _WritePOD(static_cast<uint32_t>(v.size()));
+        if( v.size() > 0 ) {
+            _O.write(reinterpret_cast<const char*>(&v[0]), v.size()*sizeof(T));
+        }
+    }
+
+    void _WriteVector(const std::vector<std::pair<dReal, dReal> >& v)
+    {
+        _WritePOD(static_cast<uint32_t>(v.size()));
+        FOREACHC(it, v) {
+            _WritePOD(it->first);
+            _WritePOD(it->second);
+        }
+    }
+
+    void _WriteSet(const std::set<int>& s)
+    {
+        _WritePOD(static_cast<uint32_t>(s.size()));
+        FOREACHC(it, s) {
+            _WritePOD(static_cast<int32_t>(*it));
+        }
+    }
+
+    void _WriteVector3(const Vector& v)
+    {
+        _WritePOD(v.x); _WritePOD(v.y); _WritePOD(v.z);
+    }
+
+    void _WriteVector4(const Vector& v)
+    {
+        _WritePOD(v.x); _WritePOD(v.y); _WritePOD(v.z); _WritePOD(v.w);
+    }
+
+    void _WriteColor(const RaveVector<float>& v)
+    {
+        _WritePOD(v.x); _WritePOD(v.y); _WritePOD(v.z); _WritePOD(v.w);
+    }
+
+    void _WriteTransform(const Transform& t)
+    {
+        _WriteVector4(t.rot);
+        _WriteVector3(t.trans);
+    }
+
+    template <typename T, std::size_t N>
+    void _WriteArray(const boost::array<T,N>& a)
+    {
+        for(std::size_t i = 0; i < N; ++i) {
+            _WritePOD(a[i]);
+        }
+    }
+
+    void _WriteParameters(const std::map<std::string, std::vector<dReal> >& mapFloatParameters, const std::map<std::string, std::vector<int> >& mapIntParameters, const std::map<std::string, std::string >& mapStringParameters)
+    {
+        _WritePOD(static_cast<uint32_t>(mapFloatParameters.size()));
+        FOREACHC(it, mapFloatParameters) {
+            _WriteString(it->first);
+            _WriteVector(it->second);
+        }
+        _WritePOD(static_cast<uint32_t>(mapIntParameters.size()));
+        FOREACHC(it, mapIntParameters) {
+            _WriteString(it->first);
+            _WriteVector(it->second);
+        }
+        _WritePOD(static_cast<uint32_t>(mapStringParameters.size()));
+        FOREACHC(it, mapStringParameters) {
+            _WriteString(it->first);
+            _WriteString(it->second);
+        }
+    }
+
+    void _WriteTriMesh(const TriMesh& trimesh)
+    {
+        _WritePOD(static_cast<uint32_t>(trimesh.vertices.size()));
+        FOREACHC(itv, trimesh.vertices) {
+            _WriteVector3(*itv);
+        }
+        _WriteVector(trimesh.indices);
+    }
+
+    void _WriteGeometryInfo(const KinBody::GeometryInfo& info)
+    {
+        _WriteTransform(info._t);
+        _WriteVector4(info._vGeomData);
+        _WriteVector4(info._vGeomData2);
+        _WriteVector4(info._vGeomData3);
+        _WriteColor(info._vDiffuseColor);
+        _WriteColor(info._vAmbientColor);
+        _WriteTriMesh(info._meshcollision);
+        _WritePOD(static_cast<int32_t>(info._type));
+        _WriteString(info._filenamerender);
+        _WriteString(info._filenamecollision);
+        _WriteVector3(info._vRenderScale);
+        _WriteVector3(info._vCollisionScale);
+        _WritePOD(info._fTransparency);
+        _WritePOD(static_cast<uint8_t>(info._bVisible));
+        _WritePOD(static_cast<uint8_t>(info._bModifiable));
+    }
+
+    void _WriteLinkInfo(const KinBody::LinkInfo& info)
+    {
+        _WritePOD(static_cast<uint32_t>(info._vgeometryinfos.size()));
+        FOREACHC(itgeom, info._vgeometryinfos) {
+            _WriteGeometryInfo(**itgeom);
+        }
+        _WritePOD(static_cast<uint32_t>(info._mapExtraGeometries.size()));
+        FOREACHC(itextra, info._mapExtraGeometries) {
+            _WriteString(itextra->first);
+            _WritePOD(static_cast<uint32_t>(itextra->second.size()));
+            FOREACHC(itgeom, itextra->second) {
+                _WriteGeometryInfo(**itgeom);
+            }
+        }
+        _WriteString(info._name);
+        _WriteTransform(info._t);
+        _WriteTransform(info._tMassFrame);
+        _WritePOD(info._mass);
+        _WriteVector3(info._vinertiamoments);
+        _WriteParameters(info._mapFloatParameters, info._mapIntParameters, info._mapStringParameters);
+        _WritePOD(static_cast<uint32_t>(info._vForcedAdjacentLinks.size()));
+        FOREACHC(it, info._vForcedAdjacentLinks) {
+            _WriteString(*it);
+        }
+        _WritePOD(static_cast<uint8_t>(info._bStatic));
+        _WritePOD(static_cast<uint8_t>(info._bIsEnabled));
+    }
+
+    void _WriteJointInfo(const KinBody::JointInfo& info)
+    {
+        _WritePOD(static_cast<int32_t>(info._type));
+        _WriteString(info._name);
+        _WriteString(info._linkname0);
+        _WriteString(info._linkname1);
+        _WriteVector3(info._vanchor);
+        for(size_t i = 0; i < info._vaxes.size(); ++i) {
+            _WriteVector3(info._vaxes[i]);
+        }
+        _WriteVector(info._vcurrentvalues);
+        _WriteArray(info._vresolution);
+        _WriteArray(info._vmaxvel);
+        _WriteArray(info._vhardmaxvel);
+        _WriteArray(info._vmaxaccel);
+        _WriteArray(info._vmaxtorque);
+        _WriteArray(info._vmaxinertia);
+        _WriteArray(info._vweights);
+        _WriteArray(info._voffsets);
+        _WriteArray(info._vlowerlimit);
+        _WriteArray(info._vupperlimit);
+        if( !!info._trajfollow ) {
+            RAVELOG_WARN_FORMAT("joint %s follows a trajectory, which is not stored in snapshots", info._name);
+        }
+        for(size_t i = 0; i < info._vmimic.size(); ++i) {
+            _WritePOD(static_cast<uint8_t>(!!info._vmimic[i]));
+            if( !!info._vmimic[i] ) {
+                for(size_t j = 0; j < info._vmimic[i]->_equations.size(); ++j) {
+                    _WriteString(info._vmimic[i]->_equations[j]);
+                }
+            }
+        }
+        _WriteParameters(info._mapFloatParameters, info._mapIntParameters, info._mapStringParameters);
+        _WritePOD(static_cast<uint8_t>(!!info._infoElectricMotor));
+        if( !!info._infoElectricMotor ) {
+            const ElectricMotorActuatorInfo& motor = *info._infoElectricMotor;
+            _WriteString(motor.model_type);
+            _WritePOD(motor.assigned_power_rating);
+            _WritePOD(motor.max_speed);
+            _WritePOD(motor.no_load_speed);
+            _WritePOD(motor.stall_torque);
+            _WritePOD(motor.max_instantaneous_torque);
+            _WriteVector(motor.nominal_speed_torque_points);
+            _WriteVector(motor.max_speed_torque_points);
+            _WritePOD(motor.nominal_torque);
+            _WritePOD(motor.rotor_inertia);
+            _WritePOD(motor.torque_constant);
+            _WritePOD(motor.nominal_voltage);
+            _WritePOD(motor.speed_constant);
+            _WritePOD(motor.starting_current);
+            _WritePOD(motor.terminal_resistance);
+            _WritePOD(motor.gear_ratio);
+            _WritePOD(motor.coloumb_friction);
+            _WritePOD(motor.viscous_friction);
+        }
+        _WriteArray(info._bIsCircular);
+        _WritePOD(static_cast<uint8_t>(info._bIsActive));
+    }
+
+    void _WriteManipulatorInfo(const RobotBase::ManipulatorInfo& info)
+    {
+        _WriteString(info._name);
+        _WriteString(info._sBaseLinkName);
+        _WriteString(info._sEffectorLinkName);
+        _WriteTransform(info._tLocalTool);
+        _WriteVector(info._vChuckingDirection);
+        _WriteVector3(info._vdirection);
+        _WriteString(info._sIkSolverXMLId);
+        _WritePOD(static_cast<uint32_t>(info._vGripperJointNames.size()));
+        FOREACHC(it, info._vGripperJointNames) {
+            _WriteString(*it);
+        }
+    }
+
+    void _WriteAttachedSensorInfo(const RobotBase::AttachedSensorInfo& info)
+    {
+        // the sensor geometry is interface specific, so only the attachment is stored
+        _WriteString(info._name);
+        _WriteString(info._linkname);
+        _WriteTransform(info._trelative);
+        _WriteString(info._sensorname);
+    }
+
+    std::ostream& _O;
+};
+
+/// \brief reads bodies from a memory mapped binary snapshot
+class SnapshotReader
+{
+public:
+    SnapshotReader(EnvironmentBasePtr penv, const std::string& filename) : _penv(penv), _filename(filename), _pcur(NULL), _pend(NULL) {
+    }
+
+    bool Read(const AttributesList& atts)
+    {
+        boost::interprocess::file_mapping filemapping(_filename.c_str(), boost::interprocess::read_only);
+        boost::interprocess::mapped_region region(filemapping, boost::interprocess::read_only);
+        _pcur = static_cast<const char*>(region.get_address());
+        _pend = _pcur + region.get_size();
+
+        _Check(sizeof(s_snapshotmagic));
+        if( memcmp(_pcur, s_snapshotmagic, sizeof(s_snapshotmagic)) != 0 ) {
+            RAVELOG_WARN_FORMAT("%s is not an openrave snapshot", _filename);
+            return false;
+        }
+        _pcur += sizeof(s_snapshotmagic);
+        uint32_t version = _ReadPOD<uint32_t>(), endian = _ReadPOD<uint32_t>(), realsize = _ReadPOD<uint32_t>();
+        if( version != s_snapshotversion || endian != s_snapshotendian || realsize != sizeof(dReal) ) {
+            RAVELOG_WARN_FORMAT("snapshot %s has version %d, endian 0x%x, and real size %d, which is not compatible with version %d, endian 0x%x, and real size %d", _filename%version%endian%realsize%s_snapshotversion%s_snapshotendian%sizeof(dReal));
+            return false;
+        }
+
+        uint32_t numbodies = _ReadCount(sizeof(uint32_t));
+        std::list<KinBodyPtr> listadded;
+        bool bsuccess = false;
+        try {
+            bsuccess = true;
+            for(uint32_t ibody = 0; ibody < numbodies; ++ibody) {
+                KinBodyPtr pbody = _ReadBody();
+                if( !pbody ) {
+                    bsuccess = false;
+                    break;
+                }
+                listadded.push_back(pbody);
+            }
+        }
+        catch(...) {
+            FOREACH(itbody, listadded) {
+                _penv->Remove(*itbody);
+            }
+            throw;
+        }
+        if( !bsuccess ) {
+            FOREACH(itbody, listadded) {
+                _penv->Remove(*itbody);
+            }
+        }
+        return bsuccess;
+    }
+
+protected:
+    /// \brief creates the body, adds it to the environment and restores its cached information
+    ///
+    /// \return the added body, or an empty pointer if the stored hashes do not match.
+    KinBodyPtr _ReadBody()
+    {
+        uint32_t flags = _ReadPOD<uint32_t>();
+        std::string name = _ReadString(), xmlid = _ReadString(), uri = _ReadString();
+        Transform tbody = _ReadTransform();
+        std::vector<dReal> vdofvalues;
+        _ReadVector(vdofvalues);
+
+        if( !!_penv->GetKinBody(name) ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("body %s from snapshot %s already exists in the environment"), name%_filename, ORE_InvalidArguments);
+        }
+
+        std::vector<KinBody::LinkInfoConstPtr> vlinkinfos(_ReadCount(sizeof(uint32_t)));
+        FOREACH(itlinkinfo, vlinkinfos) {
+            *itlinkinfo = _ReadLinkInfo();
+        }
+        std::vector<KinBody::JointInfoConstPtr> vjointinfos(_ReadCount(sizeof(int32_t)));
+        FOREACH(itjointinfo, vjointinfos) {
+            *itjointinfo = _ReadJointInfo();
+        }
+        // passive joints are initialized along with the active joints, KinBody::Init sorts them out
+        uint32_t numpassive = _ReadCount(sizeof(int32_t));
+        for(uint32_t i = 0; i < numpassive; ++i) {
+            vjointinfos.push_back(_ReadJointInfo());
+        }
+
+        KinBodyPtr pbody;
+        RobotBasePtr probot;
+        std::string activemanipname;
+        std::vector<int> vactivedofs;
+        int affinedof = 0;
+        if( flags & SBF_Robot ) {
+            std::vector<RobotBase::ManipulatorInfoConstPtr> vmanipinfos(_ReadCount(sizeof(uint32_t)));
+            FOREACH(itmanipinfo, vmanipinfos) {
+                *itmanipinfo = _ReadManipulatorInfo();
+            }
+            std::vector<RobotBase::AttachedSensorInfoConstPtr> vsensorinfos(_ReadCount(sizeof(uint32_t)));
+            FOREACH(itsensorinfo, vsensorinfos) {
+                *itsensorinfo = _ReadAttachedSensorInfo();
+            }
+            activemanipname = _ReadString();
+            _ReadVector(vactivedofs);
+            affinedof = _ReadPOD<int32_t>();
+
+            probot = RaveCreateRobot(_penv, xmlid);
+            if( !probot ) {
+                RAVELOG_WARN_FORMAT("failed to create robot type %s, using default", xmlid);
+                probot = RaveCreateRobot(_penv, "");
+            }
+            if( !probot->Init(vlinkinfos, vjointinfos, vmanipinfos, vsensorinfos, uri) ) {
+                throw OPENRAVE_EXCEPTION_FORMAT(_("failed to initialize robot %s from snapshot %s"), name%_filename, ORE_InvalidState);
+            }
+            pbody = probot;
+        }
+        else {
+            pbody = RaveCreateKinBody(_penv, xmlid);
+            if( !pbody ) {
+                RAVELOG_WARN_FORMAT("failed to create body type %s, using default", xmlid);
+                pbody = RaveCreateKinBody(_penv, "");
+            }
+            if( !pbody->Init(vlinkinfos, vjointinfos, uri) ) {
+                throw OPENRAVE_EXCEPTION_FORMAT(_("failed to initialize body %s from snapshot %s"), name%_filename, ORE_InvalidState);
+            }
+        }
+        pbody->SetName(name);
+        pbody->_bMakeJoinedLinksAdjacent = !!(flags & SBF_MakeJoinedLinksAdjacent);
+
+        std::set<int> setAdjacentLinks, setNonAdjacentLinks;
+        _ReadSet(setAdjacentLinks);
+        _ReadSet(setNonAdjacentLinks);
+        std::string kinematicshash = _ReadString(), robothash;
+        if( !!probot ) {
+            robothash = _ReadString();
+        }
+
+        _penv->Add(pbody, false);
+        if( pbody->GetKinematicsGeometryHash() != kinematicshash || (!!probot && probot->GetRobotStructureHash() != robothash) || pbody->GetAdjacentLinks() != setAdjacentLinks ) {
+            RAVELOG_WARN_FORMAT("body %s in snapshot %s does not match its stored hashes, snapshot is out of date", name%_filename);
+            _penv->Remove(pbody);
+            return KinBodyPtr();
+        }
+
+        pbody->SetTransform(tbody);
+        pbody->SetDOFValues(vdofvalues, KinBody::CLA_Nothing);
+        if( !!probot ) {
+            if( activemanipname.size() > 0 ) {
+                probot->SetActiveManipulator(activemanipname);
+            }
+            probot->SetActiveDOFs(vactivedofs, affinedof);
+        }
+        pbody->Enable(!!(flags & SBF_Enabled));
+        pbody->SetVisible(!!(flags & SBF_Visible));
+
+        // adding to the environment resets the collision cache, so restore the non-adjacent links last
+        pbody->_setNonAdjacentLinks[0].swap(setNonAdjacentLinks);
+        pbody->_nNonAdjacentLinkCache = 0;
+        return pbody;
+    }
+
+    void _Check(size_t size)
+    {
+        if( static_cast<size_t>(_pend - _pcur) < size ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("snapshot %s is truncated"), _filename, ORE_InvalidArguments);
+        }
+    }
+
+    /// \brief reads the number of elements of a container and checks that the remaining data can hold them
+    ///
+    /// \param elementsize the minimum number of bytes every element takes in the file
+    uint32_t _ReadCount(size_t elementsize)
+    {
+        uint32_t count = _ReadPOD<uint32_t>();
+        if( static_cast<uint64_t>(count)*elementsize > static_cast<uint64_t>(_pend - _pcur) ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("snapshot %s is corrupt, %d elements do not fit into the remaining %d bytes"), _filename%count%(_pend - _pcur), ORE_InvalidArguments);
+        }
+        return count;
+    }
+
+    template <typename T>
+    T _ReadPOD()
+    {
+        _Check(sizeof(T));
+        T value;
+        memcpy(&value, _pcur, sizeof(T));
+        _pcur += sizeof(T);
+        return value;
+    }
+
+    std::string _ReadString()
+    {
+        uint32_t size = _ReadCount(1);
+        std::string s(_pcur, size);
+        _pcur += size;
+        return s;
+    }
+
+    template <typename T>
+    void _ReadVector(std::vector<T>& v)
+    {
+        uint32_t size = _ReadCount(sizeof(T));
+        v.resize(size);
+        if( size > 0 ) {
+            memcpy(&v[0], _pcur, size*sizeof(T));
+            _pcur += size*sizeof(T);
+        }
+    }
+
+    /// std::pair is not trivially copyable, so read the speed-torque points one member at a time
+    void _ReadVector(std::vector<std::pair<dReal, dReal> >& v)
+    {
+        uint32_t size = _ReadCount(2*sizeof(dReal));
+        v.resize(size);
+        FOREACH(it, v) {
+            it->first = _ReadPOD<dReal>();
+            it->second = _ReadPOD<dReal>();
+        }
+    }
+
+    void _ReadSet(std::set<int>& s)
+    {
+        s.clear();
+        uint32_t size = _ReadCount(sizeof(int32_t));
+        for(uint32_t i = 0; i < size; ++i) {
+            s.insert(s.end(), _ReadPOD<int32_t>());
+        }
+    }
+
+    Vector _ReadVector3()
+    {
+        Vector v;
+        v.x = _ReadPOD<dReal>(); v.y = _ReadPOD<dReal>(); v.z = _ReadPOD<dReal>();
+        return v;
+    }
+
+    Vector _ReadVector4()
+    {
+        Vector v;
+        v.x = _ReadPOD<dReal>(); v.y = _ReadPOD<dReal>(); v.z = _ReadPOD<dReal>(); v.w = _ReadPOD<dReal>();
+        return v;
+    }
+
+    RaveVector<float> _ReadColor()
+    {
+        RaveVector<float> v;
+        v.x = _ReadPOD<float>(); v.y = _ReadPOD<float>(); v.z = _ReadPOD<float>(); v.w = _ReadPOD<float>();
+        return v;
+    }
+
+    Transform _ReadTransform()
+    {
+        Transform t;
+        t.rot = _ReadVector4();
+        t.trans = _ReadVector3();
+        return t;
+    }
+
+    template <typename T, std::size_t N>
+    void _ReadArray(boost::array<T,N>& a)
+    {
+        for(std::size_t i = 0; i < N; ++i) {
+            a[i] = _ReadPOD<T>();
+        }
+    }
+
+    void _ReadParameters(std::map<std::string, std::vector<dReal> >& mapFloatParameters, std::map<std::string, std::vector<int> >& mapIntParameters, std::map<std::string, std::string >& mapStringParameters)
+    {
+        uint32_t size = _ReadCount(2*sizeof(uint32_t));
+        for(uint32_t i = 0; i < size; ++i) {
+            std::string key = _ReadString();
+            _ReadVector(mapFloatParameters[key]);
+        }
+        size = _ReadCount(2*sizeof(uint32_t));
+        for(uint32_t i = 0; i < size; ++i) {
+            std::string key = _ReadString();
+            _ReadVector(mapIntParameters[key]);
+        }
+        size = _ReadCount(2*sizeof(uint32_t));
+        for(uint32_t i = 0; i < size; ++i) {
+            std::string key = _ReadString();
+            mapStringParameters[key] = _ReadString();
+        }
+    }
+
+    void _ReadTriMesh(TriMesh& trimesh)
+    {
+        trimesh.vertices.resize(_ReadCount(3*sizeof(dReal)));
+        FOREACH(itv, trimesh.vertices) {
+            *itv = _ReadVector3();
+        }
+        _ReadVector(trimesh.indices);
+    }
+
+    KinBody::GeometryInfoPtr _ReadGeometryInfo()
+    {
+        KinBody::GeometryInfoPtr pinfo(new KinBody::GeometryInfo());
+        KinBody::GeometryInfo& info = *pinfo;
+        info._t = _ReadTransform();
+        info._vGeomData = _ReadVector4();
+        info._vGeomData2 = _ReadVector4();
+        info._vGeomData3 = _ReadVector4();
+        info._vDiffuseColor = _ReadColor();
+        info._vAmbientColor = _ReadColor();
+        _ReadTriMesh(info._meshcollision);
+        info._type = static_cast<GeometryType>(_ReadPOD<int32_t>());
+        info._filenamerender = _ReadString();
+        info._filenamecollision = _ReadString();
+        info._vRenderScale = _ReadVector3();
+        info._vCollisionScale = _ReadVector3();
+        info._fTransparency = _ReadPOD<float>();
+        info._bVisible = !!_ReadPOD<uint8_t>();
+        info._bModifiable = !!_ReadPOD<uint8_t>();
+        return pinfo;
+    }
+
+    KinBody::LinkInfoPtr _ReadLinkInfo()
+    {
+        KinBody::LinkInfoPtr pinfo(new KinBody::LinkInfo());
+        KinBody::LinkInfo& info = *pinfo;
+        info._vgeometryinfos.resize(_ReadCount(sizeof(int32_t)));
+        FOREACH(itgeom, info._vgeometryinfos) {
+            *itgeom = _ReadGeometryInfo();
+        }
+        uint32_t numextra = _ReadCount(sizeof(uint32_t));
+        for(uint32_t i = 0; i < numextra; ++i) {
+            std::vector<KinBody::GeometryInfoPtr>& vgeometryinfos = info._mapExtraGeometries[_ReadString()];
+            vgeometryinfos.resize(_ReadCount(sizeof(int32_t)));
+            FOREACH(itgeom, vgeometryinfos) {
+                *itgeom = _ReadGeometryInfo();
+            }
+        }
+        info._name = _ReadString();
+        info._t = _ReadTransform();
+        info._tMassFrame = _ReadTransform();
+        info._mass = _ReadPOD<dReal>();
+        info._vinertiamoments = _ReadVector3();
+        _ReadParameters(info._mapFloatParameters, info._mapIntParameters, info._mapStringParameters);
+        info._vForcedAdjacentLinks.resize(_ReadCount(sizeof(uint32_t)));
+        FOREACH(it, info._vForcedAdjacentLinks) {
+            *it = _ReadString();
+        }
+        info._bStatic = !!_ReadPOD<uint8_t>();
+        info._bIsEnabled = !!_ReadPOD<uint8_t>();
+        return pinfo;
+    }
+
+    KinBody::JointInfoPtr _ReadJointInfo()
+    {
+        KinBody::JointInfoPtr pinfo(new KinBody::JointInfo());
+        KinBody::JointInfo& info = *pinfo;
+        info._type = static_cast<KinBody::JointType>(_ReadPOD<int32_t>());
+        info._name = _ReadString();
+        info._linkname0 = _ReadString();
+        info._linkname1 = _ReadString();
+        info._vanchor = _ReadVector3();
+        for(size_t i = 0; i < info._vaxes.size(); ++i) {
+            info._vaxes[i] = _ReadVector3();
+        }
+        _ReadVector(info._vcurrentvalues);
+        _ReadArray(info._vresolution);
+        _ReadArray(info._vmaxvel);
+        _ReadArray(info._vhardmaxvel);
+        _ReadArray(info._vmaxaccel);
+        _ReadArray(info._vmaxtorque);
+        _ReadArray(info._vmaxinertia);
+        _ReadArray(info._vweights);
+        _ReadArray(info._voffsets);
+        _ReadArray(info._vlowerlimit);
+        _ReadArray(info._vupperlimit);
+        for(size_t i = 0; i < info._vmimic.size(); ++i) {
+            if( _ReadPOD<uint8_t>() ) {
+                info._vmimic[i].reset(new KinBody::MimicInfo());
+                for(size_t j = 0; j < info._vmimic[i]->_equations.size(); ++j) {
+                    info._vmimic[i]->_equations[j] = _ReadString();
+                }
+            }
+        }
+        _ReadParameters(info._mapFloatParameters, info._mapIntParameters, info._mapStringParameters);
+        if( _ReadPOD<uint8_t>() ) {
+            info._infoElectricMotor.reset(new ElectricMotorActuatorInfo());
+            ElectricMotorActuatorInfo& motor = *info._infoElectricMotor;
+            motor.model_type = _ReadString();
+            motor.assigned_power_rating = _ReadPOD<dReal>();
+            motor.max_speed = _ReadPOD<dReal>();
+            motor.no_load_speed = _ReadPOD<dReal>();
+            motor.stall_torque = _ReadPOD<dReal>();
+            motor.max_instantaneous_torque = _ReadPOD<dReal>();
+            _ReadVector(motor.nominal_speed_torque_points);
+            _ReadVector(motor.max_speed_torque_points);
+            motor.nominal_torque = _ReadPOD<dReal>();
+            motor.rotor_inertia = _ReadPOD<dReal>();
+            motor.torque_constant = _ReadPOD<dReal>();
+            motor.nominal_voltage = _ReadPOD<dReal>();
+            motor.speed_constant = _ReadPOD<dReal>();
+            motor.starting_current = _ReadPOD<dReal>();
+            motor.terminal_resistance = _ReadPOD<dReal>();
+            motor.gear_ratio = _ReadPOD<dReal>();
+            motor.coloumb_friction = _ReadPOD<dReal>();
+            motor.viscous_friction = _ReadPOD<dReal>();
+        }
+        _ReadArray(info._bIsCircular);
+        info._bIsActive = !!_ReadPOD<uint8_t>();
+        return pinfo;
+    }
+
+    RobotBase::ManipulatorInfoPtr _ReadManipulatorInfo()
+    {
+        RobotBase::ManipulatorInfoPtr pinfo(new RobotBase::ManipulatorInfo());
+        RobotBase::ManipulatorInfo& info = *pinfo;
+        info._name = _ReadString();
+        info._sBaseLinkName = _ReadString();
+        info._sEffectorLinkName = _ReadString();
+        info._tLocalTool = _ReadTransform();
+        _ReadVector(info._vChuckingDirection);
+        info._vdirection = _ReadVector3();
+        info._sIkSolverXMLId = _ReadString();
+        info._vGripperJointNames.resize(_ReadCount(sizeof(uint32_t)));
+        FOREACH(it, info._vGripperJointNames) {
+            *it = _ReadString();
+        }
+        return pinfo;
+    }
+
+    RobotBase::AttachedSensorInfoPtr _ReadAttachedSensorInfo()
+    {
+        RobotBase::AttachedSensorInfoPtr pinfo(new RobotBase::AttachedSensorInfo());
+        pinfo->_name = _ReadString();
+        pinfo->_linkname = _ReadString();
+        pinfo->_trelative = _ReadTransform();
+        pinfo->_sensorname = _ReadString();
+        return pinfo;
+    }
+
+    EnvironmentBasePtr _penv;
+    std::string _filename;
+    const char* _pcur, *_pend;
+};
+
+void RaveWriteSnapshotFile(const std::list<KinBodyPtr>& listbodies, const std::string& filename, const AttributesList& atts)
+{
+    std::ofstream f(filename.c_str(), std::ios::out|std::ios::binary);
+    if( !f ) {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("failed to open %s for writing"), filename, ORE_InvalidArguments);
+    }
+    SnapshotWriter writer(f);
+    writer.WriteHeader(listbodies.size());
+    FOREACHC(itbody, listbodies) {
+        writer.WriteBody(*itbody);
+    }
+    if( !f ) {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("failed to write snapshot %s"), filename, ORE_InvalidArguments);
+    }
+}
+
+bool RaveParseSnapshotFile(EnvironmentBasePtr penv, const std::string& filename, const AttributesList& atts)
+{
+    std::string fullfilename = RaveFindLocalFile(filename);
+    if( fullfilename.size() == 0 ) {
+        return false;
+    }
+    try {
+        SnapshotReader reader(penv, fullfilename);
+        return reader.Read(atts);
+    }
+    catch(const boost::interprocess::interprocess_exception& ex) {
+        RAVELOG_WARN_FORMAT("failed to map snapshot %s: %s", fullfilename%ex.what());
+    }
+    return false;
+}
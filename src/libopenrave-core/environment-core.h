@@ -291,6 +291,7 @@ public:
         // release all other interfaces, not necessary to hold a mutex?
         _pCurrentChecker.reset();
         _pPhysicsEngine.reset();
+        RaveDestroyProfile(GetId());
         RAVELOG_VERBOSE("Environment destroyed\n");
     }
 
@@ -467,6 +468,11 @@ public:
                 return true;
             }
         }
+        else if( _IsSnapshotFile(filename) ) {
+            if( RaveParseSnapshotFile(shared_from_this(), filename, atts) ) {
+                return true;
+            }
+        }
         else if( !_IsOpenRAVEFile(filename) && _IsRigidModelFile(filename) ) {
             KinBodyPtr pbody = ReadKinBodyURI(KinBodyPtr(),filename,atts);
             if( !!pbody ) {
@@ -501,8 +507,12 @@ public:
         std::list<KinBodyPtr> listbodies;
         switch(options) {
         case SO_Everything:
-            RaveWriteColladaFile(shared_from_this(),filename,atts);
-            return;
+            if( !_IsSnapshotFile(filename) ) {
+                RaveWriteColladaFile(shared_from_this(),filename,atts);
+                return;
+            }
+            listbodies.insert(listbodies.end(), _vecbodies.begin(), _vecbodies.end());
+            break;
 
         case SO_Body: {
             std::string targetname;
@@ -547,7 +557,10 @@ public:
         }
         }
 
-        if( listbodies.size() == 1 ) {
+        if( _IsSnapshotFile(filename) ) {
+            RaveWriteSnapshotFile(listbodies,filename,atts);
+        }
+        else if( listbodies.size() == 1 ) {
             RaveWriteColladaFile(listbodies.front(),filename,atts);
         }
         else {
@@ -870,6 +883,7 @@ public:
     virtual bool CheckCollision(KinBodyConstPtr pbody1, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(pbody1);
         return _pCurrentChecker->CheckCollision(pbody1,report);
     }
@@ -877,6 +891,7 @@ public:
     virtual bool CheckCollision(KinBodyConstPtr pbody1, KinBodyConstPtr pbody2, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(pbody1);
         CHECK_COLLISION_BODY(pbody2);
         return _pCurrentChecker->CheckCollision(pbody1,pbody2,report);
@@ -885,6 +900,7 @@ public:
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, CollisionReportPtr report )
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(plink->GetParent());
         return _pCurrentChecker->CheckCollision(plink,report);
     }
@@ -892,6 +908,7 @@ public:
     virtual bool CheckCollision(KinBody::LinkConstPtr plink1, KinBody::LinkConstPtr plink2, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(plink1->GetParent());
         CHECK_COLLISION_BODY(plink2->GetParent());
         return _pCurrentChecker->CheckCollision(plink1,plink2,report);
@@ -900,6 +917,7 @@ public:
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(plink->GetParent());
         CHECK_COLLISION_BODY(pbody);
         return _pCurrentChecker->CheckCollision(plink,pbody,report);
@@ -908,6 +926,7 @@ public:
     virtual bool CheckCollision(KinBody::LinkConstPtr plink, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(plink->GetParent());
         return _pCurrentChecker->CheckCollision(plink,vbodyexcluded,vlinkexcluded,report);
     }
@@ -915,6 +934,7 @@ public:
     virtual bool CheckCollision(KinBodyConstPtr pbody, const std::vector<KinBodyConstPtr>& vbodyexcluded, const std::vector<KinBody::LinkConstPtr>& vlinkexcluded, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(pbody);
         return _pCurrentChecker->CheckCollision(pbody,vbodyexcluded,vlinkexcluded,report);
     }
@@ -922,19 +942,34 @@ public:
     virtual bool CheckCollision(const RAY& ray, KinBody::LinkConstPtr plink, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(plink->GetParent());
         return _pCurrentChecker->CheckCollision(ray,plink,report);
     }
     virtual bool CheckCollision(const RAY& ray, KinBodyConstPtr pbody, CollisionReportPtr report)
     {
         EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         CHECK_COLLISION_BODY(pbody);
         return _pCurrentChecker->CheckCollision(ray,pbody,report);
     }
     virtual bool CheckCollision(const RAY& ray, CollisionReportPtr report)
     {
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollision");
         return _pCurrentChecker->CheckCollision(ray,report);
     }
+    virtual int CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly)
+    {
+        EnvironmentMutex::scoped_lock lockenv(GetMutex());
+        OPENRAVE_PROFILE_ZONE(this, "EnvironmentBase::CheckCollisionRays");
+        if( !!pbody ) {
+            CHECK_COLLISION_BODY(pbody);
+        }
+        if( !_pCurrentChecker ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("env=%d has no collision checker"), GetId(), ORE_InvalidState);
+        }
+        return _pCurrentChecker->CheckCollisionRays(prays,nrays,pbody,pcollision,phits,bFrontFacingOnly);
+    }
 
     virtual bool CheckStandaloneSelfCollision(KinBodyConstPtr pbody, CollisionReportPtr report)
     {
@@ -2497,6 +2532,17 @@ protected:
         return data.find("<COLLADA") != std::string::npos;
     }
 
+    static bool _IsSnapshotFile(const std::string& filename)
+    {
+        size_t len = filename.size();
+        if( len < 7 ) {
+            return false;
+        }
+        std::string ext = filename.substr(len-7);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        return ext == ".orsnap";
+    }
+
     static bool _IsXFile(const std::string& filename)
     {
         size_t len = filename.size();
@@ -81,6 +81,8 @@ public:
             _vddoffsets.resize(0);
             _vdddoffsets.resize(0);
             _vintegraloffsets.resize(0);
+            _insertconversions[0]._bInit = false;
+            _insertconversions[1]._bInit = false;
             _spec = spec;
             // order the groups based on computation order
             stable_sort(_spec._vgroups.begin(),_spec._vgroups.end(),boost::bind(&GenericTrajectory::SortGroups,this,_1,_2));
@@ -135,10 +137,6 @@ public:
             Insert(index,data,bOverwrite);
         }
         else {
-            std::vector< std::vector<ConfigurationSpecification::Group>::const_iterator > vconvertgroups(_spec._vgroups.size());
-            for(size_t i = 0; i < vconvertgroups.size(); ++i) {
-                vconvertgroups[i] = spec.FindCompatibleGroup(_spec._vgroups[i]);
-            }
             size_t numpoints = data.size()/spec.GetDOF();
             size_t sourceindex = 0;
             std::vector<dReal>::iterator ittargetdata;
@@ -147,7 +145,7 @@ public:
                 size_t copyelements = min(numpoints,_vtrajdata.size()/_spec.GetDOF()-index);
                 ittargetdata = _vtrajdata.begin()+index*_spec.GetDOF();
                 itsourcedata = data.begin();
-                _ConvertData(ittargetdata,itsourcedata,vconvertgroups,spec,copyelements,false);
+                _ConvertData(ittargetdata,itsourcedata,spec,copyelements,false);
                 sourceindex = copyelements*spec.GetDOF();
                 index += copyelements;
             }
@@ -156,7 +154,7 @@ public:
                 std::vector<dReal> vtemp(numelements*_spec.GetDOF());
                 ittargetdata = vtemp.begin();
                 itsourcedata = data.begin()+sourceindex;
-                _ConvertData(ittargetdata,itsourcedata,vconvertgroups,spec,numelements,true);
+                _ConvertData(ittargetdata,itsourcedata,spec,numelements,true);
                 _vtrajdata.insert(_vtrajdata.begin()+index*_spec.GetDOF(),vtemp.begin(),vtemp.end());
             }
             _bChanged = true;
@@ -177,6 +175,7 @@ public:
 
     void Sample(std::vector<dReal>& data, dReal time) const
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "TrajectoryBase::Sample");
         BOOST_ASSERT(_bInit);
         BOOST_ASSERT(_timeoffset>=0);
         BOOST_ASSERT(time >= 0);
@@ -210,6 +209,7 @@ public:
 
     void Sample(std::vector<dReal>& data, dReal time, const ConfigurationSpecification& spec) const
     {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "TrajectoryBase::Sample");
         BOOST_ASSERT(_bInit);
         OPENRAVE_ASSERT_OP(_timeoffset,>=,0);
         OPENRAVE_ASSERT_OP(time, >=, -g_fEpsilon);
@@ -220,17 +220,18 @@ public:
         }
         data.resize(0);
         data.resize(spec.GetDOF(),0);
+        // the plan and the interpolated point are local, concurrent readers of the trajectory do not share them
+        ConfigurationSpecification::ConversionPlan plan(spec,_spec,GetEnv(),true);
         if( time >= GetDuration() ) {
-            ConfigurationSpecification::ConvertData(data.begin(),spec,_vtrajdata.end()-_spec.GetDOF(),_spec,1,GetEnv());
+            plan.Apply(data.begin(),_vtrajdata.end()-_spec.GetDOF(),1);
         }
         else {
             std::vector<dReal>::iterator it = std::lower_bound(_vaccumtime.begin(),_vaccumtime.end(),time);
             if( it == _vaccumtime.begin() ) {
-                ConfigurationSpecification::ConvertData(data.begin(),spec,_vtrajdata.begin(),_spec,1,GetEnv());
+                plan.Apply(data.begin(),_vtrajdata.begin(),1);
             }
             else {
-                // could be faster
-                vector<dReal> vinternaldata(_spec.GetDOF(),0);
+                std::vector<dReal> vinternaldata(_spec.GetDOF(),0);
                 size_t index = it-_vaccumtime.begin();
                 dReal deltatime = time-_vaccumtime.at(index-1);
                 for(size_t i = 0; i < _vgroupinterpolators.size(); ++i) {
@@ -238,7 +239,7 @@ public:
                         _vgroupinterpolators[i](index-1,deltatime,vinternaldata);
                     }
                 }
-                ConfigurationSpecification::ConvertData(data.begin(),spec,vinternaldata.begin(),_spec,1,GetEnv());
+                plan.Apply(data.begin(),vinternaldata.begin(),1);
             }
         }
     }
@@ -268,7 +269,8 @@ public:
         BOOST_ASSERT(startindex<=endindex && startindex*_spec.GetDOF() <= _vtrajdata.size() && endindex*_spec.GetDOF() <= _vtrajdata.size());
         data.resize(spec.GetDOF()*(endindex-startindex),0);
         if( startindex < endindex ) {
-            ConfigurationSpecification::ConvertData(data.begin(),spec,_vtrajdata.begin()+startindex*_spec.GetDOF(),_spec,endindex-startindex,GetEnv());
+            ConfigurationSpecification::ConversionPlan plan(spec,_spec,GetEnv(),true);
+            plan.Apply(data.begin(),_vtrajdata.begin()+startindex*_spec.GetDOF(),endindex-startindex);
         }
     }
 
@@ -344,34 +346,63 @@ public:
         std::swap(_vdeltainvtime, traj->_vdeltainvtime);
         std::swap(_bChanged, traj->_bChanged);
         std::swap(_bSamplingVerified, traj->_bSamplingVerified);
+        std::swap(_insertconversions, traj->_insertconversions);
         _InitializeGroupFunctions();
     }
 
 protected:
-    void _ConvertData(std::vector<dReal>::iterator ittargetdata, std::vector<dReal>::const_iterator itsourcedata, const std::vector< std::vector<ConfigurationSpecification::Group>::const_iterator >& vconvertgroups, const ConfigurationSpecification& spec, size_t numelements, bool filluninitialized)
+    /// \brief converts data of spec into the internal specification.
+    ///
+    /// The group conversions are kept for the last source spec of each filluninitialized option, groups missing in spec are set to zero and identity transforms.
+    void _ConvertData(std::vector<dReal>::iterator ittargetdata, std::vector<dReal>::const_iterator itsourcedata, const ConfigurationSpecification& spec, size_t numelements, bool filluninitialized)
     {
-        for(size_t igroup = 0; igroup < vconvertgroups.size(); ++igroup) {
-            if( vconvertgroups[igroup] != spec._vgroups.end() ) {
-                ConfigurationSpecification::ConvertGroupData(ittargetdata+_spec._vgroups[igroup].offset, _spec.GetDOF(), _spec._vgroups[igroup], itsourcedata+vconvertgroups[igroup]->offset, spec.GetDOF(), *vconvertgroups[igroup],numelements,GetEnv(),filluninitialized);
+        InsertConversion& conversion = _insertconversions.at(filluninitialized);
+        if( conversion._bInit && conversion._sourcespec == spec ) {
+            FOREACH(itplan,conversion._vgroupplans) {
+                itplan->UpdateDefaults();
             }
-            else if( filluninitialized ) {
-                vector<dReal> vdefaultvalues(_spec._vgroups[igroup].dof,0);
-                const string& groupname = _spec._vgroups[igroup].name;
-                if( groupname.size() >= 16 && groupname.substr(0,16) == "affine_transform" ) {
-                    stringstream ss(groupname.substr(16));
-                    string robotname;
-                    int affinedofs=0;
-                    ss >> robotname >> affinedofs;
-                    if( !!ss ) {
-                        BOOST_ASSERT((int)vdefaultvalues.size()==RaveGetAffineDOF(affinedofs));
-                        RaveGetAffineDOFValuesFromTransform(vdefaultvalues.begin(),Transform(),affinedofs);
+        }
+        else {
+            conversion._bInit = false;
+            conversion._vgroupplans.resize(_spec._vgroups.size());
+            conversion._vsourceoffsets.resize(_spec._vgroups.size());
+            conversion._vdefaultvalues.resize(0);
+            conversion._vdefaultvalues.resize(_spec.GetDOF(),0);
+            for(size_t igroup = 0; igroup < _spec._vgroups.size(); ++igroup) {
+                const ConfigurationSpecification::Group& g = _spec._vgroups[igroup];
+                std::vector<ConfigurationSpecification::Group>::const_iterator itcompatgroup = spec.FindCompatibleGroup(g);
+                if( itcompatgroup != spec._vgroups.end() ) {
+                    conversion._vgroupplans[igroup].InitGroup(_spec.GetDOF(), g, spec.GetDOF(), *itcompatgroup, GetEnv(), filluninitialized);
+                    conversion._vsourceoffsets[igroup] = itcompatgroup->offset;
+                }
+                else {
+                    conversion._vgroupplans[igroup] = ConfigurationSpecification::ConversionPlan();
+                    conversion._vsourceoffsets[igroup] = -1;
+                    if( g.name.size() >= 16 && g.name.substr(0,16) == "affine_transform" ) {
+                        stringstream ss(g.name.substr(16));
+                        string robotname;
+                        int affinedofs=0;
+                        ss >> robotname >> affinedofs;
+                        if( !!ss ) {
+                            BOOST_ASSERT(g.dof==RaveGetAffineDOF(affinedofs));
+                            RaveGetAffineDOFValuesFromTransform(conversion._vdefaultvalues.begin()+g.offset,Transform(),affinedofs);
+                        }
                     }
                 }
-                int offset = _spec._vgroups[igroup].offset;
+            }
+            conversion._sourcespec = spec;
+            conversion._bInit = true;
+        }
+
+        for(size_t igroup = 0; igroup < _spec._vgroups.size(); ++igroup) {
+            const ConfigurationSpecification::Group& g = _spec._vgroups[igroup];
+            if( conversion._vsourceoffsets[igroup] >= 0 ) {
+                conversion._vgroupplans[igroup].Apply(ittargetdata+g.offset, itsourcedata+conversion._vsourceoffsets[igroup], numelements);
+            }
+            else if( filluninitialized ) {
+                int offset = g.offset;
                 for(size_t ielement = 0; ielement < numelements; ++ielement, offset += _spec.GetDOF()) {
-                    for(int j = 0; j < _spec._vgroups[igroup].dof; ++j) {
-                        *(ittargetdata+offset+j) = vdefaultvalues[j];
-                    }
+                    std::copy(conversion._vdefaultvalues.begin()+g.offset, conversion._vdefaultvalues.begin()+(g.offset+g.dof), ittargetdata+offset);
                 }
             }
         }
@@ -1018,6 +1049,19 @@ protected:
 
     std::vector<dReal> _vtrajdata;
     mutable std::vector<dReal> _vaccumtime, _vdeltainvtime;
+
+    /// \brief conversion of inserted data into the internal specification
+    struct InsertConversion
+    {
+        InsertConversion() : _bInit(false) {
+        }
+        ConfigurationSpecification _sourcespec; ///< the source specification the conversion was built for
+        std::vector<ConfigurationSpecification::ConversionPlan> _vgroupplans; ///< for every internal group, converts the compatible source group
+        std::vector<int> _vsourceoffsets; ///< for every internal group, the offset of the compatible source group or -1
+        std::vector<dReal> _vdefaultvalues; ///< one point of default values for the internal groups not present in the source
+        bool _bInit;
+    };
+    boost::array<InsertConversion,2> _insertconversions; ///< indexed by the filluninitialized option
     bool _bInit;
     mutable bool _bChanged; ///< if true, then _ComputeInternal() has to be called in order to compute _vaccumtime and _vdeltainvtime
     mutable bool _bSamplingVerified; ///< if false, then _VerifySampling() has not be called yet to verify that all points can be sampled.
@@ -89,6 +89,8 @@ class EnvironmentXMLReader;
 class Environment;
 class RaveDatabase;
 class XFileReader;
+class SnapshotReader;
+class SnapshotWriter;
 
 #include "openrave-core.h"
 #include <openrave/utils.h>
@@ -316,5 +318,10 @@ bool RaveParseXFile(EnvironmentBasePtr penv, RobotBasePtr& pprobot, const std::s
 bool RaveParseXData(EnvironmentBasePtr penv, KinBodyPtr& ppbody, const std::vector<char>& data,const AttributesList& atts);
 bool RaveParseXData(EnvironmentBasePtr penv, RobotBasePtr& pprobot, const std::vector<char>& data,const AttributesList& atts);
 
+/// \brief writes the bodies along with their cached kinematics and collision information into a binary snapshot (*.orsnap)
+void RaveWriteSnapshotFile(const std::list<KinBodyPtr>& listbodies, const std::string& filename, const AttributesList& atts);
+/// \brief adds all the bodies of a binary snapshot to the environment. Fails if the snapshot does not match the current kinematics hashes.
+bool RaveParseSnapshotFile(EnvironmentBasePtr penv, const std::string& filename, const AttributesList& atts);
+
 #define _(msgid) OpenRAVE::RaveGetLocalizedTextForDomain("openrave", msgid)
 #endif
@@ -1337,298 +1337,526 @@ static void ConvertDOFRotation_QuatFrom3D(std::vector<dReal>::iterator ittarget,
     *(ittarget+3) = quat[3];
 }
 
-void ConfigurationSpecification::ConvertGroupData(std::vector<dReal>::iterator ittargetdata, size_t targetstride, const ConfigurationSpecification::Group& gtarget, std::vector<dReal>::const_iterator itsourcedata, size_t sourcestride, const ConfigurationSpecification::Group& gsource, size_t numpoints, EnvironmentBaseConstPtr penv, bool filluninitialized)
+/// \brief how the values of a target group are computed from a compatible source group, shared by ConvertGroupData and ConversionPlan
+struct GroupConversion
+{
+    GroupConversion() : sourcerotationstart(-1), targetrotationstart(-1), targetrotationend(-1), defaulttype(-1), affinetarget(0) {
+    }
+    std::vector<int> vtransferindices; ///< for every target value the source value it is copied from, -1 if it has to be converted or filled
+    int sourcerotationstart, targetrotationstart, targetrotationend; ///< target values [targetrotationstart,targetrotationend) are computed by rotconverterfn
+    boost::function< void(std::vector<dReal>::iterator, std::vector<dReal>::const_iterator) > rotconverterfn;
+    int defaulttype; ///< the body state filling the missing values: -1 none (zeros), 0 dof values, 1 dof velocities, 2 affine transform
+    std::string targetbodyname, sourcebodyname; ///< the bodies to get the default values from, the target is tried first
+    int affinetarget; ///< affine dofs of the target when defaulttype is 2
+    std::vector<int> vtargetdofindices; ///< dof indices of the target when defaulttype is 0 or 1
+};
+
+/// \brief parses the names of two compatible groups into the transfers between them
+static void ParseGroupConversion(GroupConversion& conv, const ConfigurationSpecification::Group& gtarget, const ConfigurationSpecification::Group& gsource)
 {
-    if( numpoints > 1 ) {
-        BOOST_ASSERT(targetstride != 0 && sourcestride != 0 );
-    }
     if( gsource.name == gtarget.name ) {
         BOOST_ASSERT(gsource.dof==gtarget.dof);
-        for(size_t i = 0; i < numpoints; ++i) {
-            if( i != 0 ) {
-                itsourcedata += sourcestride;
-                ittargetdata += targetstride;
-            }
-            std::copy(itsourcedata,itsourcedata+gsource.dof,ittargetdata);
+        conv.vtransferindices.resize(gtarget.dof);
+        for(int i = 0; i < gtarget.dof; ++i) {
+            conv.vtransferindices[i] = i;
         }
+        return;
     }
-    else {
-        stringstream ss(gtarget.name);
-        std::vector<std::string> targettokens((istream_iterator<std::string>(ss)), istream_iterator<std::string>());
-        ss.clear();
-        ss.str(gsource.name);
-        std::vector<std::string> sourcetokens((istream_iterator<std::string>(ss)), istream_iterator<std::string>());
-
-        BOOST_ASSERT(targettokens.at(0) == sourcetokens.at(0));
-        vector<int> vtransferindices; vtransferindices.reserve(gtarget.dof);
-        std::vector<dReal> vdefaultvalues;
-        if( targettokens.at(0).size() >= 6 && targettokens.at(0).substr(0,6) == "joint_") {
-            std::vector<int> vsourceindices(gsource.dof), vtargetindices(gtarget.dof);
-            if( (int)sourcetokens.size() < gsource.dof+2 ) {
-                RAVELOG_DEBUG(str(boost::format("source tokens '%s' do not have %d dof indices, guessing....")%gsource.name%gsource.dof));
-                for(int i = 0; i < gsource.dof; ++i) {
-                    vsourceindices[i] = i;
-                }
+
+    stringstream ss(gtarget.name);
+    std::vector<std::string> targettokens((istream_iterator<std::string>(ss)), istream_iterator<std::string>());
+    ss.clear();
+    ss.str(gsource.name);
+    std::vector<std::string> sourcetokens((istream_iterator<std::string>(ss)), istream_iterator<std::string>());
+    BOOST_ASSERT(targettokens.at(0) == sourcetokens.at(0));
+    conv.targetbodyname = targettokens.size() > 1 ? targettokens[1] : std::string();
+    conv.sourcebodyname = sourcetokens.size() > 1 ? sourcetokens[1] : std::string();
+
+    if( targettokens.at(0).size() >= 6 && targettokens.at(0).substr(0,6) == "joint_") {
+        std::vector<int> vsourceindices(gsource.dof), vtargetindices(gtarget.dof);
+        if( (int)sourcetokens.size() < gsource.dof+2 ) {
+            RAVELOG_DEBUG(str(boost::format("source tokens '%s' do not have %d dof indices, guessing....")%gsource.name%gsource.dof));
+            for(int i = 0; i < gsource.dof; ++i) {
+                vsourceindices[i] = i;
             }
-            else {
-                for(int i = 0; i < gsource.dof; ++i) {
-                    vsourceindices[i] = boost::lexical_cast<int>(sourcetokens.at(i+2));
-                }
+        }
+        else {
+            for(int i = 0; i < gsource.dof; ++i) {
+                vsourceindices[i] = boost::lexical_cast<int>(sourcetokens.at(i+2));
             }
-            if( (int)targettokens.size() < gtarget.dof+2 ) {
-                RAVELOG_WARN(str(boost::format("target tokens '%s' do not match dof '%d', guessing....")%gtarget.name%gtarget.dof));
-                for(int i = 0; i < gtarget.dof; ++i) {
-                    vtargetindices[i] = i;
-                }
+        }
+        if( (int)targettokens.size() < gtarget.dof+2 ) {
+            RAVELOG_WARN(str(boost::format("target tokens '%s' do not match dof '%d', guessing....")%gtarget.name%gtarget.dof));
+            for(int i = 0; i < gtarget.dof; ++i) {
+                vtargetindices[i] = i;
+            }
+        }
+        else {
+            for(int i = 0; i < gtarget.dof; ++i) {
+                vtargetindices[i] = boost::lexical_cast<int>(targettokens.at(i+2));
+            }
+        }
+
+        bool bUninitializedData=false;
+        conv.vtransferindices.resize(gtarget.dof);
+        for(int i = 0; i < gtarget.dof; ++i) {
+            std::vector<int>::iterator it = find(vsourceindices.begin(),vsourceindices.end(),vtargetindices[i]);
+            if( it == vsourceindices.end() ) {
+                bUninitializedData = true;
+                conv.vtransferindices[i] = -1;
             }
             else {
+                conv.vtransferindices[i] = static_cast<int>(it-vsourceindices.begin());
+            }
+        }
+
+        if( bUninitializedData ) {
+            if( targettokens[0] == "joint_values" ) {
+                conv.defaulttype = 0;
+            }
+            else if( targettokens[0] == "joint_velocities" ) {
+                conv.defaulttype = 1;
+            }
+            conv.vtargetdofindices.swap(vtargetindices);
+        }
+    }
+    else if( targettokens.at(0).size() >= 7 && targettokens.at(0).substr(0,7) == "affine_") {
+        int affinesource = 0, affinetarget = 0;
+        Vector sourceaxis(0,0,1), targetaxis(0,0,1);
+        if( sourcetokens.size() < 3 ) {
+            if( targettokens.size() < 3 && gsource.dof == gtarget.dof ) {
+                conv.vtransferindices.resize(gtarget.dof);
                 for(int i = 0; i < gtarget.dof; ++i) {
-                    vtargetindices[i] = boost::lexical_cast<int>(targettokens.at(i+2));
+                    conv.vtransferindices[i] = i;
                 }
+                return;
             }
-
-            bool bUninitializedData=false;
-            FOREACH(ittargetindex,vtargetindices) {
-                std::vector<int>::iterator it = find(vsourceindices.begin(),vsourceindices.end(),*ittargetindex);
-                if( it == vsourceindices.end() ) {
-                    bUninitializedData = true;
-                    vtransferindices.push_back(-1);
+            throw OPENRAVE_EXCEPTION_FORMAT(_("source affine information not present '%s'\n"),gsource.name,ORE_InvalidArguments);
+        }
+        affinesource = boost::lexical_cast<int>(sourcetokens.at(2));
+        BOOST_ASSERT(RaveGetAffineDOF(affinesource) == gsource.dof);
+        if( (affinesource & DOF_RotationAxis) && sourcetokens.size() >= 6 ) {
+            sourceaxis.x = boost::lexical_cast<dReal>(sourcetokens.at(3));
+            sourceaxis.y = boost::lexical_cast<dReal>(sourcetokens.at(4));
+            sourceaxis.z = boost::lexical_cast<dReal>(sourcetokens.at(5));
+        }
+        if( targettokens.size() < 3 ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("target affine information not present '%s'\n"),gtarget.name,ORE_InvalidArguments);
+        }
+        affinetarget = boost::lexical_cast<int>(targettokens.at(2));
+        BOOST_ASSERT(RaveGetAffineDOF(affinetarget) == gtarget.dof);
+        if( (affinetarget & DOF_RotationAxis) && targettokens.size() >= 6 ) {
+            targetaxis.x = boost::lexical_cast<dReal>(targettokens.at(3));
+            targetaxis.y = boost::lexical_cast<dReal>(targettokens.at(4));
+            targetaxis.z = boost::lexical_cast<dReal>(targettokens.at(5));
+        }
+
+        int commondata = affinesource&affinetarget;
+        int uninitdata = affinetarget&(~commondata);
+        if( (uninitdata & DOF_RotationMask) && (affinetarget & DOF_RotationMask) && (affinesource & DOF_RotationMask) ) {
+            // both hold rotations, but need to convert
+            uninitdata &= ~DOF_RotationMask;
+            conv.sourcerotationstart = RaveGetIndexFromAffineDOF(affinesource,DOF_RotationMask);
+            conv.targetrotationstart = RaveGetIndexFromAffineDOF(affinetarget,DOF_RotationMask);
+            conv.targetrotationend = conv.targetrotationstart+RaveGetAffineDOF(affinetarget&DOF_RotationMask);
+            if( affinetarget & DOF_RotationAxis ) {
+                if( affinesource & DOF_Rotation3D ) {
+                    conv.rotconverterfn = boost::bind(ConvertDOFRotation_AxisFrom3D,_1,_2,targetaxis);
                 }
-                else {
-                    vtransferindices.push_back(static_cast<int>(it-vsourceindices.begin()));
+                else if( affinesource & DOF_RotationQuat ) {
+                    conv.rotconverterfn = boost::bind(ConvertDOFRotation_AxisFromQuat,_1,_2,targetaxis);
                 }
             }
-
-            if( bUninitializedData && filluninitialized ) {
-                KinBodyPtr pbody;
-                if( targettokens.size() > 1 ) {
-                    pbody = penv->GetKinBody(targettokens.at(1));
+            else if( affinetarget & DOF_Rotation3D ) {
+                if( affinesource & DOF_RotationAxis ) {
+                    conv.rotconverterfn = boost::bind(ConvertDOFRotation_3DFromAxis,_1,_2,sourceaxis);
                 }
-                if( !pbody && sourcetokens.size() > 1 ) {
-                    pbody = penv->GetKinBody(sourcetokens.at(1));
+                else if( affinesource & DOF_RotationQuat ) {
+                    conv.rotconverterfn = ConvertDOFRotation_3DFromQuat;
                 }
-                if( !pbody ) {
-                    RAVELOG_WARN(str(boost::format("could not find body '%s' or '%s'")%gtarget.name%gsource.name));
-                    vdefaultvalues.resize(vtargetindices.size(),0);
+            }
+            else if( affinetarget & DOF_RotationQuat ) {
+                if( affinesource & DOF_RotationAxis ) {
+                    conv.rotconverterfn = boost::bind(ConvertDOFRotation_QuatFromAxis,_1,_2,sourceaxis);
                 }
-                else {
-                    std::vector<dReal> vbodyvalues;
-                    vdefaultvalues.resize(vtargetindices.size(),0);
-                    if( targettokens[0] == "joint_values" ) {
-                        pbody->GetDOFValues(vbodyvalues);
-                    }
-                    else if( targettokens[0] == "joint_velocities" ) {
-                        pbody->GetDOFVelocities(vbodyvalues);
-                    }
-                    if( vbodyvalues.size() > 0 ) {
-                        for(size_t i = 0; i < vdefaultvalues.size(); ++i) {
-                            vdefaultvalues[i] = vbodyvalues.at(vtargetindices[i]);
-                        }
-                    }
+                else if( affinesource & DOF_Rotation3D ) {
+                    conv.rotconverterfn = ConvertDOFRotation_QuatFrom3D;
                 }
             }
+            BOOST_ASSERT(!!conv.rotconverterfn);
         }
-        else if( targettokens.at(0).size() >= 7 && targettokens.at(0).substr(0,7) == "affine_") {
-            int affinesource = 0, affinetarget = 0;
-            Vector sourceaxis(0,0,1), targetaxis(0,0,1);
-            if( sourcetokens.size() < 3 ) {
-                if( targettokens.size() < 3 && gsource.dof == gtarget.dof ) {
-                    for(size_t i = 0; i < targettokens.size(); ++i) {
-                        vtransferindices[i] = i;
-                    }
-                }
-                else {
-                    throw OPENRAVE_EXCEPTION_FORMAT(_("source affine information not present '%s'\n"),gsource.name,ORE_InvalidArguments);
-                }
+
+        conv.vtransferindices.resize(gtarget.dof);
+        for(int index = 0; index < gtarget.dof; ++index) {
+            DOFAffine dof = RaveGetAffineDOFFromIndex(affinetarget,index);
+            int startindex = RaveGetIndexFromAffineDOF(affinetarget,dof);
+            if( affinesource & dof ) {
+                int sourceindex = RaveGetIndexFromAffineDOF(affinesource,dof);
+                conv.vtransferindices[index] = sourceindex+(index-startindex);
             }
             else {
-                affinesource = boost::lexical_cast<int>(sourcetokens.at(2));
-                BOOST_ASSERT(RaveGetAffineDOF(affinesource) == gsource.dof);
-                if( (affinesource & DOF_RotationAxis) && sourcetokens.size() >= 6 ) {
-                    sourceaxis.x = boost::lexical_cast<dReal>(sourcetokens.at(3));
-                    sourceaxis.y = boost::lexical_cast<dReal>(sourcetokens.at(4));
-                    sourceaxis.z = boost::lexical_cast<dReal>(sourcetokens.at(5));
-                }
+                conv.vtransferindices[index] = -1;
             }
-            if( vtransferindices.size() == 0 ) {
-                if( targettokens.size() < 3 ) {
-                    throw OPENRAVE_EXCEPTION_FORMAT(_("target affine information not present '%s'\n"),gtarget.name,ORE_InvalidArguments);
-                }
-                else {
-                    affinetarget = boost::lexical_cast<int>(targettokens.at(2));
-                    BOOST_ASSERT(RaveGetAffineDOF(affinetarget) == gtarget.dof);
-                    if( (affinetarget & DOF_RotationAxis) && targettokens.size() >= 6 ) {
-                        targetaxis.x = boost::lexical_cast<dReal>(targettokens.at(3));
-                        targetaxis.y = boost::lexical_cast<dReal>(targettokens.at(4));
-                        targetaxis.z = boost::lexical_cast<dReal>(targettokens.at(5));
-                    }
-                }
-
-                int commondata = affinesource&affinetarget;
-                int uninitdata = affinetarget&(~commondata);
-                int sourcerotationstart = -1, targetrotationstart = -1, targetrotationend = -1;
-                boost::function< void(std::vector<dReal>::iterator, std::vector<dReal>::const_iterator) > rotconverterfn;
-                if( (uninitdata & DOF_RotationMask) && (affinetarget & DOF_RotationMask) && (affinesource & DOF_RotationMask) ) {
-                    // both hold rotations, but need to convert
-                    uninitdata &= ~DOF_RotationMask;
-                    sourcerotationstart = RaveGetIndexFromAffineDOF(affinesource,DOF_RotationMask);
-                    targetrotationstart = RaveGetIndexFromAffineDOF(affinetarget,DOF_RotationMask);
-                    targetrotationend = targetrotationstart+RaveGetAffineDOF(affinetarget&DOF_RotationMask);
-                    if( affinetarget & DOF_RotationAxis ) {
-                        if( affinesource & DOF_Rotation3D ) {
-                            rotconverterfn = boost::bind(ConvertDOFRotation_AxisFrom3D,_1,_2,targetaxis);
-                        }
-                        else if( affinesource & DOF_RotationQuat ) {
-                            rotconverterfn = boost::bind(ConvertDOFRotation_AxisFromQuat,_1,_2,targetaxis);
-                        }
-                    }
-                    else if( affinetarget & DOF_Rotation3D ) {
-                        if( affinesource & DOF_RotationAxis ) {
-                            rotconverterfn = boost::bind(ConvertDOFRotation_3DFromAxis,_1,_2,sourceaxis);
-                        }
-                        else if( affinesource & DOF_RotationQuat ) {
-                            rotconverterfn = ConvertDOFRotation_3DFromQuat;
-                        }
-                    }
-                    else if( affinetarget & DOF_RotationQuat ) {
-                        if( affinesource & DOF_RotationAxis ) {
-                            rotconverterfn = boost::bind(ConvertDOFRotation_QuatFromAxis,_1,_2,sourceaxis);
-                        }
-                        else if( affinesource & DOF_Rotation3D ) {
-                            rotconverterfn = ConvertDOFRotation_QuatFrom3D;
-                        }
-                    }
-                    BOOST_ASSERT(!!rotconverterfn);
-                }
-                if( uninitdata && filluninitialized ) {
-                    // initialize with the current body values
-                    KinBodyPtr pbody;
-                    if( targettokens.size() > 1 ) {
-                        pbody = penv->GetKinBody(targettokens.at(1));
-                    }
-                    if( !pbody && sourcetokens.size() > 1 ) {
-                        pbody = penv->GetKinBody(sourcetokens.at(1));
-                    }
-                    if( !pbody ) {
-                        RAVELOG_WARN(str(boost::format("could not find body '%s' or '%s'")%gtarget.name%gsource.name));
-                        vdefaultvalues.resize(gtarget.dof,0);
-                    }
-                    else {
-                        vdefaultvalues.resize(gtarget.dof);
-                        RaveGetAffineDOFValuesFromTransform(vdefaultvalues.begin(),pbody->GetTransform(),affinetarget);
-                    }
-                }
+        }
 
-                for(int index = 0; index < gtarget.dof; ++index) {
-                    DOFAffine dof = RaveGetAffineDOFFromIndex(affinetarget,index);
-                    int startindex = RaveGetIndexFromAffineDOF(affinetarget,dof);
-                    if( affinesource & dof ) {
-                        int sourceindex = RaveGetIndexFromAffineDOF(affinesource,dof);
-                        vtransferindices.push_back(sourceindex + (index-startindex));
-                    }
-                    else {
-                        vtransferindices.push_back(-1);
-                    }
-                }
+        if( uninitdata ) {
+            // initialize with the current body values
+            conv.defaulttype = 2;
+            conv.affinetarget = affinetarget;
+        }
+    }
+    else if( targettokens.at(0).size() >= 8 && targettokens.at(0).substr(0,8) == "ikparam_") {
+        IkParameterizationType iktypesource, iktypetarget;
+        if( sourcetokens.size() >= 2 ) {
+            iktypesource = static_cast<IkParameterizationType>(boost::lexical_cast<int>(sourcetokens[1]));
+        }
+        else {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("ikparam type not present '%s'\n"),gsource.name,ORE_InvalidArguments);
+        }
+        if( targettokens.size() >= 2 ) {
+            iktypetarget = static_cast<IkParameterizationType>(boost::lexical_cast<int>(targettokens[1]));
+        }
+        else {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("ikparam type not present '%s'\n"),gtarget.name,ORE_InvalidArguments);
+        }
 
-                for(size_t i = 0; i < numpoints; ++i, itsourcedata += sourcestride, ittargetdata += targetstride) {
-                    for(int j = 0; j < (int)vtransferindices.size(); ++j) {
-                        if( vtransferindices[j] >= 0 ) {
-                            *(ittargetdata+j) = *(itsourcedata+vtransferindices[j]);
-                        }
-                        else {
-                            if( j >= targetrotationstart && j < targetrotationend ) {
-                                if( j == targetrotationstart ) {
-                                    // only convert when at first index
-                                    rotconverterfn(ittargetdata+targetrotationstart,itsourcedata+sourcerotationstart);
-                                }
-                            }
-                            else if( filluninitialized ) {
-                                *(ittargetdata+j) = vdefaultvalues.at(j);
-                            }
-                        }
-                    }
-                }
-                return;
+        if( iktypetarget == iktypesource ) {
+            conv.vtransferindices.resize(IkParameterization::GetDOF(iktypetarget));
+            for(size_t i = 0; i < conv.vtransferindices.size(); ++i) {
+                conv.vtransferindices[i] = i;
             }
         }
-        else if( targettokens.at(0).size() >= 8 && targettokens.at(0).substr(0,8) == "ikparam_") {
-            IkParameterizationType iktypesource, iktypetarget;
-            if( sourcetokens.size() >= 2 ) {
-                iktypesource = static_cast<IkParameterizationType>(boost::lexical_cast<int>(sourcetokens[1]));
+        else {
+            RAVELOG_WARN("ikparam types do not match");
+        }
+    }
+    // need a space since grabbody is also a group
+    else if( targettokens.at(0) == std::string("grab") ) {
+        std::vector<int> vsourceindices(gsource.dof), vtargetindices(gtarget.dof);
+        if( (int)sourcetokens.size() < gsource.dof+2 ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("source tokens '%s' do not have %d dof indices, guessing...."), gsource.name%gsource.dof, ORE_InvalidArguments);
+        }
+        for(int i = 0; i < gsource.dof; ++i) {
+            vsourceindices[i] = boost::lexical_cast<int>(sourcetokens.at(i+2));
+        }
+        if( (int)targettokens.size() < gtarget.dof+2 ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("target tokens '%s' do not match dof '%d', guessing...."), gtarget.name%gtarget.dof, ORE_InvalidArguments);
+        }
+        for(int i = 0; i < gtarget.dof; ++i) {
+            vtargetindices[i] = boost::lexical_cast<int>(targettokens.at(i+2));
+        }
+
+        conv.vtransferindices.resize(gtarget.dof);
+        for(int i = 0; i < gtarget.dof; ++i) {
+            std::vector<int>::iterator it = find(vsourceindices.begin(),vsourceindices.end(),vtargetindices[i]);
+            conv.vtransferindices[i] = it == vsourceindices.end() ? -1 : static_cast<int>(it-vsourceindices.begin());
+        }
+    }
+    else if( targettokens.at(0) == std::string("grabbody") ) {
+        // TODO
+    }
+    else {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("unsupported token conversion: %s"),gtarget.name,ORE_InvalidArguments);
+    }
+}
+
+ConfigurationSpecification::ConversionPlan::ConversionPlan() : _targetstride(0), _sourcestride(0), _bFillUninitialized(true)
+{
+}
+
+ConfigurationSpecification::ConversionPlan::ConversionPlan(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, EnvironmentBaseConstPtr penv, bool filluninitialized) : _targetstride(0), _sourcestride(0), _bFillUninitialized(true)
+{
+    Init(targetspec, sourcespec, penv, filluninitialized);
+}
+
+void ConfigurationSpecification::ConversionPlan::Init(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, EnvironmentBaseConstPtr penv, bool filluninitialized)
+{
+    _Reset(targetspec.GetDOF(), sourcespec.GetDOF());
+    _bFillUninitialized = filluninitialized;
+    FOREACHC(itgroup, targetspec._vgroups) {
+        std::vector<ConfigurationSpecification::Group>::const_iterator itcompatgroup = sourcespec.FindCompatibleGroup(*itgroup);
+        if( itcompatgroup != sourcespec._vgroups.end() ) {
+            _AddGroupConversion(itgroup->offset, *itgroup, itcompatgroup->offset, *itcompatgroup, penv, filluninitialized);
+        }
+        else if( filluninitialized ) {
+            _AddGroupDefaults(itgroup->offset, *itgroup, penv);
+        }
+    }
+    _vtargetgroups = targetspec._vgroups;
+    _vsourcegroups = sourcespec._vgroups;
+    UpdateDefaults();
+}
+
+void ConfigurationSpecification::ConversionPlan::InitGroup(size_t targetstride, const Group& gtarget, size_t sourcestride, const Group& gsource, EnvironmentBaseConstPtr penv, bool filluninitialized)
+{
+    _Reset(targetstride, sourcestride);
+    _bFillUninitialized = filluninitialized;
+    _AddGroupConversion(0, gtarget, 0, gsource, penv, filluninitialized);
+    UpdateDefaults();
+}
+
+bool ConfigurationSpecification::ConversionPlan::IsBuiltFor(const ConfigurationSpecification& targetspec, const ConfigurationSpecification& sourcespec, bool filluninitialized) const
+{
+    return _vtargetgroups.size() > 0 && _bFillUninitialized == filluninitialized && _vtargetgroups == targetspec._vgroups && _vsourcegroups == sourcespec._vgroups;
+}
+
+void ConfigurationSpecification::ConversionPlan::UpdateDefaults()
+{
+    FOREACH(itsource, _vdefaultsources) {
+        KinBodyPtr pbody = itsource->_pbody.lock();
+        if( !pbody ) {
+            continue;
+        }
+        if( itsource->_type == 2 ) {
+            RaveGetAffineDOFValuesFromTransform(_vdefaultvalues.begin()+itsource->_targetindex, pbody->GetTransform(), itsource->_affinedofs);
+        }
+        else {
+            if( itsource->_type == 0 ) {
+                pbody->GetDOFValues(_vbodyvaluescache);
             }
             else {
-                throw OPENRAVE_EXCEPTION_FORMAT(_("ikparam type not present '%s'\n"),gsource.name,ORE_InvalidArguments);
+                pbody->GetDOFVelocities(_vbodyvaluescache);
             }
-            if( targettokens.size() >= 2 ) {
-                iktypetarget = static_cast<IkParameterizationType>(boost::lexical_cast<int>(targettokens[1]));
+            if( _vbodyvaluescache.size() > 0 ) {
+                for(size_t i = 0; i < itsource->_vdofindices.size(); ++i) {
+                    _vdefaultvalues.at(itsource->_targetindex+i) = _vbodyvaluescache.at(itsource->_vdofindices[i]);
+                }
             }
-            else {
-                throw OPENRAVE_EXCEPTION_FORMAT(_("ikparam type not present '%s'\n"),gtarget.name,ORE_InvalidArguments);
+        }
+    }
+}
+
+void ConfigurationSpecification::ConversionPlan::Apply(std::vector<dReal>::iterator ittargetdata, std::vector<dReal>::const_iterator itsourcedata, size_t numpoints) const
+{
+    if( numpoints > 1 ) {
+        BOOST_ASSERT(_targetstride != 0 && _sourcestride != 0 );
+    }
+    for(size_t ipoint = 0; ipoint < numpoints; ++ipoint) {
+        if( ipoint != 0 ) {
+            ittargetdata += _targetstride;
+            itsourcedata += _sourcestride;
+        }
+        FOREACHC(itop, _voperations) {
+            switch(itop->type) {
+            case OT_Copy:
+                std::copy(itsourcedata+itop->sourceindex, itsourcedata+(itop->sourceindex+itop->count), ittargetdata+itop->targetindex);
+                break;
+            case OT_Fill:
+                std::copy(_vdefaultvalues.begin()+itop->targetindex, _vdefaultvalues.begin()+(itop->targetindex+itop->count), ittargetdata+itop->targetindex);
+                break;
+            case OT_Rotation:
+                _vrotationconverters[itop->count](ittargetdata+itop->targetindex, itsourcedata+itop->sourceindex);
+                break;
             }
+        }
+    }
+}
 
-            if( iktypetarget == iktypesource ) {
-                vtransferindices.resize(IkParameterization::GetDOF(iktypetarget));
-                for(size_t i = 0; i < vtransferindices.size(); ++i) {
-                    vtransferindices[i] = i;
-                }
+void ConfigurationSpecification::ConversionPlan::_Reset(size_t targetstride, size_t sourcestride)
+{
+    _voperations.resize(0);
+    _vrotationconverters.resize(0);
+    _vdefaultsources.resize(0);
+    _vdefaultvalues.resize(0);
+    _vtargetgroups.resize(0);
+    _vsourcegroups.resize(0);
+    _targetstride = targetstride;
+    _sourcestride = sourcestride;
+}
+
+void ConfigurationSpecification::ConversionPlan::_AddTransfer(int targetindex, int sourceindex)
+{
+    if( _voperations.size() > 0 ) {
+        Operation& op = _voperations.back();
+        if( op.type == OT_Copy && op.targetindex+op.count == targetindex && op.sourceindex+op.count == sourceindex ) {
+            op.count += 1;
+            return;
+        }
+    }
+    Operation op;
+    op.type = OT_Copy;
+    op.targetindex = targetindex;
+    op.sourceindex = sourceindex;
+    op.count = 1;
+    _voperations.push_back(op);
+}
+
+void ConfigurationSpecification::ConversionPlan::_AddFill(int targetindex)
+{
+    if( (int)_vdefaultvalues.size() <= targetindex ) {
+        _vdefaultvalues.resize(targetindex+1,0);
+    }
+    if( _voperations.size() > 0 ) {
+        Operation& op = _voperations.back();
+        if( op.type == OT_Fill && op.targetindex+op.count == targetindex ) {
+            op.count += 1;
+            return;
+        }
+    }
+    Operation op;
+    op.type = OT_Fill;
+    op.targetindex = targetindex;
+    op.sourceindex = -1;
+    op.count = 1;
+    _voperations.push_back(op);
+}
+
+void ConfigurationSpecification::ConversionPlan::_AddDefaultSource(EnvironmentBaseConstPtr penv, const std::string& targetbodyname, const std::string& sourcebodyname, int type, int targetindex, int affinedofs, const std::vector<int>& vdofindices)
+{
+    KinBodyPtr pbody;
+    if( !!penv ) {
+        if( targetbodyname.size() > 0 ) {
+            pbody = penv->GetKinBody(targetbodyname);
+        }
+        if( !pbody && sourcebodyname.size() > 0 ) {
+            pbody = penv->GetKinBody(sourcebodyname);
+        }
+    }
+    if( !pbody ) {
+        RAVELOG_WARN(str(boost::format("could not find body '%s' or '%s'")%targetbodyname%sourcebodyname));
+        return;
+    }
+    int numvalues = type == 2 ? RaveGetAffineDOF(affinedofs) : (int)vdofindices.size();
+    if( (int)_vdefaultvalues.size() < targetindex+numvalues ) {
+        _vdefaultvalues.resize(targetindex+numvalues,0);
+    }
+    _vdefaultsources.push_back(DefaultSource());
+    DefaultSource& source = _vdefaultsources.back();
+    source._pbody = pbody;
+    source._type = type;
+    source._targetindex = targetindex;
+    source._affinedofs = affinedofs;
+    source._vdofindices = vdofindices;
+}
+
+void ConfigurationSpecification::ConversionPlan::_AddGroupConversion(int targetoffset, const ConfigurationSpecification::Group& gtarget, int sourceoffset, const ConfigurationSpecification::Group& gsource, EnvironmentBaseConstPtr penv, bool filluninitialized)
+{
+    GroupConversion conv;
+    ParseGroupConversion(conv, gtarget, gsource);
+    for(int index = 0; index < (int)conv.vtransferindices.size(); ++index) {
+        if( conv.vtransferindices[index] >= 0 ) {
+            _AddTransfer(targetoffset+index, sourceoffset+conv.vtransferindices[index]);
+        }
+        else if( index >= conv.targetrotationstart && index < conv.targetrotationend ) {
+            if( index == conv.targetrotationstart ) {
+                // only convert when at first index
+                Operation op;
+                op.type = OT_Rotation;
+                op.targetindex = targetoffset+conv.targetrotationstart;
+                op.sourceindex = sourceoffset+conv.sourcerotationstart;
+                op.count = (int)_vrotationconverters.size();
+                _vrotationconverters.push_back(conv.rotconverterfn);
+                _voperations.push_back(op);
             }
-            else {
-                RAVELOG_WARN("ikparam types do not match");
+        }
+        else if( filluninitialized ) {
+            _AddFill(targetoffset+index);
+        }
+    }
+    if( conv.defaulttype >= 0 && filluninitialized ) {
+        _AddDefaultSource(penv, conv.targetbodyname, conv.sourcebodyname, conv.defaulttype, targetoffset, conv.affinetarget, conv.vtargetdofindices);
+    }
+}
+
+void ConfigurationSpecification::ConversionPlan::_AddGroupDefaults(int targetoffset, const ConfigurationSpecification::Group& gtarget, EnvironmentBaseConstPtr penv)
+{
+    for(int i = 0; i < gtarget.dof; ++i) {
+        _AddFill(targetoffset+i);
+    }
+    const string& name = gtarget.name;
+    if( name.size() >= 12 && name.substr(0,12) == "joint_values" ) {
+        string bodyname;
+        stringstream ss(name.substr(12));
+        ss >> bodyname;
+        if( !!ss && !!penv && !!penv->GetKinBody(bodyname) ) {
+            std::vector<int> indices((istream_iterator<int>(ss)), istream_iterator<int>());
+            if( (int)indices.size() > gtarget.dof ) {
+                indices.resize(gtarget.dof);
             }
+            _AddDefaultSource(penv, bodyname, std::string(), 0, targetoffset, 0, indices);
         }
-        // need a space since grabbody is also a group
-        else if( targettokens.at(0) == std::string("grab") ) {
-            std::vector<int> vsourceindices(gsource.dof), vtargetindices(gtarget.dof);
-            if( (int)sourcetokens.size() < gsource.dof+2 ) {
-                throw OPENRAVE_EXCEPTION_FORMAT(_("source tokens '%s' do not have %d dof indices, guessing...."), gsource.name%gsource.dof, ORE_InvalidArguments);
+    }
+    else if( name.size() >= 16 && name.substr(0,16) == "affine_transform" ) {
+        string bodyname;
+        int affinedofs;
+        stringstream ss(name.substr(16));
+        ss >> bodyname >> affinedofs;
+        if( !!ss ) {
+            BOOST_ASSERT(gtarget.dof == RaveGetAffineDOF(affinedofs));
+            // identity unless the body exists
+            RaveGetAffineDOFValuesFromTransform(_vdefaultvalues.begin()+targetoffset,Transform(),affinedofs);
+            if( !!penv && !!penv->GetKinBody(bodyname) ) {
+                _AddDefaultSource(penv, bodyname, std::string(), 2, targetoffset, affinedofs, std::vector<int>());
             }
-            else {
-                for(int i = 0; i < gsource.dof; ++i) {
-                    vsourceindices[i] = boost::lexical_cast<int>(sourcetokens.at(i+2));
+        }
+    }
+    else if( name != "deltatime" ) {
+        // messages are too frequent
+        //RAVELOG_VERBOSE(str(boost::format("cannot initialize unknown group '%s'")%name));
+    }
+}
+
+void ConfigurationSpecification::ConvertGroupData(std::vector<dReal>::iterator ittargetdata, size_t targetstride, const ConfigurationSpecification::Group& gtarget, std::vector<dReal>::const_iterator itsourcedata, size_t sourcestride, const ConfigurationSpecification::Group& gsource, size_t numpoints, EnvironmentBaseConstPtr penv, bool filluninitialized)
+{
+    if( numpoints > 1 ) {
+        BOOST_ASSERT(targetstride != 0 && sourcestride != 0 );
+    }
+    GroupConversion conv;
+    ParseGroupConversion(conv, gtarget, gsource);
+    std::vector<dReal> vdefaultvalues;
+    if( filluninitialized ) {
+        vdefaultvalues.resize(conv.vtransferindices.size(),0);
+        if( conv.defaulttype >= 0 ) {
+            KinBodyPtr pbody;
+            if( !!penv ) {
+                if( conv.targetbodyname.size() > 0 ) {
+                    pbody = penv->GetKinBody(conv.targetbodyname);
+                }
+                if( !pbody && conv.sourcebodyname.size() > 0 ) {
+                    pbody = penv->GetKinBody(conv.sourcebodyname);
                 }
             }
-            if( (int)targettokens.size() < gtarget.dof+2 ) {
-                throw OPENRAVE_EXCEPTION_FORMAT(_("target tokens '%s' do not match dof '%d', guessing...."), gtarget.name%gtarget.dof, ORE_InvalidArguments);
+            if( !pbody ) {
+                RAVELOG_WARN(str(boost::format("could not find body '%s' or '%s'")%gtarget.name%gsource.name));
             }
-            else {
-                for(int i = 0; i < gtarget.dof; ++i) {
-                    vtargetindices[i] = boost::lexical_cast<int>(targettokens.at(i+2));
-                }
+            else if( conv.defaulttype == 2 ) {
+                RaveGetAffineDOFValuesFromTransform(vdefaultvalues.begin(),pbody->GetTransform(),conv.affinetarget);
             }
-
-            bool bUninitializedData=false;
-            FOREACH(ittargetindex,vtargetindices) {
-                std::vector<int>::iterator it = find(vsourceindices.begin(),vsourceindices.end(),*ittargetindex);
-                if( it == vsourceindices.end() ) {
-                    bUninitializedData = true;
-                    vtransferindices.push_back(-1);
+            else {
+                std::vector<dReal> vbodyvalues;
+                if( conv.defaulttype == 0 ) {
+                    pbody->GetDOFValues(vbodyvalues);
                 }
                 else {
-                    vtransferindices.push_back(static_cast<int>(it-vsourceindices.begin()));
+                    pbody->GetDOFVelocities(vbodyvalues);
+                }
+                if( vbodyvalues.size() > 0 ) {
+                    for(size_t i = 0; i < vdefaultvalues.size(); ++i) {
+                        vdefaultvalues[i] = vbodyvalues.at(conv.vtargetdofindices.at(i));
+                    }
                 }
             }
-
-            if( bUninitializedData && filluninitialized ) {
-                vdefaultvalues.resize(vtargetindices.size(),0);
-            }
-        }
-        else if( targettokens.at(0) == std::string("grabbody") ) {
-            // TODO
-        }
-        else {
-            throw OPENRAVE_EXCEPTION_FORMAT(_("unsupported token conversion: %s"),gtarget.name,ORE_InvalidArguments);
         }
+    }
 
-        for(size_t i = 0; i < numpoints; ++i, itsourcedata += sourcestride, ittargetdata += targetstride) {
-            for(size_t j = 0; j < vtransferindices.size(); ++j) {
-                if( vtransferindices[j] >= 0 ) {
-                    *(ittargetdata+j) = *(itsourcedata+vtransferindices[j]);
-                }
-                else if( filluninitialized ) {
-                    *(ittargetdata+j) = vdefaultvalues.at(j);
+    for(size_t ipoint = 0; ipoint < numpoints; ++ipoint) {
+        if( ipoint != 0 ) {
+            ittargetdata += targetstride;
+            itsourcedata += sourcestride;
+        }
+        for(int j = 0; j < (int)conv.vtransferindices.size(); ++j) {
+            if( conv.vtransferindices[j] >= 0 ) {
+                *(ittargetdata+j) = *(itsourcedata+conv.vtransferindices[j]);
+            }
+            else if( j >= conv.targetrotationstart && j < conv.targetrotationend ) {
+                if( j == conv.targetrotationstart ) {
+                    // only convert when at first index
+                    conv.rotconverterfn(ittargetdata+conv.targetrotationstart,itsourcedata+conv.sourcerotationstart);
                 }
             }
+            else if( filluninitialized ) {
+                *(ittargetdata+j) = vdefaultvalues[j];
+            }
         }
     }
 }
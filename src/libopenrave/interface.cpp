@@ -17,6 +17,133 @@
 #include "libopenrave.h"
 
 namespace OpenRAVE {
+
+void CommandValue::Write(std::ostream& O) const
+{
+    // write the reals with full precision so the text commands get the same values as the structured ones
+    std::streamsize oldprecision = O.precision(std::numeric_limits<dReal>::digits10+1);
+    switch(type) {
+    case CVT_None:
+        break;
+    case CVT_Bool:
+    case CVT_Int:
+        O << intvalue;
+        break;
+    case CVT_Real:
+        O << realvalue;
+        break;
+    case CVT_String: {
+        bool bQuote = stringvalue.size() == 0;
+        for(size_t i = 0; i < stringvalue.size() && !bQuote; ++i) {
+            bQuote = isspace(static_cast<unsigned char>(stringvalue[i])) || stringvalue[i] == '"' || stringvalue[i] == '\\';
+        }
+        if( bQuote ) {
+            O << '"';
+            FOREACHC(itc, stringvalue) {
+                if( *itc == '"' || *itc == '\\' ) {
+                    O << '\\';
+                }
+                O << *itc;
+            }
+            O << '"';
+        }
+        else {
+            O << stringvalue;
+        }
+        break;
+    }
+    case CVT_Ints:
+        O << intvalues.size();
+        FOREACHC(it, intvalues) {
+            O << " " << *it;
+        }
+        break;
+    case CVT_Reals:
+        O << realvalues.size();
+        FOREACHC(it, realvalues) {
+            O << " " << *it;
+        }
+        break;
+    case CVT_Transform:
+        O << transform.rot.x << " " << transform.rot.y << " " << transform.rot.z << " " << transform.rot.w << " " << transform.trans.x << " " << transform.trans.y << " " << transform.trans.z;
+        break;
+    }
+    O.precision(oldprecision);
+}
+
+bool CommandValue::Read(std::istream& I, CommandValueType newtype)
+{
+    type = newtype;
+    switch(type) {
+    case CVT_None:
+        break;
+    case CVT_Bool: {
+        std::string value;
+        I >> value;
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        if( value == "1" || value == "true" ) {
+            intvalue = 1;
+        }
+        else if( value == "0" || value == "false" ) {
+            intvalue = 0;
+        }
+        else {
+            I.setstate(std::ios::failbit);
+        }
+        break;
+    }
+    case CVT_Int:
+        I >> intvalue;
+        break;
+    case CVT_Real:
+        I >> realvalue;
+        break;
+    case CVT_String:
+        I >> std::ws;
+        if( I.peek() == '"' ) {
+            I.get();
+            stringvalue.resize(0);
+            char c;
+            while(I.get(c) && c != '"') {
+                if( c == '\\' && !I.get(c) ) {
+                    break;
+                }
+                stringvalue.push_back(c);
+            }
+            if( !I ) {
+                // missing closing quote
+                I.setstate(std::ios::failbit);
+            }
+        }
+        else {
+            I >> stringvalue;
+        }
+        break;
+    case CVT_Ints: {
+        size_t num = 0;
+        I >> num;
+        intvalues.resize(I ? num : 0);
+        FOREACH(it, intvalues) {
+            I >> *it;
+        }
+        break;
+    }
+    case CVT_Reals: {
+        size_t num = 0;
+        I >> num;
+        realvalues.resize(I ? num : 0);
+        FOREACH(it, realvalues) {
+            I >> *it;
+        }
+        break;
+    }
+    case CVT_Transform:
+        I >> transform;
+        break;
+    }
+    return !!I;
+}
+
 InterfaceBase::InterfaceBase(InterfaceType type, EnvironmentBasePtr penv) : __type(type), __penv(penv)
 {
     RaveInitializeFromState(penv->GlobalState()); // make sure global state is set
@@ -27,7 +154,8 @@ InterfaceBase::InterfaceBase(InterfaceType type, EnvironmentBasePtr penv) : __ty
 InterfaceBase::~InterfaceBase()
 {
     boost::unique_lock< boost::shared_mutex > lock(_mutexInterface);
-    __mapCommands.clear();
+    boost::atomic_store(&__mapCommands, boost::shared_ptr<CMDMAP const>());
+    boost::atomic_store(&__mapCommandsPending, boost::shared_ptr<CMDMAP>());
     __mapUserData.clear();
     __mapReadableInterfaces.clear();
     __penv.reset();
@@ -91,8 +219,8 @@ void InterfaceBase::Clone(InterfaceBaseConstPtr preference, int cloningoptions)
 
 bool InterfaceBase::SupportsCommand(const std::string& cmd)
 {
-    boost::shared_lock< boost::shared_mutex > lock(_mutexInterface);
-    return __mapCommands.find(cmd) != __mapCommands.end();
+    boost::shared_ptr<CMDMAP const> mapcommands = _GetCommands();
+    return !!mapcommands && mapcommands->find(cmd) != mapcommands->end();
 }
 
 bool InterfaceBase::SendCommand(ostream& sout, istream& sinput)
@@ -104,13 +232,44 @@ bool InterfaceBase::SendCommand(ostream& sout, istream& sinput)
     }
     boost::shared_ptr<InterfaceCommand> interfacecmd;
     {
-        boost::shared_lock< boost::shared_mutex > lock(_mutexInterface);
-        CMDMAP::iterator it = __mapCommands.find(cmd);
-        if( it == __mapCommands.end() ) {
+        boost::shared_ptr<CMDMAP const> mapcommands = _GetCommands();
+        CMDMAP::const_iterator it;
+        if( !mapcommands || (it = mapcommands->find(cmd)) == mapcommands->end() ) {
             throw openrave_exception(str(boost::format(_("failed to find command '%s' in interface %s\n"))%cmd.c_str()%GetXMLId()),ORE_CommandNotSupported);
         }
         interfacecmd = it->second;
     }
+    if( !!interfacecmd->structuredfn ) {
+        // compatibility layer, read the arguments in the order of the schema and write the results separated by spaces
+        std::vector<CommandValue> vargs(interfacecmd->vargs.size()), vresults;
+        for(size_t i = 0; i < vargs.size(); ++i) {
+            const CommandArgument& arg = interfacecmd->vargs[i];
+            if( !vargs[i].Read(sinput, arg.type) ) {
+                if( arg.bOptional && sinput.eof() ) {
+                    vargs[i] = CommandValue();
+                    continue;
+                }
+                throw openrave_exception(str(boost::format(_("command '%s' in interface %s failed to read argument %s"))%cmd%GetXMLId()%arg.name),ORE_InvalidArguments);
+            }
+        }
+        if( !!sinput ) {
+            sinput >> std::ws;
+            if( !sinput.eof() ) {
+                throw openrave_exception(str(boost::format(_("command '%s' in interface %s has unexpected input after the arguments"))%cmd%GetXMLId()),ORE_InvalidArguments);
+            }
+        }
+        if( !interfacecmd->structuredfn(vargs, vresults) ) {
+            RAVELOG_VERBOSE(str(boost::format("command failed in interface %s: %s\n")%GetXMLId()%cmd));
+            return false;
+        }
+        for(size_t i = 0; i < vresults.size(); ++i) {
+            if( i > 0 ) {
+                sout << " ";
+            }
+            vresults[i].Write(sout);
+        }
+        return true;
+    }
     if( !interfacecmd->fn(sout,sinput) ) {
         RAVELOG_VERBOSE(str(boost::format("command failed in interface %s: %s\n")%GetXMLId()%cmd));
         return false;
@@ -118,6 +277,63 @@ bool InterfaceBase::SendCommand(ostream& sout, istream& sinput)
     return true;
 }
 
+bool InterfaceBase::SendStructuredCommand(const std::string& cmd, const std::vector<CommandValue>& vargs, std::vector<CommandValue>& vresults)
+{
+    vresults.resize(0);
+    boost::shared_ptr<InterfaceCommand> interfacecmd;
+    {
+        boost::shared_ptr<CMDMAP const> mapcommands = _GetCommands();
+        CMDMAP::const_iterator it;
+        if( !mapcommands || (it = mapcommands->find(cmd)) == mapcommands->end() ) {
+            throw openrave_exception(str(boost::format(_("failed to find command '%s' in interface %s\n"))%cmd%GetXMLId()),ORE_CommandNotSupported);
+        }
+        interfacecmd = it->second;
+    }
+    if( !interfacecmd->structuredfn ) {
+        // compatibility layer, the text command gets the arguments in their text format
+        std::stringstream sinput, sout;
+        sinput << std::setprecision(std::numeric_limits<dReal>::digits10+1);
+        for(size_t i = 0; i < vargs.size(); ++i) {
+            if( i > 0 ) {
+                sinput << " ";
+            }
+            vargs[i].Write(sinput);
+        }
+        if( !interfacecmd->fn(sout,sinput) ) {
+            RAVELOG_VERBOSE(str(boost::format("command failed in interface %s: %s\n")%GetXMLId()%cmd));
+            return false;
+        }
+        vresults.push_back(CommandValue(sout.str()));
+        return true;
+    }
+
+    const std::vector<CommandArgument>& vschema = interfacecmd->vargs;
+    if( vargs.size() > vschema.size() ) {
+        throw openrave_exception(str(boost::format(_("command '%s' in interface %s takes at most %d arguments, %d given"))%cmd%GetXMLId()%vschema.size()%vargs.size()),ORE_InvalidArguments);
+    }
+    for(size_t i = 0; i < vschema.size(); ++i) {
+        CommandValueType type = i < vargs.size() ? vargs[i].type : CVT_None;
+        if( type != vschema[i].type && !(type == CVT_None && vschema[i].bOptional) ) {
+            throw openrave_exception(str(boost::format(_("command '%s' in interface %s has invalid argument %s, type %d != %d"))%cmd%GetXMLId()%vschema[i].name%type%vschema[i].type),ORE_InvalidArguments);
+        }
+    }
+    bool bSuccess;
+    if( vargs.size() == vschema.size() ) {
+        bSuccess = interfacecmd->structuredfn(vargs, vresults);
+    }
+    else {
+        // the optional arguments that are left out are passed as CVT_None
+        std::vector<CommandValue> vallargs(vargs.begin(), vargs.end());
+        vallargs.resize(vschema.size());
+        bSuccess = interfacecmd->structuredfn(vallargs, vresults);
+    }
+    if( !bSuccess ) {
+        RAVELOG_VERBOSE(str(boost::format("command failed in interface %s: %s\n")%GetXMLId()%cmd));
+        return false;
+    }
+    return true;
+}
+
 void InterfaceBase::Serialize(BaseXMLWriterPtr writer, int options) const
 {
     FOREACHC(it, __mapReadableInterfaces) {
@@ -128,27 +344,81 @@ void InterfaceBase::Serialize(BaseXMLWriterPtr writer, int options) const
 void InterfaceBase::RegisterCommand(const std::string& cmdname, InterfaceBase::InterfaceCommandFn fncmd, const std::string& strhelp)
 {
     boost::unique_lock< boost::shared_mutex > lock(_mutexInterface);
+    _AddCommand(cmdname, boost::shared_ptr<InterfaceCommand>(new InterfaceCommand(fncmd, strhelp)));
+}
+
+void InterfaceBase::RegisterStructuredCommand(const std::string& cmdname, InterfaceBase::StructuredCommandFn fncmd, const std::vector<CommandArgument>& vargs, const std::string& strhelp)
+{
+    static const char* s_typenames[] = { "none", "bool", "int", "real", "string", "ints", "reals", "transform" };
+    std::stringstream shelp;
+    shelp << strhelp;
+    if( vargs.size() > 0 ) {
+        shelp << "\n\nArguments::\n\n";
+    }
+    bool bOptional = false;
+    FOREACHC(itarg, vargs) {
+        if( itarg->type <= CVT_None || itarg->type > CVT_Transform ) {
+            throw openrave_exception(str(boost::format(_("command '%s' argument %s has invalid type %d"))%cmdname%itarg->name%itarg->type),ORE_InvalidArguments);
+        }
+        if( bOptional && !itarg->bOptional ) {
+            throw openrave_exception(str(boost::format(_("command '%s' argument %s is required but comes after an optional argument"))%cmdname%itarg->name),ORE_InvalidArguments);
+        }
+        bOptional = itarg->bOptional;
+        shelp << "  " << itarg->name << " " << s_typenames[itarg->type] << (itarg->bOptional ? " (optional)" : "") << "\n";
+    }
+    boost::unique_lock< boost::shared_mutex > lock(_mutexInterface);
+    _AddCommand(cmdname, boost::shared_ptr<InterfaceCommand>(new InterfaceCommand(fncmd, vargs, shelp.str())));
+}
+
+void InterfaceBase::UnregisterCommand(const std::string& cmdname)
+{
+    boost::unique_lock< boost::shared_mutex > lock(_mutexInterface);
+    boost::shared_ptr<CMDMAP const> mapcommands = boost::atomic_load(&__mapCommands);
+    if( !!__mapCommandsPending || (!!mapcommands && mapcommands->find(cmdname) != mapcommands->end()) ) {
+        _GetPendingCommands().erase(cmdname);
+    }
+}
+
+void InterfaceBase::_AddCommand(const std::string& cmdname, boost::shared_ptr<InterfaceCommand> cmd)
+{
     if((cmdname.size() == 0)|| !utils::IsValidName(cmdname) ||(_stricmp(cmdname.c_str(),"commands") == 0)) {
         throw openrave_exception(str(boost::format(_("command '%s' invalid"))%cmdname),ORE_InvalidArguments);
     }
-    if( __mapCommands.find(cmdname) != __mapCommands.end() ) {
+    CMDMAP& mapcommands = _GetPendingCommands();
+    if( mapcommands.find(cmdname) != mapcommands.end() ) {
         throw openrave_exception(str(boost::format(_("command '%s' already registered"))%cmdname),ORE_InvalidArguments);
     }
-    __mapCommands[cmdname] = boost::shared_ptr<InterfaceCommand>(new InterfaceCommand(fncmd, strhelp));
+    mapcommands[cmdname] = cmd;
 }
 
-void InterfaceBase::UnregisterCommand(const std::string& cmdname)
+InterfaceBase::CMDMAP& InterfaceBase::_GetPendingCommands()
 {
-    boost::unique_lock< boost::shared_mutex > lock(_mutexInterface);
-    CMDMAP::iterator it = __mapCommands.find(cmdname);
-    if( it != __mapCommands.end() ) {
-        __mapCommands.erase(it);
+    if( !__mapCommandsPending ) {
+        // only the threads holding _mutexInterface publish, so the published map cannot change here
+        boost::shared_ptr<CMDMAP const> mapcommands = boost::atomic_load(&__mapCommands);
+        boost::atomic_store(&__mapCommandsPending, boost::shared_ptr<CMDMAP>(!!mapcommands ? new CMDMAP(*mapcommands) : new CMDMAP()));
     }
+    return *__mapCommandsPending;
+}
+
+boost::shared_ptr<InterfaceBase::CMDMAP const> InterfaceBase::_GetCommands() const
+{
+    if( !!boost::atomic_load(&__mapCommandsPending) ) {
+        boost::unique_lock< boost::shared_mutex > lock(_mutexInterface);
+        if( !!__mapCommandsPending ) {
+            boost::atomic_store(&__mapCommands, boost::shared_ptr<CMDMAP const>(__mapCommandsPending));
+            boost::atomic_store(&__mapCommandsPending, boost::shared_ptr<CMDMAP>());
+        }
+    }
+    return boost::atomic_load(&__mapCommands);
 }
 
 bool InterfaceBase::_GetCommandHelp(std::ostream& o, std::istream& sinput) const
 {
-    boost::shared_lock< boost::shared_mutex > lock(_mutexInterface);
+    boost::shared_ptr<CMDMAP const> mapcommands = _GetCommands();
+    if( !mapcommands ) {
+        return false;
+    }
     string cmd, label;
     CMDMAP::const_iterator it;
     while(!sinput.eof()) {
@@ -159,7 +429,7 @@ bool InterfaceBase::_GetCommandHelp(std::ostream& o, std::istream& sinput) const
         std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
 
         if( cmd == "commands" ) {
-            for(it = __mapCommands.begin(); it != __mapCommands.end(); ++it) {
+            for(it = mapcommands->begin(); it != mapcommands->end(); ++it) {
                 o << it->first << " ";
             }
             return true;
@@ -168,8 +438,8 @@ bool InterfaceBase::_GetCommandHelp(std::ostream& o, std::istream& sinput) const
             sinput >> label;
         }
         else {
-            it = __mapCommands.find(cmd);
-            if( it != __mapCommands.end() ) {
+            it = mapcommands->find(cmd);
+            if( it != mapcommands->end() ) {
                 o << it->second->help;
                 return true;
             }
@@ -187,7 +457,7 @@ bool InterfaceBase::_GetCommandHelp(std::ostream& o, std::istream& sinput) const
         o << "=";
     }
     o << "=========" << endl << endl;
-    for(it = __mapCommands.begin(); it != __mapCommands.end(); ++it) {
+    for(it = mapcommands->begin(); it != mapcommands->end(); ++it) {
         if( label.size() > 0 ) {
             string strlower = it->first;
             std::transform(strlower.begin(), strlower.end(), strlower.begin(), ::tolower);
@@ -58,6 +58,12 @@ protected:
     boost::function<void()> _fn;
 };
 
+/// \brief true if the two transforms are exactly equal. A link whose recomputed transform is equal did not move.
+static inline bool IsSameTransform(const Transform& t0, const Transform& t1)
+{
+    return t0.trans.x == t1.trans.x && t0.trans.y == t1.trans.y && t0.trans.z == t1.trans.z && t0.rot.x == t1.rot.x && t0.rot.y == t1.rot.y && t0.rot.z == t1.rot.z && t0.rot.w == t1.rot.w;
+}
+
 typedef boost::shared_ptr<ChangeCallbackData> ChangeCallbackDataPtr;
 
 ElectricMotorActuatorInfo::ElectricMotorActuatorInfo()
@@ -187,6 +193,7 @@ KinBody::KinBody(InterfaceType type, EnvironmentBasePtr penv) : InterfaceBase(ty
     _environmentid = 0;
     _nNonAdjacentLinkCache = 0x80000000;
     _nUpdateStampId = 0;
+    _nJacobianChainStamp = 0;
 }
 
 KinBody::~KinBody()
@@ -230,6 +237,7 @@ void KinBody::Destroy()
     _pManageData.reset();
 
     _ResetInternalCollisionCache();
+    _ResetJacobianChains();
 }
 
 bool KinBody::InitFromBoxes(const std::vector<AABB>& vaabbs, bool visible, const std::string& uri)
@@ -910,9 +918,12 @@ void KinBody::SetTransform(const Transform& trans)
     }
     Transform tbaseinv = _veclinks.front()->GetTransform().inverse();
     Transform tapply = trans * tbaseinv;
+    // the links keep their relative transforms, so do not go through Link::SetTransform and keep the self-collision plan valid
     FOREACH(itlink, _veclinks) {
-        (*itlink)->SetTransform(tapply * (*itlink)->GetTransform());
+        (*itlink)->_info._t = tapply * (*itlink)->_info._t;
     }
+    _nUpdateStampId++;
+    _SetLinkTransformStamps(_nUpdateStampId);
 }
 
 Transform KinBody::GetTransform() const
@@ -1391,18 +1402,21 @@ void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, const Transfo
         return;
     }
     Transform tbase = transBase*_veclinks.at(0)->GetTransform().inverse();
-    _veclinks.at(0)->SetTransform(transBase);
+    _veclinks.at(0)->_info._t = transBase;
 
     // apply the relative transformation to all links!! (needed for passive joints)
     for(size_t i = 1; i < _veclinks.size(); ++i) {
-        _veclinks[i]->SetTransform(tbase*_veclinks[i]->GetTransform());
+        _veclinks[i]->_info._t = tbase*_veclinks[i]->_info._t;
     }
+    // every link moved with the base, SetDOFValues ends by incrementing the update stamp once
+    _SetLinkTransformStamps(_nUpdateStampId+1);
     SetDOFValues(vJointValues,checklimits);
 }
 
 void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, uint32_t checklimits, const std::vector<int>& dofindices)
 {
     CHECK_INTERNAL_COMPUTATION;
+    OPENRAVE_PROFILE_ZONE(GetEnv().get(), "KinBody::SetDOFValues");
     if( vJointValues.size() == 0 || _veclinks.size() == 0) {
         return;
     }
@@ -1532,6 +1546,8 @@ void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, uint32_t chec
 
     std::vector<uint8_t> vlinkscomputed(_veclinks.size(),0);
     vlinkscomputed[0] = 1;
+    // the stamp that _PostprocessChangedParameters sets below, only the links whose transform changes get it
+    int nTransformStamp = _nUpdateStampId+1;
 
     for(size_t ijoint = 0; ijoint < _vTopologicallySortedJointsAll.size(); ++ijoint) {
         JointPtr pjoint = _vTopologicallySortedJointsAll[ijoint];
@@ -1724,7 +1740,12 @@ void KinBody::SetDOFValues(const std::vector<dReal>& vJointValues, uint32_t chec
         else {
             t = pjoint->GetHierarchyParentLink()->GetTransform() * t;
         }
-        pjoint->GetHierarchyChildLink()->SetTransform(t);
+        // computed from the DOF values, so the self-collision plan stays valid
+        LinkPtr pchildlink = pjoint->GetHierarchyChildLink();
+        if( !IsSameTransform(pchildlink->_info._t, t) ) {
+            pchildlink->_info._t = t;
+            pchildlink->_nTransformStamp = nTransformStamp;
+        }
         vlinkscomputed[pjoint->GetHierarchyChildLink()->GetIndex()] = 1;
     }
 
@@ -1847,10 +1868,195 @@ KinBody::JointPtr KinBody::GetJoint(const std::string& jointname) const
     return JointPtr();
 }
 
+/// \brief max number of dof index sets whose jacobian chains are cached for every link
+static const size_t s_nMaxJacobianChainsPerLink = 8;
+
+KinBody::JacobianChainConstPtr KinBody::GetJacobianChain(int linkindex, const std::vector<int>& dofindices) const
+{
+    CHECK_INTERNAL_COMPUTATION;
+    OPENRAVE_ASSERT_FORMAT(linkindex >= 0 && linkindex < (int)_veclinks.size(), "body %s bad link index %d (num links %d)", GetName()%linkindex%_veclinks.size(),ORE_InvalidArguments);
+    boost::mutex::scoped_lock lock(_mutexJacobianChains);
+    if( _vJacobianChains.size() != _veclinks.size() ) {
+        _vJacobianChains.resize(_veclinks.size());
+    }
+    // the chains of a link are kept in least recently used order, so the active dofs of a robot changing often does not grow the cache
+    std::vector<JacobianChainPtr>& vchains = _vJacobianChains[linkindex];
+    for(size_t ichain = 0; ichain < vchains.size(); ++ichain) {
+        if( vchains[ichain]->dofindices == dofindices ) {
+            for(size_t i = ichain+1; i < vchains.size(); ++i) {
+                vchains[i-1].swap(vchains[i]);
+            }
+            return vchains.back();
+        }
+    }
+    if( vchains.size() >= s_nMaxJacobianChainsPerLink ) {
+        vchains.erase(vchains.begin());
+    }
+
+    JacobianChainPtr pchain(new JacobianChain());
+    pchain->linkindex = linkindex;
+    pchain->dofindices = dofindices;
+    pchain->numcolumns = dofindices.size() > 0 ? dofindices.size() : GetDOF();
+    pchain->_pbody = this;
+    pchain->_nStamp = _nJacobianChainStamp;
+    int offset = linkindex*_veclinks.size();
+    int curlink = 0;
+    while(_vAllPairsShortestPaths[offset+curlink].first>=0) {
+        int jointindex = _vAllPairsShortestPaths[offset+curlink].second;
+        if( jointindex < (int)_vecjoints.size() ) {
+            // active joint
+            JointPtr pjoint = _vecjoints.at(jointindex);
+            if( DoesAffect(pjoint->GetJointIndex(), linkindex) != 0 ) {
+                for(int dof = 0; dof < pjoint->GetDOF(); ++dof) {
+                    JacobianChain::Axis axis;
+                    axis.column = pjoint->GetDOFIndex()+dof;
+                    if( dofindices.size() > 0 ) {
+                        std::vector<int>::const_iterator itindex = find(dofindices.begin(),dofindices.end(),axis.column);
+                        if( itindex == dofindices.end() ) {
+                            continue;
+                        }
+                        axis.column = itindex-dofindices.begin();
+                    }
+                    axis.pjoint = pjoint;
+                    axis.jointaxis = dof;
+                    if( pjoint->IsRevolute(dof) ) {
+                        axis.type = 1;
+                    }
+                    else if( pjoint->IsPrismatic(dof) ) {
+                        axis.type = 2;
+                    }
+                    else {
+                        RAVELOG_WARN_FORMAT("GetJacobianChain joint %s type %d not supported", pjoint->GetName()%pjoint->GetType());
+                        axis.type = 0;
+                    }
+                    pchain->vaxes.push_back(axis);
+                }
+            }
+        }
+        else {
+            JointPtr pjoint = _vPassiveJoints.at(jointindex-_vecjoints.size());
+            for(int idof = 0; idof < pjoint->GetDOF(); ++idof) {
+                if( pjoint->IsMimic(idof) ) {
+                    pchain->bHasMimic = true;
+                }
+            }
+        }
+        curlink = _vAllPairsShortestPaths[offset+curlink].first;
+    }
+    vchains.push_back(pchain);
+    return pchain;
+}
+
+void KinBody::ComputeJacobians(const JacobianChain& chain, const Vector& position, dReal* ptranslation, dReal* paxisangle, dReal* phessiantranslation, dReal* phessianaxisangle, size_t stride) const
+{
+    CHECK_INTERNAL_COMPUTATION;
+    OPENRAVE_ASSERT_FORMAT(chain._pbody == this, "body %s was given the jacobian chain of another body", GetName(), ORE_InvalidArguments);
+    OPENRAVE_ASSERT_FORMAT(chain._nStamp == _nJacobianChainStamp, "body %s jacobian chain of link %d is out of date", GetName()%chain.linkindex, ORE_InvalidState);
+    OPENRAVE_ASSERT_FORMAT(!phessiantranslation || (!!ptranslation && !!paxisangle), "body %s translation hessian needs both jacobians", GetName(), ORE_InvalidArguments);
+    OPENRAVE_ASSERT_FORMAT(!phessianaxisangle || !!paxisangle, "body %s axis-angle hessian needs the axis-angle jacobian", GetName(), ORE_InvalidArguments);
+    const size_t numcolumns = chain.numcolumns;
+    if( stride == 0 ) {
+        stride = numcolumns;
+    }
+    OPENRAVE_ASSERT_OP(stride,>=,numcolumns);
+    if( numcolumns == 0 ) {
+        return;
+    }
+
+    if( chain.bHasMimic ) {
+        // the partial velocities of the mimic joints need temporary memory, so fall back to the std::vector functions
+        std::vector<dReal> vtemp;
+        dReal* pdest[4] = { ptranslation, paxisangle, phessiantranslation, phessianaxisangle };
+        for(int itype = 0; itype < 4; ++itype) {
+            if( !pdest[itype] ) {
+                continue;
+            }
+            switch(itype) {
+            case 0: ComputeJacobianTranslation(chain.linkindex, position, vtemp, chain.dofindices); break;
+            case 1: ComputeJacobianAxisAngle(chain.linkindex, vtemp, chain.dofindices); break;
+            case 2: ComputeHessianTranslation(chain.linkindex, position, vtemp, chain.dofindices); break;
+            case 3: ComputeHessianAxisAngle(chain.linkindex, vtemp, chain.dofindices); break;
+            }
+            size_t numrows = itype < 2 ? 3 : 3*numcolumns;
+            for(size_t i = 0; i < numrows; ++i) {
+                std::copy(vtemp.begin()+i*numcolumns, vtemp.begin()+(i+1)*numcolumns, pdest[itype]+i*stride);
+            }
+        }
+        return;
+    }
+
+    for(size_t i = 0; i < 3; ++i) {
+        if( !!ptranslation ) {
+            std::fill(ptranslation+i*stride, ptranslation+i*stride+numcolumns, dReal(0));
+        }
+        if( !!paxisangle ) {
+            std::fill(paxisangle+i*stride, paxisangle+i*stride+numcolumns, dReal(0));
+        }
+    }
+    FOREACHC(itaxis, chain.vaxes) {
+        const size_t index = itaxis->column;
+        if( itaxis->type == 1 ) {
+            Vector v = itaxis->pjoint->GetAxis(itaxis->jointaxis);
+            if( !!paxisangle ) {
+                paxisangle[index] = v.x; paxisangle[stride+index] = v.y; paxisangle[2*stride+index] = v.z;
+            }
+            if( !!ptranslation ) {
+                v = v.cross(position-itaxis->pjoint->GetAnchor());
+                ptranslation[index] = v.x; ptranslation[stride+index] = v.y; ptranslation[2*stride+index] = v.z;
+            }
+        }
+        else if( itaxis->type == 2 ) {
+            if( !!ptranslation ) {
+                Vector v = itaxis->pjoint->GetAxis(itaxis->jointaxis);
+                ptranslation[index] = v.x; ptranslation[stride+index] = v.y; ptranslation[2*stride+index] = v.z;
+            }
+        }
+    }
+
+    // the hessian entries are cross products of the jacobian columns: the axis-angle column of a joint is its rotation axis,
+    // which moves the translation columns of all the joints after it on the chain
+    for(int ihessian = 0; ihessian < 2; ++ihessian) {
+        dReal* phessian = ihessian == 0 ? phessiantranslation : phessianaxisangle;
+        if( !phessian ) {
+            continue;
+        }
+        const dReal* pjacobian = ihessian == 0 ? ptranslation : paxisangle;
+        for(size_t i = 0; i < 3*numcolumns; ++i) {
+            std::fill(phessian+i*stride, phessian+i*stride+numcolumns, dReal(0));
+        }
+        for(size_t i = 0; i < chain.vaxes.size(); ++i) {
+            const size_t index = chain.vaxes[i].column;
+            if( chain.vaxes[i].type != 1 ) {
+                continue;
+            }
+            Vector vaxis(paxisangle[index], paxisangle[stride+index], paxisangle[2*stride+index]);
+            for(size_t j = ihessian == 0 ? i : i+1; j < chain.vaxes.size(); ++j) {
+                const size_t index2 = chain.vaxes[j].column;
+                Vector v = vaxis.cross(Vector(pjacobian[index2], pjacobian[stride+index2], pjacobian[2*stride+index2]));
+                size_t indexoffset = 3*stride*index+index2;
+                phessian[indexoffset] = v.x; phessian[indexoffset+stride] = v.y; phessian[indexoffset+2*stride] = v.z;
+                if( j != i ) {
+                    // symmetric
+                    indexoffset = 3*stride*index2+index;
+                    phessian[indexoffset] = v.x; phessian[indexoffset+stride] = v.y; phessian[indexoffset+2*stride] = v.z;
+                }
+            }
+        }
+    }
+}
+
 void KinBody::ComputeJacobianTranslation(int linkindex, const Vector& position, vector<dReal>& vjacobian,const std::vector<int>& dofindices) const
 {
     CHECK_INTERNAL_COMPUTATION;
     OPENRAVE_ASSERT_FORMAT(linkindex >= 0 && linkindex < (int)_veclinks.size(), "body %s bad link index %d (num links %d)", GetName()%linkindex%_veclinks.size(),ORE_InvalidArguments);
+    JacobianChainConstPtr pchain = GetJacobianChain(linkindex, dofindices);
+    if( !pchain->bHasMimic ) {
+        vjacobian.resize(3*pchain->numcolumns);
+        if( pchain->numcolumns > 0 ) {
+            ComputeJacobians(*pchain, position, &vjacobian[0], NULL);
+        }
+        return;
+    }
     size_t dofstride=0;
     if( dofindices.size() > 0 ) {
         dofstride = dofindices.size();
@@ -2063,6 +2269,14 @@ void KinBody::ComputeJacobianAxisAngle(int linkindex, std::vector<dReal>& vjacob
 {
     CHECK_INTERNAL_COMPUTATION;
     OPENRAVE_ASSERT_FORMAT(linkindex >= 0 && linkindex < (int)_veclinks.size(), "body %s bad link index %d (num links %d)", GetName()%linkindex%_veclinks.size(),ORE_InvalidArguments);
+    JacobianChainConstPtr pchain = GetJacobianChain(linkindex, dofindices);
+    if( !pchain->bHasMimic ) {
+        vjacobian.resize(3*pchain->numcolumns);
+        if( pchain->numcolumns > 0 ) {
+            ComputeJacobians(*pchain, Vector(), NULL, &vjacobian[0]);
+        }
+        return;
+    }
     size_t dofstride=0;
     if( dofindices.size() > 0 ) {
         dofstride = dofindices.size();
@@ -2182,6 +2396,16 @@ void KinBody::ComputeHessianTranslation(int linkindex, const Vector& position, s
 {
     CHECK_INTERNAL_COMPUTATION;
     OPENRAVE_ASSERT_FORMAT(linkindex >= 0 && linkindex < (int)_veclinks.size(), "body %s bad link index %d (num links %d)", GetName()%linkindex%_veclinks.size(),ORE_InvalidArguments);
+    JacobianChainConstPtr pchain = GetJacobianChain(linkindex, dofindices);
+    if( !pchain->bHasMimic ) {
+        size_t numcolumns = pchain->numcolumns;
+        hessian.resize(numcolumns*3*numcolumns);
+        if( numcolumns > 0 ) {
+            std::vector<dReal> vjacobians(6*numcolumns);
+            ComputeJacobians(*pchain, position, &vjacobians[0], &vjacobians[3*numcolumns], &hessian[0], NULL);
+        }
+        return;
+    }
     size_t dofstride=0;
     if( dofindices.size() > 0 ) {
         dofstride = dofindices.size();
@@ -2403,6 +2627,16 @@ void KinBody::ComputeHessianAxisAngle(int linkindex, std::vector<dReal>& hessian
 {
     CHECK_INTERNAL_COMPUTATION;
     OPENRAVE_ASSERT_FORMAT(linkindex >= 0 && linkindex < (int)_veclinks.size(), "body %s bad link index %d (num links %d)", GetName()%linkindex%_veclinks.size(),ORE_InvalidArguments);
+    JacobianChainConstPtr pchain = GetJacobianChain(linkindex, dofindices);
+    if( !pchain->bHasMimic ) {
+        size_t numcolumns = pchain->numcolumns;
+        hessian.resize(numcolumns*3*numcolumns);
+        if( numcolumns > 0 ) {
+            std::vector<dReal> vjacobian(3*numcolumns);
+            ComputeJacobians(*pchain, Vector(), NULL, &vjacobian[0], NULL, &hessian[0]);
+        }
+        return;
+    }
     size_t dofstride=0;
     if( dofindices.size() > 0 ) {
         dofstride = dofindices.size();
@@ -3222,6 +3456,7 @@ CollisionCheckerBasePtr KinBody::GetSelfCollisionChecker() const
 
 bool KinBody::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
 {
+    OPENRAVE_PROFILE_ZONE(GetEnv().get(), "KinBody::CheckSelfCollision");
     if( !collisionchecker ) {
         collisionchecker = _selfcollisionchecker;
         if( !collisionchecker ) {
@@ -3237,6 +3472,17 @@ bool KinBody::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBase
         }
     }
 
+    int incremental = _CheckSelfCollisionIncremental(report, collisionchecker);
+    if( incremental >= 0 ) {
+        return incremental > 0;
+    }
+    bool bCollision = _CheckSelfCollision(report, collisionchecker);
+    _UpdateSelfCollisionPlan(bCollision, collisionchecker);
+    return bCollision;
+}
+
+bool KinBody::_CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
+{
     if( collisionchecker->CheckStandaloneSelfCollision(shared_kinbody_const(), report) ) {
         if( !!report ) {
             RAVELOG_VERBOSE(str(boost::format("Self collision: %s\n")%report->__str__()));
@@ -3246,10 +3492,168 @@ bool KinBody::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBase
     return false;
 }
 
+void KinBody::_ComputeSelfCollisionPlan(SelfCollisionPlan& plan) const
+{
+    const std::set<int>& nonadjacent = GetNonAdjacentLinks(0);
+    plan.vpairs.reserve(nonadjacent.size());
+    plan.vpairlinkindices.reserve(nonadjacent.size());
+    FOREACHC(itset, nonadjacent) {
+        plan.vpairs.push_back(std::make_pair(LinkConstPtr(_veclinks.at(*itset&0xffff)), LinkConstPtr(_veclinks.at(*itset>>16))));
+        plan.vpairlinkindices.push_back(*itset);
+    }
+}
+
+int KinBody::_CheckSelfCollisionIncremental(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
+{
+    if( !_pSelfCollisionPlan || _pSelfCollisionPlan->vdofvalues.size() == 0 ) {
+        return -1;
+    }
+    SelfCollisionPlan& plan = *_pSelfCollisionPlan;
+    int coloptions = collisionchecker->GetCollisionOptions();
+    if( plan.pchecker.lock() != collisionchecker || plan.coloptions != coloptions || (coloptions & (CO_Distance|CO_AllLinkCollisions|CO_ActiveDOFs)) ) {
+        return -1;
+    }
+    if( plan.bHasGeometryGroup && collisionchecker->GetGeometryGroup() != plan.geometrygroup ) {
+        // the checker is using different geometries
+        return -1;
+    }
+
+    // the relative transforms of attached bodies are only known to be the same if their DOFs did not move and they were not moved relative to their carrying links
+    plan.vcurattacheddofvalues.resize(0);
+    std::vector<Transform>::const_iterator itattachedtransform = plan.vattachedtransforms.begin();
+    for(size_t ibody = 0; ibody < plan.vattachedbodies.size(); ++ibody) {
+        KinBodyConstPtr pbody = plan.vattachedbodies[ibody].lock();
+        if( !pbody ) {
+            return -1;
+        }
+        pbody->GetDOFValues(plan.vtempvalues);
+        plan.vcurattacheddofvalues.insert(plan.vcurattacheddofvalues.end(), plan.vtempvalues.begin(), plan.vtempvalues.end());
+        Transform tcarrierinv = _veclinks.at(plan.vattachedlinkindices.at(ibody))->GetTransform().inverse();
+        FOREACHC(itlink, pbody->GetLinks()) {
+            if( itattachedtransform == plan.vattachedtransforms.end() || TransformDistanceFast(*itattachedtransform, tcarrierinv*(*itlink)->GetTransform()) > g_fEpsilonLinear ) {
+                return -1;
+            }
+            ++itattachedtransform;
+        }
+    }
+    if( itattachedtransform != plan.vattachedtransforms.end() || plan.vcurattacheddofvalues != plan.vattacheddofvalues ) {
+        return -1;
+    }
+
+    GetDOFValues(plan.vcurdofvalues);
+    if( plan.vcurdofvalues.size() != plan.vdofvalues.size() ) {
+        return -1;
+    }
+    plan.vcurmask.resize(0);
+    plan.vcurmask.resize(plan.nmaskwords, 0);
+    // without any pairs the masks are empty
+    for(size_t idof = 0; idof < plan.vcurdofvalues.size() && plan.nmaskwords > 0; ++idof) {
+        if( plan.vcurdofvalues[idof] != plan.vdofvalues[idof] ) {
+            const uint64_t* pdofmask = &plan.vdofmasks.at(idof*plan.nmaskwords);
+            for(size_t iword = 0; iword < plan.nmaskwords; ++iword) {
+                plan.vcurmask[iword] |= pdofmask[iword];
+            }
+        }
+    }
+
+    if( !!report ) {
+        // the pairs that are not checked leave the report untouched, so it has to reflect a collision-free check
+        report->Reset(coloptions);
+    }
+    for(size_t iword = 0; iword < plan.nmaskwords; ++iword) {
+        uint64_t mask = plan.vcurmask[iword];
+        for(size_t ipair = iword*64; mask != 0; mask >>= 1, ++ipair) {
+            if( !(mask & 1) ) {
+                continue;
+            }
+            const std::pair<LinkConstPtr, LinkConstPtr>& linkpair = plan.vpairs[ipair];
+            if( !linkpair.first->IsEnabled() || !linkpair.second->IsEnabled() ) {
+                continue;
+            }
+            if( collisionchecker->CheckCollision(linkpair.first, linkpair.second, report) ) {
+                if( !!report ) {
+                    RAVELOG_VERBOSE(str(boost::format("Self collision: %s\n")%report->__str__()));
+                }
+                plan.vdofvalues.resize(0);
+                return 1;
+            }
+        }
+    }
+
+    FOREACHC(itbody, plan.vattachedbodies) {
+        if( KinBodyConstPtr(*itbody)->CheckSelfCollision(report, collisionchecker) ) {
+            plan.vdofvalues.resize(0);
+            return 1;
+        }
+    }
+    plan.vdofvalues.swap(plan.vcurdofvalues);
+    return 0;
+}
+
+void KinBody::_UpdateSelfCollisionPlan(bool bCollision, CollisionCheckerBasePtr collisionchecker) const
+{
+    if( !_pSelfCollisionPlan ) {
+        SelfCollisionPlanPtr pplan(new SelfCollisionPlan());
+        _ComputeSelfCollisionPlan(*pplan);
+        pplan->nmaskwords = (pplan->vpairs.size()+63)/64;
+        pplan->vdofmasks.resize(GetDOF()*pplan->nmaskwords, 0);
+        for(int idof = 0; idof < GetDOF() && pplan->nmaskwords > 0; ++idof) {
+            uint64_t* pdofmask = &pplan->vdofmasks[idof*pplan->nmaskwords];
+            for(size_t ipair = 0; ipair < pplan->vpairlinkindices.size(); ++ipair) {
+                uint32_t linkindices = pplan->vpairlinkindices[ipair];
+                if( IsDOFInChain(linkindices&0xffff, linkindices>>16, idof) ) {
+                    pdofmask[ipair/64] |= (uint64_t)1<<(ipair%64);
+                }
+            }
+        }
+        _pSelfCollisionPlan = pplan;
+    }
+
+    SelfCollisionPlan& plan = *_pSelfCollisionPlan;
+    plan.vdofvalues.resize(0);
+    int coloptions = collisionchecker->GetCollisionOptions();
+    if( bCollision || (coloptions & (CO_Distance|CO_AllLinkCollisions|CO_ActiveDOFs)) ) {
+        return;
+    }
+    plan.vattacheddofvalues.resize(0);
+    plan.vattachedtransforms.resize(0);
+    for(size_t ibody = 0; ibody < plan.vattachedbodies.size(); ++ibody) {
+        KinBodyConstPtr pbody = plan.vattachedbodies[ibody].lock();
+        if( !pbody ) {
+            return;
+        }
+        pbody->GetDOFValues(plan.vtempvalues);
+        plan.vattacheddofvalues.insert(plan.vattacheddofvalues.end(), plan.vtempvalues.begin(), plan.vtempvalues.end());
+        Transform tcarrierinv = _veclinks.at(plan.vattachedlinkindices.at(ibody))->GetTransform().inverse();
+        FOREACHC(itlink, pbody->GetLinks()) {
+            plan.vattachedtransforms.push_back(tcarrierinv*(*itlink)->GetTransform());
+        }
+    }
+    if( plan.pchecker.lock() != collisionchecker ) {
+        // checkers that do not implement geometry groups throw, so only query them when the checker changes
+        try {
+            plan.geometrygroup = collisionchecker->GetGeometryGroup();
+            plan.bHasGeometryGroup = true;
+        }
+        catch(const openrave_exception&) {
+            plan.geometrygroup.clear();
+            plan.bHasGeometryGroup = false;
+        }
+    }
+    else if( plan.bHasGeometryGroup ) {
+        plan.geometrygroup = collisionchecker->GetGeometryGroup();
+    }
+    GetDOFValues(plan.vdofvalues);
+    plan.pchecker = collisionchecker;
+    plan.coloptions = coloptions;
+}
+
 void KinBody::_ComputeInternalInformation()
 {
+    OPENRAVE_PROFILE_ZONE(GetEnv().get(), "KinBody::_ComputeInternalInformation");
     uint64_t starttime = utils::GetMicroTime();
     _nHierarchyComputed = 1;
+    _ResetJacobianChains();
 
     int lindex=0;
     FOREACH(itlink,_veclinks) {
@@ -4283,12 +4687,20 @@ void KinBody::SetNonCollidingConfiguration()
 
 void KinBody::_ResetInternalCollisionCache()
 {
+    _pSelfCollisionPlan.reset();
     _nNonAdjacentLinkCache = 0x80000000;
     FOREACH(it,_setNonAdjacentLinks) {
         it->clear();
     }
 }
 
+void KinBody::_ResetJacobianChains()
+{
+    boost::mutex::scoped_lock lock(_mutexJacobianChains);
+    _vJacobianChains.clear();
+    _nJacobianChainStamp++;
+}
+
 const std::set<int>& KinBody::GetNonAdjacentLinks(int adjacentoptions) const
 {
     class TransformsSaver
@@ -4324,6 +4736,7 @@ private:
             boost::static_pointer_cast<Link>(_veclinks[i])->_info._t = _vInitialLinkTransformations.at(i);
         }
         _nUpdateStampId++; // because transforms were modified
+        _SetLinkTransformStamps(_nUpdateStampId);
         for(size_t i = 0; i < _veclinks.size(); ++i) {
             for(size_t j = i+1; j < _veclinks.size(); ++j) {
                 if((_setAdjacentLinks.find(i|(j<<16)) == _setAdjacentLinks.end())&& !collisionchecker->CheckCollision(LinkConstPtr(_veclinks[i]), LinkConstPtr(_veclinks[j])) ) {
@@ -4331,7 +4744,8 @@ private:
                 }
             }
         }
-        _nUpdateStampId++; // because transforms were modified
+        _nUpdateStampId++; // because transforms were modified, the saver restores them right after
+        _SetLinkTransformStamps(_nUpdateStampId);
         _nNonAdjacentLinkCache = 0;
     }
     if( (_nNonAdjacentLinkCache&adjacentoptions) != adjacentoptions ) {
@@ -4406,11 +4820,11 @@ void KinBody::Clone(InterfaceBaseConstPtr preference, int cloningoptions)
         _vPassiveJoints.push_back(pnewjoint);
     }
 
-    _vTopologicallySortedJoints.resize(0); _vTopologicallySortedJoints.resize(r->_vTopologicallySortedJoints.size());
+    _vTopologicallySortedJoints.resize(0); _vTopologicallySortedJoints.reserve(r->_vTopologicallySortedJoints.size());
     FOREACHC(itjoint, r->_vTopologicallySortedJoints) {
         _vTopologicallySortedJoints.push_back(_vecjoints.at((*itjoint)->GetJointIndex()));
     }
-    _vTopologicallySortedJointsAll.resize(0); _vTopologicallySortedJointsAll.resize(r->_vTopologicallySortedJointsAll.size());
+    _vTopologicallySortedJointsAll.resize(0); _vTopologicallySortedJointsAll.reserve(r->_vTopologicallySortedJointsAll.size());
     FOREACHC(itjoint, r->_vTopologicallySortedJointsAll) {
         std::vector<JointPtr>::const_iterator it = find(r->_vecjoints.begin(),r->_vecjoints.end(),*itjoint);
         if( it != r->_vecjoints.end() ) {
@@ -4426,7 +4840,11 @@ void KinBody::Clone(InterfaceBaseConstPtr preference, int cloningoptions)
             }
         }
     }
-    _vDOFOrderedJoints = r->_vDOFOrderedJoints;
+    _vTopologicallySortedJointIndicesAll = r->_vTopologicallySortedJointIndicesAll;
+    _vDOFOrderedJoints.resize(0); _vDOFOrderedJoints.reserve(r->_vDOFOrderedJoints.size());
+    FOREACHC(itjoint, r->_vDOFOrderedJoints) {
+        _vDOFOrderedJoints.push_back(_vecjoints.at((*itjoint)->GetJointIndex()));
+    }
     _vJointsAffectingLinks = r->_vJointsAffectingLinks;
     _vDOFIndices = r->_vDOFIndices;
 
@@ -4475,12 +4893,21 @@ void KinBody::Clone(InterfaceBaseConstPtr preference, int cloningoptions)
 
     // cache
     _ResetInternalCollisionCache();
+    _ResetJacobianChains();
     _nUpdateStampId++; // update the stamp instead of copying
+    _SetLinkTransformStamps(_nUpdateStampId);
 }
 
 void KinBody::_PostprocessChangedParameters(uint32_t parameters)
 {
     _nUpdateStampId++;
+    if( parameters & (Prop_JointMimic|Prop_LinkGeometry|Prop_LinkStatic|Prop_LinkEnable|Prop_BodyAttached|Prop_RobotGrabbed) ) {
+        // the pairs to check or their collision state can change
+        _pSelfCollisionPlan.reset();
+    }
+    if( parameters & Prop_JointMimic ) {
+        _ResetJacobianChains();
+    }
     if( _nHierarchyComputed == 1 ) {
         _nParametersChanged |= parameters;
         return;
@@ -26,6 +26,7 @@ KinBody::Link::Link(KinBodyPtr parent)
 {
     _parent = parent;
     _index = -1;
+    _nTransformStamp = 0;
 }
 
 KinBody::Link::~Link()
@@ -283,7 +284,11 @@ void KinBody::Link::SetStatic(bool bStatic)
 void KinBody::Link::SetTransform(const Transform& t)
 {
     _info._t = t;
-    GetParent()->_nUpdateStampId++;
+    KinBodyPtr parent = GetParent();
+    parent->_nUpdateStampId++;
+    _nTransformStamp = parent->_nUpdateStampId;
+    // the link can move relative to the others without the DOF values changing, so the next self-collision check has to test all pairs
+    parent->_InvalidateSelfCollisionPlan();
 }
 
 void KinBody::Link::SetForce(const Vector& force, const Vector& pos, bool bAdd)
@@ -441,11 +441,6 @@ public:
             RAVELOG_WARN("failed to set to C locale: %s\n",e.what());
         }
 
-        _pdatabase.reset(new RaveDatabase());
-        if( !_pdatabase->Init(bLoadAllPlugins) ) {
-            RAVELOG_FATAL("failed to create the openrave plugin database\n");
-        }
-
         char* phomedir = getenv("OPENRAVE_HOME"); // getenv not thread-safe?
         if( phomedir == NULL ) {
 #ifndef _WIN32
@@ -463,6 +458,18 @@ public:
         CreateDirectory(_homedirectory.c_str(),NULL);
 #endif
 
+        // the plugin cache stores the interfaces each plugin offers so that plugins do not have to be opened at startup.
+        // it writes to the home directory, so it is only used when OPENRAVE_PLUGIN_CACHE is set to a value other than 0
+        std::string plugincachefilename;
+        const char* pOPENRAVE_PLUGIN_CACHE = std::getenv("OPENRAVE_PLUGIN_CACHE");
+        if( pOPENRAVE_PLUGIN_CACHE != NULL && strlen(pOPENRAVE_PLUGIN_CACHE) > 0 && strcmp(pOPENRAVE_PLUGIN_CACHE, "0") != 0 ) {
+            plugincachefilename = str(boost::format("%s%cplugins.cache")%_homedirectory%s_filesep);
+        }
+        _pdatabase.reset(new RaveDatabase());
+        if( !_pdatabase->Init(bLoadAllPlugins, plugincachefilename) ) {
+            RAVELOG_FATAL("failed to create the openrave plugin database\n");
+        }
+
 #ifdef _WIN32
         const char* delim = ";";
 #else
@@ -489,20 +496,22 @@ public:
     {
         // don't use any log statements since global instance might be null
         // environments have to be destroyed carefully since their destructors can be called, which will attempt to unregister the environment
-        std::map<int, EnvironmentBase*> mapenvironments;
+        std::list<EnvironmentBasePtr> listenvironments;
         {
             boost::mutex::scoped_lock lock(_mutexinternal);
-            mapenvironments = _mapenvironments;
+            FOREACH(itenv,_mapenvironments) {
+                // acquire shared pointers to all environments first, destroying one environment can release the last reference to another
+                listenvironments.push_back(itenv->second->shared_from_this());
+            }
         }
-        FOREACH(itenv,mapenvironments) {
-            // equire a shared pointer to prevent environment from getting deleted during Destroy loop
-            EnvironmentBasePtr penv = itenv->second->shared_from_this();
-            penv->Destroy();
+        FOREACH(itenv,listenvironments) {
+            (*itenv)->Destroy();
         }
-        mapenvironments.clear();
+        listenvironments.clear();
         _mapenvironments.clear();
         _pdefaultsampler.reset();
         _mapreaders.clear();
+        SetTraceHandler(TraceHandlerBasePtr());
 
         // process the callbacks
         std::list<boost::function<void()> > listDestroyCallbacks;
@@ -833,6 +842,13 @@ protected:
         boost::mutex::scoped_lock lock(_mutexinternal);
         return _nDataAccessOptions;
     }
+    void SetTraceHandler(TraceHandlerBasePtr handler) {
+        boost::atomic_store(&_ptracehandler, handler);
+    }
+    TraceHandlerBasePtr GetTraceHandler() {
+        // called inside planning loops, so read the handler without taking a mutex
+        return boost::atomic_load(&_ptracehandler);
+    }
     std::string GetDefaultViewerType() {
         if( _defaultviewertype.size() > 0 ) {
             return _defaultviewertype;
@@ -1057,6 +1073,8 @@ private:
 #endif
     int _nDataAccessOptions;
 
+    TraceHandlerBasePtr _ptracehandler; ///< only accessed with boost::atomic_load/atomic_store
+
     std::vector<string> _vdatadirs;
 #ifdef HAVE_BOOST_FILESYSTEM
     std::vector<boost::filesystem::path> _vBoostDataDirs; ///< \brief returns absolute filenames of the data
@@ -1339,6 +1357,16 @@ std::string RaveGetDefaultViewerType()
     return RaveGlobal::instance()->GetDefaultViewerType();
 }
 
+void RaveSetTraceHandler(TraceHandlerBasePtr handler)
+{
+    RaveGlobal::instance()->SetTraceHandler(handler);
+}
+
+TraceHandlerBasePtr RaveGetTraceHandler()
+{
+    return RaveGlobal::instance()->GetTraceHandler();
+}
+
 const char *RaveGetLocalizedTextForDomain(const std::string& domainname, const char *msgid)
 {
 #ifndef _WIN32
@@ -1974,6 +2002,151 @@ bool PhysicsEngineBase::GetLinkForceTorque(KinBody::LinkConstPtr plink, Vector&
     return true;
 }
 
+bool PhysicsEngineBase::SimulateRollout(PhysicsRollout& rollout)
+{
+    EnvironmentBasePtr penv = GetEnv();
+    std::vector<KinBodyPtr> vcontrolbodies(rollout.vcontrols.size());
+    for(size_t icontrol = 0; icontrol < rollout.vcontrols.size(); ++icontrol) {
+        const PhysicsRollout::BodyTorques& control = rollout.vcontrols[icontrol];
+        vcontrolbodies[icontrol] = penv->GetKinBody(control.bodyname);
+        if( !vcontrolbodies[icontrol] ) {
+            RAVELOG_WARN_FORMAT("env=%d, rollout body %s does not exist", penv->GetId()%control.bodyname);
+            return false;
+        }
+        if( (int)control.vtorques.size() != rollout.nSteps*vcontrolbodies[icontrol]->GetDOF() ) {
+            RAVELOG_WARN_FORMAT("env=%d, rollout body %s has %d torques, expected %d", penv->GetId()%control.bodyname%control.vtorques.size()%(rollout.nSteps*vcontrolbodies[icontrol]->GetDOF()));
+            return false;
+        }
+    }
+
+    std::vector<KinBodyPtr> vbodies;
+    penv->GetBodies(vbodies);
+    std::vector<KinBody::KinBodyStateSaverPtr> vsavers; vsavers.reserve(vbodies.size());
+    rollout.vbodynames.resize(vbodies.size());
+    size_t numlinks = 0;
+    for(size_t ibody = 0; ibody < vbodies.size(); ++ibody) {
+        vsavers.push_back(KinBody::KinBodyStateSaverPtr(new KinBody::KinBodyStateSaver(vbodies[ibody], KinBody::Save_LinkTransformation|KinBody::Save_LinkEnable|KinBody::Save_LinkVelocities)));
+        rollout.vbodynames[ibody] = vbodies[ibody]->GetName();
+        numlinks += vbodies[ibody]->GetLinks().size();
+    }
+
+    rollout.vrecordedtransforms.resize(0);
+    if( rollout.nRecordStride > 0 ) {
+        rollout.vrecordedtransforms.reserve(rollout.nSteps/rollout.nRecordStride);
+    }
+    std::vector<dReal> vjointtorques;
+    std::vector<Transform> vlinktransforms;
+    for(int istep = 0; istep < rollout.nSteps; ++istep) {
+        for(size_t icontrol = 0; icontrol < vcontrolbodies.size(); ++icontrol) {
+            const KinBodyPtr& pbody = vcontrolbodies[icontrol];
+            std::vector<dReal>::const_iterator ittorques = rollout.vcontrols[icontrol].vtorques.begin() + istep*pbody->GetDOF();
+            FOREACHC(itjoint, pbody->GetJoints()) {
+                std::vector<dReal>::const_iterator itjointtorques = ittorques + (*itjoint)->GetDOFIndex();
+                vjointtorques.assign(itjointtorques, itjointtorques + (*itjoint)->GetDOF());
+                AddJointTorque(*itjoint, vjointtorques);
+            }
+        }
+        SimulateStep(rollout.fTimeStep);
+        if( rollout.nRecordStride > 0 && ((istep+1) % rollout.nRecordStride) == 0 ) {
+            rollout.vrecordedtransforms.push_back(std::vector<Transform>());
+            std::vector<Transform>& vrecorded = rollout.vrecordedtransforms.back();
+            vrecorded.reserve(numlinks);
+            FOREACHC(itbody, vbodies) {
+                (*itbody)->GetLinkTransformations(vlinktransforms);
+                vrecorded.insert(vrecorded.end(), vlinktransforms.begin(), vlinktransforms.end());
+            }
+        }
+    }
+
+    rollout.vfinaltransforms.resize(0);
+    rollout.vfinaltransforms.reserve(numlinks);
+    rollout.vfinalvelocities.resize(0);
+    rollout.vfinalvelocities.reserve(numlinks);
+    std::vector<std::pair<Vector,Vector> > vlinkvelocities;
+    FOREACHC(itbody, vbodies) {
+        (*itbody)->GetLinkTransformations(vlinktransforms);
+        rollout.vfinaltransforms.insert(rollout.vfinaltransforms.end(), vlinktransforms.begin(), vlinktransforms.end());
+        GetLinkVelocities(*itbody, vlinkvelocities);
+        vlinkvelocities.resize((*itbody)->GetLinks().size());
+        rollout.vfinalvelocities.insert(rollout.vfinalvelocities.end(), vlinkvelocities.begin(), vlinkvelocities.end());
+    }
+
+    // restore the state the rollout started from
+    vsavers.clear();
+    return true;
+}
+
+static void _SimulatePhysicsRolloutsThread(EnvironmentBasePtr penv, std::vector<PhysicsRollout>* pvrollouts, size_t ithread, size_t nthreads, uint8_t* psuccess)
+{
+    EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+    PhysicsEngineBasePtr pphysics = penv->GetPhysicsEngine();
+    for(size_t irollout = ithread; irollout < pvrollouts->size(); irollout += nthreads) {
+        try {
+            if( !pphysics->SimulateRollout(pvrollouts->at(irollout)) ) {
+                *psuccess = 0;
+            }
+        }
+        catch(const std::exception& ex) {
+            RAVELOG_WARN_FORMAT("env=%d, rollout %d failed: %s", penv->GetId()%irollout%ex.what());
+            *psuccess = 0;
+        }
+    }
+}
+
+bool RaveSimulatePhysicsRollouts(EnvironmentBasePtr penv, std::vector<PhysicsRollout>& vrollouts, int nthreads)
+{
+    if( nthreads > (int)vrollouts.size() ) {
+        nthreads = (int)vrollouts.size();
+    }
+    if( vrollouts.size() == 0 ) {
+        return true;
+    }
+    if( nthreads < 1 ) {
+        nthreads = 1;
+    }
+
+    std::vector<EnvironmentBasePtr> vclones(nthreads);
+    {
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        PhysicsEngineBasePtr pphysics = penv->GetPhysicsEngine();
+        std::vector<KinBodyPtr> vbodies;
+        penv->GetBodies(vbodies);
+        std::vector<std::pair<Vector,Vector> > vlinkvelocities;
+        for(int ithread = 0; ithread < nthreads; ++ithread) {
+            vclones[ithread] = penv->CloneSelf(Clone_Bodies|Clone_Simulation);
+            // the clone only steps when asked to
+            vclones[ithread]->StopSimulation();
+            // velocities are not part of the cloned state
+            PhysicsEngineBasePtr pclonephysics = vclones[ithread]->GetPhysicsEngine();
+            FOREACHC(itbody, vbodies) {
+                KinBodyPtr pclonebody = vclones[ithread]->GetKinBody((*itbody)->GetName());
+                if( !!pclonebody && pphysics->GetLinkVelocities(*itbody, vlinkvelocities) ) {
+                    pclonephysics->SetLinkVelocities(pclonebody, vlinkvelocities);
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> vsuccess(nthreads, 1);
+    if( nthreads == 1 ) {
+        _SimulatePhysicsRolloutsThread(vclones[0], &vrollouts, 0, 1, &vsuccess[0]);
+    }
+    else {
+        boost::thread_group threads;
+        for(int ithread = 0; ithread < nthreads; ++ithread) {
+            threads.create_thread(boost::bind(_SimulatePhysicsRolloutsThread, vclones[ithread], &vrollouts, ithread, nthreads, &vsuccess[ithread]));
+        }
+        threads.join_all();
+    }
+
+    bool bsuccess = true;
+    for(int ithread = 0; ithread < nthreads; ++ithread) {
+        vclones[ithread]->Destroy();
+        bsuccess &= !!vsuccess[ithread];
+    }
+    return bsuccess;
+}
+
 void TriMesh::ApplyTransform(const Transform& t)
 {
     FOREACH(it, vertices) {
@@ -2070,6 +2243,7 @@ void Grabbed::_ProcessCollidingLinks(const std::set<int>& setRobotLinksToIgnore)
     _mapLinkIsNonColliding.clear();
     KinBodyPtr pgrabbedbody(_pgrabbedbody);
     RobotBasePtr probot = RaveInterfaceCast<RobotBase>(_plinkrobot->GetParent());
+    probot->_pSelfCollisionPlan.reset();
     EnvironmentBasePtr penv = probot->GetEnv();
     CollisionCheckerBasePtr pchecker = probot->GetSelfCollisionChecker();
     if( !pchecker ) {
@@ -2371,6 +2545,230 @@ CollisionOptionsStateSaver::~CollisionOptionsStateSaver()
     _p->SetCollisionOptions(_oldoptions);
 }
 
+int CollisionCheckerBase::CheckCollisionRays(const dReal* prays, int nrays, KinBodyConstPtr pbody, uint8_t* pcollision, dReal* phits, bool bFrontFacingOnly)
+{
+    CollisionReport report;
+    CollisionReportPtr preport(&report,utils::null_deleter());
+    RAY r;
+    int nhits = 0;
+    for(int i = 0; i < nrays; ++i, prays += 6, phits += 6) {
+        r.pos = Vector(prays[0], prays[1], prays[2]);
+        r.dir = Vector(prays[3], prays[4], prays[5]);
+        bool bCollision = !pbody ? CheckCollision(r, preport) : CheckCollision(r, pbody, preport);
+        pcollision[i] = 0;
+        std::fill(phits, phits+6, dReal(0));
+        if( bCollision && report.contacts.size() > 0 ) {
+            const CollisionReport::CONTACT& c = report.contacts[0];
+            if( !bFrontFacingOnly || c.norm.dot3(r.dir) < 0 ) {
+                pcollision[i] = 1;
+                phits[0] = c.pos.x; phits[1] = c.pos.y; phits[2] = c.pos.z;
+                phits[3] = c.norm.x; phits[4] = c.norm.y; phits[5] = c.norm.z;
+                ++nhits;
+            }
+        }
+    }
+    return nhits;
+}
+
+bool CollisionCheckerBase::CheckContinuousCollision(KinBodyPtr pbody, const std::vector<int>& vdofindices, const std::vector<dReal>& q0, const std::vector<dReal>& q1, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, dReal fmindistance, CollisionReportPtr report, dReal* ptimeofimpact)
+{
+    static const int s_nMaxIterations = 10000;
+    const size_t ndof = vdofindices.size();
+    OPENRAVE_ASSERT_OP(q0.size(),==,ndof);
+    OPENRAVE_ASSERT_OP(q1.size(),==,ndof);
+    const bool bquadratic = timeelapsed > 0 && dq0.size() == ndof && dq1.size() == ndof;
+    const dReal fduration = bquadratic ? timeelapsed : dReal(1);
+
+    // the velocity of every dof is linear in time, so its magnitude is largest at one of the ends
+    std::vector<dReal> vdofspeed(pbody->GetDOF(), 0), vaccel(ndof, 0);
+    for(size_t i = 0; i < ndof; ++i) {
+        OPENRAVE_ASSERT_FORMAT(vdofindices[i] >= 0 && vdofindices[i] < pbody->GetDOF(), "body %s does not have dof index %d", pbody->GetName()%vdofindices[i], ORE_InvalidArguments);
+        if( bquadratic ) {
+            vaccel[i] = (dq1[i]-dq0[i])/timeelapsed;
+            vdofspeed[vdofindices[i]] = max(RaveFabs(dq0[i]), RaveFabs(dq1[i]));
+        }
+        else {
+            vdofspeed[vdofindices[i]] = RaveFabs(q1[i]-q0[i]);
+        }
+    }
+
+    // bound the speed of any point of the body. The distance from a joint anchor to a point of a link is bounded by the
+    // sum of the distances between the consecutive anchors of the chain, which do not change with the joint values.
+    std::vector<KinBodyPtr> vgrabbed;
+    RobotBasePtr probot;
+    if( pbody->IsRobot() ) {
+        probot = RaveInterfaceCast<RobotBase>(pbody);
+        probot->GetGrabbed(vgrabbed);
+    }
+    dReal fmaxspeed = 0;
+    std::vector<KinBody::JointPtr> vchain;
+    std::vector<dReal> vanchorradius;
+    FOREACHC(itlink, pbody->GetLinks()) {
+        const KinBody::LinkPtr& plink = *itlink;
+        if( !plink->IsEnabled() ) {
+            continue;
+        }
+        Vector vcenter;
+        dReal fextent = 0;
+        if( plink->GetGeometries().size() > 0 ) {
+            AABB ab = plink->ComputeAABB();
+            vcenter = ab.pos;
+            fextent = RaveSqrt(ab.extents.lengthsqr3());
+        }
+        else {
+            vcenter = plink->GetTransform().trans;
+        }
+        FOREACHC(itgrabbed, vgrabbed) {
+            if( probot->IsGrabbing(*itgrabbed) == plink ) {
+                AABB ab = (*itgrabbed)->ComputeAABB();
+                fextent = max(fextent, RaveSqrt((ab.pos-vcenter).lengthsqr3()) + RaveSqrt(ab.extents.lengthsqr3()));
+            }
+        }
+        if( plink->GetIndex() == 0 || !pbody->GetChain(0, plink->GetIndex(), vchain) || vchain.size() == 0 ) {
+            continue;
+        }
+
+        // vanchorradius[k] bounds the distance from the anchor of vchain[k] to any point of the link
+        vanchorradius.resize(vchain.size());
+        dReal fradius = RaveSqrt((vchain.back()->GetAnchor()-vcenter).lengthsqr3()) + fextent;
+        for(int k = (int)vchain.size()-1; k >= 0; --k) {
+            const KinBody::JointPtr& pjoint = vchain[k];
+            if( k+1 < (int)vchain.size() ) {
+                fradius += RaveSqrt((pjoint->GetAnchor()-vchain[k+1]->GetAnchor()).lengthsqr3());
+            }
+            for(int iaxis = 0; iaxis < pjoint->GetDOF(); ++iaxis) {
+                if( pjoint->IsPrismatic(iaxis) ) {
+                    // a sliding joint changes the distances along the chain by at most its range
+                    std::pair<dReal, dReal> limits = pjoint->GetLimit(iaxis);
+                    fradius += limits.second - limits.first;
+                }
+            }
+            vanchorradius[k] = fradius;
+        }
+
+        dReal flinkspeed = 0;
+        for(size_t k = 0; k < vchain.size(); ++k) {
+            const KinBody::JointPtr& pjoint = vchain[k];
+            if( pjoint->IsMimic() ) {
+                throw OPENRAVE_EXCEPTION_FORMAT(_("continuous collision checking does not support mimic joint %s of body %s"), pjoint->GetName()%pbody->GetName(), ORE_NotImplemented);
+            }
+            if( pjoint->GetDOFIndex() < 0 || !pbody->DoesAffect(pjoint->GetJointIndex(), plink->GetIndex()) ) {
+                continue;
+            }
+            for(int iaxis = 0; iaxis < pjoint->GetDOF(); ++iaxis) {
+                dReal fspeed = vdofspeed.at(pjoint->GetDOFIndex()+iaxis);
+                flinkspeed += pjoint->IsPrismatic(iaxis) ? fspeed : fspeed*vanchorradius[k];
+            }
+        }
+        fmaxspeed = max(fmaxspeed, flinkspeed);
+    }
+
+    // when the distance is not known, fall back to stepping by the dof resolutions like discretized checking
+    dReal ffixedstep = fduration;
+    std::vector<dReal> vresolutions;
+    pbody->GetDOFResolutions(vresolutions);
+    for(int idof = 0; idof < pbody->GetDOF(); ++idof) {
+        if( vdofspeed[idof] > 0 && vresolutions.at(idof) > 0 ) {
+            ffixedstep = min(ffixedstep, vresolutions[idof]/vdofspeed[idof]);
+        }
+    }
+
+    const int coloptions = GetCollisionOptions();
+    KinBody::KinBodyStateSaver saver(pbody, KinBody::Save_LinkTransformation);
+    CollisionOptionsStateSaver optionsaver(shared_collisionchecker(), coloptions|CO_Distance, false);
+    if( !(GetCollisionOptions() & CO_Distance) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT(_("collision checker %s does not support CO_Distance, which continuous collision checking needs"), GetXMLId(), ORE_NotImplemented);
+    }
+    // self-collisions are checked with the checker of the body like KinBody::CheckSelfCollision does, using the same options as this checker
+    CollisionCheckerBasePtr pselfchecker = pbody->GetSelfCollisionChecker();
+    CollisionOptionsStateSaverPtr selfoptionsaver;
+    if( !pselfchecker ) {
+        pselfchecker = shared_collisionchecker();
+    }
+    else if( pselfchecker != shared_collisionchecker() ) {
+        selfoptionsaver.reset(new CollisionOptionsStateSaver(pselfchecker, coloptions|CO_Distance, false));
+        if( !(pselfchecker->GetCollisionOptions() & CO_Distance) ) {
+            throw OPENRAVE_EXCEPTION_FORMAT(_("self-collision checker %s of body %s does not support CO_Distance, which continuous collision checking needs"), pselfchecker->GetXMLId()%pbody->GetName(), ORE_NotImplemented);
+        }
+    }
+
+    CollisionReportPtr pdistreport(new CollisionReport()), pselfdistreport(new CollisionReport());
+    std::vector<dReal> vdofvalues;
+    pbody->GetDOFValues(vdofvalues);
+    dReal t = 0;
+    for(int iter = 0;; ++iter) {
+        for(size_t i = 0; i < ndof; ++i) {
+            vdofvalues[vdofindices[i]] = bquadratic ? q0[i] + t*(dq0[i] + 0.5*t*vaccel[i]) : q0[i] + t*(q1[i]-q0[i]);
+        }
+        pbody->SetDOFValues(vdofvalues, KinBody::CLA_Nothing);
+        bool bcollision = CheckCollision(KinBodyConstPtr(pbody), pdistreport);
+        dReal fdist = pdistreport->minDistance;
+        CollisionReportPtr pclosestreport = pdistreport;
+        if( !bcollision ) {
+            bcollision = pbody->CheckSelfCollision(pselfdistreport, pselfchecker);
+            if( bcollision || pselfdistreport->minDistance < fdist ) {
+                fdist = pselfdistreport->minDistance;
+                pclosestreport = pselfdistreport;
+            }
+        }
+        if( bcollision || fdist <= fmindistance ) {
+            if( !!report ) {
+                _FillContinuousCollisionReport(pbody, coloptions, *pclosestreport, report);
+            }
+            if( !!ptimeofimpact ) {
+                *ptimeofimpact = t;
+            }
+            return true;
+        }
+        if( t >= fduration || fmaxspeed <= 0 ) {
+            return false;
+        }
+        if( iter >= s_nMaxIterations ) {
+            RAVELOG_DEBUG_FORMAT("env=%d, continuous collision checking of %s did not finish after %d steps, treating as colliding", GetEnv()->GetId()%pbody->GetName()%iter);
+            if( !!report ) {
+                _FillContinuousCollisionReport(pbody, coloptions, *pclosestreport, report);
+            }
+            if( !!ptimeofimpact ) {
+                *ptimeofimpact = t;
+            }
+            return true;
+        }
+        if( fdist >= 1e19 ) {
+            // the checker did not compute a distance, for example because the closest pair is beyond its distance threshold
+            t = min(fduration, t + ffixedstep);
+        }
+        else {
+            // two links of the body can approach each other with twice the link speed. Keeping half of fmindistance
+            // as clearance guarantees every step moves forward by at least fmindistance/(4*fmaxspeed)
+            t = min(fduration, t + (fdist - 0.5*fmindistance)/(2*fmaxspeed));
+        }
+    }
+}
+
+void CollisionCheckerBase::_FillContinuousCollisionReport(KinBodyPtr pbody, int coloptions, const CollisionReport& distreport, CollisionReportPtr report)
+{
+    // check again with the options of the caller, so the report only has the information that was requested
+    CollisionOptionsStateSaver optionsaver(shared_collisionchecker(), coloptions, false);
+    CollisionCheckerBasePtr pselfchecker = pbody->GetSelfCollisionChecker();
+    CollisionOptionsStateSaverPtr selfoptionsaver;
+    if( !pselfchecker ) {
+        pselfchecker = shared_collisionchecker();
+    }
+    else if( pselfchecker != shared_collisionchecker() ) {
+        selfoptionsaver.reset(new CollisionOptionsStateSaver(pselfchecker, coloptions, false));
+    }
+    if( CheckCollision(KinBodyConstPtr(pbody), report) || pbody->CheckSelfCollision(report, pselfchecker) ) {
+        return;
+    }
+    // closer than fmindistance without touching, only report the closest pair
+    report->Reset(coloptions);
+    report->plink1 = distreport.plink1;
+    report->plink2 = distreport.plink2;
+    if( coloptions & CO_Distance ) {
+        report->minDistance = distreport.minDistance;
+    }
+}
+
 void RaveInitRandomGeneration(uint32_t seed)
 {
     RaveGlobal::instance()->GetDefaultSampler()->SetSeed(seed);
@@ -310,6 +310,7 @@ public:
             _mapLinkIsNonColliding[plink] = 0;
             _listNonCollidingLinks.remove(plink);
         }
+        probot->_pSelfCollisionPlan.reset();
     }
 
     /// return -1 for unknown, 0 for no, 1 for yes
@@ -335,6 +336,7 @@ public:
         KinBodyConstPtr pgrabbedbody(_pgrabbedbody);
         if( !pgrabbedbody || !pgrabbedbody->IsEnabled() ) {
             _listNonCollidingLinks.clear();
+            probot->_pSelfCollisionPlan.reset();
             return;
         }
 
@@ -388,6 +390,7 @@ public:
         }
 
         _listNonCollidingLinks.clear();
+        probot->_pSelfCollisionPlan.reset();
         itnoncolliding = _mapLinkIsNonColliding.begin();
         while( itnoncolliding != _mapLinkIsNonColliding.end() ) {
             KinBodyPtr noncollidingparent = itnoncolliding->first->GetParent(true);
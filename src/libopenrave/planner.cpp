@@ -913,6 +913,7 @@ PlannerStatus PlannerBase::_ProcessPostPlanners(RobotBasePtr probot, TrajectoryB
     params->_nMaxIterations = 0; // have to reset since path optimizers also use it and new parameters could be in extra parameters
     //params->_nMaxPlanningTime = 0; // have to reset since path optimizers also use it and new parameters could be in extra parameters??
     if( __cachePostProcessPlanner->InitPlan(probot, params) ) {
+        OPENRAVE_PROFILE_ZONE(GetEnv().get(), "PlannerBase::_ProcessPostPlanners");
         return __cachePostProcessPlanner->PlanPath(ptraj);
     }
 
@@ -922,6 +923,10 @@ PlannerStatus PlannerBase::_ProcessPostPlanners(RobotBasePtr probot, TrajectoryB
 
 PlannerAction PlannerBase::_CallCallbacks(const PlannerProgress& progress)
 {
+    TraceHandlerBasePtr tracer = RaveGetTraceHandler();
+    if( !!tracer ) {
+        tracer->TraceEvent(TET_PlannerIteration, GetXMLId(), progress._iteration, 0);
+    }
     FOREACHC(it,__listRegisteredCallbacks) {
         CustomPlannerCallbackDataPtr pitdata = boost::dynamic_pointer_cast<CustomPlannerCallbackData>(it->lock());
         if( !!pitdata) {
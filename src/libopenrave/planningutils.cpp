@@ -640,6 +640,7 @@ ActiveDOFTrajectorySmoother::ActiveDOFTrajectorySmoother(RobotBasePtr robot, con
 
 PlannerStatus ActiveDOFTrajectorySmoother::PlanPath(TrajectoryBasePtr traj)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "ActiveDOFTrajectorySmoother::PlanPath");
     if( traj->GetNumWaypoints() == 1 ) {
         // don't need velocities, but should at least add a time group
         ConfigurationSpecification spec = traj->GetConfigurationSpecification();
@@ -705,6 +706,7 @@ ActiveDOFTrajectoryRetimer::ActiveDOFTrajectoryRetimer(RobotBasePtr robot, const
 
 PlannerStatus ActiveDOFTrajectoryRetimer::PlanPath(TrajectoryBasePtr traj, bool hastimestamps)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "ActiveDOFTrajectoryRetimer::PlanPath");
     if( traj->GetNumWaypoints() == 1 ) {
         // don't need velocities, but should at least add a time group
         ConfigurationSpecification spec = traj->GetConfigurationSpecification();
@@ -1027,6 +1029,7 @@ void AffineTrajectoryRetimer::SetPlanner(const std::string& plannername, const s
 
 PlannerStatus AffineTrajectoryRetimer::PlanPath(TrajectoryBasePtr traj, const std::vector<dReal>& maxvelocities, const std::vector<dReal>& maxaccelerations, bool hastimestamps)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "AffineTrajectoryRetimer::PlanPath");
     if( traj->GetNumWaypoints() == 1 ) {
         // don't need retiming, but should at least add a time group
         ConfigurationSpecification spec = traj->GetConfigurationSpecification();
@@ -1146,16 +1149,19 @@ PlannerStatus AffineTrajectoryRetimer::PlanPath(TrajectoryBasePtr traj, const st
 
 PlannerStatus SmoothActiveDOFTrajectory(TrajectoryBasePtr traj, RobotBasePtr robot, dReal fmaxvelmult, dReal fmaxaccelmult, const std::string& plannername, const std::string& plannerparameters)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "planningutils::SmoothTrajectory");
     return _PlanActiveDOFTrajectory(traj,robot,false,fmaxvelmult,fmaxaccelmult,plannername.size() > 0 ? plannername : "parabolicsmoother", true,plannerparameters);
 }
 
 PlannerStatus SmoothAffineTrajectory(TrajectoryBasePtr traj, const std::vector<dReal>& maxvelocities, const std::vector<dReal>& maxaccelerations, const std::string& plannername, const std::string& plannerparameters)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "planningutils::SmoothTrajectory");
     return _PlanAffineTrajectory(traj, maxvelocities, maxaccelerations, false, plannername.size() > 0 ? plannername : "parabolicsmoother", true, plannerparameters);
 }
 
 PlannerStatus SmoothTrajectory(TrajectoryBasePtr traj, dReal fmaxvelmult, dReal fmaxaccelmult, const std::string& plannername, const std::string& plannerparameters)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "planningutils::SmoothTrajectory");
     return _PlanTrajectory(traj,false,fmaxvelmult,fmaxaccelmult,plannername.size() > 0 ? plannername : "parabolicsmoother", true,plannerparameters);
 }
 
@@ -1192,16 +1198,19 @@ static std::string GetPlannerFromInterpolation(TrajectoryBasePtr traj, const std
 
 PlannerStatus RetimeActiveDOFTrajectory(TrajectoryBasePtr traj, RobotBasePtr robot, bool hastimestamps, dReal fmaxvelmult, dReal fmaxaccelmult, const std::string& plannername, const std::string& plannerparameters)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "planningutils::RetimeTrajectory");
     return _PlanActiveDOFTrajectory(traj,robot,hastimestamps,fmaxvelmult,fmaxaccelmult,GetPlannerFromInterpolation(traj,plannername), false,plannerparameters);
 }
 
 PlannerStatus RetimeAffineTrajectory(TrajectoryBasePtr traj, const std::vector<dReal>& maxvelocities, const std::vector<dReal>& maxaccelerations, bool hastimestamps, const std::string& plannername, const std::string& plannerparameters)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "planningutils::RetimeTrajectory");
     return _PlanAffineTrajectory(traj, maxvelocities, maxaccelerations, hastimestamps, GetPlannerFromInterpolation(traj,plannername), false,plannerparameters);
 }
 
 PlannerStatus RetimeTrajectory(TrajectoryBasePtr traj, bool hastimestamps, dReal fmaxvelmult, dReal fmaxaccelmult, const std::string& plannername, const std::string& plannerparameters)
 {
+    OPENRAVE_PROFILE_ZONE(traj->GetEnv().get(), "planningutils::RetimeTrajectory");
     return _PlanTrajectory(traj,hastimestamps,fmaxvelmult,fmaxaccelmult,GetPlannerFromInterpolation(traj,plannername), false,plannerparameters);
 }
 
@@ -1994,7 +2003,7 @@ void GetDHParameters(std::vector<DHParameter>& vparameters, KinBodyConstPtr pbod
     }
 }
 
-DynamicsCollisionConstraint::DynamicsCollisionConstraint(PlannerBase::PlannerParametersConstPtr parameters, const std::list<KinBodyPtr>& listCheckBodies, int filtermask) : _listCheckBodies(listCheckBodies), _filtermask(filtermask), _torquelimitmode(0), _perturbation(0.1)
+DynamicsCollisionConstraint::DynamicsCollisionConstraint(PlannerBase::PlannerParametersConstPtr parameters, const std::list<KinBodyPtr>& listCheckBodies, int filtermask) : _listCheckBodies(listCheckBodies), _filtermask(filtermask), _torquelimitmode(0), _perturbation(0.1), _bContinuousCollision(false), _fContinuousMinDistance(1e-4)
 {
     BOOST_ASSERT(listCheckBodies.size()>0);
     _report.reset(new CollisionReport());
@@ -2012,6 +2021,109 @@ void DynamicsCollisionConstraint::SetPlannerParameters(PlannerBase::PlannerParam
         _specvel = parameters->_configurationspecification.ConvertToVelocitySpecification();
         _setvelstatefn = _specvel.GetSetFn(_listCheckBodies.front()->GetEnv());
     }
+    if( _bContinuousCollision ) {
+        _InitContinuousCollisionChecking(parameters);
+    }
+}
+
+void DynamicsCollisionConstraint::SetContinuousCollisionChecking(bool bcontinuous, dReal fmindistance)
+{
+    _bContinuousCollision = bcontinuous;
+    _fContinuousMinDistance = fmindistance;
+    if( _bContinuousCollision ) {
+        _InitContinuousCollisionChecking(_parameters.lock());
+    }
+}
+
+void DynamicsCollisionConstraint::_InitContinuousCollisionChecking(PlannerBase::PlannerParametersConstPtr params)
+{
+    _vcontinuousdofindices.resize(0);
+    _vcontinuousconfigindices.resize(0);
+    if( !params || _listCheckBodies.size() != 1 ) {
+        return;
+    }
+    params->_configurationspecification.ExtractUsedIndices(_listCheckBodies.front(), _vcontinuousdofindices, _vcontinuousconfigindices);
+    if( (int)_vcontinuousdofindices.size() != params->GetDOF() ) {
+        RAVELOG_DEBUG_FORMAT("configuration of %d dofs does not only hold joint values of %s, so segments are not checked continuously", params->GetDOF()%_listCheckBodies.front()->GetName());
+        _vcontinuousdofindices.resize(0);
+        _vcontinuousconfigindices.resize(0);
+    }
+}
+
+int DynamicsCollisionConstraint::_CheckContinuousCollision(PlannerBase::PlannerParametersConstPtr params, const std::vector<dReal>& q0, const std::vector<dReal>& vdelta, const std::vector<dReal>& dq0, const std::vector<dReal>& dq1, dReal timeelapsed, int options, ConstraintFilterReturnPtr filterreturn)
+{
+    if( _vcontinuousdofindices.size() == 0 ) {
+        return -1;
+    }
+    KinBodyPtr pbody = _listCheckBodies.front();
+    size_t ndof = _vcontinuousdofindices.size();
+    bool bvelocities = timeelapsed > 0 && dq0.size() == q0.size() && dq1.size() == q0.size();
+    _vcontinuousq0.resize(ndof);
+    _vcontinuousq1.resize(ndof);
+    _vcontinuousdq0.resize(bvelocities ? ndof : 0);
+    _vcontinuousdq1.resize(bvelocities ? ndof : 0);
+    for(size_t i = 0; i < ndof; ++i) {
+        int iconfig = _vcontinuousconfigindices[i];
+        _vcontinuousq0[i] = q0.at(iconfig);
+        // use the difference so that circular joints take the short way around
+        _vcontinuousq1[i] = q0.at(iconfig) + vdelta.at(iconfig);
+        if( bvelocities ) {
+            _vcontinuousdq0[i] = dq0.at(iconfig);
+            _vcontinuousdq1[i] = dq1.at(iconfig);
+        }
+    }
+
+    CollisionCheckerBasePtr pchecker = pbody->GetEnv()->GetCollisionChecker();
+    bool bcollision = false;
+    dReal ftimeofimpact = 0;
+    try {
+        bcollision = pchecker->CheckContinuousCollision(pbody, _vcontinuousdofindices, _vcontinuousq0, _vcontinuousq1, _vcontinuousdq0, _vcontinuousdq1, timeelapsed, _fContinuousMinDistance, _report, &ftimeofimpact);
+    }
+    catch(const openrave_exception& ex) {
+        if( ex.GetCode() != ORE_NotImplemented ) {
+            throw;
+        }
+        // the checkers can be changed between calls, so only fall back for this segment
+        RAVELOG_DEBUG_FORMAT("continuous collision checking not possible, falling back to discretized checking: %s", ex.what());
+        return -1;
+    }
+    if( !bcollision ) {
+        return 0;
+    }
+
+    int nret = CFO_CheckEnvCollisions;
+    if( !!_report->plink1 && !!_report->plink2 && _report->plink1->GetParent() == _report->plink2->GetParent() ) {
+        nret = CFO_CheckSelfCollisions;
+    }
+    if( !(options & nret) ) {
+        // the collision type found is not requested, but continuous checking cannot look past it
+        nret = options & (CFO_CheckEnvCollisions|CFO_CheckSelfCollisions);
+    }
+    if( !!filterreturn ) {
+        filterreturn->_returncode = nret;
+        // the configuration at the time of impact, interpolated like the discretized checking does
+        size_t nconfigdof = q0.size();
+        filterreturn->_invalidvalues.resize(nconfigdof);
+        filterreturn->_invalidvelocities.resize(dq0.size() == nconfigdof ? nconfigdof : 0);
+        for(size_t i = 0; i < nconfigdof; ++i) {
+            if( bvelocities ) {
+                dReal faccel = (dq1[i]-dq0[i])/timeelapsed;
+                filterreturn->_invalidvalues[i] = q0[i] + ftimeofimpact*(dq0[i] + 0.5*ftimeofimpact*faccel);
+                filterreturn->_invalidvelocities[i] = dq0[i] + ftimeofimpact*faccel;
+            }
+            else {
+                filterreturn->_invalidvalues[i] = q0[i] + ftimeofimpact*vdelta.at(i);
+                if( filterreturn->_invalidvelocities.size() > 0 ) {
+                    filterreturn->_invalidvelocities[i] = dq1.size() == nconfigdof ? dq0[i] + ftimeofimpact*(dq1[i]-dq0[i]) : dq0[i];
+                }
+            }
+        }
+        filterreturn->_fTimeWhenInvalid = ftimeofimpact;
+        if( options & CFO_FillCollisionReport ) {
+            filterreturn->_report = *_report;
+        }
+    }
+    return nret;
 }
 
 void DynamicsCollisionConstraint::SetUserCheckFunction(const boost::function<bool() >& usercheckfn, bool bCallAfterCheckCollision)
@@ -2080,6 +2192,7 @@ int DynamicsCollisionConstraint::_CheckState(const std::vector<dReal>& vdofveloc
             if( IS_DEBUGLEVEL(Level_Verbose) ) {
                 _PrintOnFailure("pre usercheckfn failed");
             }
+            _TraceOnFailure("pre usercheckfn", CFO_CheckUserConstraints);
             return CFO_CheckUserConstraints;
         }
     }
@@ -2130,6 +2243,7 @@ int DynamicsCollisionConstraint::_CheckState(const std::vector<dReal>& vdofveloc
                             }
                             _PrintOnFailure(str(boost::format("rejected torque due to joint %s (%d): %e !< %e !< %e. vel=[%s]")%pbody->GetJointFromDOFIndex(index)->GetName()%index%torquelimits.first%fcurtorque%torquelimits.second%ssvel.str()));
                         }
+                        _TraceOnFailure(pbody->GetJointFromDOFIndex(index)->GetName().c_str(), CFO_CheckTimeBasedConstraints);
                         return CFO_CheckTimeBasedConstraints;
                     }
                 }
@@ -2144,6 +2258,7 @@ int DynamicsCollisionConstraint::_CheckState(const std::vector<dReal>& vdofveloc
             if( IS_DEBUGLEVEL(Level_Verbose) ) {
                 _PrintOnFailure(std::string("collision failed ")+_report->__str__());
             }
+            _TraceOnFailure((*itbody)->GetName().c_str(), CFO_CheckEnvCollisions);
             return CFO_CheckEnvCollisions;
         }
         if( (options&CFO_CheckSelfCollisions) && (*itbody)->CheckSelfCollision(_report) ) {
@@ -2153,6 +2268,7 @@ int DynamicsCollisionConstraint::_CheckState(const std::vector<dReal>& vdofveloc
             if( IS_DEBUGLEVEL(Level_Verbose) ) {
                 _PrintOnFailure(std::string("self-collision failed ")+_report->__str__());
             }
+            _TraceOnFailure((*itbody)->GetName().c_str(), CFO_CheckSelfCollisions);
             return CFO_CheckSelfCollisions;
         }
     }
@@ -2161,6 +2277,7 @@ int DynamicsCollisionConstraint::_CheckState(const std::vector<dReal>& vdofveloc
             if( IS_DEBUGLEVEL(Level_Verbose) ) {
                 _PrintOnFailure("post usercheckfn failed");
             }
+            _TraceOnFailure("post usercheckfn", CFO_CheckUserConstraints);
             return CFO_CheckUserConstraints;
         }
     }
@@ -2191,6 +2308,21 @@ void DynamicsCollisionConstraint::_PrintOnFailure(const std::string& prefix)
     }
 }
 
+void DynamicsCollisionConstraint::_TraceOnFailure(const char* reason, int failure)
+{
+    // the reason is only turned into a string when tracing, so constraint failures cost nothing otherwise
+    TraceHandlerBasePtr tracer = RaveGetTraceHandler();
+    if( !tracer ) {
+        return;
+    }
+    PlannerBase::PlannerParametersConstPtr params = _parameters.lock();
+    _vtracevalues.resize(0);
+    if( !!params ) {
+        params->_getstatefn(_vtracevalues);
+    }
+    tracer->TraceEvent(TET_ConstraintFailure, reason, failure, 0, _vtracevalues.size() > 0 ? &_vtracevalues[0] : NULL, _vtracevalues.size());
+}
+
 inline std::ostream& RaveSerializeTransform(std::ostream& O, const Transform& t, char delim=',')
 {
     O << t.rot.x << delim << t.rot.y << delim << t.rot.z << delim << t.rot.w << delim << t.trans.x << delim << t.trans.y << delim << t.trans.z;
@@ -2402,6 +2534,21 @@ int DynamicsCollisionConstraint::Check(const std::vector<dReal>& q0, const std::
         start = 1;
     }
 
+    if( _bContinuousCollision && numSteps > 0 && (maskoptions & (CFO_CheckEnvCollisions|CFO_CheckSelfCollisions)) ) {
+        int ncontinuousret = _CheckContinuousCollision(params, q0, dQ, dq0, dq1, timeelapsed, maskoptions, filterreturn);
+        if( ncontinuousret > 0 ) {
+            return ncontinuousret;
+        }
+        else if( ncontinuousret == 0 && !((maskoptions & CFO_CheckWithPerturbation) && _perturbation > 0) ) {
+            // collisions of the whole segment are checked, only step through it for the remaining constraints.
+            // perturbed configurations are off the segment, so with perturbations the collisions are still checked at every step
+            maskoptions &= ~(CFO_CheckEnvCollisions|CFO_CheckSelfCollisions);
+            if( !(maskoptions & (CFO_CheckTimeBasedConstraints|CFO_CheckUserConstraints)) && !(options & CFO_FillCheckedConfiguration) ) {
+                return 0;
+            }
+        }
+    }
+
     if( numSteps == 0 ) {
         // everything is so small that there is no interpolation...
         if( bCheckEnd && !!filterreturn && (options & CFO_FillCheckedConfiguration) ) {
@@ -32,6 +32,7 @@
 #else
 #define OPENRAVE_LAZY_LOADING true
 #include <dlfcn.h>
+#include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <dirent.h>
@@ -51,6 +52,8 @@
 
 #include <boost/thread/condition.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
 
 #ifdef _WIN32
 const char s_filesep = '\\';
@@ -72,6 +75,11 @@ class RaveDatabase : public boost::enable_shared_from_this<RaveDatabase>
             if( !!database ) {
                 boost::mutex::scoped_lock lock(database->_mutex);
                 database->_listRegisteredInterfaces.erase(_iterator);
+                InterfaceKey key(_type, utils::ConvertToLowerCase(_name));
+                RegisteredInterfaceMap::iterator itindex = database->_mapRegisteredInterfaces.find(key);
+                if( itindex != database->_mapRegisteredInterfaces.end() && itindex->second.expired() ) {
+                    database->_mapRegisteredInterfaces.erase(itindex);
+                }
             }
         }
 
@@ -84,6 +92,10 @@ protected:
     };
     typedef boost::shared_ptr<RegisteredInterface> RegisteredInterfacePtr;
 
+    /// \brief interface type and lower case interface name
+    typedef std::pair<InterfaceType, std::string> InterfaceKey;
+    typedef boost::unordered_map<InterfaceKey, boost::weak_ptr<RegisteredInterface>, boost::hash<InterfaceKey> > RegisteredInterfaceMap;
+
 public:
     class Plugin : public UserData, public boost::enable_shared_from_this<Plugin>
     {
@@ -218,6 +230,9 @@ public:
             if( name.size() == 0 ) {
                 return false;
             }
+            if( _setBadInterfaces.find(make_pair(type,utils::ConvertToLowerCase(name))) != _setBadInterfaces.end() ) {
+                return false;
+            }
             std::map<InterfaceType, std::vector<std::string> >::iterator itregisterednames = _infocached.interfacenames.find(type);
             if( itregisterednames == _infocached.interfacenames.end() ) {
                 return false;
@@ -232,10 +247,6 @@ public:
 
         InterfaceBasePtr CreateInterface(InterfaceType type, const std::string& name, const char* interfacehash, EnvironmentBasePtr penv) {
             pair< InterfaceType, string> p(type,utils::ConvertToLowerCase(name));
-            if( _setBadInterfaces.find(p) != _setBadInterfaces.end() ) {
-                return InterfaceBasePtr();
-            }
-
             if( !HasInterface(type,name) ) {
                 return InterfaceBasePtr();
             }
@@ -312,9 +323,10 @@ protected:
     };
     typedef boost::shared_ptr<Plugin> PluginPtr;
     typedef boost::shared_ptr<Plugin const> PluginConstPtr;
+    typedef boost::unordered_map<InterfaceKey, PluginPtr, boost::hash<InterfaceKey> > PluginInterfaceMap;
     friend class Plugin;
 
-    RaveDatabase() : _bShutdown(false) {
+    RaveDatabase() : _bPluginCacheModified(false), _bShutdown(false) {
     }
     virtual ~RaveDatabase() {
         Destroy();
@@ -360,9 +372,12 @@ protected:
         return RaveInterfaceCast<SpaceSamplerBase>(Create(penv, PT_SpaceSampler, name));
     }
 
-    virtual bool Init(bool bLoadAllPlugins)
+    /// \param plugincachefilename if not empty, the file storing the attributes of previously loaded plugins. Plugins whose file did not change since are added without being opened.
+    virtual bool Init(bool bLoadAllPlugins, const std::string& plugincachefilename=std::string())
     {
         _threadPluginLoader.reset(new boost::thread(boost::bind(&RaveDatabase::_PluginLoaderThread, this)));
+        _plugincachefilename = plugincachefilename;
+        _LoadPluginCache();
         std::vector<std::string> vplugindirs;
 #ifdef _WIN32
         const char* delim = ";";
@@ -446,6 +461,7 @@ protected:
         {
             boost::mutex::scoped_lock lock(_mutex);
             _listplugins.clear();
+            _mapInterfacePlugins.clear();
         }
         // cannot lock mutex due to __erase_iterator
         // cannot clear _listRegisteredInterfaces since there are destructors that will remove items from the list
@@ -493,69 +509,61 @@ protected:
                 return InterfaceBasePtr();
             }
 
-            // have to copy in order to allow plugins to register stuff inside their creation methods
-            std::list< boost::weak_ptr<RegisteredInterface> > listRegisteredInterfaces;
-            list<PluginPtr> listplugins;
+            // most names are exactly a registered interface name, so look them up in the index first
+            RegisteredInterfacePtr registrationindexed;
+            PluginPtr pluginindexed;
             {
+                InterfaceKey key(type, utils::ConvertToLowerCase(name.substr(0,nInterfaceNameLength)));
                 boost::mutex::scoped_lock lock(_mutex);
-                listRegisteredInterfaces = _listRegisteredInterfaces;
-                listplugins = _listplugins;
+                RegisteredInterfaceMap::iterator itregistration = _mapRegisteredInterfaces.find(key);
+                if( itregistration != _mapRegisteredInterfaces.end() ) {
+                    registrationindexed = itregistration->second.lock();
+                }
+                if( !registrationindexed ) {
+                    PluginInterfaceMap::iterator itplugin = _mapInterfacePlugins.find(key);
+                    if( itplugin != _mapInterfacePlugins.end() ) {
+                        pluginindexed = itplugin->second;
+                    }
+                }
             }
-            FOREACH(it, listRegisteredInterfaces) {
-                RegisteredInterfacePtr registration = it->lock();
-                if( !!registration ) {
-                    if(( nInterfaceNameLength >= registration->_name.size()) &&( _strnicmp(name.c_str(),registration->_name.c_str(),registration->_name.size()) == 0) ) {
-                        std::stringstream sinput(name);
-                        std::string interfacename;
-                        sinput >> interfacename;
-                        std::transform(interfacename.begin(), interfacename.end(), interfacename.begin(), ::tolower);
-                        pointer = registration->_createfn(penv,sinput);
-                        if( !!pointer ) {
-                            if( pointer->GetInterfaceType() != type ) {
-                                RAVELOG_FATAL(str(boost::format("plugin interface name %s, type %s, types do not match\n")%name%RaveGetInterfaceName(type)));
-                                pointer.reset();
-                            }
-                            else {
-                                pointer = InterfaceBasePtr(pointer.get(), utils::smart_pointer_deleter<InterfaceBasePtr>(pointer,INTERFACE_PREDELETER));
-                                pointer->__strpluginname = "__internal__";
-                                pointer->__strxmlid = name;
-                                //pointer->__plugin; // need to protect resources?
+            if( !!registrationindexed ) {
+                pointer = _CreateFromRegistration(registrationindexed, penv, type, name);
+            }
+            else if( !!pluginindexed ) {
+                pointer = _CreateFromPlugin(pluginindexed, penv, type, name);
+            }
+
+            if( !pointer ) {
+                // names can also match the interface names as a prefix, so have to go through everything.
+                // have to copy in order to allow plugins to register stuff inside their creation methods
+                std::list< boost::weak_ptr<RegisteredInterface> > listRegisteredInterfaces;
+                list<PluginPtr> listplugins;
+                {
+                    boost::mutex::scoped_lock lock(_mutex);
+                    listRegisteredInterfaces = _listRegisteredInterfaces;
+                    listplugins = _listplugins;
+                }
+                FOREACH(it, listRegisteredInterfaces) {
+                    RegisteredInterfacePtr registration = it->lock();
+                    if( !!registration && registration != registrationindexed ) {
+                        if(( nInterfaceNameLength >= registration->_name.size()) &&( _strnicmp(name.c_str(),registration->_name.c_str(),registration->_name.size()) == 0) ) {
+                            pointer = _CreateFromRegistration(registration, penv, type, name);
+                            if( !!pointer ) {
                                 break;
                             }
                         }
                     }
                 }
-            }
 
-            if( !pointer ) {
-                const char* hash = RaveGetInterfaceHash(type);
-                list<PluginPtr>::iterator itplugin = listplugins.begin();
-                while(itplugin != listplugins.end()) {
-                    pointer = (*itplugin)->CreateInterface(type, name, hash, penv);
-                    if( !!pointer ) {
-                        if( strcmp(pointer->GetHash(), hash) ) {
-                            RAVELOG_FATAL(str(boost::format("plugin interface name %s, %s has invalid hash, might be compiled with stale openrave files\n")%name%RaveGetInterfaceName(type)));
-                            (*itplugin)->_setBadInterfaces.insert(make_pair(type,utils::ConvertToLowerCase(name)));
-                            pointer.reset();
-                        }
-                        else if( pointer->GetInterfaceType() != type ) {
-                            RAVELOG_FATAL(str(boost::format("plugin interface name %s, type %s, types do not match\n")%name%RaveGetInterfaceName(type)));
-                            (*itplugin)->_setBadInterfaces.insert(make_pair(type,utils::ConvertToLowerCase(name)));
-                            pointer.reset();
-                        }
-                        else {
-                            pointer = InterfaceBasePtr(pointer.get(), utils::smart_pointer_deleter<InterfaceBasePtr>(pointer,INTERFACE_PREDELETER, INTERFACE_POSTDELETER(name, *itplugin)));
-                            pointer->__strpluginname = (*itplugin)->ppluginname;
-                            pointer->__strxmlid = name;
-                            pointer->__plugin = *itplugin;
-                            break;
+                if( !pointer ) {
+                    FOREACH(itplugin, listplugins) {
+                        if( *itplugin != pluginindexed ) {
+                            pointer = _CreateFromPlugin(*itplugin, penv, type, name);
+                            if( !!pointer ) {
+                                break;
+                            }
                         }
                     }
-                    if( !(*itplugin)->IsValid() ) {
-                        boost::mutex::scoped_lock lock(_mutex);
-                        _listplugins.remove(*itplugin);
-                    }
-                    ++itplugin;
                 }
             }
         }
@@ -583,50 +591,10 @@ protected:
     /// If pdir is already specified, reloads all
     bool AddDirectory(const std::string& pdir)
     {
-#ifdef _WIN32
-        WIN32_FIND_DATAA FindFileData;
-        HANDLE hFind;
-        string strfind = pdir;
-        strfind += "\\*";
-        strfind += PLUGIN_EXT;
-
-        hFind = FindFirstFileA(strfind.c_str(), &FindFileData);
-        if (hFind == INVALID_HANDLE_VALUE) {
-            RAVELOG_DEBUG("No plugins in dir: %s (GetLastError reports %d)\n", pdir.c_str(), GetLastError ());
-            return false;
-        }
-        else  {
-            do {
-                RAVELOG_DEBUG("Adding plugin %s\n", FindFileData.cFileName);
-                string strplugin = pdir;
-                strplugin += "\\";
-                strplugin += FindFileData.cFileName;
-                LoadPlugin(strplugin.c_str());
-            } while (FindNextFileA(hFind, &FindFileData) != 0);
-            FindClose(hFind);
-        }
-#else
-        // linux
-        DIR *dp;
-        struct dirent *ep;
-        dp = opendir (pdir.c_str());
-        if (dp != NULL) {
-            while ( (ep = readdir (dp)) != NULL ) {
-                // check for a .so in every file
-                if( strstr(ep->d_name, PLUGIN_EXT) != NULL ) {
-                    string strplugin = pdir;
-                    strplugin += "/";
-                    strplugin += ep->d_name;
-                    LoadPlugin(strplugin.c_str());
-                }
-            }
-            (void) closedir (dp);
-        }
-        else {
-            RAVELOG_DEBUG("Couldn't open directory %s\n", pdir.c_str());
-        }
-#endif
-        return true;
+        bool bsuccess = _AddDirectory(pdir);
+        boost::mutex::scoped_lock lock(_mutex);
+        _SavePluginCache();
+        return bsuccess;
     }
 
     void ReloadPlugins()
@@ -638,28 +606,17 @@ protected:
                 *itplugin = newplugin;
             }
         }
+        _UpdateInterfaceIndex();
         _CleanupUnusedLibraries();
+        _SavePluginCache();
     }
 
     bool LoadPlugin(const std::string& pluginname)
     {
+        bool bsuccess = _AddPlugin(pluginname);
         boost::mutex::scoped_lock lock(_mutex);
-        std::list<PluginPtr>::iterator it = _GetPlugin(pluginname);
-        string newpluginname;
-        if( it != _listplugins.end() ) {
-            // since we got a match, use the old name and remove the old library
-            newpluginname = (*it)->ppluginname;
-            _listplugins.erase(it);
-        }
-        else {
-            newpluginname = pluginname;
-        }
-        PluginPtr p = _LoadPlugin(newpluginname);
-        if( !!p ) {
-            _listplugins.push_back(p);
-        }
-        _CleanupUnusedLibraries();
-        return !!p;
+        _SavePluginCache();
+        return bsuccess;
     }
 
     bool RemovePlugin(const std::string& pluginname)
@@ -670,6 +627,7 @@ protected:
             return false;
         }
         _listplugins.erase(it);
+        _UpdateInterfaceIndex();
         _CleanupUnusedLibraries();
         return true;
     }
@@ -677,6 +635,10 @@ protected:
     virtual bool HasInterface(InterfaceType type, const string& interfacename)
     {
         boost::mutex::scoped_lock lock(_mutex);
+        InterfaceKey key(type, utils::ConvertToLowerCase(interfacename));
+        if( _mapInterfacePlugins.find(key) != _mapInterfacePlugins.end() ) {
+            return true;
+        }
         FOREACHC(it,_listRegisteredInterfaces) {
             RegisteredInterfacePtr registration = it->lock();
             if( !!registration ) {
@@ -753,6 +715,11 @@ protected:
         boost::mutex::scoped_lock lock(_mutex);
         RegisteredInterfacePtr pdata(new RegisteredInterface(type,name,createfn,shared_from_this()));
         pdata->_iterator = _listRegisteredInterfaces.insert(_listRegisteredInterfaces.end(),pdata);
+        // first registration wins, the same as the order the list is searched in
+        boost::weak_ptr<RegisteredInterface>& indexed = _mapRegisteredInterfaces[InterfaceKey(type,utils::ConvertToLowerCase(name))];
+        if( indexed.expired() ) {
+            indexed = pdata;
+        }
         return pdata;
     }
 
@@ -761,6 +728,313 @@ protected:
     }
 
 protected:
+    InterfaceBasePtr _CreateFromRegistration(RegisteredInterfacePtr registration, EnvironmentBasePtr penv, InterfaceType type, const std::string& name)
+    {
+        std::stringstream sinput(name);
+        std::string interfacename;
+        sinput >> interfacename;
+        std::transform(interfacename.begin(), interfacename.end(), interfacename.begin(), ::tolower);
+        InterfaceBasePtr pointer = registration->_createfn(penv,sinput);
+        if( !!pointer ) {
+            if( pointer->GetInterfaceType() != type ) {
+                RAVELOG_FATAL(str(boost::format("plugin interface name %s, type %s, types do not match\n")%name%RaveGetInterfaceName(type)));
+                pointer.reset();
+            }
+            else {
+                pointer = InterfaceBasePtr(pointer.get(), utils::smart_pointer_deleter<InterfaceBasePtr>(pointer,INTERFACE_PREDELETER));
+                pointer->__strpluginname = "__internal__";
+                pointer->__strxmlid = name;
+                //pointer->__plugin; // need to protect resources?
+            }
+        }
+        return pointer;
+    }
+
+    InterfaceBasePtr _CreateFromPlugin(PluginPtr plugin, EnvironmentBasePtr penv, InterfaceType type, const std::string& name)
+    {
+        const char* hash = RaveGetInterfaceHash(type);
+        InterfaceBasePtr pointer = plugin->CreateInterface(type, name, hash, penv);
+        if( !!pointer ) {
+            if( strcmp(pointer->GetHash(), hash) ) {
+                RAVELOG_FATAL(str(boost::format("plugin interface name %s, %s has invalid hash, might be compiled with stale openrave files\n")%name%RaveGetInterfaceName(type)));
+                plugin->_setBadInterfaces.insert(make_pair(type,utils::ConvertToLowerCase(name)));
+                pointer.reset();
+            }
+            else if( pointer->GetInterfaceType() != type ) {
+                RAVELOG_FATAL(str(boost::format("plugin interface name %s, type %s, types do not match\n")%name%RaveGetInterfaceName(type)));
+                plugin->_setBadInterfaces.insert(make_pair(type,utils::ConvertToLowerCase(name)));
+                pointer.reset();
+            }
+            else {
+                pointer = InterfaceBasePtr(pointer.get(), utils::smart_pointer_deleter<InterfaceBasePtr>(pointer,INTERFACE_PREDELETER, INTERFACE_POSTDELETER(name, plugin)));
+                pointer->__strpluginname = plugin->ppluginname;
+                pointer->__strxmlid = name;
+                pointer->__plugin = plugin;
+                return pointer;
+            }
+        }
+        if( !plugin->IsValid() ) {
+            boost::mutex::scoped_lock lock(_mutex);
+            _listplugins.remove(plugin);
+            _UpdateInterfaceIndex();
+        }
+        return pointer;
+    }
+
+    /// \brief rebuilds the lookup from (type, lower case interface name) to the plugin offering it, has to be called whenever _listplugins changes.
+    ///
+    /// Plugins earlier in the list take precedence, which is the same order Create searches in. Assumes _mutex is locked.
+    void _UpdateInterfaceIndex()
+    {
+        _mapInterfacePlugins.clear();
+        FOREACHC(itplugin, _listplugins) {
+            FOREACHC(ittype, (*itplugin)->_infocached.interfacenames) {
+                FOREACHC(itname, ittype->second) {
+                    _mapInterfacePlugins.insert(make_pair(InterfaceKey(ittype->first, utils::ConvertToLowerCase(*itname)), *itplugin));
+                }
+            }
+        }
+    }
+
+    /// \brief gets the modification time and size of a plugin file for validating the plugin cache
+    ///
+    /// The time keeps the full resolution of the file system (nanoseconds, 100 nanoseconds on Windows), so a plugin rebuilt within the same second is not taken from the cache.
+    static bool _GetPluginFileStamp(const std::string& filename, int64_t& modifiedtime, uint64_t& filesize)
+    {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA fileattributes;
+        if( !GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &fileattributes) || (fileattributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ) {
+            return false;
+        }
+        modifiedtime = static_cast<int64_t>((static_cast<uint64_t>(fileattributes.ftLastWriteTime.dwHighDateTime)<<32)|fileattributes.ftLastWriteTime.dwLowDateTime);
+        filesize = (static_cast<uint64_t>(fileattributes.nFileSizeHigh)<<32)|fileattributes.nFileSizeLow;
+        return true;
+#else
+        struct stat filestat;
+        if( stat(filename.c_str(), &filestat) != 0 || !S_ISREG(filestat.st_mode) ) {
+            RAVELOG_VERBOSE(str(boost::format("failed to stat %s")%filename));
+            return false;
+        }
+#ifdef __APPLE_CC__
+        modifiedtime = static_cast<int64_t>(filestat.st_mtimespec.tv_sec)*1000000000 + filestat.st_mtimespec.tv_nsec;
+#else
+        modifiedtime = static_cast<int64_t>(filestat.st_mtim.tv_sec)*1000000000 + filestat.st_mtim.tv_nsec;
+#endif
+        filesize = static_cast<uint64_t>(filestat.st_size);
+        return true;
+#endif
+    }
+
+    /// \brief reads the plugin cache file. The cache is discarded if it was written by a different plugin interface.
+    void _LoadPluginCache()
+    {
+        _mapPluginCache.clear();
+        _bPluginCacheModified = false;
+        if( _plugincachefilename.size() == 0 ) {
+            return;
+        }
+        ifstream f(_plugincachefilename.c_str());
+        if( !f ) {
+            return;
+        }
+        std::string line, header, pluginhash;
+        if( !getline(f, line) ) {
+            return;
+        }
+        std::stringstream sheader(line);
+        sheader >> header >> pluginhash;
+        if( header != "openrave_plugincache" || pluginhash != OPENRAVE_PLUGININFO_HASH ) {
+            RAVELOG_DEBUG(str(boost::format("ignoring stale plugin cache %s")%_plugincachefilename));
+            return;
+        }
+        std::string pluginname;
+        while( getline(f, pluginname) && getline(f, line) ) {
+            std::stringstream sentry(line);
+            PluginCacheEntry entry;
+            size_t numtypes = 0;
+            sentry >> entry.modifiedtime >> entry.filesize >> entry.info.version >> numtypes;
+            for(size_t itype = 0; itype < numtypes && !!sentry; ++itype) {
+                int type = 0;
+                size_t numnames = 0;
+                sentry >> type >> numnames;
+                std::vector<std::string>& vnames = entry.info.interfacenames[static_cast<InterfaceType>(type)];
+                vnames.resize(numnames);
+                FOREACH(itname, vnames) {
+                    sentry >> *itname;
+                }
+            }
+            if( !sentry ) {
+                RAVELOG_WARN(str(boost::format("plugin cache %s is corrupted, ignoring")%_plugincachefilename));
+                _mapPluginCache.clear();
+                return;
+            }
+            _mapPluginCache[pluginname] = entry;
+        }
+    }
+
+    /// \brief writes the plugin cache if new plugins were recorded since it was read. Assumes _mutex is locked.
+    void _SavePluginCache()
+    {
+        if( !_bPluginCacheModified || _plugincachefilename.size() == 0 ) {
+            return;
+        }
+        // write to a temporary file first so that other processes never read a partially written cache
+#ifdef _WIN32
+        unsigned long processid = GetCurrentProcessId();
+#else
+        unsigned long processid = getpid();
+#endif
+        std::string tempfilename = str(boost::format("%s.%d")%_plugincachefilename%processid);
+        {
+            ofstream f(tempfilename.c_str());
+            if( !f ) {
+                RAVELOG_DEBUG(str(boost::format("failed to write plugin cache %s")%tempfilename));
+                return;
+            }
+            f << "openrave_plugincache " << OPENRAVE_PLUGININFO_HASH << " " << OPENRAVE_VERSION_STRING << endl;
+            FOREACHC(itentry, _mapPluginCache) {
+                f << itentry->first << endl;
+                f << itentry->second.modifiedtime << " " << itentry->second.filesize << " " << itentry->second.info.version << " " << itentry->second.info.interfacenames.size();
+                FOREACHC(ittype, itentry->second.info.interfacenames) {
+                    f << " " << static_cast<int>(ittype->first) << " " << ittype->second.size();
+                    FOREACHC(itname, ittype->second) {
+                        f << " " << *itname;
+                    }
+                }
+                f << endl;
+            }
+        }
+#ifdef HAVE_BOOST_FILESYSTEM
+        try {
+            boost::filesystem::rename(boost::filesystem::path(tempfilename), boost::filesystem::path(_plugincachefilename));
+            _bPluginCacheModified = false;
+        }
+        catch(const boost::filesystem::filesystem_error& ex) {
+            RAVELOG_DEBUG(str(boost::format("failed to write plugin cache %s: %s")%_plugincachefilename%ex.what()));
+            boost::system::error_code ec;
+            boost::filesystem::remove(boost::filesystem::path(tempfilename), ec);
+        }
+#else
+#ifdef _WIN32
+        // rename does not replace an existing file on windows
+        remove(_plugincachefilename.c_str());
+#endif
+        if( rename(tempfilename.c_str(), _plugincachefilename.c_str()) == 0 ) {
+            _bPluginCacheModified = false;
+        }
+        else {
+            RAVELOG_DEBUG(str(boost::format("failed to write plugin cache %s")%_plugincachefilename));
+            remove(tempfilename.c_str());
+        }
+#endif
+    }
+
+    /// \brief creates the plugin from the cached attributes without opening the library if the file did not change since it was cached.
+    ///
+    /// The library is opened by the loader thread the first time an interface is created from it.
+    PluginPtr _LoadPluginFromCache(const std::string& libraryname)
+    {
+        std::map<std::string, PluginCacheEntry>::const_iterator itentry = _mapPluginCache.find(libraryname);
+        if( itentry == _mapPluginCache.end() ) {
+            return PluginPtr();
+        }
+        int64_t modifiedtime = 0;
+        uint64_t filesize = 0;
+        if( !_GetPluginFileStamp(libraryname, modifiedtime, filesize) || modifiedtime != itentry->second.modifiedtime || filesize != itentry->second.filesize ) {
+            return PluginPtr();
+        }
+        PluginPtr p(new Plugin(shared_from_this()));
+        p->ppluginname = libraryname;
+        p->_infocached = itentry->second.info;
+        p->_bInitializing = false;
+        RAVELOG_VERBOSE(str(boost::format("loading plugin from cache: %s")%libraryname));
+        return p;
+    }
+
+    void _AddPluginCacheEntry(const std::string& libraryname, const PLUGININFO& info)
+    {
+        if( _plugincachefilename.size() == 0 ) {
+            return;
+        }
+        PluginCacheEntry entry;
+        if( _GetPluginFileStamp(libraryname, entry.modifiedtime, entry.filesize) ) {
+            entry.info = info;
+            _mapPluginCache[libraryname] = entry;
+            _bPluginCacheModified = true;
+        }
+    }
+
+    bool _AddDirectory(const std::string& pdir)
+    {
+#ifdef _WIN32
+        WIN32_FIND_DATAA FindFileData;
+        HANDLE hFind;
+        string strfind = pdir;
+        strfind += "\\*";
+        strfind += PLUGIN_EXT;
+
+        hFind = FindFirstFileA(strfind.c_str(), &FindFileData);
+        if (hFind == INVALID_HANDLE_VALUE) {
+            RAVELOG_DEBUG("No plugins in dir: %s (GetLastError reports %d)\n", pdir.c_str(), GetLastError ());
+            return false;
+        }
+        else  {
+            do {
+                RAVELOG_DEBUG("Adding plugin %s\n", FindFileData.cFileName);
+                string strplugin = pdir;
+                strplugin += "\\";
+                strplugin += FindFileData.cFileName;
+                _AddPlugin(strplugin);
+            } while (FindNextFileA(hFind, &FindFileData) != 0);
+            FindClose(hFind);
+        }
+#else
+        // linux
+        DIR *dp;
+        struct dirent *ep;
+        dp = opendir (pdir.c_str());
+        if (dp != NULL) {
+            while ( (ep = readdir (dp)) != NULL ) {
+                // check for a .so in every file
+                if( strstr(ep->d_name, PLUGIN_EXT) != NULL ) {
+                    string strplugin = pdir;
+                    strplugin += "/";
+                    strplugin += ep->d_name;
+                    _AddPlugin(strplugin);
+                }
+            }
+            (void) closedir (dp);
+        }
+        else {
+            RAVELOG_DEBUG("Couldn't open directory %s\n", pdir.c_str());
+        }
+#endif
+        return true;
+    }
+
+    /// \brief loads the plugin and adds it to the database without saving the plugin cache
+    bool _AddPlugin(const std::string& pluginname)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        std::list<PluginPtr>::iterator it = _GetPlugin(pluginname);
+        string newpluginname;
+        if( it != _listplugins.end() ) {
+            // since we got a match, use the old name and remove the old library
+            newpluginname = (*it)->ppluginname;
+            _listplugins.erase(it);
+        }
+        else {
+            newpluginname = pluginname;
+        }
+        PluginPtr p = _LoadPlugin(newpluginname);
+        if( !!p ) {
+            _listplugins.push_back(p);
+        }
+        _UpdateInterfaceIndex();
+        _CleanupUnusedLibraries();
+        return !!p;
+    }
+
     void _CleanupUnusedLibraries()
     {
         FOREACH(it,_listDestroyLibraryQueue) {
@@ -805,6 +1079,10 @@ protected:
 
     PluginPtr _LoadPlugin(const string& _libraryname)
     {
+        PluginPtr pcached = _LoadPluginFromCache(_libraryname);
+        if( !!pcached ) {
+            return pcached;
+        }
         string libraryname = _libraryname;
         void* plibrary = _SysLoadLibrary(libraryname.c_str(),OPENRAVE_LAZY_LOADING);
         if( plibrary == NULL ) {
@@ -900,6 +1178,7 @@ protected:
 #endif
 
         p->_bInitializing = false;
+        _AddPluginCacheEntry(libraryname, p->_infocached);
         if( OPENRAVE_LAZY_LOADING ) {
             // have confirmed that plugin is ok, so reload with no-lazy loading
             p->plibrary = NULL;     // NOTE: for some reason, closing the lazy loaded library can make the system crash, so instead keep the pointer around, but create a new one with RTLD_NOW
@@ -1032,6 +1311,21 @@ protected:
     std::list<void*> _listDestroyLibraryQueue;
     std::list< boost::weak_ptr<RegisteredInterface> > _listRegisteredInterfaces;
     std::list<std::string> _listplugindirs;
+    PluginInterfaceMap _mapInterfacePlugins; ///< first plugin offering each interface, updated with _listplugins
+    RegisteredInterfaceMap _mapRegisteredInterfaces; ///< first registered interface of each name
+
+    /// \brief cached attributes of a plugin file
+    struct PluginCacheEntry
+    {
+        PluginCacheEntry() : modifiedtime(0), filesize(0) {
+        }
+        int64_t modifiedtime;
+        uint64_t filesize;
+        PLUGININFO info;
+    };
+    std::map<std::string, PluginCacheEntry> _mapPluginCache; ///< indexed by the plugin filename
+    std::string _plugincachefilename;
+    bool _bPluginCacheModified;
 
     /// \name plugin loading
     //@{
@@ -0,0 +1,576 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2014 Rosen Diankov (rosen.diankov@gmail.com)
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include "libopenrave.h"
+
+#include <boost/atomic.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstring>
+
+namespace OpenRAVE {
+
+namespace {
+
+/// \brief counter updated by the owning thread without locking while the queries read and reset it, copyable so the nodes can be stored in vectors
+struct ProfileCounter
+{
+    ProfileCounter() : value(0) {
+    }
+    ProfileCounter(const ProfileCounter& r) : value(r.Get()) {
+    }
+    ProfileCounter& operator=(const ProfileCounter& r) {
+        value.store(r.Get(), boost::memory_order_relaxed);
+        return *this;
+    }
+    uint64_t Get() const {
+        return value.load(boost::memory_order_relaxed);
+    }
+    void Add(uint64_t n) {
+        value.fetch_add(n, boost::memory_order_relaxed);
+    }
+    void Reset() {
+        value.store(0, boost::memory_order_relaxed);
+    }
+    boost::atomic<uint64_t> value;
+};
+
+/// \brief node of the call tree of one thread, children are linked through nextsibling
+struct ProfileThreadNode
+{
+    ProfileThreadNode(const char* name, int envid, int parent) : name(name), envid(envid), parent(parent), firstchild(-1), nextsibling(-1) {
+    }
+    const char* name;
+    int envid;
+    int parent, firstchild, nextsibling;
+    ProfileCounter numcalls, totaltime;
+};
+
+/// \brief one recorded zone call
+struct ProfileEvent
+{
+    const char* name;
+    int envid;
+    int threadindex;
+    uint64_t starttime, duration;
+};
+
+/// \brief number of events a thread collects before appending them to the queryable events
+static const size_t s_nProfileEventBatch = 64;
+
+/** \brief call trees of one thread.
+
+    Only the owning thread changes the nodes and it updates the atomic counters without locking. The mutex is only taken when
+    nodes or a batch of events are added, and by the queries. Resetting from another thread clears the counters in place.
+ */
+class ProfileThreadData
+{
+public:
+    ProfileThreadData(int threadindex) : _current(-1), _threadindex(threadindex), _destroyedgeneration(0) {
+    }
+
+    /// \brief returns the root node of the environment, creates it if not present
+    int GetRoot(int envid)
+    {
+        FOREACHC(itroot, _vroots) {
+            if( _vnodes[*itroot].envid == envid ) {
+                return *itroot;
+            }
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        _vnodes.push_back(ProfileThreadNode(NULL, envid, -1));
+        _vroots.push_back(_vnodes.size()-1);
+        return _vroots.back();
+    }
+
+    /// \brief returns the child zone of the node, creates it if not present
+    int GetChild(int parent, const char* name)
+    {
+        for(int child = _vnodes[parent].firstchild; child >= 0; child = _vnodes[child].nextsibling) {
+            // the same literal used from different translation units can have different pointers
+            if( _vnodes[child].name == name || strcmp(_vnodes[child].name, name) == 0 ) {
+                return child;
+            }
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        int child = _vnodes.size();
+        _vnodes.push_back(ProfileThreadNode(name, _vnodes[parent].envid, parent));
+        _vnodes[child].nextsibling = _vnodes[parent].firstchild;
+        _vnodes[parent].firstchild = child;
+        return child;
+    }
+
+    /// \brief records the event, the batch is appended when it is full or when the outermost zone exits
+    void AddEvent(const ProfileEvent& event, size_t maxevents)
+    {
+        if( _vevents.size()+_vbatchevents.size() < maxevents ) {
+            _vbatchevents.push_back(event);
+        }
+        if( _vbatchevents.size() > 0 && (_vbatchevents.size() >= s_nProfileEventBatch || _current < 0) ) {
+            boost::mutex::scoped_lock lock(_mutex);
+            _vevents.insert(_vevents.end(), _vbatchevents.begin(), _vbatchevents.end());
+            _vbatchevents.resize(0);
+        }
+    }
+
+    /// \brief removes the nodes and events of the environments. Has to be called by the owning thread when no zone is active since the node indices change.
+    void RemoveEnvironments(const std::set<int>& setenvids)
+    {
+        std::vector<int> vnewindices(_vnodes.size(), -1);
+        std::vector<ProfileThreadNode> vnodes;
+        vnodes.reserve(_vnodes.size());
+        for(size_t i = 0; i < _vnodes.size(); ++i) {
+            if( setenvids.find(_vnodes[i].envid) == setenvids.end() ) {
+                vnewindices[i] = vnodes.size();
+                vnodes.push_back(_vnodes[i]);
+            }
+        }
+        if( vnodes.size() == _vnodes.size() ) {
+            return;
+        }
+        // the nodes of an environment only link to each other, so all links of the kept nodes are kept
+        FOREACH(itnode, vnodes) {
+            itnode->parent = itnode->parent >= 0 ? vnewindices[itnode->parent] : -1;
+            itnode->firstchild = itnode->firstchild >= 0 ? vnewindices[itnode->firstchild] : -1;
+            itnode->nextsibling = itnode->nextsibling >= 0 ? vnewindices[itnode->nextsibling] : -1;
+        }
+        std::vector<int> vroots;
+        FOREACHC(itroot, _vroots) {
+            if( vnewindices[*itroot] >= 0 ) {
+                vroots.push_back(vnewindices[*itroot]);
+            }
+        }
+        std::vector<ProfileEvent> vevents;
+        FOREACHC(itevent, _vevents) {
+            if( setenvids.find(itevent->envid) == setenvids.end() ) {
+                vevents.push_back(*itevent);
+            }
+        }
+        boost::mutex::scoped_lock lock(_mutex);
+        _vnodes.swap(vnodes);
+        _vroots.swap(vroots);
+        _vevents.swap(vevents);
+    }
+
+    boost::mutex _mutex;
+    std::vector<ProfileThreadNode> _vnodes;
+    std::vector<int> _vroots; ///< root node of every environment
+    std::vector<ProfileEvent> _vevents; ///< events that can be queried
+    std::vector<ProfileEvent> _vbatchevents; ///< events only accessed by the owning thread
+    int _current; ///< node of the innermost active zone, -1 if none
+    int _threadindex;
+    int _destroyedgeneration; ///< generation of the destroyed environments that were removed from the nodes
+};
+
+typedef boost::shared_ptr<ProfileThreadData> ProfileThreadDataPtr;
+
+void _MergeProfileNode(const ProfileThreadData& data, int inode, ProfileNode& node);
+
+class ProfilerGlobal
+{
+public:
+    ProfilerGlobal() : _bProfiling(false), _maxevents(0), _destroyedgeneration(0), _nextthreadindex(0), _threaddata(&ProfilerGlobal::_CleanupThreadData) {
+    }
+
+    ProfileThreadData* GetThreadData()
+    {
+        ProfileThreadDataPtr* pdata = _threaddata.get();
+        if( !pdata ) {
+            boost::mutex::scoped_lock lock(_mutex);
+            pdata = new ProfileThreadDataPtr(new ProfileThreadData(_nextthreadindex++));
+            (*pdata)->_destroyedgeneration = _destroyedgeneration;
+            _listthreads.push_back(*pdata);
+            _threaddata.reset(pdata);
+        }
+        return pdata->get();
+    }
+
+    /// \brief copies the thread data pointers so queries do not hold the global lock
+    void GetThreads(std::vector<ProfileThreadDataPtr>& vthreads)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        vthreads.assign(_listthreads.begin(), _listthreads.end());
+    }
+
+    /// \brief removes the nodes of the destroyed environments from the thread, called by the owning thread
+    void RemoveDestroyedEnvironments(ProfileThreadData& data)
+    {
+        std::set<int> setenvids;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            setenvids = _setdestroyedenvs;
+            data._destroyedgeneration = _destroyedgeneration;
+        }
+        data.RemoveEnvironments(setenvids);
+    }
+
+    /// \brief adds the profile of the threads that exited
+    void GetFinishedProfile(int envid, ProfileNode& root)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        std::map<int, ProfileNode>::const_iterator it = _mapfinished.find(envid);
+        if( it != _mapfinished.end() ) {
+            _MergeNode(it->second, root);
+        }
+    }
+
+    /// \brief adds the events of the threads that exited
+    void GetFinishedEvents(int envid, std::vector<ProfileEvent>& vevents)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        FOREACHC(itevent, _vfinishedevents) {
+            if( itevent->envid == envid ) {
+                vevents.push_back(*itevent);
+            }
+        }
+    }
+
+    void ResetFinished(int envid)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        std::map<int, ProfileNode>::iterator it = _mapfinished.find(envid);
+        if( it != _mapfinished.end() ) {
+            _ResetNode(it->second);
+        }
+        _RemoveFinishedEvents(envid);
+    }
+
+    /// \brief removes the profile of the environment. The other threads remove their nodes the next time they enter a zone or when they exit.
+    void DestroyEnvironment(int envid)
+    {
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            _setdestroyedenvs.insert(envid);
+            _mapfinished.erase(envid);
+            _RemoveFinishedEvents(envid);
+            ++_destroyedgeneration;
+        }
+        ProfileThreadDataPtr* pdata = _threaddata.get();
+        if( !!pdata && (*pdata)->_current < 0 ) {
+            RemoveDestroyedEnvironments(**pdata);
+        }
+    }
+
+    bool IsDestroyed(int envid)
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        return _setdestroyedenvs.find(envid) != _setdestroyedenvs.end();
+    }
+
+    volatile bool _bProfiling;
+    size_t _maxevents; ///< max events recorded per thread
+    volatile int _destroyedgeneration; ///< incremented every time an environment is destroyed
+
+private:
+    /// \brief called at thread exit, the profile of the thread is merged into the finished profile and the thread is removed
+    static void _CleanupThreadData(ProfileThreadDataPtr* pdata);
+
+    static void _MergeNode(const ProfileNode& src, ProfileNode& dest)
+    {
+        dest.numcalls += src.numcalls;
+        dest.totaltime += src.totaltime;
+        FOREACHC(itsrcchild, src.children) {
+            std::vector<ProfileNode>::iterator itchild = dest.children.begin();
+            while(itchild != dest.children.end() && itchild->name != itsrcchild->name) {
+                ++itchild;
+            }
+            if( itchild == dest.children.end() ) {
+                dest.children.push_back(ProfileNode());
+                dest.children.back().name = itsrcchild->name;
+                itchild = dest.children.end()-1;
+            }
+            _MergeNode(*itsrcchild, *itchild);
+        }
+    }
+
+    static void _ResetNode(ProfileNode& node)
+    {
+        node.numcalls = 0;
+        node.totaltime = 0;
+        FOREACH(itchild, node.children) {
+            _ResetNode(*itchild);
+        }
+    }
+
+    void _RemoveFinishedEvents(int envid)
+    {
+        std::vector<ProfileEvent>::iterator itevent = _vfinishedevents.begin();
+        while(itevent != _vfinishedevents.end()) {
+            if( itevent->envid == envid ) {
+                itevent = _vfinishedevents.erase(itevent);
+            }
+            else {
+                ++itevent;
+            }
+        }
+    }
+
+    boost::mutex _mutex;
+    std::list<ProfileThreadDataPtr> _listthreads;
+    std::set<int> _setdestroyedenvs; ///< ids are never reused, so threads can remove the nodes of destroyed environments lazily
+    std::map<int, ProfileNode> _mapfinished; ///< merged call trees of the threads that exited
+    std::vector<ProfileEvent> _vfinishedevents; ///< events of the threads that exited, at most maxevents
+    int _nextthreadindex;
+    boost::thread_specific_ptr<ProfileThreadDataPtr> _threaddata;
+};
+
+static ProfilerGlobal& GetProfilerGlobal()
+{
+    static ProfilerGlobal s_profiler;
+    return s_profiler;
+}
+
+void ProfilerGlobal::_CleanupThreadData(ProfileThreadDataPtr* pdata)
+{
+    ProfileThreadData& data = **pdata;
+    ProfilerGlobal& profiler = GetProfilerGlobal();
+    {
+        boost::mutex::scoped_lock lock(profiler._mutex);
+        FOREACHC(itroot, data._vroots) {
+            int envid = data._vnodes[*itroot].envid;
+            if( profiler._setdestroyedenvs.find(envid) == profiler._setdestroyedenvs.end() ) {
+                ProfileNode root;
+                _MergeProfileNode(data, *itroot, root);
+                _MergeNode(root, profiler._mapfinished[envid]);
+            }
+        }
+        data._vevents.insert(data._vevents.end(), data._vbatchevents.begin(), data._vbatchevents.end());
+        FOREACHC(itevent, data._vevents) {
+            if( profiler._vfinishedevents.size() >= profiler._maxevents ) {
+                break;
+            }
+            if( profiler._setdestroyedenvs.find(itevent->envid) == profiler._setdestroyedenvs.end() ) {
+                profiler._vfinishedevents.push_back(*itevent);
+            }
+        }
+        profiler._listthreads.remove(*pdata);
+    }
+    delete pdata;
+}
+
+/// \brief merges the subtree of a thread node into the output node
+void _MergeProfileNode(const ProfileThreadData& data, int inode, ProfileNode& node)
+{
+    const ProfileThreadNode& threadnode = data._vnodes[inode];
+    node.numcalls += threadnode.numcalls.Get();
+    node.totaltime += threadnode.totaltime.Get();
+    for(int child = threadnode.firstchild; child >= 0; child = data._vnodes[child].nextsibling) {
+        const char* name = data._vnodes[child].name;
+        std::vector<ProfileNode>::iterator itchild = node.children.begin();
+        while(itchild != node.children.end() && itchild->name != name) {
+            ++itchild;
+        }
+        if( itchild == node.children.end() ) {
+            node.children.push_back(ProfileNode());
+            node.children.back().name = name;
+            itchild = node.children.end()-1;
+        }
+        _MergeProfileNode(data, child, *itchild);
+    }
+}
+
+void _WriteChromeTraceEvent(std::ostream& O, bool& bfirst, const std::string& name, uint64_t starttime, uint64_t duration, int pid, int tid)
+{
+    if( !bfirst ) {
+        O << ",";
+    }
+    bfirst = false;
+    O << "\n{\"name\":";
+    utils::WriteJSONString(O, name);
+    // chrome trace times are in microseconds
+    O << ",\"cat\":\"openrave\",\"ph\":\"X\",\"ts\":" << starttime/1000 << "." << std::setw(3) << std::setfill('0') << starttime%1000 << std::setfill(' ');
+    O << ",\"dur\":" << duration/1000 << "." << std::setw(3) << std::setfill('0') << duration%1000 << std::setfill(' ');
+    O << ",\"pid\":" << pid << ",\"tid\":" << tid << "}";
+}
+
+/// \brief writes the merged tree as nested events, children are placed one after another from the start of the parent
+void _WriteChromeTraceNode(std::ostream& O, bool& bfirst, const ProfileNode& node, uint64_t starttime, int pid)
+{
+    _WriteChromeTraceEvent(O, bfirst, node.name, starttime, node.totaltime, pid, 0);
+    FOREACHC(itchild, node.children) {
+        _WriteChromeTraceNode(O, bfirst, *itchild, starttime, pid);
+        starttime += itchild->totaltime;
+    }
+}
+
+} // end namespace
+
+uint64_t ProfileNode::GetSelfTime() const
+{
+    uint64_t childtime = 0;
+    FOREACHC(itchild, children) {
+        childtime += itchild->totaltime;
+    }
+    return totaltime > childtime ? totaltime-childtime : 0;
+}
+
+void ProfileZone::_Enter(const EnvironmentBase* penv, const char* name)
+{
+    ProfilerGlobal& profiler = GetProfilerGlobal();
+    ProfileThreadData* pdata = profiler.GetThreadData();
+    int parent = pdata->_current;
+    if( parent < 0 && pdata->_destroyedgeneration != profiler._destroyedgeneration ) {
+        profiler.RemoveDestroyedEnvironments(*pdata);
+    }
+    int envid = penv->GetId();
+    if( parent < 0 || pdata->_vnodes[parent].envid != envid ) {
+        parent = pdata->GetRoot(envid);
+    }
+    _node = pdata->GetChild(parent, name);
+    _parentnode = pdata->_current;
+    pdata->_current = _node;
+    _pdata = pdata;
+    _starttime = utils::GetNanoPerformanceTime();
+}
+
+void ProfileZone::_Exit()
+{
+    uint64_t duration = utils::GetNanoPerformanceTime()-_starttime;
+    ProfileThreadData* pdata = static_cast<ProfileThreadData*>(_pdata);
+    ProfileThreadNode& node = pdata->_vnodes[_node];
+    node.numcalls.Add(1);
+    node.totaltime.Add(duration);
+    pdata->_current = _parentnode;
+    size_t maxevents = GetProfilerGlobal()._maxevents;
+    if( maxevents > 0 ) {
+        ProfileEvent event;
+        event.name = node.name;
+        event.envid = node.envid;
+        event.threadindex = pdata->_threadindex;
+        event.starttime = _starttime;
+        event.duration = duration;
+        pdata->AddEvent(event, maxevents);
+    }
+}
+
+void RaveSetProfiling(bool benable, size_t maxevents)
+{
+#if !OPENRAVE_PROFILING
+    if( benable ) {
+        RAVELOG_WARN("OpenRAVE was compiled without OPT_PROFILING, so profiling zones are not recorded\n");
+    }
+#endif
+    ProfilerGlobal& profiler = GetProfilerGlobal();
+    profiler._maxevents = maxevents;
+    profiler._bProfiling = benable;
+}
+
+bool RaveIsProfiling()
+{
+    return GetProfilerGlobal()._bProfiling;
+}
+
+void RaveGetProfile(EnvironmentBaseConstPtr penv, ProfileNode& root)
+{
+    root = ProfileNode();
+    int envid = penv->GetId();
+    if( GetProfilerGlobal().IsDestroyed(envid) ) {
+        return;
+    }
+    std::vector<ProfileThreadDataPtr> vthreads;
+    GetProfilerGlobal().GetThreads(vthreads);
+    FOREACHC(itthread, vthreads) {
+        ProfileThreadData& data = **itthread;
+        boost::mutex::scoped_lock lock(data._mutex);
+        FOREACHC(itroot, data._vroots) {
+            if( data._vnodes[*itroot].envid == envid ) {
+                _MergeProfileNode(data, *itroot, root);
+            }
+        }
+    }
+    GetProfilerGlobal().GetFinishedProfile(envid, root);
+    root.numcalls = 0;
+    root.totaltime = 0;
+    FOREACHC(itchild, root.children) {
+        root.totaltime += itchild->totaltime;
+    }
+}
+
+void RaveResetProfile(EnvironmentBaseConstPtr penv)
+{
+    int envid = penv->GetId();
+    std::vector<ProfileThreadDataPtr> vthreads;
+    GetProfilerGlobal().GetThreads(vthreads);
+    FOREACHC(itthread, vthreads) {
+        ProfileThreadData& data = **itthread;
+        boost::mutex::scoped_lock lock(data._mutex);
+        // keep the nodes since active zones reference them
+        FOREACH(itnode, data._vnodes) {
+            if( itnode->envid == envid ) {
+                itnode->numcalls.Reset();
+                itnode->totaltime.Reset();
+            }
+        }
+        std::vector<ProfileEvent>::iterator itevent = data._vevents.begin();
+        while(itevent != data._vevents.end()) {
+            if( itevent->envid == envid ) {
+                itevent = data._vevents.erase(itevent);
+            }
+            else {
+                ++itevent;
+            }
+        }
+    }
+    GetProfilerGlobal().ResetFinished(envid);
+}
+
+void RaveDestroyProfile(int environmentid)
+{
+    GetProfilerGlobal().DestroyEnvironment(environmentid);
+}
+
+void RaveWriteProfileChromeTrace(EnvironmentBaseConstPtr penv, std::ostream& O)
+{
+    int pid = penv->GetId();
+    bool bfirst = true;
+    O << "{\"traceEvents\":[";
+    std::vector<ProfileThreadDataPtr> vthreads;
+    GetProfilerGlobal().GetThreads(vthreads);
+    std::vector<ProfileEvent> vevents;
+    if( GetProfilerGlobal().IsDestroyed(pid) ) {
+        vthreads.resize(0);
+    }
+    FOREACHC(itthread, vthreads) {
+        ProfileThreadData& data = **itthread;
+        boost::mutex::scoped_lock lock(data._mutex);
+        FOREACHC(itevent, data._vevents) {
+            if( itevent->envid == pid ) {
+                vevents.push_back(*itevent);
+            }
+        }
+    }
+    GetProfilerGlobal().GetFinishedEvents(pid, vevents);
+    if( vevents.size() > 0 ) {
+        uint64_t starttime = vevents[0].starttime;
+        FOREACHC(itevent, vevents) {
+            starttime = std::min(starttime, itevent->starttime);
+        }
+        FOREACHC(itevent, vevents) {
+            _WriteChromeTraceEvent(O, bfirst, itevent->name, itevent->starttime-starttime, itevent->duration, pid, itevent->threadindex);
+        }
+    }
+    else {
+        ProfileNode root;
+        RaveGetProfile(penv, root);
+        uint64_t starttime = 0;
+        FOREACHC(itchild, root.children) {
+            _WriteChromeTraceNode(O, bfirst, *itchild, starttime, pid);
+            starttime += itchild->totaltime;
+        }
+    }
+    O << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+}
@@ -1091,16 +1091,8 @@ void RobotBase::CalculateActiveJacobian(int index, const Vector& offset, vector<
     int dofstride = GetActiveDOF();
     vjacobian.resize(3*dofstride);
     if( _vActiveDOFIndices.size() != 0 ) {
-        if( _nAffineDOFs == OpenRAVE::DOF_NoTransform ) {
-            ComputeJacobianTranslation(index, offset, vjacobian, _vActiveDOFIndices);
-            return;
-        }
-        // have to copy
-        std::vector<dReal> vjacobianjoints;
-        ComputeJacobianTranslation(index, offset, vjacobianjoints, _vActiveDOFIndices);
-        for(size_t i = 0; i < 3; ++i) {
-            std::copy(vjacobianjoints.begin()+i*_vActiveDOFIndices.size(),vjacobianjoints.begin()+(i+1)*_vActiveDOFIndices.size(),vjacobian.begin()+i*dofstride);
-        }
+        // write the joint columns directly, the affine columns follow them in every row
+        ComputeJacobians(*GetJacobianChain(index, _vActiveDOFIndices), offset, &vjacobian[0], NULL, NULL, NULL, dofstride);
     }
 
     if( _nAffineDOFs == OpenRAVE::DOF_NoTransform ) {
@@ -1307,16 +1299,8 @@ void RobotBase::CalculateActiveAngularVelocityJacobian(int index, std::vector<dR
     int dofstride = GetActiveDOF();
     vjacobian.resize(3*dofstride);
     if( _vActiveDOFIndices.size() != 0 ) {
-        if( _nAffineDOFs == OpenRAVE::DOF_NoTransform ) {
-            ComputeJacobianAxisAngle(index, vjacobian, _vActiveDOFIndices);
-            return;
-        }
-        // have to copy
-        std::vector<dReal> vjacobianjoints;
-        ComputeJacobianAxisAngle(index, vjacobianjoints, _vActiveDOFIndices);
-        for(size_t i = 0; i < 3; ++i) {
-            std::copy(vjacobianjoints.begin()+i*_vActiveDOFIndices.size(),vjacobianjoints.begin()+(i+1)*_vActiveDOFIndices.size(),vjacobian.begin()+i*dofstride);
-        }
+        // write the joint columns directly, the affine columns follow them in every row
+        ComputeJacobians(*GetJacobianChain(index, _vActiveDOFIndices), Vector(), NULL, &vjacobian[0], NULL, NULL, dofstride);
     }
 
     if( _nAffineDOFs == OpenRAVE::DOF_NoTransform ) {
@@ -1920,19 +1904,49 @@ bool RobotBase::RemoveAttachedSensor(AttachedSensorPtr attsensor)
 }
 
 /// Check if body is self colliding. Links that are joined together are ignored.
-bool RobotBase::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
+void RobotBase::_ComputeSelfCollisionPlan(SelfCollisionPlan& plan) const
 {
-    if( !collisionchecker ) {
-        collisionchecker = _selfcollisionchecker;
-        if( !collisionchecker ) {
-            collisionchecker = GetEnv()->GetCollisionChecker();
-            if( !collisionchecker ) {
-                // no checker set
-                return false;
+    KinBody::_ComputeSelfCollisionPlan(plan);
+    for(size_t igrabbed = 0; igrabbed < _vGrabbedBodies.size(); ++igrabbed) {
+        GrabbedConstPtr pgrabbed = boost::dynamic_pointer_cast<Grabbed const>(_vGrabbedBodies[igrabbed]);
+        KinBodyPtr pbody(pgrabbed->_pgrabbedbody);
+        if( !pbody ) {
+            continue;
+        }
+        int grabbinglinkindex = pgrabbed->_plinkrobot->GetIndex();
+        plan.vattachedbodies.push_back(pbody);
+        plan.vattachedlinkindices.push_back(grabbinglinkindex);
+        FOREACHC(itlink, pgrabbed->_listNonCollidingLinks) {
+            if( (*itlink)->GetParent() == shared_kinbody_const() ) {
+                FOREACHC(itbodylink, pbody->GetLinks()) {
+                    plan.vpairs.push_back(std::make_pair(*itlink, LinkConstPtr(*itbodylink)));
+                    plan.vpairlinkindices.push_back((*itlink)->GetIndex()|(grabbinglinkindex<<16));
+                }
+                continue;
+            }
+
+            // a link of another grabbed body, which moves with the robot link grabbing it. Like _CheckSelfCollision, the pair is only
+            // checked if each link is non-colliding for the other body. The condition is symmetric, so only add the pair once.
+            for(size_t igrabbed2 = igrabbed+1; igrabbed2 < _vGrabbedBodies.size(); ++igrabbed2) {
+                GrabbedConstPtr pgrabbed2 = boost::dynamic_pointer_cast<Grabbed const>(_vGrabbedBodies[igrabbed2]);
+                if( KinBodyPtr(pgrabbed2->_pgrabbedbody) != (*itlink)->GetParent() ) {
+                    continue;
+                }
+                int carrierlinkindex = pgrabbed2->_plinkrobot->GetIndex();
+                FOREACHC(itbodylink, pbody->GetLinks()) {
+                    if( find(pgrabbed2->_listNonCollidingLinks.begin(),pgrabbed2->_listNonCollidingLinks.end(),*itbodylink) != pgrabbed2->_listNonCollidingLinks.end() ) {
+                        plan.vpairs.push_back(std::make_pair(*itlink, LinkConstPtr(*itbodylink)));
+                        plan.vpairlinkindices.push_back(carrierlinkindex|(grabbinglinkindex<<16));
+                    }
+                }
+                break;
             }
         }
     }
+}
 
+bool RobotBase::_CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
+{
     bool bAllLinkCollisions = !!(collisionchecker->GetCollisionOptions()&CO_AllLinkCollisions);
     CollisionReportKeepSaver reportsaver(report);
     if( !!report && bAllLinkCollisions && report->nKeepPrevious == 0 ) {
@@ -1941,7 +1955,7 @@ bool RobotBase::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBa
     }
 
     bool bCollision = false;
-    if( KinBody::CheckSelfCollision(report, collisionchecker) ) {
+    if( KinBody::_CheckSelfCollision(report, collisionchecker) ) {
         if( !bAllLinkCollisions ) { // if checking all collisions, have to continue
             return true;
         }
@@ -2073,6 +2087,11 @@ bool RobotBase::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBa
     return bCollision;
 }
 
+bool RobotBase::CheckSelfCollision(CollisionReportPtr report, CollisionCheckerBasePtr collisionchecker) const
+{
+    return KinBody::CheckSelfCollision(report, collisionchecker);
+}
+
 bool RobotBase::CheckLinkCollision(int ilinkindex, const Transform& tlinktrans, CollisionReportPtr report)
 {
     LinkPtr plink = _veclinks.at(ilinkindex);
@@ -2243,6 +2262,7 @@ void RobotBase::SimulationStep(dReal fElapsedTime)
 
 void RobotBase::_ComputeInternalInformation()
 {
+    OPENRAVE_PROFILE_ZONE(GetEnv().get(), "RobotBase::_ComputeInternalInformation");
     KinBody::_ComputeInternalInformation();
     _vAllDOFIndices.resize(GetDOF());
     for(int i = 0; i < GetDOF(); ++i) {
@@ -183,6 +183,12 @@ void RobotBase::Manipulator::GetGripperDOFValues(std::vector<dReal>& v) const
 }
 
 
+/// \brief reports a finished ik call to the trace handler
+static void _TraceIkSolve(const TraceHandlerBasePtr& tracer, const std::string& manipname, int numsolutions, uint64_t starttime)
+{
+    tracer->TraceEvent(TET_IkSolve, manipname, numsolutions, utils::GetNanoPerformanceTime()-starttime);
+}
+
 bool RobotBase::Manipulator::FindIKSolution(const IkParameterization& goal, vector<dReal>& solution, int filteroptions) const
 {
     return FindIKSolution(goal, vector<dReal>(), solution, filteroptions);
@@ -207,7 +213,14 @@ bool RobotBase::Manipulator::FindIKSolution(const IkParameterization& goal, cons
         localgoal=goal;
     }
     boost::shared_ptr< vector<dReal> > psolution(&solution, utils::null_deleter());
-    return vFreeParameters.size() == 0 ? pIkSolver->Solve(localgoal, solution, filteroptions, psolution) : pIkSolver->Solve(localgoal, solution, vFreeParameters, filteroptions, psolution);
+    OPENRAVE_PROFILE_ZONE(pIkSolver->GetEnv().get(), "IkSolverBase::Solve");
+    TraceHandlerBasePtr tracer = RaveGetTraceHandler();
+    uint64_t starttime = !!tracer ? utils::GetNanoPerformanceTime() : 0;
+    bool bsuccess = vFreeParameters.size() == 0 ? pIkSolver->Solve(localgoal, solution, filteroptions, psolution) : pIkSolver->Solve(localgoal, solution, vFreeParameters, filteroptions, psolution);
+    if( !!tracer ) {
+        _TraceIkSolve(tracer, GetName(), bsuccess ? 1 : 0, starttime);
+    }
+    return bsuccess;
 }
 
 bool RobotBase::Manipulator::FindIKSolutions(const IkParameterization& goal, std::vector<std::vector<dReal> >& solutions, int filteroptions) const
@@ -227,7 +240,14 @@ bool RobotBase::Manipulator::FindIKSolutions(const IkParameterization& goal, con
     else {
         localgoal=goal;
     }
-    return vFreeParameters.size() == 0 ? pIkSolver->SolveAll(localgoal,filteroptions,solutions) : pIkSolver->SolveAll(localgoal,vFreeParameters,filteroptions,solutions);
+    OPENRAVE_PROFILE_ZONE(pIkSolver->GetEnv().get(), "IkSolverBase::SolveAll");
+    TraceHandlerBasePtr tracer = RaveGetTraceHandler();
+    uint64_t starttime = !!tracer ? utils::GetNanoPerformanceTime() : 0;
+    bool bsuccess = vFreeParameters.size() == 0 ? pIkSolver->SolveAll(localgoal,filteroptions,solutions) : pIkSolver->SolveAll(localgoal,vFreeParameters,filteroptions,solutions);
+    if( !!tracer ) {
+        _TraceIkSolve(tracer, GetName(), (int)solutions.size(), starttime);
+    }
+    return bsuccess;
 }
 
 
@@ -254,7 +274,14 @@ bool RobotBase::Manipulator::FindIKSolution(const IkParameterization& goal, cons
     else {
         localgoal=goal;
     }
-    return vFreeParameters.size() == 0 ? pIkSolver->Solve(localgoal, solution, filteroptions, ikreturn) : pIkSolver->Solve(localgoal, solution, vFreeParameters, filteroptions, ikreturn);
+    OPENRAVE_PROFILE_ZONE(pIkSolver->GetEnv().get(), "IkSolverBase::Solve");
+    TraceHandlerBasePtr tracer = RaveGetTraceHandler();
+    uint64_t starttime = !!tracer ? utils::GetNanoPerformanceTime() : 0;
+    bool bsuccess = vFreeParameters.size() == 0 ? pIkSolver->Solve(localgoal, solution, filteroptions, ikreturn) : pIkSolver->Solve(localgoal, solution, vFreeParameters, filteroptions, ikreturn);
+    if( !!tracer ) {
+        _TraceIkSolve(tracer, GetName(), bsuccess ? 1 : 0, starttime);
+    }
+    return bsuccess;
 }
 
 bool RobotBase::Manipulator::FindIKSolutions(const IkParameterization& goal, int filteroptions, std::vector<IkReturnPtr>& vikreturns) const
@@ -274,7 +301,14 @@ bool RobotBase::Manipulator::FindIKSolutions(const IkParameterization& goal, con
     else {
         localgoal=goal;
     }
-    return vFreeParameters.size() == 0 ? pIkSolver->SolveAll(localgoal,filteroptions,vikreturns) : pIkSolver->SolveAll(localgoal,vFreeParameters,filteroptions,vikreturns);
+    OPENRAVE_PROFILE_ZONE(pIkSolver->GetEnv().get(), "IkSolverBase::SolveAll");
+    TraceHandlerBasePtr tracer = RaveGetTraceHandler();
+    uint64_t starttime = !!tracer ? utils::GetNanoPerformanceTime() : 0;
+    bool bsuccess = vFreeParameters.size() == 0 ? pIkSolver->SolveAll(localgoal,filteroptions,vikreturns) : pIkSolver->SolveAll(localgoal,vFreeParameters,filteroptions,vikreturns);
+    if( !!tracer ) {
+        _TraceIkSolve(tracer, GetName(), (int)vikreturns.size(), starttime);
+    }
+    return bsuccess;
 }
 
 IkParameterization RobotBase::Manipulator::GetIkParameterization(IkParameterizationType iktype, bool inworld) const
@@ -121,5 +121,22 @@ std::string GetFilenameUntilSeparator(std::istream& sinput, char separator)
     return filename.substr( startpos, endpos-startpos+1 );
 }
 
+void WriteJSONString(std::ostream& O, const std::string& s)
+{
+    O << '"';
+    FOREACHC(itc, s) {
+        if( *itc == '"' || *itc == '\\' ) {
+            O << '\\' << *itc;
+        }
+        else if( (unsigned char)*itc < 0x20 ) {
+            O << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)(unsigned char)*itc << std::dec << std::setfill(' ');
+        }
+        else {
+            O << *itc;
+        }
+    }
+    O << '"';
+}
+
 } // utils
 } // OpenRAVE
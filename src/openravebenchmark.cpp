@@ -0,0 +1,580 @@
+// -*- coding: utf-8 -*-
+// Copyright (C) 2006-2014 Rosen Diankov (rosen.diankov@gmail.com)
+//
+// This file is part of OpenRAVE.
+// OpenRAVE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/** \file openravebenchmark.cpp
+    \brief Times the kinematics, collision, ik, planning, trajectory, and loading hot paths on the bundled robots and scenes.
+
+    Every benchmark runs for a minimum time and reports the per-call statistics as JSON (default) or CSV so results can be compared across releases.
+ */
+#include "libopenrave-core/ravep.h"
+#include <openrave/utils.h>
+#include <openrave/planningutils.h>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace OpenRAVE;
+using namespace std;
+
+struct BenchmarkResult
+{
+    BenchmarkResult() : numcalls(0), mean(0), median(0), minimum(0), maximum(0) {
+    }
+    std::string name, status;
+    size_t numcalls; ///< total number of timed calls
+    double mean, median, minimum, maximum; ///< seconds per call
+};
+
+/// \brief runs the benchmarks selected on the command line and collects the results
+class Benchmarker
+{
+public:
+    Benchmarker() : _mintime(0.5), _maxcalls(1000000) {
+    }
+
+    double _mintime; ///< minimum seconds to run each benchmark
+    size_t _maxcalls;
+    std::vector<std::string> _vfilters, _vexcludes;
+    std::vector<BenchmarkResult> _vresults;
+
+    bool IsSelected(const std::string& name) const
+    {
+        if( _vfilters.size() > 0 ) {
+            bool bfound = false;
+            FOREACHC(itfilter, _vfilters) {
+                if( name.find(*itfilter) != std::string::npos ) {
+                    bfound = true;
+                    break;
+                }
+            }
+            if( !bfound ) {
+                return false;
+            }
+        }
+        FOREACHC(itexclude, _vexcludes) {
+            if( name.find(*itexclude) != std::string::npos ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** \brief times fn until the minimum time has passed.
+
+        Calls are grouped into batches so that fast functions are not dominated by the timer. The statistics are computed over the per-call time of each batch.
+        \param fn is called with a running call index
+     */
+    void Run(const std::string& name, const boost::function<void(size_t)>& fn)
+    {
+        if( !IsSelected(name) ) {
+            return;
+        }
+        BenchmarkResult result;
+        result.name = name;
+        try {
+            // warm up caches and find the batch size that takes at least 50us
+            size_t batchsize = 1;
+            uint64_t starttime = utils::GetNanoPerformanceTime();
+            fn(0);
+            uint64_t elapsed = utils::GetNanoPerformanceTime()-starttime;
+            if( elapsed < 50000 ) {
+                batchsize = std::min(size_t(50000/std::max(elapsed, uint64_t(1)))+1, size_t(10000));
+            }
+
+            std::vector<double> vbatchtimes;
+            size_t callindex = 1;
+            uint64_t benchmarkstart = utils::GetNanoPerformanceTime();
+            while(callindex < _maxcalls) {
+                starttime = utils::GetNanoPerformanceTime();
+                for(size_t i = 0; i < batchsize; ++i) {
+                    fn(callindex++);
+                }
+                uint64_t endtime = utils::GetNanoPerformanceTime();
+                vbatchtimes.push_back((endtime-starttime)*1e-9/batchsize);
+                if( (endtime-benchmarkstart)*1e-9 >= _mintime ) {
+                    break;
+                }
+            }
+            result.numcalls = vbatchtimes.size()*batchsize;
+            double sum = 0;
+            FOREACHC(ittime, vbatchtimes) {
+                sum += *ittime;
+            }
+            result.mean = sum/vbatchtimes.size();
+            std::sort(vbatchtimes.begin(), vbatchtimes.end());
+            result.median = vbatchtimes[vbatchtimes.size()/2];
+            result.minimum = vbatchtimes.front();
+            result.maximum = vbatchtimes.back();
+            result.status = "ok";
+            RAVELOG_INFO_FORMAT("%s: %e s/call (%d calls)", name%result.mean%result.numcalls);
+        }
+        catch(const std::exception& ex) {
+            result.status = std::string("failed: ") + ex.what();
+            RAVELOG_WARN_FORMAT("%s failed: %s", name%ex.what());
+        }
+        _vresults.push_back(result);
+    }
+
+    /// \brief records a benchmark that could not run, for example because a plugin is missing
+    void Skip(const std::string& name, const std::string& reason)
+    {
+        if( !IsSelected(name) ) {
+            return;
+        }
+        BenchmarkResult result;
+        result.name = name;
+        result.status = "skipped: " + reason;
+        RAVELOG_WARN_FORMAT("%s skipped: %s", name%reason);
+        _vresults.push_back(result);
+    }
+
+    void WriteJSON(std::ostream& O, const std::string& scenefilename) const
+    {
+        O << "{\"openrave_version\": \"" << OPENRAVE_VERSION_STRING << "\", \"precision\": " << OPENRAVE_PRECISION << ", \"scene\": ";
+        utils::WriteJSONString(O, scenefilename);
+        O << ", \"mintime\": " << _mintime << ",\n \"benchmarks\": [";
+        for(size_t i = 0; i < _vresults.size(); ++i) {
+            const BenchmarkResult& result = _vresults[i];
+            O << (i > 0 ? ",\n  " : "\n  ") << "{\"name\": ";
+            utils::WriteJSONString(O, result.name);
+            O << ", \"status\": ";
+            utils::WriteJSONString(O, result.status);
+            O << ", \"numcalls\": " << result.numcalls << ", \"mean\": " << result.mean << ", \"median\": " << result.median << ", \"min\": " << result.minimum << ", \"max\": " << result.maximum << "}";
+        }
+        O << "\n ]\n}\n";
+    }
+
+    void WriteCSV(std::ostream& O) const
+    {
+        O << "name,status,numcalls,mean,median,min,max" << endl;
+        FOREACHC(itresult, _vresults) {
+            std::string status = itresult->status;
+            std::replace(status.begin(), status.end(), ',', ';');
+            O << itresult->name << "," << status << "," << itresult->numcalls << "," << itresult->mean << "," << itresult->median << "," << itresult->minimum << "," << itresult->maximum << endl;
+        }
+    }
+
+};
+
+/// \brief deterministic random configurations inside the limits of the active dofs
+class ConfigurationGenerator
+{
+public:
+    ConfigurationGenerator(RobotBasePtr probot, uint32_t seed) : _probot(probot)
+    {
+        _sampler = RaveCreateSpaceSampler(probot->GetEnv(), "mt19937");
+        _sampler->SetSeed(seed);
+        probot->GetActiveDOFLimits(_vlower, _vupper);
+    }
+
+    void Sample(std::vector<dReal>& values)
+    {
+        values.resize(_vlower.size());
+        for(size_t i = 0; i < values.size(); ++i) {
+            values[i] = _vlower[i] + (_vupper[i]-_vlower[i])*_sampler->SampleSequenceOneReal(IT_Closed);
+        }
+    }
+
+    /// \brief samples configurations until one is collision free, returns false if none was found
+    bool SampleCollisionFree(std::vector<dReal>& values, int maxtries=1000)
+    {
+        RobotBase::RobotStateSaver saver(_probot);
+        for(int itry = 0; itry < maxtries; ++itry) {
+            Sample(values);
+            _probot->SetActiveDOFValues(values);
+            if( !_probot->GetEnv()->CheckCollision(_probot) && !_probot->CheckSelfCollision() ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    RobotBasePtr _probot;
+    SpaceSamplerBasePtr _sampler;
+    std::vector<dReal> _vlower, _vupper;
+};
+
+static void BenchmarkSetDOFValues(RobotBasePtr probot, const std::vector< std::vector<dReal> >& vconfigs, size_t index)
+{
+    probot->SetActiveDOFValues(vconfigs[index%vconfigs.size()], KinBody::CLA_Nothing);
+}
+
+static void BenchmarkGetLinkTransformations(RobotBasePtr probot, std::vector<Transform>& vtransforms, size_t index)
+{
+    probot->GetLinkTransformations(vtransforms);
+}
+
+static void BenchmarkComputeJacobianTranslation(RobotBasePtr probot, RobotBase::ManipulatorPtr pmanip, const std::vector< std::vector<dReal> >& vconfigs, std::vector<dReal>& vjacobian, size_t index)
+{
+    probot->SetActiveDOFValues(vconfigs[index%vconfigs.size()], KinBody::CLA_Nothing);
+    probot->ComputeJacobianTranslation(pmanip->GetEndEffector()->GetIndex(), pmanip->GetTransform().trans, vjacobian, pmanip->GetArmIndices());
+}
+
+static void BenchmarkSelfCollision(RobotBasePtr probot, const std::vector< std::vector<dReal> >& vconfigs, size_t index)
+{
+    probot->SetActiveDOFValues(vconfigs[index%vconfigs.size()], KinBody::CLA_Nothing);
+    probot->CheckSelfCollision();
+}
+
+static void BenchmarkEnvironmentCollision(RobotBasePtr probot, const std::vector< std::vector<dReal> >& vconfigs, size_t index)
+{
+    probot->SetActiveDOFValues(vconfigs[index%vconfigs.size()], KinBody::CLA_Nothing);
+    probot->GetEnv()->CheckCollision(KinBodyConstPtr(probot));
+}
+
+static void BenchmarkIkSolve(RobotBase::ManipulatorPtr pmanip, const std::vector<IkParameterization>& vikparams, std::vector<dReal>& solution, size_t index)
+{
+    pmanip->FindIKSolution(vikparams[index%vikparams.size()], solution, 0);
+}
+
+static void BenchmarkIkSolveAll(RobotBase::ManipulatorPtr pmanip, const std::vector<IkParameterization>& vikparams, std::vector< std::vector<dReal> >& solutions, size_t index)
+{
+    pmanip->FindIKSolutions(vikparams[index%vikparams.size()], solutions, 0);
+}
+
+static void BenchmarkBiRRT(RobotBasePtr probot, PlannerBasePtr planner, const std::vector<dReal>& vinitial, const std::vector< std::vector<dReal> >& vgoals, TrajectoryBasePtr ptraj, size_t index)
+{
+    PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+    params->SetRobotActiveJoints(probot);
+    params->vinitialconfig = vinitial;
+    params->vgoalconfig = vgoals[index%vgoals.size()];
+    params->_nMaxIterations = 4000;
+    params->_nRandomGeneratorSeed = index%vgoals.size();
+    RobotBase::RobotStateSaver saver(probot);
+    if( !planner->InitPlan(probot, params) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0("failed to init birrt", ORE_Failed);
+    }
+    if( !(planner->PlanPath(ptraj) & PS_HasSolution) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("birrt failed on query %d", (index%vgoals.size()), ORE_Failed);
+    }
+}
+
+static void BenchmarkSmoother(RobotBasePtr probot, const std::vector<TrajectoryBasePtr>& vpaths, TrajectoryBasePtr ptraj, size_t index)
+{
+    ptraj->Clone(vpaths[index%vpaths.size()], 0);
+    RobotBase::RobotStateSaver saver(probot);
+    if( !(planningutils::SmoothActiveDOFTrajectory(ptraj, probot, 1, 1, "parabolicsmoother") & PS_HasSolution) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT0("parabolicsmoother failed", ORE_Failed);
+    }
+}
+
+static void BenchmarkTrajectorySample(TrajectoryBasePtr ptraj, std::vector<dReal>& data, size_t index)
+{
+    // golden ratio sequence spreads the sample times over the trajectory
+    dReal t = std::fmod(index*0.6180339887, 1.0)*ptraj->GetDuration();
+    ptraj->Sample(data, t);
+}
+
+static void BenchmarkConvertData(TrajectoryBasePtr ptraj, const ConfigurationSpecification& spec, const std::vector<dReal>& vtrajdata, std::vector<dReal>& data)
+{
+    ConfigurationSpecification::ConvertData(data.begin(), spec, vtrajdata.begin(), ptraj->GetConfigurationSpecification(), ptraj->GetNumWaypoints(), ptraj->GetEnv());
+}
+
+static void BenchmarkLoad(EnvironmentBasePtr penv, const std::string& filename, size_t index)
+{
+    penv->Reset();
+    if( !penv->Load(filename) ) {
+        throw OPENRAVE_EXCEPTION_FORMAT("failed to load %s", filename, ORE_InvalidArguments);
+    }
+}
+
+static void PrintHelp()
+{
+    RAVELOG_INFO("openrave-benchmark [--scene filename] [--robot name] [--manip name] [--checkers ode,fcl,pqp,bullet] [--mintime seconds] [--filter name]... [--exclude name]... [--format json|csv] [--output filename] [--loadik] [-d debuglevel]\n\n"
+                 "Times the core hot paths and writes the per-call statistics in seconds. --filter and --exclude select benchmarks whose name contains the string.\n"
+                 "The ik benchmarks use the ik solver already set on the manipulator, --loadik loads an ikfast solver and generates it if it is not in the database.\n");
+}
+
+int main(int argc, char ** argv)
+{
+    Benchmarker benchmarker;
+    std::string scenefilename = "data/lab1.env.xml", robotname, manipname, outputfilename, format = "json";
+    std::string xmlfilename = "robots/barrettwam.robot.xml", colladafilename = "robots/mitsubishi-pa10.zae";
+    std::vector<std::string> vcheckers;
+    vcheckers.push_back("ode"); vcheckers.push_back("fcl"); vcheckers.push_back("pqp"); vcheckers.push_back("bullet");
+    int debuglevel = Level_Warn;
+    bool bloadik = false;
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool bhasvalue = i+1 < argc;
+        if( arg == "-h" || arg == "--help" ) {
+            RaveInitialize(false, Level_Info);
+            PrintHelp();
+            RaveDestroy();
+            return 0;
+        }
+        else if( arg == "--scene" && bhasvalue ) {
+            scenefilename = argv[++i];
+        }
+        else if( arg == "--robot" && bhasvalue ) {
+            robotname = argv[++i];
+        }
+        else if( arg == "--manip" && bhasvalue ) {
+            manipname = argv[++i];
+        }
+        else if( arg == "--checkers" && bhasvalue ) {
+            vcheckers.resize(0);
+            std::stringstream ss(argv[++i]);
+            std::string checker;
+            while(std::getline(ss, checker, ',')) {
+                if( checker.size() > 0 ) {
+                    vcheckers.push_back(checker);
+                }
+            }
+        }
+        else if( arg == "--mintime" && bhasvalue ) {
+            benchmarker._mintime = atof(argv[++i]);
+        }
+        else if( arg == "--filter" && bhasvalue ) {
+            benchmarker._vfilters.push_back(argv[++i]);
+        }
+        else if( arg == "--exclude" && bhasvalue ) {
+            benchmarker._vexcludes.push_back(argv[++i]);
+        }
+        else if( arg == "--format" && bhasvalue ) {
+            format = argv[++i];
+        }
+        else if( arg == "--output" && bhasvalue ) {
+            outputfilename = argv[++i];
+        }
+        else if( arg == "--loadik" ) {
+            bloadik = true;
+        }
+        else if( arg == "-d" && bhasvalue ) {
+            debuglevel = atoi(argv[++i]);
+        }
+        else {
+            RaveInitialize(false, Level_Info);
+            RAVELOG_ERROR_FORMAT("unknown argument %s", arg);
+            PrintHelp();
+            RaveDestroy();
+            return 1;
+        }
+    }
+
+    RaveInitialize(true, debuglevel);
+    int retcode = 0;
+    {
+        EnvironmentBasePtr penv = RaveCreateEnvironment(0);
+        EnvironmentMutex::scoped_lock lock(penv->GetMutex());
+        if( !penv->Load(scenefilename) ) {
+            RAVELOG_ERROR_FORMAT("failed to load scene %s", scenefilename);
+            RaveDestroy();
+            return 1;
+        }
+        RobotBasePtr probot = robotname.size() > 0 ? penv->GetRobot(robotname) : RobotBasePtr();
+        if( !probot ) {
+            std::vector<RobotBasePtr> vrobots;
+            penv->GetRobots(vrobots);
+            if( vrobots.size() == 0 ) {
+                RAVELOG_ERROR_FORMAT("scene %s has no robots", scenefilename);
+                RaveDestroy();
+                return 1;
+            }
+            probot = vrobots.at(0);
+        }
+        if( manipname.size() > 0 ) {
+            probot->SetActiveManipulator(manipname);
+        }
+        RobotBase::ManipulatorPtr pmanip = probot->GetActiveManipulator();
+        if( !!pmanip ) {
+            probot->SetActiveDOFs(pmanip->GetArmIndices());
+        }
+        else {
+            std::vector<int> vindices(probot->GetDOF());
+            for(int i = 0; i < probot->GetDOF(); ++i) {
+                vindices[i] = i;
+            }
+            probot->SetActiveDOFs(vindices);
+        }
+        std::vector<dReal> vinitial;
+        probot->GetActiveDOFValues(vinitial);
+
+        ConfigurationGenerator generator(probot, 0);
+        std::vector< std::vector<dReal> > vconfigs(1000);
+        FOREACH(itconfig, vconfigs) {
+            generator.Sample(*itconfig);
+        }
+
+        // kinematics
+        std::vector<Transform> vtransforms;
+        std::vector<dReal> vjacobian, vsolution;
+        benchmarker.Run("kinematics.setdofvalues", boost::bind(BenchmarkSetDOFValues, probot, boost::cref(vconfigs), _1));
+        benchmarker.Run("kinematics.getlinktransformations", boost::bind(BenchmarkGetLinkTransformations, probot, boost::ref(vtransforms), _1));
+        if( !!pmanip ) {
+            benchmarker.Run("kinematics.computejacobiantranslation", boost::bind(BenchmarkComputeJacobianTranslation, probot, pmanip, boost::cref(vconfigs), boost::ref(vjacobian), _1));
+        }
+        probot->SetActiveDOFValues(vinitial);
+
+        // collision for every checker
+        CollisionCheckerBasePtr poriginalchecker = penv->GetCollisionChecker();
+        FOREACHC(itchecker, vcheckers) {
+            std::string selfname = "collision.self." + *itchecker, envname = "collision.env." + *itchecker;
+            if( !benchmarker.IsSelected(selfname) && !benchmarker.IsSelected(envname) ) {
+                continue;
+            }
+            CollisionCheckerBasePtr pchecker = RaveCreateCollisionChecker(penv, *itchecker);
+            if( !pchecker || !penv->SetCollisionChecker(pchecker) ) {
+                benchmarker.Skip(selfname, "checker not available");
+                benchmarker.Skip(envname, "checker not available");
+                continue;
+            }
+            benchmarker.Run(selfname, boost::bind(BenchmarkSelfCollision, probot, boost::cref(vconfigs), _1));
+            benchmarker.Run(envname, boost::bind(BenchmarkEnvironmentCollision, probot, boost::cref(vconfigs), _1));
+        }
+        penv->SetCollisionChecker(poriginalchecker);
+        probot->SetActiveDOFValues(vinitial);
+
+        // inverse kinematics on reachable poses
+        if( benchmarker.IsSelected("ik.solve") || benchmarker.IsSelected("ik.solveall") ) {
+            bool bhasik = !!pmanip && !!pmanip->GetIkSolver();
+            // generating an ikfast solver can take minutes, so only load when requested
+            if( !!pmanip && !bhasik && bloadik ) {
+                ModuleBasePtr ikfast = RaveCreateModule(penv, "ikfast");
+                if( !!ikfast ) {
+                    penv->Add(ikfast, true, "");
+                    std::stringstream sout, sinput;
+                    sinput << "LoadIKFastSolver " << probot->GetName() << " Transform6D";
+                    try {
+                        bhasik = ikfast->SendCommand(sout, sinput) && !!pmanip->GetIkSolver();
+                    }
+                    catch(const std::exception& ex) {
+                        RAVELOG_WARN_FORMAT("failed to load ik: %s", ex.what());
+                    }
+                }
+            }
+            IkParameterizationType iktype = IKP_None;
+            if( bhasik ) {
+                FOREACHC(ittype, RaveGetIkParameterizationMap()) {
+                    if( pmanip->GetIkSolver()->Supports(ittype->first) ) {
+                        iktype = ittype->first;
+                        break;
+                    }
+                }
+            }
+            if( iktype != IKP_None ) {
+                std::vector<IkParameterization> vikparams;
+                {
+                    RobotBase::RobotStateSaver saver(probot);
+                    for(size_t i = 0; i < 100; ++i) {
+                        probot->SetActiveDOFValues(vconfigs[i], KinBody::CLA_Nothing);
+                        vikparams.push_back(pmanip->GetIkParameterization(iktype));
+                    }
+                }
+                std::vector< std::vector<dReal> > vsolutions;
+                benchmarker.Run("ik.solve", boost::bind(BenchmarkIkSolve, pmanip, boost::cref(vikparams), boost::ref(vsolution), _1));
+                benchmarker.Run("ik.solveall", boost::bind(BenchmarkIkSolveAll, pmanip, boost::cref(vikparams), boost::ref(vsolutions), _1));
+            }
+            else {
+                benchmarker.Skip("ik.solve", bloadik ? "no ik solver" : "no ik solver, use --loadik");
+                benchmarker.Skip("ik.solveall", bloadik ? "no ik solver" : "no ik solver, use --loadik");
+            }
+        }
+
+        // planning on fixed collision-free queries, the planned paths are reused for smoothing and trajectory benchmarks
+        std::vector< std::vector<dReal> > vgoals;
+        std::vector<TrajectoryBasePtr> vpaths;
+        PlannerBasePtr birrt = RaveCreatePlanner(penv, "birrt");
+        if( !!birrt ) {
+            ConfigurationGenerator goalgenerator(probot, 1);
+            for(int i = 0; i < 5; ++i) {
+                std::vector<dReal> vgoal;
+                if( goalgenerator.SampleCollisionFree(vgoal) ) {
+                    vgoals.push_back(vgoal);
+                }
+            }
+            // only keep the queries that can be solved so the timed runs do not fail
+            std::vector< std::vector<dReal> > vsolvedgoals;
+            for(size_t i = 0; i < vgoals.size(); ++i) {
+                TrajectoryBasePtr ptraj = RaveCreateTrajectory(penv, "");
+                try {
+                    BenchmarkBiRRT(probot, birrt, vinitial, vgoals, ptraj, i);
+                    vsolvedgoals.push_back(vgoals[i]);
+                    vpaths.push_back(ptraj);
+                }
+                catch(const std::exception& ex) {
+                    RAVELOG_WARN_FORMAT("query %d failed: %s", i%ex.what());
+                }
+            }
+            vgoals.swap(vsolvedgoals);
+        }
+        if( vpaths.size() > 0 ) {
+            TrajectoryBasePtr ptraj = RaveCreateTrajectory(penv, "");
+            benchmarker.Run("planning.birrt", boost::bind(BenchmarkBiRRT, probot, birrt, boost::cref(vinitial), boost::cref(vgoals), ptraj, _1));
+            benchmarker.Run("planning.parabolicsmoother", boost::bind(BenchmarkSmoother, probot, boost::cref(vpaths), ptraj, _1));
+
+            TrajectoryBasePtr psmoothed = RaveCreateTrajectory(penv, "");
+            psmoothed->Clone(vpaths.at(0), 0);
+            planningutils::SmoothActiveDOFTrajectory(psmoothed, probot);
+            std::vector<dReal> vdata, vtrajdata;
+            benchmarker.Run("trajectory.sample", boost::bind(BenchmarkTrajectorySample, psmoothed, boost::ref(vdata), _1));
+
+            ConfigurationSpecification spec = probot->GetActiveConfigurationSpecification();
+            spec.AddDeltaTimeGroup();
+            psmoothed->GetWaypoints(0, psmoothed->GetNumWaypoints(), vtrajdata);
+            std::vector<dReal> vconverted(spec.GetDOF()*psmoothed->GetNumWaypoints());
+            benchmarker.Run("trajectory.convertdata", boost::bind(BenchmarkConvertData, psmoothed, boost::cref(spec), boost::cref(vtrajdata), boost::ref(vconverted)));
+        }
+        else {
+            benchmarker.Skip("planning.birrt", "no planned paths");
+            benchmarker.Skip("planning.parabolicsmoother", "no planned paths");
+            benchmarker.Skip("trajectory.sample", "no planned paths");
+            benchmarker.Skip("trajectory.convertdata", "no planned paths");
+        }
+
+        // loading uses its own environment so the scene is kept
+        if( benchmarker.IsSelected("load.xml") || benchmarker.IsSelected("load.collada") ) {
+            EnvironmentBasePtr penvload = RaveCreateEnvironment(0);
+            benchmarker.Run("load.xml", boost::bind(BenchmarkLoad, penvload, xmlfilename, _1));
+            benchmarker.Run("load.collada", boost::bind(BenchmarkLoad, penvload, colladafilename, _1));
+            penvload->Destroy();
+        }
+
+        if( outputfilename.size() > 0 ) {
+            std::ofstream f(outputfilename.c_str());
+            if( !f ) {
+                RAVELOG_ERROR_FORMAT("failed to open %s", outputfilename);
+                retcode = 1;
+            }
+            else if( format == "csv" ) {
+                benchmarker.WriteCSV(f);
+            }
+            else {
+                benchmarker.WriteJSON(f, scenefilename);
+            }
+        }
+        else if( format == "csv" ) {
+            benchmarker.WriteCSV(std::cout);
+        }
+        else {
+            benchmarker.WriteJSON(std::cout, scenefilename);
+        }
+        lock.unlock();
+        penv->Destroy();
+    }
+    RaveDestroy();
+    return retcode;
+}
@@ -67,6 +67,68 @@ class RunCollision(EnvironmentSetup):
                     assert(check==robot.CheckSelfCollision())
                 env.Remove(robot)
 
+    def test_selfcollisionincremental(self):
+        # moving a subset of the joints only checks the affected pairs, which has to give the same result as checking all pairs
+        env=self.env
+        with env:
+            robot=env.ReadRobotURI('robots/barrettwam.robot.xml')
+            env.Add(robot)
+            checker=env.GetCollisionChecker()
+            lower,upper = robot.GetDOFLimits()
+            v = robot.GetDOFValues()
+            for i in range(50):
+                dofindex = random.randint(robot.GetDOF())
+                v[dofindex] = lower[dofindex]+random.rand()*(upper[dofindex]-lower[dofindex])
+                robot.SetDOFValues(v)
+                assert(robot.CheckSelfCollision()==checker.CheckSelfCollision(robot))
+
+    def test_selfcollisionlinktransform(self):
+        # moving links without changing the DOF values has to be seen by the next self-collision check
+        env=self.env
+        with env:
+            robot=env.ReadRobotURI('robots/barrettwam.robot.xml')
+            env.Add(robot)
+            report = CollisionReport()
+            assert(not robot.CheckSelfCollision(report))
+            assert(not robot.CheckSelfCollision(report))
+            link = robot.GetLinks()[-1]
+            T = link.GetTransform()
+            link.SetTransform(robot.GetLink('wam3').GetTransform())
+            assert(robot.CheckSelfCollision(report))
+            assert(report.plink1 is not None and report.plink2 is not None)
+            link.SetTransform(T)
+            assert(not robot.CheckSelfCollision(report))
+            assert(report.plink1 is None and report.plink2 is None)
+
+            Tlinks = robot.GetLinkTransformations()
+            Tmoved = list(Tlinks)
+            Tmoved[-1] = Tlinks[0]
+            robot.SetLinkTransformations(Tmoved, robot.GetDOFValues())
+            assert(robot.CheckSelfCollision(report))
+            robot.SetLinkTransformations(Tlinks, robot.GetDOFValues())
+            assert(not robot.CheckSelfCollision(report))
+
+    def test_selfcollisiongrabbedtransform(self):
+        # moving a grabbed body relative to its grabbing link has to be seen by the next self-collision check of the robot
+        env=self.env
+        with env:
+            robot=env.ReadRobotURI('robots/barrettwam.robot.xml')
+            env.Add(robot)
+            body = env.ReadKinBodyXMLData('<KinBody name="box"><Body name="box" type="dynamic"><Geom type="box"><extents>0.05 0.05 0.05</extents></Geom></Body></KinBody>')
+            env.Add(body)
+            manip = robot.GetActiveManipulator()
+            Tbody = manip.GetTransform()
+            Tbody[0:3,3] += 0.5*manip.GetDirection()
+            body.SetTransform(Tbody)
+            robot.Grab(body)
+            assert(not robot.CheckSelfCollision())
+            assert(not robot.CheckSelfCollision())
+            body.SetTransform(robot.GetLink('wam3').GetTransform())
+            assert(robot.CheckSelfCollision())
+            body.SetTransform(Tbody)
+            assert(not robot.CheckSelfCollision())
+            assert(not robot.CheckSelfCollision())
+
     def test_selfcollision(self):
         with self.env:
             self.LoadEnv('data/lab1.env.xml')
@@ -259,6 +321,79 @@ class RunCollision(EnvironmentSetup):
         manip.CheckEndEffectorCollision(report)
         assert(len(report.vLinkColliding)==4)
 
+    def test_collisionrays(self):
+        env=self.env
+        with env:
+            self.LoadEnv('data/lab1.env.xml')
+            robot=env.GetRobots()[0]
+            N = 200
+            rays = c_[tile(array([0,0,2.0]),(N,1)), random.rand(N,3)*4-2]
+            inliers,hitpoints = env.CheckCollisionRays(rays,None)
+            assert(inliers.shape == (N,) and hitpoints.shape == (N,6))
+            report = CollisionReport()
+            for i in range(N):
+                bcollision = env.CheckCollision(Ray(rays[i,0:3],rays[i,3:6]),report)
+                assert(inliers[i] == (bcollision and len(report.contacts) > 0))
+                if inliers[i]:
+                    assert(transdist(hitpoints[i,0:3],report.contacts[0].pos) <= g_epsilon)
+            # non-contiguous input has to give the same result
+            inliers2,hitpoints2 = env.CheckCollisionRays(asfortranarray(rays),None)
+            assert(all(inliers2==inliers) and transdist(hitpoints2,hitpoints) <= g_epsilon)
+
+    def test_threadedcollisions(self):
+        import threading, multiprocessing
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        numthreads = min(4,multiprocessing.cpu_count())
+        clones = [env.CloneSelf(CloningOptions.Bodies) for i in range(numthreads)]
+        try:
+            lower,upper = robot.GetDOFLimits()
+            randomstate = numpy.random.RandomState(0)
+            configs = [[lower+randomstate.rand(len(lower))*(upper-lower) for i in range(100)] for cloneenv in clones]
+            def checkcollisions(cloneenv,values,results):
+                clonerobot = cloneenv.GetRobot(robot.GetName())
+                for q in values:
+                    clonerobot.SetDOFValues(q)
+                    results.append((cloneenv.CheckCollision(clonerobot), clonerobot.CheckSelfCollision()))
+            serialresults = [[] for cloneenv in clones]
+            for cloneenv,values,results in zip(clones,configs,serialresults):
+                checkcollisions(cloneenv,values,results)
+            threadedresults = [[] for cloneenv in clones]
+            threads = [threading.Thread(target=checkcollisions,args=args) for args in zip(clones,configs,threadedresults)]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+            # the checks release the GIL, they still have to give the same answers
+            assert(threadedresults == serialresults)
+        finally:
+            for cloneenv in clones:
+                cloneenv.Destroy()
+
+    def test_tracelog(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        env.SetCollisionChecker(RaveCreateCollisionChecker(env,'tracecollisionchecker '+self.collisioncheckername))
+        tracelogger = RaveCreateModule(env,'tracelogger')
+        tracefilename = 'test_tracelog.ortrace'
+        assert(tracelogger.SendCommand('Start %s'%tracefilename) is not None)
+        try:
+            with env:
+                for i in range(20):
+                    env.CheckCollision(robot)
+            tracelogger.SendCommand('Stop')
+            numrecords, numbytes, numdropped = [int(x) for x in tracelogger.SendCommand('GetStatistics').split()]
+            assert(numrecords >= 20 and numdropped == 0)
+            events = [event for event in misc.LoadTraceLog(tracefilename) if event[0] == TraceEventType.CollisionQuery]
+            assert(len(events) == 20)
+            assert(all([event[1] == robot.GetName() for event in events]))
+        finally:
+            tracelogger.SendCommand('Stop')
+            if os.path.exists(tracefilename):
+                os.remove(tracefilename)
+
 #generate_classes(RunCollision, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunCollision):
@@ -269,6 +404,151 @@ class test_fcl(RunCollision):
     def __init__(self):
         RunCollision.__init__(self, 'fcl_')
 
+    def test_raysmatchode(self):
+        self.log.debug('fcl ray hits have to match the ode ray hits')
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        with env:
+            ode = RaveCreateCollisionChecker(env,'ode')
+            ode.InitEnvironment()
+            N = 100
+            rays = c_[tile(array([0,0,2.0]),(N,1)), random.rand(N,3)*4-2]
+            report = CollisionReport()
+            odereport = CollisionReport()
+            for i in range(N):
+                bcollision = env.CheckCollision(Ray(rays[i,0:3],rays[i,3:6]),report)
+                bodecollision = ode.CheckCollision(Ray(rays[i,0:3],rays[i,3:6]),odereport)
+                assert(bcollision == bodecollision)
+                if bcollision:
+                    assert(transdist(report.contacts[0].pos,odereport.contacts[0].pos) <= 1e-3)
+
+    def test_raygeometrygroup(self):
+        self.log.debug('rays have to use the geometry group of the checker')
+        env=self.env
+        with env:
+            body = RaveCreateKinBody(env,'')
+            body.InitFromBoxes(array([[0,0,0,0.1,0.1,0.1]]),True)
+            body.SetName('box')
+            env.Add(body)
+            infobox = KinBody.Link.GeometryInfo()
+            infobox._type = GeometryType.Box
+            infobox._vGeomData = [0.5,0.5,0.5]
+            body.GetLinks()[0].SetGroupGeometries('large',[infobox])
+
+            checker = env.GetCollisionChecker()
+            report = CollisionReport()
+            assert(env.CheckCollision(Ray([0,0,2],[0,0,-4]),report))
+            assert(abs(report.contacts[0].pos[2]-0.1) <= g_epsilon)
+            assert(not env.CheckCollision(Ray([0.3,0,2],[0,0,-4]),report))
+
+            checker.SetGeometryGroup('large')
+            assert(env.CheckCollision(Ray([0,0,2],[0,0,-4]),report))
+            assert(abs(report.contacts[0].pos[2]-0.5) <= g_epsilon)
+            assert(env.CheckCollision(Ray([0.3,0,2],[0,0,-4]),report))
+            assert(abs(report.contacts[0].pos[2]-0.5) <= g_epsilon)
+            assert(report.plink1 == body.GetLinks()[0])
+
+    def test_rayfrontfacing(self):
+        self.log.debug('rays report the outward normal, so rays leaving a geometry are not front facing')
+        env=self.env
+        with env:
+            body = RaveCreateKinBody(env,'')
+            body.InitFromBoxes(array([[0,0,0,0.1,0.1,0.1]]),True)
+            body.SetName('box')
+            env.Add(body)
+            report = CollisionReport()
+            # from inside the box the ray hits the top face from behind
+            assert(env.CheckCollision(Ray([0,0,0],[0,0,1]),report))
+            assert(abs(report.contacts[0].pos[2]-0.1) <= g_epsilon)
+            assert(transdist(report.contacts[0].norm,[0,0,1]) <= g_epsilon)
+            rays = array([[0,0,0,0,0,1],[0,0,1,0,0,-2]])
+            inliers,hitpoints = env.CheckCollisionRays(rays,None,True)
+            assert(not inliers[0] and inliers[1])
+            assert(abs(hitpoints[1,2]-0.1) <= g_epsilon and transdist(hitpoints[1,3:6],[0,0,1]) <= g_epsilon)
+            inliers,hitpoints = env.CheckCollisionRays(rays,None,False)
+            assert(inliers[0] and inliers[1])
+            assert(transdist(hitpoints[0,3:6],[0,0,1]) <= g_epsilon)
+
+    def test_distancethreshold(self):
+        self.log.debug('test fcl distance computation and the distance threshold')
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        with env:
+            robot=env.GetRobots()[0]
+            manip=robot.GetActiveManipulator()
+            checker=env.GetCollisionChecker()
+            pqp = RaveCreateCollisionChecker(env,'pqp')
+            pqp.InitEnvironment()
+            pqp.SetCollisionOptions(CollisionOptions.Distance)
+            pqpreport = CollisionReport()
+            pqp.CheckCollision(manip.GetEndEffector(),report=pqpreport)
+
+            checker.SetCollisionOptions(CollisionOptions.Distance)
+            report = CollisionReport()
+            assert(not checker.CheckCollision(manip.GetEndEffector(),report=report))
+            assert(abs(report.minDistance-pqpreport.minDistance) < 0.01)
+            assert(report.plink1 == manip.GetEndEffector())
+            assert(report.plink2 == env.GetKinBody('pole').GetLinks()[0])
+
+            # nothing is within the threshold, so the threshold is reported without links
+            checker.SendCommand('SetDistanceThreshold %f'%(0.5*pqpreport.minDistance))
+            assert(not checker.CheckCollision(manip.GetEndEffector(),report=report))
+            assert(abs(report.minDistance-0.5*pqpreport.minDistance) <= g_epsilon)
+            assert(report.plink1 is None and report.plink2 is None)
+
+            checker.SendCommand('SetDistanceThreshold %f'%(2*pqpreport.minDistance))
+            assert(not checker.CheckCollision(manip.GetEndEffector(),report=report))
+            assert(abs(report.minDistance-pqpreport.minDistance) < 0.01)
+            assert(report.plink2 == env.GetKinBody('pole').GetLinks()[0])
+
+    def test_continuousthinobstacle(self):
+        self.log.debug('test that a continuous sweep catches a wall both endpoints miss')
+        env=self.env
+        xmldata = """<KinBody name="arm">
+  <Body name="base">
+    <Geom type="box"><extents>0.02 0.02 0.02</extents></Geom>
+  </Body>
+  <Body name="link">
+    <Geom type="box"><extents>0.5 0.02 0.02</extents><translation>0.6 0 0</translation></Geom>
+  </Body>
+  <Joint name="j0" type="hinge">
+    <Body>base</Body><Body>link</Body>
+    <axis>0 0 1</axis><limitsrad>-3 3</limitsrad>
+  </Joint>
+</KinBody>
+"""
+        with env:
+            arm = env.ReadKinBodyXMLData(xmldata)
+            env.Add(arm)
+            # the tip moves less than the wall thickness per resolution step
+            arm.SetDOFResolutions([0.002])
+            wall = RaveCreateKinBody(env,'')
+            wall.InitFromBoxes(array([[0,0,0,0.4,0.002,0.1]]),True)
+            wall.SetName('wall')
+            env.Add(wall)
+            T = matrixFromAxisAngle([0,0,0.5])
+            T[0:3,3] = [0.8*cos(0.5),0.8*sin(0.5),0]
+            wall.SetTransform(T)
+
+            # with the fcl distance threshold, the distance is unknown for most of the sweep
+            env.GetCollisionChecker().SendCommand('SetDistanceThreshold 0.001')
+            checkers = [RaveCreateCollisionChecker(env,'pqp'), env.GetCollisionChecker()]
+            for checker in checkers:
+                checker.InitEnvironment()
+                checker.SetCollisionOptions(0)
+                arm.SetDOFValues([0])
+                assert(not checker.CheckCollision(arm))
+                arm.SetDOFValues([1])
+                assert(not checker.CheckCollision(arm))
+                report = CollisionReport()
+                assert(checker.CheckContinuousCollision(arm,[0],[0],[1],report=report))
+                assert(report.plink1 == arm.GetLink('link'))
+                assert(report.plink2 == wall.GetLinks()[0])
+                # the report only has what the caller asked for
+                assert(len(report.contacts) == 0)
+                assert(checker.GetCollisionOptions() == 0)
+                assert(not checker.CheckContinuousCollision(arm,[0],[0],[0.3]))
+
 # class test_bullet(RunCollision):
 #     def __init__(self):
 #         RunCollision.__init__(self, 'bullet')
@@ -15,6 +15,7 @@ from common_test_openrave import *
 from openravepy import openravepy_configurationcache
 
 import imp
+import re
 
 class TestConfigurationCache(EnvironmentSetup):
     def setup(self):
@@ -226,6 +227,49 @@ class TestConfigurationCache(EnvironmentSetup):
             assert(int(cachechecker.SendCommand('ValidateSelfCache')) == 1)
             self.log.info('valid tests passed')
 
+    def test_cachestatistics(self):
+        env = self.env
+        with env:
+            self.LoadEnv('data/lab1.env.xml')
+            robot = env.GetRobots()[0]
+            robot.SetActiveDOFs(robot.GetActiveManipulator().GetArmIndices())
+            cachechecker = RaveCreateCollisionChecker(env,'CacheChecker')
+            assert(cachechecker.SendCommand('TrackRobotState %s'%robot.GetName()) is not None)
+            env.SetCollisionChecker(cachechecker)
+            robot.SetSelfCollisionChecker(cachechecker)
+
+            for command in ['GetCacheStatistics', 'GetSelfCacheStatistics']:
+                # reading the statistics resets the counters
+                cachechecker.SendCommand(command)
+                for i in range(10):
+                    if command == 'GetCacheStatistics':
+                        env.CheckCollision(robot)
+                    else:
+                        robot.CheckSelfCollision()
+                # the text output is four integers separated by spaces: checks, collision hits, free hits and cache size
+                output = cachechecker.SendCommand(command)
+                assert(re.match(r'^\d+ \d+ \d+ \d+$', output.strip()) is not None)
+                checks, collisionhits, freehits, cachesize = [int(x) for x in output.split()]
+                # the first check of the configuration misses and inserts it, the others hit
+                assert(checks == 10)
+                assert(collisionhits+freehits == checks-1)
+                assert(cachesize == 1)
+                assert(cachechecker.SendCommand(command).split() == ['0', '0', '0', str(cachesize)])
+
+            # structured commands return the typed values without any text parsing
+            cachechecker.SendStructuredCommand('GetCacheStatistics')
+            for i in range(10):
+                env.CheckCollision(robot)
+            results = cachechecker.SendStructuredCommand('GetCacheStatistics')
+            assert(len(results) == 4 and all([isinstance(x,(int,long)) for x in results]))
+            assert(results[0] == 10 and results[1]+results[2] >= 9 and results[3] == 1)
+            # the arguments are checked against the schema, GetCacheStatistics does not take any
+            assert_raises(openrave_exception, cachechecker.SendStructuredCommand, 'GetCacheStatistics', [1])
+            assert_raises(openrave_exception, cachechecker.SendCommand, 'GetCacheStatistics 1')
+            # text commands get the arguments as text and return their output as one string
+            assert(cachechecker.SendStructuredCommand('TrackRobotState', [robot.GetName()]) is not None)
+            assert(int(cachechecker.SendStructuredCommand('ValidateCache')[0]) == 1)
+
     def test_planning(self):
             env = self.env
             with env:
@@ -245,6 +245,51 @@ class TestEnvironment(EnvironmentSetup):
             os.chdir(oldcwd)
     
 
+    def test_snapshot(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        with env:
+            robot=env.GetRobots()[0]
+            robot.SetDOFValues(0.1*ones(robot.GetDOF()))
+            nonadjacent=robot.GetNonAdjacentLinks(KinBody.AdjacentOptions.Enabled)
+            env.Save('snapshottest.orsnap')
+            try:
+                env2=Environment()
+                try:
+                    starttime=time.time()
+                    assert(env2.Load('snapshottest.orsnap'))
+                    self.log.info('snapshot load time: %fs',time.time()-starttime)
+                    misc.CompareEnvironments(env,env2,epsilon=g_epsilon)
+                    robot2=env2.GetRobot(robot.GetName())
+                    assert(robot2.GetKinematicsGeometryHash()==robot.GetKinematicsGeometryHash())
+                    assert(robot2.GetNonAdjacentLinks(KinBody.AdjacentOptions.Enabled)==nonadjacent)
+                    # restoring over existing bodies has to fail instead of renaming them
+                    numbodies = len(env2.GetBodies())
+                    self.assertRaises(openrave_exception, env2.Load, 'snapshottest.orsnap')
+                    assert(len(env2.GetBodies())==numbodies)
+                finally:
+                    env2.Destroy()
+
+                data = open('snapshottest.orsnap','rb').read()
+                # truncated snapshot
+                open('snapshottest.orsnap','wb').write(data[:len(data)/2])
+                env2=Environment()
+                try:
+                    self.assertRaises(openrave_exception, env2.Load, 'snapshottest.orsnap')
+                    assert(len(env2.GetBodies())==0)
+                finally:
+                    env2.Destroy()
+                # corrupt the name length of the first body, which comes after the 24 byte header and the 4 byte body flags
+                corrupt = data[:28] + '\xff\xff\xff\x7f' + data[32:]
+                open('snapshottest.orsnap','wb').write(corrupt)
+                env2=Environment()
+                try:
+                    self.assertRaises(openrave_exception, env2.Load, 'snapshottest.orsnap')
+                finally:
+                    env2.Destroy()
+            finally:
+                os.remove('snapshottest.orsnap')
+                
     def test_trylock(self):
         env=self.env
         log=self.log
@@ -262,3 +307,96 @@ class TestEnvironment(EnvironmentSetup):
         # thread is done, so should be able to lock
         assert(env.Lock(1.0))
         env.Unlock()
+
+    def test_staterecorder(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        mug1=env.GetKinBody('mug1')
+        mug2=env.GetKinBody('mug2')
+        recorder=RaveCreateModule(env,'staterecorder')
+        statefilename='test_staterecorder.orstate'
+        initialvalues=robot.GetDOFValues()
+        try:
+            with env:
+                # a keyframe every 5 frames, so seeking has to decode across blocks
+                assert(recorder.SendCommand('Start %s 0.05 1'%statefilename) is not None)
+                recordedvalues=[initialvalues]
+                recordedgrabbing=[False]
+                recordedmug2=[mug2.GetTransform()]
+                recorder.SendCommand('Record')
+                for i in range(1,21):
+                    values=initialvalues.copy()
+                    values[0]+=0.01*i
+                    robot.SetDOFValues(values)
+                    if i == 5:
+                        robot.Grab(mug1)
+                    elif i == 16:
+                        robot.Release(mug1)
+                    if i == 12:
+                        env.Remove(mug2)
+                    elif i < 12:
+                        T=mug2.GetTransform()
+                        T[0,3]+=0.01
+                        mug2.SetTransform(T)
+                    env.StepSimulation(0.01)
+                    recorder.SendCommand('Record')
+                    recordedvalues.append(values)
+                    recordedgrabbing.append(robot.IsGrabbing(mug1) is not None)
+                    recordedmug2.append(mug2.GetTransform() if i < 12 else None)
+            recorder.SendCommand('Stop')
+            player=RaveCreateModule(env,'stateplayer')
+            assert(player.SendCommand('Open %s'%statefilename) is not None)
+            starttime,endtime=[float(x) for x in player.SendCommand('GetTimeRange').split()]
+            assert(endtime > starttime)
+            # exactly on the frames and in the middle of two frames, in an order that seeks back and forth across keyframes
+            for offset in [0,0.005]:
+                for i in [20,3,12,11,5,4,15,16,0,10,9,17,7,1,19,6]:
+                    player.SendCommand('Seek %f'%(starttime+0.01*i+offset))
+                    with env:
+                        assert(transdist(robot.GetDOFValues(),recordedvalues[i]) <= g_epsilon)
+                        assert((robot.IsGrabbing(mug1) is not None) == recordedgrabbing[i])
+                        body=env.GetKinBody('mug2')
+                        if recordedmug2[i] is None:
+                            assert(body is None)
+                        else:
+                            assert(body is not None and transdist(body.GetTransform(),recordedmug2[i]) <= g_epsilon)
+            player.SendCommand('Seek %f'%(endtime+1))
+            assert(transdist(robot.GetDOFValues(),recordedvalues[-1]) <= g_epsilon)
+        finally:
+            recorder.SendCommand('Stop')
+            if os.path.exists(statefilename):
+                os.remove(statefilename)
+
+    def test_profiler(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        robot=env.GetRobots()[0]
+        profiler=RaveCreateModule(env,'profiler')
+        if int(profiler.SendCommand('IsCompiled')) == 0:
+            raise nose.SkipTest('OpenRAVE was compiled without OPT_PROFILING')
+
+        assert(profiler.SendCommand('Start 1000') is not None)
+        try:
+            with env:
+                for i in range(10):
+                    robot.SetDOFValues(robot.GetDOFValues())
+                    env.CheckCollision(robot)
+            zones=[line.split() for line in profiler.SendCommand('GetProfile').splitlines()]
+            assert(len(zones) > 0)
+            for depth, name, numcalls, totaltime, selftime in zones:
+                assert(int(depth) >= 0 and int(numcalls) > 0 and float(selftime) <= float(totaltime)+g_epsilon)
+            tracefilename='test_profiler.json'
+            assert(profiler.SendCommand('WriteChromeTrace %s'%tracefilename) is not None)
+            try:
+                import json
+                events=json.load(open(tracefilename,'r'))['traceEvents']
+                assert(len(events) >= len(zones))
+            finally:
+                os.remove(tracefilename)
+            profiler.SendCommand('Reset')
+            zones=[line.split() for line in profiler.SendCommand('GetProfile').splitlines()]
+            assert(len(zones) > 0)
+            assert(all([int(numcalls) == 0 for depth, name, numcalls, totaltime, selftime in zones]))
+        finally:
+            profiler.SendCommand('Stop')
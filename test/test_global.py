@@ -24,6 +24,69 @@ def test_pluginloading():
     env=Environment()
     assert(RaveCreateProblem(env,'ikfast') is not None)
 
+@with_destroy
+def test_plugincache():
+    import tempfile, shutil
+    RaveDestroy()
+    RaveInitialize(load_all_plugins=True)
+    sourcepath = [name for name,info in RaveGetPluginInfo() if os.path.basename(name).find('basesamplers') >= 0][0]
+    RaveDestroy()
+    homedir = tempfile.mkdtemp()
+    OPENRAVE_HOME = os.environ.get('OPENRAVE_HOME',None)
+    OPENRAVE_PLUGINS = os.environ.get('OPENRAVE_PLUGINS',None)
+    OPENRAVE_PLUGIN_CACHE = os.environ.pop('OPENRAVE_PLUGIN_CACHE',None)
+    try:
+        # copy the plugin so that its modification time can be changed
+        plugindir = os.path.join(homedir,'plugins')
+        os.mkdir(plugindir)
+        pluginpath = os.path.join(plugindir,os.path.basename(sourcepath))
+        shutil.copy(sourcepath,pluginpath)
+        modifiedtime = int(os.stat(pluginpath).st_mtime)-10
+        os.utime(pluginpath,(modifiedtime,modifiedtime))
+        os.environ['OPENRAVE_HOME'] = homedir
+        os.environ['OPENRAVE_PLUGINS'] = plugindir
+        cachefilename = os.path.join(homedir,'plugins.cache')
+        def ReadStamp():
+            lines = open(cachefilename).read().splitlines()
+            return [long(value) for value in lines[lines.index(pluginpath)+1].split()[0:2]]
+
+        def CreateSampler():
+            RaveInitialize(load_all_plugins=True)
+            env=Environment()
+            try:
+                assert(RaveCreateSpaceSampler(env,'mt19937') is not None)
+            finally:
+                env.Destroy()
+                RaveDestroy()
+
+        # the cache is off by default and nothing is written to the home directory
+        CreateSampler()
+        assert(not os.path.exists(cachefilename))
+        os.environ['OPENRAVE_PLUGIN_CACHE'] = '1'
+
+        # miss, the plugin is opened and recorded with its nanosecond modification time and size
+        CreateSampler()
+        assert(ReadStamp() == [modifiedtime*1000000000,os.path.getsize(pluginpath)])
+
+        # hit, the cache is used and not rewritten
+        cacheinode = os.stat(cachefilename).st_ino
+        CreateSampler()
+        assert(os.stat(cachefilename).st_ino == cacheinode)
+        assert(ReadStamp() == [modifiedtime*1000000000,os.path.getsize(pluginpath)])
+
+        # invalidation, a modification within the same second is detected
+        os.utime(pluginpath,(modifiedtime,modifiedtime+0.5))
+        CreateSampler()
+        assert(os.stat(cachefilename).st_ino != cacheinode)
+        assert(ReadStamp() == [modifiedtime*1000000000+500000000,os.path.getsize(pluginpath)])
+    finally:
+        for name,value in [('OPENRAVE_HOME',OPENRAVE_HOME),('OPENRAVE_PLUGINS',OPENRAVE_PLUGINS),('OPENRAVE_PLUGIN_CACHE',OPENRAVE_PLUGIN_CACHE)]:
+            if value is None:
+                os.environ.pop(name,None)
+            else:
+                os.environ[name] = value
+        shutil.rmtree(homedir)
+
 class RunTutorialExample(object):
     __name__= 'test_global.tutorialexample'
     def __call__(self,modulepath):
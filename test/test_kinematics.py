@@ -1122,3 +1122,129 @@ class TestKinematics(EnvironmentSetup):
         assert(robot.CheckSelfCollision())
         robot.SetNonCollidingConfiguration()
         assert(not robot.CheckSelfCollision())
+
+    def test_outputarrays(self):
+        env=self.env
+        with env:
+            robot=self.LoadRobot('robots/barrettwam.robot.xml')
+            body=env.ReadKinBodyURI('data/mug1.kinbody.xml')
+            env.Add(body,True)
+            robot.SetDOFValues(robot.GetDOFValues()+0.1*(random.rand(robot.GetDOF())-0.5))
+            out = zeros(robot.GetDOF())
+            assert(robot.GetDOFValues(None,out) is out)
+            assert(transdist(out,robot.GetDOFValues()) <= g_epsilon)
+            out2 = zeros(3)
+            assert(transdist(robot.GetDOFValues([0,2,3],out=out2),robot.GetDOFValues([0,2,3])) <= g_epsilon)
+
+            numlinks = len(robot.GetLinks())
+            poses = zeros((numlinks,7))
+            robot.GetLinkTransformations(False,poses)
+            matrices = zeros((numlinks,4,4))
+            robot.GetLinkTransformations(False,matrices)
+            for ilink,link in enumerate(robot.GetLinks()):
+                assert(transdist(poses[ilink],link.GetTransformPose()) <= g_epsilon)
+                assert(transdist(matrices[ilink],link.GetTransform()) <= g_epsilon)
+            velocities = zeros((numlinks,6))
+            assert(transdist(robot.GetLinkVelocities(out=velocities),robot.GetLinkVelocities()) <= g_epsilon)
+
+            alldofvalues = env.GetBodiesDOFValues([robot,body])
+            assert(transdist(alldofvalues,robot.GetDOFValues()) <= g_epsilon)
+            allposes = zeros((numlinks+len(body.GetLinks()),7))
+            env.GetBodiesLinkTransformationPoses([robot,body],allposes)
+            assert(transdist(allposes[:numlinks],poses) <= g_epsilon)
+            assert(transdist(allposes[numlinks:],poseFromMatrix(body.GetTransform())) <= g_epsilon)
+
+            # wrong size or layout has to be rejected
+            assert_raises(openrave_exception,robot.GetDOFValues,None,zeros(robot.GetDOF()+1))
+            assert_raises(openrave_exception,robot.GetLinkVelocities,zeros((6,numlinks)).T)
+
+    def test_batchkinematics(self):
+        env=self.env
+        with env:
+            robot=self.LoadRobot('robots/barrettwam.robot.xml')
+            manip=robot.GetActiveManipulator()
+            lower,upper = robot.GetDOFLimits()
+            N = 50
+            dofvalues = lower+random.rand(N,robot.GetDOF())*(upper-lower)
+            origvalues = robot.GetDOFValues()
+            poses = robot.ComputeBatchLinkTransformationPoses(dofvalues,None,4)
+            armvalues = dofvalues[:,manip.GetArmIndices()]
+            jacobians = manip.CalculateBatchJacobians(armvalues,None,4)
+            # the body itself has to be untouched
+            assert(transdist(robot.GetDOFValues(),origvalues) <= g_epsilon)
+            assert(poses.shape == (N,len(robot.GetLinks()),7) and jacobians.shape == (N,6,len(manip.GetArmIndices())))
+            for i in range(N):
+                robot.SetDOFValues(dofvalues[i])
+                for ilink,link in enumerate(robot.GetLinks()):
+                    assert(transdist(poses[i,ilink],link.GetTransformPose()) <= g_epsilon)
+                robot.SetDOFValues(armvalues[i],manip.GetArmIndices())
+                assert(transdist(jacobians[i,0:3],manip.CalculateJacobian()) <= g_epsilon)
+                assert(transdist(jacobians[i,3:6],manip.CalculateAngularVelocityJacobian()) <= g_epsilon)
+            out = zeros(poses.shape)
+            assert(robot.ComputeBatchLinkTransformationPoses(dofvalues,out,1) is out)
+            assert(transdist(out,poses) <= g_epsilon)
+
+    def test_batchkinematicsthreaded(self):
+        env=self.env
+        xml="""
+<kinbody name="a">
+  <body name="L0">
+  </body>
+  <body name="L1">
+    <translation>0 0 0.3</translation>
+  </body>
+  <body name="L2">
+    <translation>0 0.2 0.5</translation>
+  </body>
+  <body name="L3">
+    <translation>0.1 0 0.8</translation>
+  </body>
+  <joint name="J0" type="hinge">
+    <body>L0</body>
+    <body>L1</body>
+    <axis>0 0 1</axis>
+    <limitsdeg>-90 90</limitsdeg>
+  </joint>
+  <joint name="J1" type="hinge">
+    <body>L1</body>
+    <body>L2</body>
+    <anchor>0 0 0.3</anchor>
+    <axis>1 0 0</axis>
+    <limitsdeg>-90 90</limitsdeg>
+  </joint>
+  <joint name="J1a" type="hinge" mimic_pos="2*J1+J0" mimic_vel="|J1 2 |J0 1" mimic_accel="|J1 0 |J0 0">
+    <body>L2</body>
+    <body>L3</body>
+    <anchor>0 0.2 0.5</anchor>
+    <axis>0 1 0</axis>
+  </joint>
+</kinbody>
+"""
+        with env:
+            body = env.ReadKinBodyData(xml)
+            env.Add(body)
+            T = matrixFromAxisAngle([0.3,0.2,0.1])
+            T[0:3,3] = [0.5,-0.2,0.1]
+            body.SetTransform(T)
+            lower,upper = body.GetDOFLimits()
+            N = 200
+            dofvalues = lower+random.rand(N,body.GetDOF())*(upper-lower)
+            serialposes = body.ComputeBatchLinkTransformationPoses(dofvalues,None,1)
+            # repeated calls reuse the cached copies, so run the threaded query twice
+            for itry in range(2):
+                poses = body.ComputeBatchLinkTransformationPoses(dofvalues,None,4)
+                assert(transdist(poses,serialposes) <= g_epsilon)
+            for i in range(N):
+                body.SetDOFValues(dofvalues[i])
+                for ilink,link in enumerate(body.GetLinks()):
+                    assert(transdist(serialposes[i,ilink],link.GetTransformPose()) <= g_epsilon)
+
+            # the copies have to follow the base transform and joint limits of the body
+            T[0:3,3] = [-0.3,0.4,0.2]
+            body.SetTransform(T)
+            body.SetDOFLimits(0.5*lower,0.5*upper)
+            poses = body.ComputeBatchLinkTransformationPoses(dofvalues,None,4)
+            for i in range(N):
+                body.SetDOFValues(dofvalues[i],range(body.GetDOF()),checklimits=KinBody.CheckLimitsAction.CheckLimitsSilent)
+                for ilink,link in enumerate(body.GetLinks()):
+                    assert(transdist(poses[i,ilink],link.GetTransformPose()) <= g_epsilon)
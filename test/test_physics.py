@@ -254,6 +254,104 @@ class RunPhysics(EnvironmentSetup):
             T1 = nonmovingbody.GetTransform()
             assert(transdist(T0,T1)<=0.5)
 
+    def test_odeautodisable(self):
+        log.info('test that ode skips bodies at rest and wakes them up when they are moved')
+        if self.physicsenginename != 'ode':
+            return
+
+        xmldata = """<environment>
+  <KinBody name="resting">
+    <Translation>0 0 0.2</Translation>
+    <Body type="dynamic">
+      <Geom type="box">
+        <extents>0.1 0.1 0.1</extents>
+      </Geom>
+      <mass type="box">
+        <extents>0.1 0.1 0.1</extents>
+        <density>1000</density>
+      </mass>
+    </Body>
+  </KinBody>
+  <KinBody name="falling">
+    <Translation>2 0 3</Translation>
+    <Body type="dynamic">
+      <Geom type="box">
+        <extents>0.1 0.1 0.1</extents>
+      </Geom>
+      <mass type="box">
+        <extents>0.1 0.1 0.1</extents>
+        <density>1000</density>
+      </mass>
+    </Body>
+  </KinBody>
+  <KinBody name="floor">
+    <Body type="static">
+      <Translation>0 0 -0.1</Translation>
+      <Geom type="box">
+        <extents>10 10 0.1</extents>
+      </Geom>
+    </Body>
+  </KinBody>
+  <physicsengine type="ode">
+    <odeproperties>
+      <gravity>0 0 -9.8</gravity>
+      <autodisable>%d</autodisable>
+      <autodisablesteps>10</autodisablesteps>
+    </odeproperties>
+  </physicsengine>
+</environment>
+"""
+        env=self.env
+        with env:
+            # bodies that are moving are stepped exactly as without autodisable
+            trajectories = []
+            for autodisable in [0,1]:
+                env.Reset()
+                self.LoadDataEnv(xmldata%autodisable)
+                falling = env.GetKinBody('falling')
+                resting = env.GetKinBody('resting')
+                Tfalling = []
+                Tresting = []
+                for i in range(50):
+                    env.StepSimulation(0.01)
+                    Tfalling.append(falling.GetTransform())
+                    Tresting.append(resting.GetTransform())
+                trajectories.append((array(Tfalling),array(Tresting)))
+            assert(all(abs(trajectories[0][0]-trajectories[1][0]) <= g_epsilon))
+            assert(all(abs(trajectories[0][1]-trajectories[1][1]) <= 0.01))
+
+            # a body at rest is put to sleep and is not updated anymore
+            for i in range(500):
+                env.StepSimulation(0.01)
+            stamp = resting.GetUpdateStamp()
+            T = resting.GetTransform()
+            for i in range(10):
+                env.StepSimulation(0.01)
+            assert(resting.GetUpdateStamp() == stamp)
+            assert(transdist(resting.GetTransform(),T) <= g_epsilon)
+
+            # moving it through openrave wakes it up
+            T[2,3] += 0.5
+            resting.SetTransform(T)
+            stamp = resting.GetUpdateStamp()
+            for i in range(10):
+                env.StepSimulation(0.01)
+            assert(resting.GetUpdateStamp() != stamp)
+            assert(resting.GetTransform()[2,3] < T[2,3]-0.01)
+
+            # the cached step buffers follow bodies being removed and added
+            env.Remove(falling)
+            for i in range(10):
+                env.StepSimulation(0.01)
+            Tfalling = falling.GetTransform()
+            Tfalling[2,3] += 1
+            falling.SetTransform(Tfalling)
+            env.Add(falling)
+            stamp = falling.GetUpdateStamp()
+            for i in range(10):
+                env.StepSimulation(0.01)
+            assert(falling.GetUpdateStamp() != stamp)
+
     def test_applytorque(self):
         log.info('test if torque can be applied')
         self.LoadEnv('data/lab1.env.xml')
@@ -267,6 +365,60 @@ class RunPhysics(EnvironmentSetup):
             for i in range(10):
                 env.StepSimulation(0.01)
 
+    def test_rollouts(self):
+        log.info('test that parallel rollouts give the same results as serial ones and do not change the environment')
+        env=self.env
+        self.LoadEnv('data/hanoi.env.xml')
+        with env:
+            env.GetPhysicsEngine().SetGravity([0,0,-9.81])
+            robot = env.GetRobots()[0]
+            robot.GetLinks()[0].SetStatic(True)
+            Tlinks = [link.GetTransform() for link in env.GetBodies()[0].GetLinks()]
+            rollouts = []
+            for i in range(6):
+                rollout = PhysicsRollout()
+                rollout.fTimeStep = 0.005
+                rollout.nSteps = 20
+                rollout.nRecordStride = 5
+                rollout.AddControls(robot.GetName(), 0.1*i*ones((rollout.nSteps,robot.GetDOF())))
+                rollouts.append(rollout)
+            assert(RaveSimulatePhysicsRollouts(env,rollouts,1))
+            serialtransforms = [array(rollout.vfinaltransforms) for rollout in rollouts]
+            assert(all([len(rollout.vrecordedtransforms) == 4 for rollout in rollouts]))
+            assert(RaveSimulatePhysicsRollouts(env,rollouts,3))
+            for rollout, Tserial in zip(rollouts, serialtransforms):
+                assert(len(rollout.vbodynames) == len(env.GetBodies()))
+                assert(all(abs(array(rollout.vfinaltransforms)-Tserial) <= g_epsilon))
+            for link, T in zip(env.GetBodies()[0].GetLinks(), Tlinks):
+                assert(transdist(link.GetTransform(),T) <= g_epsilon)
+            # simulating the same rollout again on the same engine gives the same results
+            physics = env.GetPhysicsEngine()
+            rollout = rollouts[-1]
+            assert(physics.SimulateRollout(rollout))
+            Tfinal = array(rollout.vfinaltransforms)
+            assert(physics.SimulateRollout(rollout))
+            assert(all(abs(array(rollout.vfinaltransforms)-Tfinal) <= g_epsilon))
+
+    def test_rolloutcollisioncallback(self):
+        log.info('collision callbacks called while stepping can use the collision checker')
+        env=self.env
+        self.LoadEnv('data/hanoi.env.xml')
+        env.SetCollisionChecker(RaveCreateCollisionChecker(env,'ode'))
+        robot = env.GetRobots()[0]
+        checks = []
+        def collisioncallback(report,fromphysics):
+            checks.append(env.CheckCollision(robot))
+            return CollisionAction.DefaultAction
+        handle = env.RegisterCollisionCallback(collisioncallback)
+        with env:
+            env.GetPhysicsEngine().SetGravity([0,0,-9.81])
+            rollout = PhysicsRollout()
+            rollout.fTimeStep = 0.005
+            rollout.nSteps = 50
+            assert(env.GetPhysicsEngine().SimulateRollout(rollout))
+        assert(len(checks) > 0)
+        handle.Close()
+
 #generate_classes(RunPhysics, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunPhysics):
@@ -277,3 +429,91 @@ class test_ode(RunPhysics):
 #     def __init__(self):
 #         RunPhysics.__init__(self, 'bullet')
 #         
+
+class test_bulletproperties(EnvironmentSetup):
+    xmldata = """<environment>
+  <KinBody name="box">
+    <Translation>0 0 %(height)f</Translation>
+    <Body type="dynamic">
+      <Geom type="box">
+        <extents>0.1 0.1 0.1</extents>
+      </Geom>
+      <mass type="box">
+        <extents>0.1 0.1 0.1</extents>
+        <density>1000</density>
+      </mass>
+    </Body>
+  </KinBody>
+  <KinBody name="floor">
+    <Body type="static">
+      <Translation>0 0 -0.1</Translation>
+      <Geom type="box">
+        <extents>10 10 0.1</extents>
+      </Geom>
+    </Body>
+  </KinBody>
+  <physicsengine type="bullet">
+    <bulletproperties>
+      <gravity>0 0 -9.8</gravity>
+      <linear_damping>0</linear_damping>
+      <broadphase>%(broadphase)s</broadphase>
+      <world_bounds>-20 -20 -20 20 20 20</world_bounds>
+      <fixed_timestep>0.01</fixed_timestep>
+      <max_substeps>%(max_substeps)d</max_substeps>
+      <contact_caching>%(contact_caching)d</contact_caching>
+    </bulletproperties>
+  </physicsengine>
+</environment>
+"""
+    def LoadBox(self,height=0.5,broadphase='dbvt',max_substeps=0,contact_caching=0):
+        if RaveCreatePhysicsEngine(self.env,'bullet') is None:
+            raise nose.SkipTest('OpenRAVE was compiled without the bullet physics engine')
+        self.env.Reset()
+        self.LoadDataEnv(self.xmldata%{'height':height,'broadphase':broadphase,'max_substeps':max_substeps,'contact_caching':contact_caching})
+        assert(self.env.GetPhysicsEngine().GetXMLId() == 'bullet')
+        return self.env.GetKinBody('box')
+
+    def test_broadphase(self):
+        log.info('test that the box lands on the floor with both broadphases')
+        env=self.env
+        with env:
+            finalheights = []
+            for broadphase in ['dbvt','sap']:
+                box = self.LoadBox(broadphase=broadphase)
+                for i in range(200):
+                    env.StepSimulation(0.01)
+                finalheights.append(box.GetTransform()[2,3])
+            assert(all(abs(array(finalheights)-0.1) <= 0.01))
+
+    def test_fixedtimestep(self):
+        log.info('test that the elapsed time is only divided into substeps when max_substeps is set')
+        env=self.env
+        with env:
+            falldistances = []
+            for max_substeps in [0,10]:
+                box = self.LoadBox(height=5,max_substeps=max_substeps)
+                for i in range(10):
+                    env.StepSimulation(0.05)
+                falldistances.append(5-box.GetTransform()[2,3])
+            # without substeps every step advances the world by fixed_timestep, so the box falls for 0.1s instead of 0.5s
+            assert(abs(falldistances[0]-0.5*9.8*0.1**2) <= 0.01)
+            assert(abs(falldistances[1]-0.5*9.8*0.5**2) <= 0.05)
+
+    def test_rolloutreset(self):
+        log.info('test that rollouts start from the same state when contacts are cached between steps')
+        env=self.env
+        with env:
+            box = self.LoadBox(height=0.15,contact_caching=1)
+            physics = env.GetPhysicsEngine()
+            Tbox = box.GetTransform()
+            rollout = PhysicsRollout()
+            rollout.fTimeStep = 0.01
+            rollout.nSteps = 50
+            assert(physics.SimulateRollout(rollout))
+            Tfinal = array(rollout.vfinaltransforms)
+            # stepping the engine fills the contact manifolds and the deactivation timers
+            for i in range(100):
+                env.StepSimulation(0.01)
+            box.SetTransform(Tbox)
+            assert(physics.SimulateRollout(rollout))
+            assert(all(abs(array(rollout.vfinaltransforms)-Tfinal) <= g_epsilon))
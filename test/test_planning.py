@@ -615,6 +615,111 @@ class RunPlanning(EnvironmentSetup):
             assert(success)
             assert(not env.CheckCollision(collisionbody))
 
+    def test_grasperdistancestepping(self):
+        env=self.env
+        # needs a checker that measures distances
+        env.SetCollisionChecker(RaveCreateCollisionChecker(env,'pqp'))
+        robot=self.LoadRobot('robots/barretthand.robot.xml')
+        self.LoadEnv('data/mug1.kinbody.xml')
+        with env:
+            target=env.GetKinBody('mug')
+            manip=robot.GetActiveManipulator()
+            robot.SetActiveDOFs(manip.GetGripperIndices(),DOFAffine.X|DOFAffine.Y|DOFAffine.Z)
+            planner=RaveCreatePlanner(env,'Grasper')
+            numsolutions = 0
+            for direction in [[1,0,0],[-1,0.3,0],[0,0,1]]:
+                for returntrajectory in [0,1]:
+                    results = []
+                    for distancestepping in [0,1]:
+                        robot.SetTransform(eye(4))
+                        robot.SetDOFValues(zeros(robot.GetDOF()))
+                        params=Planner.PlannerParameters()
+                        params.SetRobotActiveJoints(robot)
+                        params.SetExtraParameters('<targetbody>%d</targetbody><btransformrobot>1</btransformrobot><breturntrajectory>%d</breturntrajectory><vtargetdirection>%f %f %f</vtargetdirection>'%((target.GetEnvironmentId(),returntrajectory)+tuple(direction)))
+                        planner.SendCommand('SetDistanceStepping %d'%distancestepping)
+                        traj=RaveCreateTrajectory(env,'')
+                        assert(planner.InitPlan(robot,params))
+                        status=planner.PlanPath(traj)
+                        numchecks=int(planner.SendCommand('GetCollisionCheckCount'))
+                        waypoints=[traj.GetWaypoint(i,robot.GetActiveConfigurationSpecification()) for i in range(traj.GetNumWaypoints())]
+                        contacts=[]
+                        if len(waypoints) > 0:
+                            robot.SetActiveDOFValues(waypoints[-1])
+                            contacts=[link.GetName() for link in robot.GetLinks() if env.CheckCollision(link,target)]
+                        results.append((status,waypoints,contacts,numchecks))
+                    # the distances only skip checks, so the plans have to be the same as stepping through every check
+                    assert(results[0][0] == results[1][0])
+                    assert(len(results[0][1]) == len(results[1][1]))
+                    for waypoint0,waypoint1 in zip(results[0][1],results[1][1]):
+                        assert(transdist(waypoint0,waypoint1) <= g_epsilon)
+                    assert(results[0][2] == results[1][2])
+                    assert(results[1][3] < results[0][3])
+                    if len(results[0][1]) > 0:
+                        numsolutions += 1
+            assert(numsolutions > 0)
+
+    def test_graspthreaded(self):
+        env=self.env
+        env.SetCollisionChecker(RaveCreateCollisionChecker(env,'pqp'))
+        robot=self.LoadRobot('robots/barretthand.robot.xml')
+        self.LoadEnv('data/mug1.kinbody.xml')
+        with env:
+            target=env.GetKinBody('mug')
+            manip=robot.GetActiveManipulator()
+            robot.SetActiveDOFs(manip.GetGripperIndices(),DOFAffine.X|DOFAffine.Y|DOFAffine.Z)
+            grasper=interfaces.Grasper(robot)
+            ab=target.ComputeAABB()
+            approachrays=[]
+            for direction in [[1,0,0],[-1,0,0],[0,1,0],[0,-1,0],[0,0,-1]]:
+                approachrays.append(r_[ab.pos()-array(direction)*linalg.norm(ab.extents()),direction])
+            approachrays=array(approachrays)
+            standoffs=array([0,0.025])
+            preshapes=array([zeros(len(manip.GetGripperIndices()))])
+            rolls=array([0,pi/2])
+            manipulatordirections=array([manip.GetDirection()])
+            def graspthreaded(numthreads,**kwargs):
+                return grasper.GraspThreaded(approachrays=approachrays,standoffs=standoffs,preshapes=preshapes,rolls=rolls,manipulatordirections=manipulatordirections,target=target,forceclosurethreshold=-1,numthreads=numthreads,**kwargs)
+            def compareresults(results0,results1):
+                assert(len(results0) == len(results1))
+                for result0,result1 in zip(results0,results1):
+                    for value0,value1 in zip(result0[:8],result1[:8]):
+                        assert(numpy.sum(abs(array(value0)-array(value1))) <= g_epsilon)
+                    assert(transdist(result0[8],result1[8]) <= g_epsilon)
+                    assert(transdist(result0[9],result1[9]) <= g_epsilon)
+                    assert(result0[10].shape == result1[10].shape and transdist(result0[10],result1[10]) <= g_epsilon)
+
+            numgrasps = len(approachrays)*len(standoffs)*len(preshapes)*len(rolls)*len(manipulatordirections)
+            nextid,results = graspthreaded(1)
+            assert(nextid == numgrasps and len(results) >= 4)
+            # the results are sorted by grasp index, so the thread count cannot change them
+            for numthreads in [2,4]:
+                nextid2,results2 = graspthreaded(numthreads)
+                assert(nextid2 == nextid)
+                compareresults(results,results2)
+
+            # truncating to maxgrasps keeps the first grasps by index and resumes right after the last one kept
+            for numthreads in [1,4]:
+                nextid2,results2 = graspthreaded(numthreads,maxgrasps=2)
+                compareresults(results[0:2],results2)
+                nextid3,results3 = graspthreaded(numthreads,maxgrasps=2,startindex=nextid2)
+                compareresults(results[2:4],results3)
+
+    def test_plannerbenchmark(self):
+        env=self.env
+        self.LoadEnv('data/lab1.env.xml')
+        import json
+        benchmark = RaveCreateModule(env,'plannerbenchmark')
+        results = [json.loads(benchmark.SendCommand('Run planner birrt manip arm numqueries 2 numseeds 3 maxiterations 2000 numthreads %d'%numthreads)) for numthreads in [1,3]]
+        for result in results:
+            assert(result['summary']['numruns'] == 6)
+            assert(result['summary']['successrate'] > 0)
+        # the runs only depend on the query and seed, so the thread count should not change them
+        runs0 = results[0]['scenes'][0]['runs']
+        runs1 = results[1]['scenes'][0]['runs']
+        for run0,run1 in zip(runs0,runs1):
+            assert(run0['success'] == run1['success'])
+            assert(abs(run0['pathlength']-run1['pathlength']) <= g_epsilon)
+
 #generate_classes(RunPlanning, globals(), [('ode','ode'),('bullet','bullet')])
 
 class test_ode(RunPlanning):
@@ -107,7 +107,7 @@ def CompileProject(cmakedir,cmakebuilddir=None):
     finally:
         os.chdir(curdir)
 
-def CompileRunCPP(name,cppdata):
+def CompileRunCPP(name,cppdata,usecore=False):
     curdir = os.getcwd()
     try:
         shutil.rmtree(name)
@@ -125,9 +125,9 @@ include_directories(${OpenRAVE_INCLUDE_DIRS} ${Boost_INCLUDE_DIRS})
 link_directories(${OpenRAVE_LIBRARY_DIRS} ${Boost_LIBRARY_DIRS})
 add_executable(%(name)s %(name)s.cpp)
 set_target_properties(%(name)s PROPERTIES COMPILE_FLAGS "${OpenRAVE_CXX_FLAGS}" LINK_FLAGS "${OpenRAVE_LINK_FLAGS}")
-target_link_libraries(%(name)s ${OpenRAVE_LIBRARIES})
+target_link_libraries(%(name)s %(libraries)s)
 install(TARGETS %(name)s DESTINATION .)
-"""%{'name':name}
+"""%{'name':name,'libraries':'${OpenRAVE_CORE_LIBRARIES}' if usecore else '${OpenRAVE_LIBRARIES}'}
         open(os.path.join(name,'CMakeLists.txt'),'w').write(CMakeLists)
         programdir = CompileProject(name,os.path.join(name,'build'))
         assert(os.system(GetRunCommand()+os.path.join(programdir,name)) == 0)
@@ -163,6 +163,623 @@ int main()
 }
     """
     CompileRunCPP('testutils',cppdata)
+
+def test_cppstructuredcommands():
+    cppdata="""#include <openrave-core.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/format.hpp>
+#include <boost/atomic.hpp>
+#include <iostream>
+#include <sstream>
+#include <cmath>
+using namespace OpenRAVE;
+using namespace std;
+
+#define CHECK(expr) if( !(expr) ) { cerr << "line " << __LINE__ << ": " << #expr << " failed" << endl; return 1; }
+
+class TestModule : public ModuleBase
+{
+public:
+    TestModule(EnvironmentBasePtr penv) : ModuleBase(penv) {
+        std::vector<CommandArgument> vargs;
+        vargs.push_back(CommandArgument("count", CVT_Int));
+        vargs.push_back(CommandArgument("scale", CVT_Real));
+        vargs.push_back(CommandArgument("values", CVT_Reals, true));
+        RegisterStructuredCommand("Scale", boost::bind(&TestModule::_ScaleCommand, this, _1, _2), vargs, "Scales the values");
+        RegisterCommand("Echo", boost::bind(&TestModule::_EchoCommand, this, _1, _2), "Echoes the input");
+    }
+    void Register(const std::string& cmdname, const std::vector<CommandArgument>& vargs) {
+        RegisterStructuredCommand(cmdname, boost::bind(&TestModule::_ScaleCommand, this, _1, _2), vargs, "");
+    }
+    void Unregister(const std::string& cmdname) {
+        UnregisterCommand(cmdname);
+    }
+    bool _ScaleCommand(const std::vector<CommandValue>& vargs, std::vector<CommandValue>& vresults) {
+        if( vargs.size() < 3 || vargs[2].type == CVT_None ) {
+            vresults.push_back(CommandValue(vargs.size() > 0 ? vargs[0].intvalue : 0));
+            vresults.push_back(CommandValue(vargs.size() > 1 ? vargs[0].intvalue*vargs[1].realvalue : 0));
+        }
+        else {
+            std::vector<dReal> values = vargs[2].realvalues;
+            for(size_t i = 0; i < values.size(); ++i) {
+                values[i] *= vargs[1].realvalue;
+            }
+            vresults.push_back(CommandValue(values));
+        }
+        return true;
+    }
+    bool _EchoCommand(ostream& sout, istream& sinput) {
+        sout << sinput.rdbuf();
+        return true;
+    }
+};
+
+static boost::atomic<bool> s_bfailed(false); ///< set by the sending threads
+
+static void SendLoop(boost::shared_ptr<TestModule> module, int num)
+{
+    std::vector<CommandValue> vargs, vresults;
+    vargs.push_back(CommandValue(2));
+    vargs.push_back(CommandValue(0.5));
+    for(int i = 0; i < num; ++i) {
+        if( !module->SendStructuredCommand("scale", vargs, vresults) || vresults.size() != 2 || vresults[0].intvalue != 2 ) {
+            s_bfailed = true;
+        }
+        module->SupportsCommand(str(boost::format("dynamic%d")%(i%10)));
+    }
+}
+
+static void RegisterLoop(boost::shared_ptr<TestModule> module, int num)
+{
+    for(int i = 0; i < num; ++i) {
+        std::string cmdname = str(boost::format("Dynamic%d")%(i%10));
+        if( module->SupportsCommand(cmdname) ) {
+            module->Unregister(cmdname);
+        }
+        else {
+            module->Register(cmdname, std::vector<CommandArgument>());
+        }
+    }
+}
+
+int main()
+{
+    RaveInitialize(false);
+    EnvironmentBasePtr penv = RaveCreateEnvironment();
+    boost::shared_ptr<TestModule> module(new TestModule(penv));
+    std::vector<CommandValue> vargs, vresults;
+
+    // structured send with the optional argument left out and given
+    vargs.push_back(CommandValue(size_t(3)));
+    vargs.push_back(CommandValue(2.0f));
+    CHECK(module->SendStructuredCommand("scale", vargs, vresults));
+    CHECK(vresults.size() == 2 && vresults[0].type == CVT_Int && vresults[0].intvalue == 3 && vresults[1].type == CVT_Real && vresults[1].realvalue == 6);
+    vargs.push_back(CommandValue(std::vector<dReal>(2, 1.5)));
+    CHECK(module->SendStructuredCommand("Scale", vargs, vresults));
+    CHECK(vresults.size() == 1 && vresults[0].type == CVT_Reals && vresults[0].realvalues.size() == 2 && vresults[0].realvalues[1] == 3);
+
+    // schema validation
+    int numerrors = 0;
+    std::vector<CommandValue> vbadargs;
+    vbadargs.push_back(CommandValue("3"));
+    vbadargs.push_back(CommandValue(2.0));
+    try { module->SendStructuredCommand("scale", vbadargs, vresults); } catch(const openrave_exception& ex) { numerrors += ex.GetCode() == ORE_InvalidArguments; }
+    vbadargs.resize(1);
+    vbadargs[0] = CommandValue(3);
+    try { module->SendStructuredCommand("scale", vbadargs, vresults); } catch(const openrave_exception& ex) { numerrors += ex.GetCode() == ORE_InvalidArguments; }
+    vbadargs = vargs;
+    vbadargs.push_back(CommandValue(true));
+    try { module->SendStructuredCommand("scale", vbadargs, vresults); } catch(const openrave_exception& ex) { numerrors += ex.GetCode() == ORE_InvalidArguments; }
+    std::vector<CommandArgument> vschema;
+    vschema.push_back(CommandArgument("a", CVT_Int, true));
+    vschema.push_back(CommandArgument("b", CVT_Int));
+    try { module->Register("Invalid", vschema); } catch(const openrave_exception& ex) { numerrors += ex.GetCode() == ORE_InvalidArguments; }
+    try { module->SendStructuredCommand("missing", vargs, vresults); } catch(const openrave_exception& ex) { numerrors += ex.GetCode() == ORE_CommandNotSupported; }
+    CHECK(numerrors == 5);
+    CHECK(!module->SupportsCommand("invalid"));
+
+    // text compatibility in both directions
+    std::stringstream sout, sinput;
+    sinput.str("Scale 3 2");
+    CHECK(module->SendCommand(sout, sinput) && sout.str() == "3 6");
+    sout.str(""); sinput.clear(); sinput.str("Scale 3 2 2 1 2 ");
+    CHECK(module->SendCommand(sout, sinput) && sout.str() == "2 2 4");
+    sout.str(""); sinput.clear(); sinput.str("Scale 3 2 2 1 2 5");
+    try { module->SendCommand(sout, sinput); CHECK(false); } catch(const openrave_exception& ex) { CHECK(ex.GetCode() == ORE_InvalidArguments); }
+    sout.str(""); sinput.clear(); sinput.str("Scale 3");
+    try { module->SendCommand(sout, sinput); CHECK(false); } catch(const openrave_exception& ex) { CHECK(ex.GetCode() == ORE_InvalidArguments); }
+    vargs.resize(0);
+    vargs.push_back(CommandValue(1));
+    vargs.push_back(CommandValue("a"));
+    CHECK(module->SendStructuredCommand("echo", vargs, vresults));
+    CHECK(vresults.size() == 1 && vresults[0].type == CVT_String && vresults[0].stringvalue == "1 a");
+
+    // reals keep their precision and strings with whitespace or quotes survive the text form
+    {
+        std::stringstream ss;
+        dReal fvalue = dReal(0.1)+dReal(1e-12);
+        std::string svalue = "a \\"quoted\\" \\\\ string";
+        CommandValue(fvalue).Write(ss);
+        ss << " ";
+        CommandValue(svalue).Write(ss);
+        ss << " ";
+        CommandValue(std::string()).Write(ss);
+        ss << " ";
+        CommandValue("word").Write(ss);
+        CHECK(ss.precision() == 6);
+        CommandValue value;
+        CHECK(value.Read(ss, CVT_Real) && fabs(value.realvalue-fvalue) <= 1e-15);
+        CHECK(value.Read(ss, CVT_String) && value.stringvalue == svalue);
+        CHECK(value.Read(ss, CVT_String) && value.stringvalue.size() == 0);
+        CHECK(value.Read(ss, CVT_String) && value.stringvalue == "word");
+        ss.clear();
+        ss.str("\\"unterminated");
+        CHECK(!value.Read(ss, CVT_String));
+    }
+
+    // registering while sending from other threads
+    boost::thread_group threads;
+    for(int i = 0; i < 4; ++i) {
+        threads.create_thread(boost::bind(SendLoop, module, 20000));
+    }
+    threads.create_thread(boost::bind(RegisterLoop, module, 2000));
+    threads.join_all();
+    CHECK(!s_bfailed);
+    CHECK(module->SupportsCommand("scale") && module->SupportsCommand("echo"));
+
+    module.reset();
+    penv->Destroy();
+    RaveDestroy();
+    return 0;
+}
+    """
+    CompileRunCPP('teststructuredcommands',cppdata,usecore=True)
+
+def test_cppclonejoints():
+    cppdata="""#include <openrave-core.h>
+#include <iostream>
+using namespace OpenRAVE;
+using namespace std;
+
+#define CHECK(expr) if( !(expr) ) { cerr << "line " << __LINE__ << ": " << #expr << " failed" << endl; return 1; }
+
+static const char* s_mimicxml = "<KinBody name='a'>"
+"<Body name='L0'/>"
+"<Body name='L1'><translation>0 0 0.3</translation></Body>"
+"<Body name='L2'><translation>0 0.2 0.5</translation></Body>"
+"<Body name='L3'><translation>0.1 0 0.8</translation></Body>"
+"<Joint name='J0' type='hinge'><Body>L0</Body><Body>L1</Body><axis>0 0 1</axis><limitsdeg>-90 90</limitsdeg></Joint>"
+"<Joint name='J1' type='hinge'><Body>L1</Body><Body>L2</Body><anchor>0 0 0.3</anchor><axis>1 0 0</axis><limitsdeg>-90 90</limitsdeg></Joint>"
+"<Joint name='J1a' type='hinge' mimic_pos='2*J1+J0' mimic_vel='|J1 2 |J0 1' mimic_accel='|J1 0 |J0 0'><Body>L2</Body><Body>L3</Body><anchor>0 0.2 0.5</anchor><axis>0 1 0</axis></Joint>"
+"</KinBody>";
+
+int main()
+{
+    RaveInitialize(true);
+    EnvironmentBasePtr penv = RaveCreateEnvironment();
+    KinBodyPtr pbody = penv->ReadKinBodyData(KinBodyPtr(), s_mimicxml);
+    CHECK(!!pbody);
+    penv->Add(pbody);
+
+    // a clone that is never added to an environment has to be usable on its own
+    EnvironmentBasePtr penvclone = RaveCreateEnvironment();
+    KinBodyPtr pclone = RaveCreateKinBody(penvclone, "");
+    pclone->Clone(pbody, 0);
+    CHECK(pclone->GetDependencyOrderedJoints().size() == pbody->GetDependencyOrderedJoints().size());
+    for(size_t i = 0; i < pclone->GetDependencyOrderedJoints().size(); ++i) {
+        KinBody::JointPtr pjoint = pclone->GetDependencyOrderedJoints()[i];
+        CHECK(!!pjoint && pjoint->GetParent() == pclone && pjoint->GetName() == pbody->GetDependencyOrderedJoints()[i]->GetName());
+    }
+
+    std::vector<dReal> vvalues(pbody->GetDOF());
+    vvalues[0] = 0.4; vvalues[1] = -0.3;
+    pbody->SetDOFValues(vvalues);
+    pclone->SetDOFValues(vvalues);
+    for(size_t i = 0; i < pbody->GetLinks().size(); ++i) {
+        Transform t0 = pbody->GetLinks()[i]->GetTransform(), t1 = pclone->GetLinks()[i]->GetTransform();
+        CHECK((t0.trans-t1.trans).lengthsqr3() <= 1e-14 && min((t0.rot-t1.rot).lengthsqr4(), (t0.rot+t1.rot).lengthsqr4()) <= 1e-14);
+    }
+
+    // the DOF-ordered joints of the clone are its own, changing its limits leaves the original alone
+    std::vector<dReal> vmaxvel, vclonemaxvel;
+    pbody->GetDOFVelocityLimits(vmaxvel);
+    vclonemaxvel = vmaxvel;
+    for(size_t i = 0; i < vclonemaxvel.size(); ++i) {
+        vclonemaxvel[i] *= 0.5;
+    }
+    pclone->SetDOFVelocityLimits(vclonemaxvel);
+    std::vector<dReal> vtest;
+    pbody->GetDOFVelocityLimits(vtest);
+    CHECK(vtest == vmaxvel);
+    pclone->GetDOFVelocityLimits(vtest);
+    CHECK(vtest == vclonemaxvel);
+
+    pclone.reset();
+    penvclone->Destroy();
+    penv->Destroy();
+    RaveDestroy();
+    return 0;
+}
+    """
+    CompileRunCPP('testclonejoints',cppdata,usecore=True)
+
+def test_cpplinktransformstamps():
+    cppdata="""#include <openrave-core.h>
+#include <iostream>
+using namespace OpenRAVE;
+using namespace std;
+
+#define CHECK(expr) if( !(expr) ) { cerr << "line " << __LINE__ << ": " << #expr << " failed" << endl; return 1; }
+
+static const char* s_chainxml = "<KinBody name='a'>"
+"<Body name='L0'/>"
+"<Body name='L1'><translation>0 0 0.3</translation></Body>"
+"<Body name='L2'><translation>0 0.2 0.5</translation></Body>"
+"<Body name='L3'><translation>0.1 0 0.8</translation></Body>"
+"<Joint name='J0' type='hinge'><Body>L0</Body><Body>L1</Body><axis>0 0 1</axis><limitsdeg>-90 90</limitsdeg></Joint>"
+"<Joint name='J1' type='hinge'><Body>L1</Body><Body>L2</Body><anchor>0 0 0.3</anchor><axis>1 0 0</axis><limitsdeg>-90 90</limitsdeg></Joint>"
+"<Joint name='J2' type='slider'><Body>L2</Body><Body>L3</Body><axis>0 0 1</axis><limits>-0.1 0.1</limits></Joint>"
+"</KinBody>";
+
+static std::vector<int> GetStamps(KinBodyPtr pbody)
+{
+    std::vector<int> vstamps;
+    for(size_t i = 0; i < pbody->GetLinks().size(); ++i) {
+        vstamps.push_back(pbody->GetLinks()[i]->GetTransformStamp());
+    }
+    return vstamps;
+}
+
+int main()
+{
+    RaveInitialize(true);
+    EnvironmentBasePtr penv = RaveCreateEnvironment();
+    KinBodyPtr pbody = penv->ReadKinBodyData(KinBodyPtr(), s_chainxml);
+    CHECK(!!pbody);
+    penv->Add(pbody);
+
+    // moving J1 moves the links after it and keeps the stamps of the others
+    std::vector<dReal> vvalues(pbody->GetDOF(),0);
+    pbody->SetDOFValues(vvalues);
+    std::vector<int> vstamps = GetStamps(pbody);
+    vvalues[1] = 0.3;
+    pbody->SetDOFValues(vvalues);
+    std::vector<int> vnewstamps = GetStamps(pbody);
+    CHECK(vnewstamps[0] == vstamps[0] && vnewstamps[1] == vstamps[1]);
+    CHECK(vnewstamps[2] == pbody->GetUpdateStamp() && vnewstamps[3] == pbody->GetUpdateStamp());
+
+    // setting the same values moves nothing
+    int nbodystamp = pbody->GetUpdateStamp();
+    pbody->SetDOFValues(vvalues);
+    CHECK(pbody->GetUpdateStamp() != nbodystamp);
+    CHECK(GetStamps(pbody) == vnewstamps);
+
+    // the last link only
+    vvalues[2] = 0.05;
+    pbody->SetDOFValues(vvalues);
+    vstamps = GetStamps(pbody);
+    CHECK(vstamps[2] == vnewstamps[2] && vstamps[3] == pbody->GetUpdateStamp());
+
+    // moving the base moves every link
+    Transform t = pbody->GetTransform();
+    t.trans.x += 0.5;
+    pbody->SetTransform(t);
+    vstamps = GetStamps(pbody);
+    for(size_t i = 0; i < vstamps.size(); ++i) {
+        CHECK(vstamps[i] == pbody->GetUpdateStamp());
+    }
+    t.trans.y += 0.5;
+    pbody->SetDOFValues(vvalues, t);
+    vstamps = GetStamps(pbody);
+    for(size_t i = 0; i < vstamps.size(); ++i) {
+        CHECK(vstamps[i] == pbody->GetUpdateStamp());
+    }
+    CHECK((pbody->GetTransform().trans-t.trans).lengthsqr3() <= 1e-14);
+
+    // a link moved on its own
+    vnewstamps = vstamps;
+    pbody->GetLinks()[1]->SetTransform(pbody->GetLinks()[1]->GetTransform());
+    vstamps = GetStamps(pbody);
+    CHECK(vstamps[1] == pbody->GetUpdateStamp() && vstamps[0] == vnewstamps[0] && vstamps[2] == vnewstamps[2] && vstamps[3] == vnewstamps[3]);
+
+    penv->Destroy();
+    RaveDestroy();
+    return 0;
+}
+    """
+    CompileRunCPP('testlinktransformstamps',cppdata,usecore=True)
+
+def test_cppjacobianchains():
+    cppdata="""#include <openrave-core.h>
+#include <iostream>
+#include <cmath>
+using namespace OpenRAVE;
+using namespace std;
+
+#define CHECK(expr) if( !(expr) ) { cerr << "line " << __LINE__ << ": " << #expr << " failed" << endl; return 1; }
+
+static bool IsClose(const dReal* pstrided, size_t stride, const std::vector<dReal>& vdense, size_t numcolumns)
+{
+    for(size_t i = 0; i < vdense.size(); ++i) {
+        if( fabs(pstrided[(i/numcolumns)*stride+(i%numcolumns)]-vdense[i]) > 1e-7 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// checks the jacobians of ComputeJacobians with central differences of the link pose, and its hessians with central differences of the jacobians
+static int CheckDerivatives(KinBodyPtr pbody, int linkindex, const std::vector<int>& dofindices, const Vector& localposition)
+{
+    KinBody::JacobianChainConstPtr pchain = pbody->GetJacobianChain(linkindex, dofindices);
+    const size_t numcolumns = pchain->numcolumns;
+    const dReal fdelta = 1e-5;
+    std::vector<dReal> vvalues;
+    pbody->GetDOFValues(vvalues);
+    Transform tlink = pbody->GetLinks().at(linkindex)->GetTransform();
+    std::vector<dReal> vtranslation(3*numcolumns), vaxisangle(3*numcolumns), vhessiantranslation(3*numcolumns*numcolumns), vhessianaxisangle(3*numcolumns*numcolumns);
+    pbody->ComputeJacobians(*pchain, tlink*localposition, &vtranslation[0], &vaxisangle[0], &vhessiantranslation[0], &vhessianaxisangle[0]);
+    if( pchain->bHasMimic ) {
+        // the hessians of mimic joints are copied from the std::vector functions, only the jacobians are compared with finite differences
+        std::vector<dReal> vhessian;
+        pbody->ComputeHessianTranslation(linkindex, tlink*localposition, vhessian, dofindices);
+        CHECK(IsClose(&vhessiantranslation[0], numcolumns, vhessian, numcolumns));
+        pbody->ComputeHessianAxisAngle(linkindex, vhessian, dofindices);
+        CHECK(IsClose(&vhessianaxisangle[0], numcolumns, vhessian, numcolumns));
+    }
+    // vdiff[k+numcolumns*(j+3*i)] is the derivative of jacobian[j,k] by dof i
+    std::vector<dReal> vdifftranslation(3*numcolumns*numcolumns, 0), vdiffaxisangle(3*numcolumns*numcolumns, 0), vtemptranslation(3*numcolumns), vtempaxisangle(3*numcolumns);
+    for(size_t i = 0; i < numcolumns; ++i) {
+        Transform tlinks[2];
+        for(int iside = 0; iside < 2; ++iside) {
+            dReal sign = iside == 0 ? -1 : 1;
+            std::vector<dReal> vnewvalues = vvalues;
+            vnewvalues.at(dofindices.size() > 0 ? dofindices[i] : i) += sign*fdelta;
+            pbody->SetDOFValues(vnewvalues, KinBody::CLA_Nothing);
+            tlinks[iside] = pbody->GetLinks().at(linkindex)->GetTransform();
+            pbody->ComputeJacobians(*pchain, tlinks[iside]*localposition, &vtemptranslation[0], &vtempaxisangle[0]);
+            for(size_t k = 0; k < 3*numcolumns; ++k) {
+                vdifftranslation[3*numcolumns*i+k] += sign*vtemptranslation[k]/(2*fdelta);
+                vdiffaxisangle[3*numcolumns*i+k] += sign*vtempaxisangle[k]/(2*fdelta);
+            }
+        }
+        Vector vdifftrans = (tlinks[1]*localposition-tlinks[0]*localposition)*(0.5/fdelta);
+        Vector vdiffrot = axisAngleFromQuat(quatMultiply(tlinks[1].rot, quatInverse(tlinks[0].rot)))*(0.5/fdelta);
+        for(int j = 0; j < 3; ++j) {
+            CHECK(fabs(vtranslation[j*numcolumns+i]-vdifftrans[j]) < 1e-5);
+            CHECK(fabs(vaxisangle[j*numcolumns+i]-vdiffrot[j]) < 1e-5);
+        }
+    }
+    pbody->SetDOFValues(vvalues, KinBody::CLA_Nothing);
+    if( pchain->bHasMimic ) {
+        return 0;
+    }
+    for(size_t i = 0; i < numcolumns; ++i) {
+        for(size_t j = 0; j < 3; ++j) {
+            for(size_t k = 0; k < numcolumns; ++k) {
+                CHECK(fabs(vhessiantranslation[k+numcolumns*(j+3*i)]-vdifftranslation[k+numcolumns*(j+3*i)]) < 1e-5);
+                // the axis-angle hessian is stored symmetrically, while only the axes after a joint on the chain move with it
+                CHECK(fabs(vhessianaxisangle[k+numcolumns*(j+3*i)]-vdiffaxisangle[k+numcolumns*(j+3*i)]-vdiffaxisangle[i+numcolumns*(j+3*k)]) < 1e-5);
+            }
+        }
+    }
+    return 0;
+}
+
+static const char* s_mimicxml = "<robot name='mimic'><kinbody>"
+"<body name='L0'/><body name='L1'><translation>0 0 0.3</translation></body><body name='L2'><translation>0 0.2 0.5</translation></body><body name='L3'><translation>0.1 0 0.8</translation></body><body name='L4'><translation>0.1 0.1 1.0</translation></body>"
+"<joint name='J0' type='hinge'><body>L0</body><body>L1</body><axis>0 0 1</axis><limitsdeg>-90 90</limitsdeg></joint>"
+"<joint name='J1' type='hinge'><body>L1</body><body>L2</body><anchor>0 0 0.3</anchor><axis>1 0 0</axis><limitsdeg>-90 90</limitsdeg></joint>"
+"<joint name='J1a' type='hinge' mimic_pos='2*J1+J0' mimic_vel='|J1 2 |J0 1' mimic_accel='|J1 0 |J0 0'><body>L2</body><body>L3</body><anchor>0 0.2 0.5</anchor><axis>0 1 0</axis></joint>"
+"<joint name='J2' type='slider'><body>L3</body><body>L4</body><axis>0.6 0 0.8</axis><limits>-1 1</limits></joint>"
+"</kinbody></robot>";
+
+int main()
+{
+    RaveInitialize(true);
+    EnvironmentBasePtr penv = RaveCreateEnvironment();
+    RobotBasePtr probot = penv->ReadRobotURI("robots/barrettwam.robot.xml");
+    CHECK(!!probot);
+    penv->Add(probot);
+    std::vector<dReal> vvalues(probot->GetDOF());
+    for(size_t i = 0; i < vvalues.size(); ++i) {
+        vvalues[i] = 0.1*(i+1);
+    }
+    probot->SetDOFValues(vvalues);
+    int linkindex = probot->GetActiveManipulator()->GetEndEffector()->GetIndex();
+    Vector position = probot->GetLinks().at(linkindex)->GetTransform()*Vector(0.01,0.02,0.1);
+
+    // strided ComputeJacobians writes the same values as the std::vector functions and leaves the extra columns alone
+    std::vector<int> vdofindices;
+    vdofindices.push_back(3); vdofindices.push_back(0); vdofindices.push_back(2); vdofindices.push_back(5);
+    for(int iset = 0; iset < 2; ++iset) {
+        const std::vector<int>& dofindices = iset == 0 ? std::vector<int>() : vdofindices;
+        KinBody::JacobianChainConstPtr pchain = probot->GetJacobianChain(linkindex, dofindices);
+        CHECK(probot->GetJacobianChain(linkindex, dofindices) == pchain);
+        size_t numcolumns = pchain->numcolumns, stride = numcolumns+2;
+        std::vector<dReal> vtranslation(3*stride, 100), vaxisangle(3*stride, 100), vhessiantranslation(3*numcolumns*stride, 100), vhessianaxisangle(3*numcolumns*stride, 100);
+        probot->ComputeJacobians(*pchain, position, &vtranslation[0], &vaxisangle[0], &vhessiantranslation[0], &vhessianaxisangle[0], stride);
+        std::vector<dReal> vjacobian;
+        probot->ComputeJacobianTranslation(linkindex, position, vjacobian, dofindices);
+        CHECK(IsClose(&vtranslation[0], stride, vjacobian, numcolumns));
+        probot->ComputeJacobianAxisAngle(linkindex, vjacobian, dofindices);
+        CHECK(IsClose(&vaxisangle[0], stride, vjacobian, numcolumns));
+        probot->ComputeHessianTranslation(linkindex, position, vjacobian, dofindices);
+        CHECK(IsClose(&vhessiantranslation[0], stride, vjacobian, numcolumns));
+        probot->ComputeHessianAxisAngle(linkindex, vjacobian, dofindices);
+        CHECK(IsClose(&vhessianaxisangle[0], stride, vjacobian, numcolumns));
+        for(size_t i = 0; i < 3*numcolumns; ++i) {
+            for(size_t j = numcolumns; j < stride; ++j) {
+                CHECK(i >= 3 || (vtranslation[i*stride+j] == 100 && vaxisangle[i*stride+j] == 100));
+                CHECK(vhessiantranslation[i*stride+j] == 100 && vhessianaxisangle[i*stride+j] == 100);
+            }
+        }
+        CHECK(CheckDerivatives(probot, linkindex, dofindices, Vector(0.01,0.02,0.1)) == 0);
+    }
+
+    // the affine columns follow the joint columns of the active jacobian, compare with finite differences
+    std::vector<int> varmindices = probot->GetActiveManipulator()->GetArmIndices();
+    probot->SetActiveDOFs(varmindices, DOF_X|DOF_Y|DOF_Z|DOF_RotationAxis, Vector(0,0,1));
+    Vector localposition(0.01,0.02,0.1);
+    std::vector<dReal> vactivevalues, vjacobian;
+    probot->GetActiveDOFValues(vactivevalues);
+    position = probot->GetLinks().at(linkindex)->GetTransform()*localposition;
+    probot->CalculateActiveJacobian(linkindex, position, vjacobian);
+    int numactive = probot->GetActiveDOF();
+    CHECK((int)vjacobian.size() == 3*numactive);
+    const dReal fdelta = 1e-5;
+    for(int i = 0; i < numactive; ++i) {
+        std::vector<dReal> vnewvalues = vactivevalues;
+        vnewvalues[i] += fdelta;
+        probot->SetActiveDOFValues(vnewvalues, KinBody::CLA_Nothing);
+        Vector newposition = probot->GetLinks().at(linkindex)->GetTransform()*localposition;
+        for(int j = 0; j < 3; ++j) {
+            CHECK(fabs((newposition[j]-position[j])/fdelta-vjacobian[j*numactive+i]) < 1e-3);
+        }
+    }
+    probot->SetActiveDOFValues(vactivevalues, KinBody::CLA_Nothing);
+
+    // many dof index sets are cached without affecting the results
+    for(int i = 0; i < 20; ++i) {
+        std::vector<int> dofindices(1, i%probot->GetDOF());
+        dofindices.push_back(i/probot->GetDOF());
+        probot->GetJacobianChain(linkindex, dofindices);
+    }
+    KinBody::JacobianChainConstPtr pchain = probot->GetJacobianChain(linkindex, vdofindices);
+    std::vector<dReal> vtranslation(3*vdofindices.size());
+    probot->ComputeJacobians(*pchain, position, &vtranslation[0], NULL);
+    probot->ComputeJacobianTranslation(linkindex, position, vjacobian, vdofindices);
+    CHECK(IsClose(&vtranslation[0], vdofindices.size(), vjacobian, vdofindices.size()));
+
+    // a chain computed before the kinematics changed is rejected
+    penv->Remove(probot);
+    penv->Add(probot);
+    bool bInvalidState = false;
+    try {
+        probot->ComputeJacobians(*pchain, position, &vtranslation[0], NULL);
+    }
+    catch(const openrave_exception& ex) {
+        bInvalidState = ex.GetCode() == ORE_InvalidState;
+    }
+    CHECK(bInvalidState);
+    pchain = probot->GetJacobianChain(linkindex, vdofindices);
+    probot->ComputeJacobians(*pchain, position, &vtranslation[0], NULL);
+
+    // a mimic joint on the chain uses the std::vector functions
+    RobotBasePtr pmimic = penv->ReadRobotData(RobotBasePtr(), s_mimicxml);
+    CHECK(!!pmimic);
+    penv->Add(pmimic);
+    Transform tmimic;
+    tmimic.rot = quatFromAxisAngle(Vector(0.3,0.2,0.1));
+    tmimic.trans = Vector(0.5,-0.2,0.1);
+    pmimic->SetTransform(tmimic);
+    std::vector<dReal> vmimicvalues(pmimic->GetDOF());
+    for(size_t i = 0; i < vmimicvalues.size(); ++i) {
+        vmimicvalues[i] = 0.2*(i+1);
+    }
+    pmimic->SetDOFValues(vmimicvalues);
+    int mimiclinkindex = pmimic->GetLink("L4")->GetIndex();
+    CHECK(pmimic->GetJacobianChain(mimiclinkindex)->bHasMimic);
+    CHECK(CheckDerivatives(pmimic, mimiclinkindex, std::vector<int>(), Vector(0.01,0.02,0.1)) == 0);
+    std::vector<int> vmimicdofindices;
+    vmimicdofindices.push_back(2); vmimicdofindices.push_back(0);
+    CHECK(CheckDerivatives(pmimic, mimiclinkindex, vmimicdofindices, Vector(0.01,0.02,0.1)) == 0);
+
+    // the chain of another body is rejected
+    bool bInvalidArguments = false;
+    try {
+        probot->ComputeJacobians(*pmimic->GetJacobianChain(mimiclinkindex), position, &vtranslation[0], NULL);
+    }
+    catch(const openrave_exception& ex) {
+        bInvalidArguments = ex.GetCode() == ORE_InvalidArguments;
+    }
+    CHECK(bInvalidArguments);
+
+    penv->Destroy();
+    RaveDestroy();
+    return 0;
+}
+    """
+    CompileRunCPP('testjacobianchains',cppdata,usecore=True)
+
+def test_cppcontinuousfilterreturn():
+    cppdata="""#include <openrave-core.h>
+#include <openrave/planningutils.h>
+#include <iostream>
+#include <cmath>
+using namespace OpenRAVE;
+using namespace std;
+
+#define CHECK(expr) if( !(expr) ) { cerr << "line " << __LINE__ << ": " << #expr << " failed" << endl; return 1; }
+
+static const char* s_armxml = "<KinBody name='arm'>"
+"<Body name='base'><Geom type='box'><extents>0.02 0.02 0.02</extents></Geom></Body>"
+"<Body name='link'><Geom type='box'><extents>0.5 0.02 0.02</extents><translation>0.6 0 0</translation></Geom></Body>"
+"<Joint name='j0' type='hinge'><Body>base</Body><Body>link</Body><axis>0 0 1</axis><limitsrad>-3 3</limitsrad></Joint>"
+"</KinBody>";
+
+int main()
+{
+    RaveInitialize(true);
+    EnvironmentBasePtr penv = RaveCreateEnvironment();
+    CollisionCheckerBasePtr pchecker = RaveCreateCollisionChecker(penv, "pqp");
+    CHECK(!!pchecker);
+    penv->SetCollisionChecker(pchecker);
+    KinBodyPtr parm = penv->ReadKinBodyData(KinBodyPtr(), s_armxml);
+    CHECK(!!parm);
+    penv->Add(parm);
+    // a thin wall along the 0.5 rad direction, the arm sweeping from 0 to 1 rad hits its side
+    KinBodyPtr pwall = RaveCreateKinBody(penv, "");
+    std::vector<AABB> vboxes(1, AABB(Vector(0,0,0), Vector(0.4,0.002,0.1)));
+    pwall->InitFromBoxes(vboxes, true);
+    pwall->SetName("wall");
+    penv->Add(pwall);
+    Transform twall;
+    twall.rot = quatFromAxisAngle(Vector(0,0,0.5));
+    twall.trans = Vector(0.8*cos(0.5), 0.8*sin(0.5), 0);
+    pwall->SetTransform(twall);
+
+    PlannerBase::PlannerParametersPtr params(new PlannerBase::PlannerParameters());
+    params->SetConfigurationSpecification(penv, parm->GetConfigurationSpecificationIndices(std::vector<int>(1, 0)));
+    std::list<KinBodyPtr> listCheckBodies(1, parm);
+    planningutils::DynamicsCollisionConstraint constraint(params, listCheckBodies);
+    constraint.SetContinuousCollisionChecking(true);
+    ConstraintFilterReturnPtr filterreturn(new ConstraintFilterReturn());
+    std::vector<dReal> q0(1, 0), q1(1, 1), dq0, dq1, vtest(1);
+
+    // line segment, the time is the interpolation coefficient
+    CHECK(constraint.Check(q0, q1, dq0, dq1, 0, IT_Closed, 0xffff, filterreturn) & CFO_CheckEnvCollisions);
+    CHECK(filterreturn->_returncode & CFO_CheckEnvCollisions);
+    CHECK(filterreturn->_fTimeWhenInvalid > 0.3 && filterreturn->_fTimeWhenInvalid < 0.5);
+    CHECK(filterreturn->_invalidvalues.size() == 1 && fabs(filterreturn->_invalidvalues[0]-filterreturn->_fTimeWhenInvalid) < 1e-7);
+    CHECK(filterreturn->_invalidvelocities.size() == 0);
+    // the contact is at the reported configuration
+    vtest[0] = filterreturn->_invalidvalues[0] - 0.01;
+    parm->SetDOFValues(vtest);
+    CHECK(!penv->CheckCollision(KinBodyConstPtr(parm)));
+    vtest[0] = filterreturn->_invalidvalues[0] + 0.01;
+    parm->SetDOFValues(vtest);
+    CHECK(penv->CheckCollision(KinBodyConstPtr(parm)));
+    dReal flinetime = filterreturn->_fTimeWhenInvalid;
+
+    // parabolic segment q(t) = 0.25*t^2 over 2s reaches the same configuration at its time of impact
+    dq0.resize(1, 0);
+    dq1.resize(1, 1);
+    filterreturn->Clear();
+    CHECK(constraint.Check(q0, q1, dq0, dq1, 2, IT_Closed, 0xffff, filterreturn) & CFO_CheckEnvCollisions);
+    dReal t = filterreturn->_fTimeWhenInvalid;
+    CHECK(t > 0 && t < 2);
+    CHECK(filterreturn->_invalidvalues.size() == 1 && fabs(filterreturn->_invalidvalues[0]-0.25*t*t) < 1e-7);
+    CHECK(filterreturn->_invalidvelocities.size() == 1 && fabs(filterreturn->_invalidvelocities[0]-0.5*t) < 1e-7);
+    CHECK(fabs(filterreturn->_invalidvalues[0]-flinetime) < 0.01);
+
+    penv->Destroy();
+    RaveDestroy();
+    return 0;
+}
+    """
+    CompileRunCPP('testcontinuousfilterreturn',cppdata,usecore=True)
     
 def test_createplugin():
     curdir = os.getcwd()
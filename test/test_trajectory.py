@@ -179,6 +179,54 @@ class TestTrajectory(EnvironmentSetup):
         assert(robot.WaitForController(0.1))
         assert(robot.GetGrabbed()[-1] == body1)
 
+    def test_convertdata(self):
+        env = self.env
+        with env:
+            self.LoadEnv('robots/barrettwam.robot.xml')
+            robot=env.GetRobots()[0]
+            robot.SetDOFValues(arange(robot.GetDOF())*0.1)
+            sourcespec=robot.GetConfigurationSpecificationIndices([0,1,2])
+            targetspec=robot.GetConfigurationSpecificationIndices([2,0,4])
+            targetspec.AddDeltaTimeGroup()
+            sourcedata = array([1.0,2.0,3.0,4.0,5.0,6.0])
+            targetdata = sourcespec.ConvertData(targetspec,sourcedata,2,env,True)
+            assert(transdist(targetdata,[3.0,1.0,0.4,0,6.0,4.0,0.4,0]) <= g_epsilon)
+
+    def test_sampleconversion(self):
+        env = self.env
+        with env:
+            self.LoadEnv('robots/barrettwam.robot.xml')
+            robot=env.GetRobots()[0]
+            robot.SetDOFValues(arange(robot.GetDOF())*0.1)
+            trajspec=robot.GetConfigurationSpecificationIndices([0,1,2],'linear')
+            trajspec.AddDeltaTimeGroup()
+            traj=RaveCreateTrajectory(env,'')
+            traj.Init(trajspec)
+            traj.Insert(0,[1.0,2.0,3.0,0,2.0,4.0,6.0,1.0])
+
+            # reordered groups, repeated samples reuse the conversion
+            reorderedspec=robot.GetConfigurationSpecificationIndices([2,0,1],'linear')
+            for i in range(3):
+                assert(transdist(traj.Sample(0.5,reorderedspec),[4.5,1.5,3.0]) <= g_epsilon)
+            assert(transdist(traj.GetWaypoints(0,2,reorderedspec),[3.0,1.0,2.0,6.0,2.0,4.0]) <= g_epsilon)
+
+            # dof 4 and the transform are not in the trajectory, so they come from the current state of the robot on every sample
+            missingspec=robot.GetConfigurationSpecificationIndices([2,4],'linear')
+            missingspec.AddGroup('affine_transform %s %d'%(robot.GetName(),DOFAffine.Transform),7,'linear')
+            robot.SetTransform(eye(4))
+            assert(transdist(traj.Sample(0.5,missingspec),[4.5,0.4,0,0,0,1,0,0,0]) <= g_epsilon)
+            robot.SetDOFValues([1.0],[4])
+            T=eye(4)
+            T[0:3,3] = [1,2,3]
+            robot.SetTransform(T)
+            assert(transdist(traj.Sample(0.5,missingspec),[4.5,1.0,1,2,3,1,0,0,0]) <= g_epsilon)
+            assert(transdist(traj.Sample(1.0,reorderedspec),[6.0,2.0,4.0]) <= g_epsilon)
+
+            # inserting reordered data reuses the conversion, the missing deltatime is set to 0
+            traj.Insert(2,[9.0,7.0,8.0],reorderedspec)
+            traj.Insert(3,[12.0,10.0,11.0],reorderedspec)
+            assert(transdist(traj.GetWaypoints(2,4),[7.0,8.0,9.0,0,10.0,11.0,12.0,0]) <= g_epsilon)
+
     def test_smoothingsamepoint(self):
         env = self.env
         self.LoadEnv('data/lab1.env.xml')
@@ -363,6 +411,25 @@ class TestTrajectory(EnvironmentSetup):
             ret=planningutils.RetimeActiveDOFTrajectory(traj,robot,False,maxvelmult=1,maxaccelmult=1,plannername='parabolictrajectoryretimer',plannerparameters='<multidofinterp>1</multidofinterp>')
             assert(ret==PlannerStatus.HasSolution)
 
+    def test_longretiming(self):
+        env=self.env
+        with env:
+            self.LoadEnv('robots/barrettwam.robot.xml')
+            robot=env.GetRobots()[0]
+            robot.SetActiveDOFs(range(7))
+            lower,upper = robot.GetActiveDOFLimits()
+            traj = RaveCreateTrajectory(env,'')
+            traj.Init(robot.GetActiveConfigurationSpecification())
+            # long enough for the segments to be checked in several blocks
+            for i in range(3000):
+                traj.Insert(i,0.5*(lower+upper)+0.2*(upper-lower)*sin(0.01*i+arange(7)))
+            ret=planningutils.RetimeActiveDOFTrajectory(traj,robot,False,maxvelmult=1,maxaccelmult=1,plannername='parabolictrajectoryretimer')
+            assert(ret==PlannerStatus.HasSolution)
+            duration = traj.GetDuration()
+            ret=planningutils.RetimeActiveDOFTrajectory(traj,robot,True,maxvelmult=1,maxaccelmult=1,plannername='parabolictrajectoryretimer',plannerparameters='<hasvelocities>1</hasvelocities>')
+            assert(ret==PlannerStatus.HasSolution)
+            assert(abs(traj.GetDuration()-duration) <= g_epsilon)
+
     def test_simpleretiming(self):
         env=self.env
         robot=self.LoadRobot('robots/pumaarm.zae')